@@ -47,6 +47,7 @@ the original Fortran code:
 
 #include <math.h>
 #include <string.h>
+#include <stdlib.h>
 
 #ifndef M_PI
 #define M_PI           3.14159265358979323846
@@ -162674,6 +162675,146 @@ const double w[5] = {
 static const double a0_div_ath_times_au =
   384747.9806448954 / (384747.9806743165 * 149597870.691);
 
+  /* Truncated series, same as in vsop87.c:
+     the terms which cannot move the moon by more than the tolerance
+     are removed from a copy of the instructions and coefficients,
+     the dropped terms sum up to less than the tolerance.
+     The copy is only used for |t| <= ELP82B_TRUNCATION_T. */
+#define ELP82B_NR_OF_TERMS 37514
+  /* below this tolerance (AU) the full series is used: */
+#define ELP82B_MIN_TOLERANCE 1e-9
+  /* 1000..3000, bounds the terms of order t^alpha: */
+#define ELP82B_TRUNCATION_T 10.0
+  /* upper bound of the distance to the earth (AU), converts the angles into AU */
+#define ELP82B_MAX_DISTANCE 0.00272
+#define ELP82B_MAX_DEPTH 32
+
+static int elp82b_requested_level = -1;
+static int elp82b_truncated_level = -1;
+static unsigned char elp82b_truncated_instructions[sizeof(elp82b_instructions)];
+static double elp82b_truncated_coefficients[ELP82B_NR_OF_TERMS*2];
+static double *elp82b_term_weight = 0;
+static double *elp82b_sorted_weight = 0;
+
+static
+int CompareElp82bWeight(const void *a,const void *b) {
+  const double wa = *(const double*)a;
+  const double wb = *(const double*)b;
+  return (wa > wb) - (wa < wb);
+}
+
+static
+void InitElp82bWeights(void) {
+  const unsigned char *instructions = elp82b_instructions;
+  const double *coefficients = elp82b_coefficients;
+  double accu_scale[9];
+  int k,term = 0;
+  for (k=0;k<9;k++) {
+      /* accu[k] is of order t^(k/3), longitude, latitude in arcsec then distance */
+    const int alpha = k / 3;
+    accu_scale[k] = ((k % 3) == 2) ? a0_div_ath_times_au
+                  : ELP82B_MAX_DISTANCE * (M_PI/(180*3600));
+    if (alpha > 0) accu_scale[k] *= pow(ELP82B_TRUNCATION_T,alpha);
+  }
+  elp82b_term_weight = (double*)malloc(ELP82B_NR_OF_TERMS*sizeof(double));
+  elp82b_sorted_weight = (double*)malloc(ELP82B_NR_OF_TERMS*sizeof(double));
+  for (;;) {
+    int term_count = *instructions++;
+    if (term_count < 0xFE) {
+      instructions++;
+      term_count >>= 4;
+      while (--term_count >= 0) {
+        const int j = *instructions++;
+        elp82b_term_weight[term] = sqrt(coefficients[0]*coefficients[0]
+                                      + coefficients[1]*coefficients[1])
+                                 * accu_scale[j];
+        elp82b_sorted_weight[term] = elp82b_term_weight[term];
+        coefficients += 2;
+        term++;
+      }
+    } else if (term_count == 0xFF) break;
+  }
+  qsort(elp82b_sorted_weight,ELP82B_NR_OF_TERMS,sizeof(double),
+        &CompareElp82bWeight);
+}
+
+static
+void TruncateElp82bTerms(const double cutoff) {
+    /* copy the terms heavier than the cutoff,
+       the arguments left without terms are removed */
+  const unsigned char *instructions = elp82b_instructions;
+  const double *coefficients = elp82b_coefficients;
+  unsigned char *out = elp82b_truncated_instructions;
+  double *out_coefficients = elp82b_truncated_coefficients;
+  unsigned char *node_out[ELP82B_MAX_DEPTH];
+  double *node_coefficients[ELP82B_MAX_DEPTH];
+  int node_used[ELP82B_MAX_DEPTH];
+  int depth = 0;
+  int term = 0;
+  for (;;) {
+    int term_count = *instructions++;
+    if (term_count < 0xFE) {
+      int kept = 0;
+      unsigned char *header;
+      node_out[depth] = out;
+      node_coefficients[depth] = out_coefficients;
+      header = out;
+      *out++ = term_count & 15;
+      *out++ = *instructions++;
+      term_count >>= 4;
+      while (--term_count >= 0) {
+        const int j = *instructions++;
+        if (elp82b_term_weight[term] > cutoff) {
+          *out++ = j;
+          out_coefficients[0] = coefficients[0];
+          out_coefficients[1] = coefficients[1];
+          out_coefficients += 2;
+          kept++;
+        }
+        coefficients += 2;
+        term++;
+      }
+      *header |= (kept << 4);
+      node_used[depth++] = (kept > 0);
+    } else {
+        /* pop the argument, or close all the arguments at the end */
+      do {
+        depth--;
+        if (node_used[depth]) {
+          if (term_count == 0xFE) *out++ = 0xFE;
+          if (depth > 0) node_used[depth-1] = 1;
+        } else {
+          out = node_out[depth];
+          out_coefficients = node_coefficients[depth];
+        }
+      } while (term_count == 0xFF && depth > 0);
+      if (term_count == 0xFF) {
+        *out++ = 0xFF;
+        break;
+      }
+    }
+  }
+}
+
+static
+void BuildElp82bTruncation(void) {
+  elp82b_truncated_level = elp82b_requested_level;
+  if (elp82b_requested_level >= 0) {
+      /* drop the lightest terms as long as their sum stays below the tolerance */
+    const double tolerance = ldexp(ELP82B_MIN_TOLERANCE,elp82b_requested_level);
+    double cutoff = -1.0;
+    double sum = 0.0;
+    int i;
+    if (!elp82b_term_weight) InitElp82bWeights();
+    for (i=0;i<ELP82B_NR_OF_TERMS;i++) {
+      sum += elp82b_sorted_weight[i];
+      if (sum > tolerance) break;
+      cutoff = elp82b_sorted_weight[i];
+    }
+    TruncateElp82bTerms(cutoff);
+  }
+}
+
 static
 void GetElp82bSphericalCoor(const double t,double r[3]) {
   int i,k;
@@ -162696,8 +162837,13 @@ void GetElp82bSphericalCoor(const double t,double r[3]) {
 
   PrepareElp82bLambdaArray(17,elp82b_max_lambda_factor,lambda,cos_sin_lambda);
   memcpy(accu,elp82b_constants,sizeof(elp82b_constants));
-  AccumulateElp82bTerms(elp82b_instructions,elp82b_coefficients,cos_sin_lambda,
-                        accu,stack);
+  if (elp82b_truncated_level >= 0 && fabs(t) <= ELP82B_TRUNCATION_T)
+    AccumulateElp82bTerms(elp82b_truncated_instructions,
+                          elp82b_truncated_coefficients,cos_sin_lambda,
+                          accu,stack);
+  else
+    AccumulateElp82bTerms(elp82b_instructions,elp82b_coefficients,
+                          cos_sin_lambda,accu,stack);
 
     /* calculate r1,r2,r3: */
   r[0] =   (accu[0] + w[0]
@@ -162731,9 +162877,22 @@ static const double q3 =  1.265417e-9;
 static const double q4 = -1.371808e-12;
 static const double q5 = -3.20334e-15;
 
+void SetElp82bTolerance(double tolerance) {
+  int level = -1;
+  if (tolerance >= ELP82B_MIN_TOLERANCE) {
+    level = (int)floor(log2(tolerance/ELP82B_MIN_TOLERANCE));
+  }
+  elp82b_requested_level = level;
+}
+
 void GetElp82bCoor(const double jd,double xyz[3]) {
   const double t = (jd - 2451545.0) / 36525.0;
   double r[3];
+  if (elp82b_requested_level != elp82b_truncated_level) {
+    BuildElp82bTruncation();
+      /* the cached coordinates were computed with the previous terms */
+    t_0 = t_1 = t_2 = -1e100;
+  }
   CalcInterpolatedElements(t,r,3,&GetElp82bSphericalCoor,DELTA_T,
                            &t_0,r_0,&t_1,r_1,&t_2,r_2);
   {
@@ -79,6 +79,13 @@ void GetElp82bCoor(double jd,double xyz[3]);
      ICRF, J2000 and FK5 are the same, while the transformation
      ICRF <-> VSOP87 must be done with the matrix given above.
    */
+
+void SetElp82bTolerance(double tolerance);
+  /* Accept a position error of tolerance AU for the moon:
+     between the years 1000 and 3000 the terms whose amplitudes sum up
+     to less than the tolerance are skipped. A tolerance of 0 (the default)
+     computes the full series.
+  */
      
 
 #ifdef __cplusplus
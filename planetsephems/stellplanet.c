@@ -83,6 +83,24 @@ void get_uranus_helio_osculating_coords(double jd0,double jd,double xyz[3])
 void get_neptune_helio_osculating_coords(double jd0,double jd,double xyz[3])
   {GetVsop87OsculatingCoor(jd0,jd,VSOP87_NEPTUNE,xyz);}
 
+/* Accept a position error of tolerance AU for the body, see SetVsop87Tolerance */
+void set_mercury_helio_tolerance(double tolerance)
+  {SetVsop87Tolerance(VSOP87_MERCURY,tolerance);}
+void set_venus_helio_tolerance(double tolerance)
+  {SetVsop87Tolerance(VSOP87_VENUS,tolerance);}
+void set_emb_helio_tolerance(double tolerance)
+  {SetVsop87Tolerance(VSOP87_EMB,tolerance);}
+void set_mars_helio_tolerance(double tolerance)
+  {SetVsop87Tolerance(VSOP87_MARS,tolerance);}
+void set_jupiter_helio_tolerance(double tolerance)
+  {SetVsop87Tolerance(VSOP87_JUPITER,tolerance);}
+void set_saturn_helio_tolerance(double tolerance)
+  {SetVsop87Tolerance(VSOP87_SATURN,tolerance);}
+void set_uranus_helio_tolerance(double tolerance)
+  {SetVsop87Tolerance(VSOP87_URANUS,tolerance);}
+void set_neptune_helio_tolerance(double tolerance)
+  {SetVsop87Tolerance(VSOP87_NEPTUNE,tolerance);}
+
 /* Calculate the rectangular geocentric lunar coordinates to the inertial mean
  * ecliptic and equinox of J2000.
  * The geocentric coordinates returned are in units of UA.
@@ -93,6 +111,9 @@ void get_neptune_helio_osculating_coords(double jd0,double jd,double xyz[3])
 void get_lunar_parent_coordsv(double jd,double xyz[3])
   {GetElp82bCoor(jd,xyz);}
 
+void set_lunar_parent_tolerance(double tolerance)
+  {SetElp82bTolerance(tolerance);}
+
 void get_phobos_parent_coordsv(double jd,double xyz[3])
   {GetMarsSatCoor(jd,MARS_SAT_PHOBOS,xyz);}
 void get_deimos_parent_coordsv(double jd,double xyz[3])
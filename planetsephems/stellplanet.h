@@ -48,7 +48,17 @@ void get_uranus_helio_osculating_coords(double jd0,double jd,double xyz[3]);
 void get_neptune_helio_osculating_coords(double jd0,double jd,double xyz[3]);
 void get_pluto_helio_osculating_coords(double jd0,double jd,double xyz[3]);
 
+void set_mercury_helio_tolerance(double tolerance);
+void set_venus_helio_tolerance(double tolerance);
+void set_emb_helio_tolerance(double tolerance);
+void set_mars_helio_tolerance(double tolerance);
+void set_jupiter_helio_tolerance(double tolerance);
+void set_saturn_helio_tolerance(double tolerance);
+void set_uranus_helio_tolerance(double tolerance);
+void set_neptune_helio_tolerance(double tolerance);
+
 void get_lunar_parent_coordsv(double jd,double xyz[3]);
+void set_lunar_parent_tolerance(double tolerance);
 
 void get_phobos_parent_coordsv(double jd,double xyz[3]);
 void get_deimos_parent_coordsv(double jd,double xyz[3]);
@@ -48,6 +48,7 @@ so that for given T the functions cos and sin have only to be called 12 times.
 #include "elliptic_to_rectangular.h"
 
 #include <string.h>
+#include <stdlib.h>
 #include <math.h>
 
 static
@@ -137262,6 +137263,181 @@ void AccumulateVsop87Terms(const unsigned char *instructions,
   }
 }
 
+  /* Truncated series:
+     the terms which cannot move a planet by more than its tolerance
+     are removed from a copy of the instructions and coefficients.
+     The weight of a term is its amplitude converted into a position
+     error, the dropped terms of a planet sum up to less than its tolerance.
+     The copy is only used for |t| <= VSOP87_TRUNCATION_T. */
+#define VSOP87_NR_OF_TERMS 61126
+  /* below this tolerance (AU) the full series is used: */
+#define VSOP87_MIN_TOLERANCE 1e-9
+  /* 1000..3000, the terms of order t^alpha are bounded by their amplitude: */
+#define VSOP87_TRUNCATION_T 1.0
+#define VSOP87_MAX_DEPTH 32
+
+  /* approximative semi-major axes, converts the elements into AU */
+static
+const double vsop87_a[8] = {
+  0.387, 0.723, 1.000, 1.524, 5.203, 9.537, 19.19, 30.07
+};
+
+struct Vsop87Weight {
+  double weight;
+  int body;
+};
+
+static int vsop87_requested_level[8] = {-1,-1,-1,-1,-1,-1,-1,-1};
+static int vsop87_truncated_level[8] = {-1,-1,-1,-1,-1,-1,-1,-1};
+static int vsop87_truncated = 0;
+static unsigned char vsop87_truncated_instructions[sizeof(vsop87_instructions)];
+static double vsop87_truncated_coefficients[VSOP87_NR_OF_TERMS*2];
+static double *vsop87_term_weight = 0;
+static struct Vsop87Weight *vsop87_sorted_weight = 0;
+static int vsop87_body_first[8+1];
+static int vsop87_accu_body[sizeof(vsop87_constants)/sizeof(vsop87_constants[0])];
+
+static
+int CompareVsop87Weight(const void *a,const void *b) {
+  const struct Vsop87Weight *wa = (const struct Vsop87Weight*)a;
+  const struct Vsop87Weight *wb = (const struct Vsop87Weight*)b;
+  if (wa->body != wb->body) return wa->body - wb->body;
+  return (wa->weight > wb->weight) - (wa->weight < wb->weight);
+}
+
+static
+void InitVsop87Weights(void) {
+  const unsigned char *instructions = vsop87_instructions;
+  const double *coefficients = vsop87_coefficients;
+  double accu_scale[sizeof(vsop87_constants)/sizeof(vsop87_constants[0])];
+  int i,alpha,term = 0;
+  for (i=0;i<8*6;i++) {
+    const int body = i / 6;
+    const int element = i % 6;
+      /* a in AU, lambda in radian, k,h,q,p move the planet by about 2*a */
+    const double scale = (element == 0) ? 1.0 : ((element == 1) ? vsop87_a[body] : 2.0*vsop87_a[body]);
+    double t_alpha = 1.0;
+    for (alpha=0;alpha<6;alpha++) {
+      const int j = vsop87_index_translation_table[i*6+alpha];
+      if (j >= 0) {
+        vsop87_accu_body[j] = body;
+        accu_scale[j] = scale * t_alpha;
+      }
+      t_alpha *= VSOP87_TRUNCATION_T;
+    }
+  }
+  vsop87_term_weight = (double*)malloc(VSOP87_NR_OF_TERMS*sizeof(double));
+  vsop87_sorted_weight = (struct Vsop87Weight*)malloc(VSOP87_NR_OF_TERMS*sizeof(struct Vsop87Weight));
+  for (;;) {
+    int lambda_index = *instructions++;
+    if (lambda_index < 0xFE) {
+      int term_count;
+      instructions++;
+      term_count = *instructions++;
+      while (--term_count >= 0) {
+        const int j = *instructions++;
+        vsop87_term_weight[term] = sqrt(coefficients[0]*coefficients[0]
+                                      + coefficients[1]*coefficients[1])
+                                 * accu_scale[j];
+        vsop87_sorted_weight[term].weight = vsop87_term_weight[term];
+        vsop87_sorted_weight[term].body = vsop87_accu_body[j];
+        coefficients += 2;
+        term++;
+      }
+    } else if (lambda_index == 0xFF) break;
+  }
+  qsort(vsop87_sorted_weight,VSOP87_NR_OF_TERMS,sizeof(struct Vsop87Weight),
+        &CompareVsop87Weight);
+  for (i=0,term=0;i<=8;i++) {
+    while (term < VSOP87_NR_OF_TERMS && vsop87_sorted_weight[term].body < i) term++;
+    vsop87_body_first[i] = term;
+  }
+}
+
+static
+void TruncateVsop87Terms(const double cutoff[8]) {
+    /* copy the terms heavier than the cutoff of their planet,
+       the arguments left without terms are removed */
+  const unsigned char *instructions = vsop87_instructions;
+  const double *coefficients = vsop87_coefficients;
+  unsigned char *out = vsop87_truncated_instructions;
+  double *out_coefficients = vsop87_truncated_coefficients;
+  unsigned char *node_out[VSOP87_MAX_DEPTH];
+  double *node_coefficients[VSOP87_MAX_DEPTH];
+  int node_used[VSOP87_MAX_DEPTH];
+  int depth = 0;
+  int term = 0;
+  for (;;) {
+    int lambda_index = *instructions++;
+    if (lambda_index < 0xFE) {
+      int term_count,kept = 0;
+      unsigned char *count;
+      node_out[depth] = out;
+      node_coefficients[depth] = out_coefficients;
+      *out++ = lambda_index;
+      *out++ = *instructions++;
+      count = out++;
+      term_count = *instructions++;
+      while (--term_count >= 0) {
+        const int j = *instructions++;
+        if (vsop87_term_weight[term] > cutoff[vsop87_accu_body[j]]) {
+          *out++ = j;
+          out_coefficients[0] = coefficients[0];
+          out_coefficients[1] = coefficients[1];
+          out_coefficients += 2;
+          kept++;
+        }
+        coefficients += 2;
+        term++;
+      }
+      *count = kept;
+      node_used[depth++] = (kept > 0);
+    } else {
+        /* pop the argument, or close all the arguments at the end */
+      do {
+        depth--;
+        if (node_used[depth]) {
+          if (lambda_index == 0xFE) *out++ = 0xFE;
+          if (depth > 0) node_used[depth-1] = 1;
+        } else {
+          out = node_out[depth];
+          out_coefficients = node_coefficients[depth];
+        }
+      } while (lambda_index == 0xFF && depth > 0);
+      if (lambda_index == 0xFF) {
+        *out++ = 0xFF;
+        break;
+      }
+    }
+  }
+}
+
+static
+void BuildVsop87Truncation(void) {
+  double cutoff[8];
+  int body;
+  vsop87_truncated = 0;
+  for (body=0;body<8;body++) {
+    if (vsop87_requested_level[body] >= 0 && !vsop87_term_weight)
+      InitVsop87Weights();
+    vsop87_truncated_level[body] = vsop87_requested_level[body];
+    cutoff[body] = -1.0;
+    if (vsop87_requested_level[body] >= 0) {
+        /* drop the lightest terms as long as their sum stays below the tolerance */
+      const double tolerance = ldexp(VSOP87_MIN_TOLERANCE,vsop87_requested_level[body]);
+      double sum = 0.0;
+      int i;
+      for (i=vsop87_body_first[body];i<vsop87_body_first[body+1];i++) {
+        sum += vsop87_sorted_weight[i].weight;
+        if (sum > tolerance) break;
+        cutoff[body] = vsop87_sorted_weight[i].weight;
+      }
+      vsop87_truncated = 1;
+    }
+  }
+  if (vsop87_truncated) TruncateVsop87Terms(cutoff);
+}
+
 static
 void CalcVsop87Elem(const double t,double elem[8*6]) {
   unsigned int i;
@@ -137275,8 +137451,13 @@ void CalcVsop87Elem(const double t,double elem[8*6]) {
   for (i=0;i<(sizeof(vsop87_constants)/sizeof(vsop87_constants[0]));++i) {
     accu[i] = 0.0;
   }
-  AccumulateVsop87Terms(vsop87_instructions,vsop87_coefficients,cos_sin_lambda,
-                        accu,stack);
+  if (vsop87_truncated && fabs(t) <= VSOP87_TRUNCATION_T)
+    AccumulateVsop87Terms(vsop87_truncated_instructions,
+                          vsop87_truncated_coefficients,cos_sin_lambda,
+                          accu,stack);
+  else
+    AccumulateVsop87Terms(vsop87_instructions,vsop87_coefficients,
+                          cos_sin_lambda,accu,stack);
 
   for (i=0;i<8*6;i++) {
     elem[i] = 0.0;
@@ -137331,12 +137512,31 @@ static double vsop87_elem_2[VSOP87_DIM];
 static double vsop87_jd0 = -1e100;
 static double vsop87_elem[VSOP87_DIM];
 
+void SetVsop87Tolerance(int body,double tolerance) {
+  int level = -1;
+  if (tolerance >= VSOP87_MIN_TOLERANCE) {
+    level = (int)floor(log2(tolerance/VSOP87_MIN_TOLERANCE));
+  }
+  vsop87_requested_level[body] = level;
+}
+
+static
+void UpdateVsop87Truncation(void) {
+  if (memcmp(vsop87_requested_level,vsop87_truncated_level,
+             sizeof(vsop87_truncated_level)) == 0) return;
+  BuildVsop87Truncation();
+    /* the cached elements were computed with the previous terms */
+  t_0 = t_1 = t_2 = -1e100;
+  vsop87_jd0 = -1e100;
+}
+
 void GetVsop87Coor(double jd,int body,double *xyz) {
   GetVsop87OsculatingCoor(jd,jd,body,xyz);
 }
 
 void GetVsop87OsculatingCoor(const double jd0,const double jd,
                              const int body,double *xyz) {
+  UpdateVsop87Truncation();
   if (jd0 != vsop87_jd0) {
     const double t0 = (jd0 - 2451545.0) / 365250.0;
     vsop87_jd0 = jd0;
@@ -66,6 +66,14 @@ void GetVsop87OsculatingCoor(const double jd0,const double jd, const int body,do
   /* The oculating orbit of epoch jd0, evaluated at jd, is returned.
   */
 
+void SetVsop87Tolerance(int body,double tolerance);
+  /* Accept a position error of tolerance AU for the given planet:
+     between the years 1000 and 3000 the terms whose amplitudes sum up
+     to less than the tolerance are skipped. A tolerance of 0 (the default)
+     computes the full series. The series is rebuilt by the next
+     GetVsop87Coor when the tolerance changed by more than a factor 2.
+  */
+
 #ifdef __cplusplus
 }
 #endif
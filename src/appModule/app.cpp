@@ -25,6 +25,7 @@
  *
  */
 
+#include <chrono>
 #include <exception>
 #include <iomanip>
 #include <fstream>
@@ -634,6 +635,7 @@ void App::firstInit()
 	enable_mkfifo=conf.getBoolean(SCS_IO, SCK_ENABLE_MKFIFO);
 	flagAlwaysVisible = conf.getBoolean(SCS_MAIN,SCK_FLAG_ALWAYS_VISIBLE);
 	flagMasterput=conf.getBoolean(SCS_IO, SCK_FLAG_MASTERPUT);
+	sharedDataBudget = std::chrono::milliseconds(conf.getInt(SCS_IO, SCK_SHARED_DATA_BUDGET, 4));
 
 	if (enable_tcp) {
 		int port = conf.getInt(SCS_IO, SCK_TCP_PORT_IN);
@@ -665,22 +667,24 @@ void App::firstInit()
 
 void App::updateFromSharedData()
 {
+	// the commands which don't fit in the budget wait for the next frame, each source runs at least one
+	const auto deadline = std::chrono::steady_clock::now() + sharedDataBudget;
+	std::string out;
 	if (enable_mkfifo) {
-		std::string out;
-		if (mkfifo->update(out)) {
+		while (mkfifo->update(out)) {
 			cLog::get()->write("get mkfifo: " + out);
 			commander->executeCommand(out);
+			if (std::chrono::steady_clock::now() >= deadline)
+				break;
 		}
 	}
 	if (enable_tcp) {
-		std::string out;
-		do {
-			out = tcp->getInput();
-			if (!out.empty()) {
-				cLog::get()->write("get tcp : " + out);
-				commander->executeCommand(out);
-			}
-		} while (!out.empty());
+		while (!(out = tcp->getInput()).empty()) {
+			cLog::get()->write("get tcp : " + out);
+			commander->executeCommand(out);
+			if (std::chrono::steady_clock::now() >= deadline)
+				break;
+		}
 	}
 	if (flagMasterput==true)
 		masterput();
@@ -31,6 +31,7 @@
 #include <SDL2/SDL_thread.h>
 #include <queue>
 #include <memory>
+#include <chrono>
 #include <string>
 
 #include "tools/no_copy.hpp"
@@ -169,6 +170,7 @@ private:
 	bool enable_tcp;
 	bool enable_mkfifo;
 	bool flagMasterput;
+	std::chrono::milliseconds sharedDataBudget{4}; //! time given each frame to the commands received from outside
 
 
 	// External class
@@ -26,6 +26,9 @@
 #include <iostream> //ServerSocket
 #include <sstream>
 #include <string> //ServerSocket
+#include <vector>
+#include <chrono>
+#include <algorithm>
 
 //#include "spacecrafter.hpp"
 #include "appModule/mkfifo.hpp" //ServerSocket
@@ -39,6 +42,8 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #endif
 
 //mkfifo -----------------------
@@ -48,6 +53,19 @@ Mkfifo::Mkfifo()
 
 Mkfifo::~Mkfifo()
 {
+	if (threadMkfifoRead.joinable()) {
+		is_active = false;
+		#ifdef __linux__
+		const uint64_t one = 1;
+		if (write(wakeFd, &one, sizeof(one)) < 0)
+			cLog::get()->write("Mkfifo can't wake its thread up "+std::to_string(errno), LOG_TYPE::L_ERROR, LOG_FILE::TCP);
+		#endif
+		threadMkfifoRead.join();
+	}
+	#ifdef __linux__
+	if (wakeFd >= 0)
+		close(wakeFd);
+	#endif
 }
 
 void Mkfifo::init(const std::string& _filename, int _buffer_size)
@@ -55,80 +73,111 @@ void Mkfifo::init(const std::string& _filename, int _buffer_size)
 	filename=_filename;
 	buffer_size= _buffer_size;
 	is_active= true;
-	lock=SDL_CreateMutex();
-	threadMkfifoRead = SDL_CreateThread(thread_wrapper,"ThreadRead", this);
-}
-
-int Mkfifo::thread_wrapper(void *Data)
-{
-	return ((Mkfifo *)Data)->thread();
+	#ifdef __linux__
+	wakeFd = eventfd(0, EFD_CLOEXEC);
+	#endif
+	threadMkfifoRead = std::thread(&Mkfifo::thread, this);
 }
 
-int Mkfifo::thread()
+void Mkfifo::thread()
 {
 	#ifdef __linux__
 	cLog::get()->write("Thread MKFIFO, buffer_in_size is "+std::to_string(buffer_size), LOG_TYPE::L_INFO, LOG_FILE::TCP);
-	int fdtr;
-	char *in;
-	in = (char*) calloc (buffer_size,sizeof(char));
-	if (in ==NULL) return 1;
+	if (wakeFd < 0) {
+		cLog::get()->write("Error creating Mkfifo eventfd "+std::to_string(errno), LOG_TYPE::L_ERROR, LOG_FILE::TCP);
+		return;
+	}
+	std::vector<char> in(buffer_size);
 
 	cLog::get()->write("Pipe named  " + filename, LOG_TYPE::L_INFO);
 	// doesn't xexist
 	unlink(filename.c_str());
 	if (mkfifo((filename.c_str()), S_IRWXU| S_IWGRP | S_IWOTH ) == -1) { //TODO why result has no g+o=w mode ?
 		cLog::get()->write("Error creating MkFifo pipe thread in_thread "+std::to_string(errno), LOG_TYPE::L_ERROR, LOG_FILE::TCP);
-		return 2;
+		return;
 	} else {
 		cLog::get()->write("Creating Mkfifo pipe successfull", LOG_TYPE::L_INFO);
 		chmod(filename.c_str(), 0777);
 	}
-	if((fdtr = open (filename.c_str(), O_RDONLY )) == -1) {
-		cLog::get()->write("Unable to open named mkfifo pipe, error code is "+std::to_string(errno), LOG_TYPE::L_ERROR, LOG_FILE::TCP);
-		return 2;
-	}
 
+	int fdtr = -1;
+	std::string pending; // received after the last line break
 	while (is_active) {
-		memset(in,'\0',buffer_size);
+		if (fdtr == -1) {
+			// O_NONBLOCK: don't wait for a writer in open(), poll() does it
+			if ((fdtr = open(filename.c_str(), O_RDONLY | O_NONBLOCK)) == -1) {
+				cLog::get()->write("Unable to open named mkfifo pipe, error code is "+std::to_string(errno), LOG_TYPE::L_ERROR, LOG_FILE::TCP);
+				break;
+			}
+		}
 
-		if (read(fdtr, in, buffer_size) == -1) {
-			cLog::get()->write("Mkfifo read() error "+std::to_string(errno), LOG_TYPE::L_ERROR, LOG_FILE::TCP);
+		pollfd fds[2] = {{fdtr, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+		if (poll(fds, 2, -1) == -1) {
+			if (errno == EINTR)
+				continue;
+			cLog::get()->write("Mkfifo poll() error "+std::to_string(errno), LOG_TYPE::L_ERROR, LOG_FILE::TCP);
+			break;
 		}
+		if (fds[1].revents)
+			break; // destructor
+		if (!fds[0].revents)
+			continue;
 
-		if (in[0] !='\0') {
-			in[buffer_size-1]='\0';
-			SDL_LockMutex( lock );
-			from_outside.push(in);
-			SDL_UnlockMutex( lock );
-		} else
-			sleep(1);
+		const ssize_t count = read(fdtr, in.data(), in.size());
+		if (count > 0) {
+			pending.append(in.data(), count);
+			pushLines(pending, false);
+		} else if (count == 0 || (errno != EAGAIN && errno != EINTR)) {
+			if (count == -1)
+				cLog::get()->write("Mkfifo read() error "+std::to_string(errno), LOG_TYPE::L_ERROR, LOG_FILE::TCP);
+			// every writer has left, reopening the pipe clears POLLHUP so that poll() sleeps until the next one
+			pushLines(pending, true);
+			close(fdtr);
+			fdtr = -1;
+		}
 	}
 	cLog::get()->write("Closing Mkfifo pipe thread", LOG_TYPE::L_INFO, LOG_FILE::TCP);
-	close(fdtr);
-	free(in);
+	if (fdtr != -1)
+		close(fdtr);
 	unlink(filename.c_str());
-	return 0;
 
 	#else
 	cLog::get()->write("Mkfifo is not implemented on windows", LOG_TYPE::L_ERROR, LOG_FILE::TCP);
 	is_active = false;
-	return 2;
 
 	#endif
 }
 
+void Mkfifo::pushLines(std::string &pending, bool lastData)
+{
+	size_t begin = 0;
+	while (begin < pending.size()) {
+		size_t end = pending.find_first_of(std::string("\n\r\0", 3), begin);
+		if (end == std::string::npos) {
+			if (!lastData)
+				break;
+			end = pending.size(); // writers as util/server_standalone/writer_fifo.c send no line break
+		}
+		if (end > begin) {
+			std::string line = pending.substr(begin, end - begin);
+			// if the main loop is late, wait for it rather than lose or reorder commands
+			while (!from_outside.push(std::move(line)) && is_active)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		begin = end + 1;
+	}
+	pending.erase(0, std::min(begin, pending.size()));
+
+	if (pending.size() >= (size_t) buffer_size) {
+		cLog::get()->write("Mkfifo command longer than the buffer, dropped", LOG_TYPE::L_WARNING, LOG_FILE::TCP);
+		pending.clear();
+	}
+}
+
 bool Mkfifo::update(std::string &output)
 {
-	if ( (is_active ==true)) {
-		if (! from_outside.empty() ) {
-			SDL_LockMutex(lock);
-			output= from_outside.front();
-			from_outside.pop();
-			SDL_UnlockMutex(lock);
-			cLog::get()->write("Mkfifo : I get " + output, LOG_TYPE::L_INFO, LOG_FILE::TCP);
-			return true;
-		} else
-			return false;
-	} else
+	if (!from_outside.pop(output))
 		return false;
+	cLog::get()->write("Mkfifo : I get " + output, LOG_TYPE::L_INFO, LOG_FILE::TCP);
+	return true;
 }
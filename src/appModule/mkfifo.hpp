@@ -25,13 +25,12 @@
 #ifndef MKFIFO_HPP
 #define MKFIFO_HPP
 
-#include <SDL2/SDL_thread.h>
-#include <queue> //ServerSocket
+#include <string>
+#include <thread>
+#include <atomic>
 #include "tools/no_copy.hpp"
+#include "tools/SpscQueue.hpp"
 //#include "tools/app_settings.hpp"
-#include <string>
-#include <SDL2/SDL_net.h> //ServerSocket
-#include <iostream> //ServerSocket
 
 #ifdef __linux__
 //for pipe
@@ -41,6 +40,9 @@
 #include <errno.h>
 #endif
 
+//! commands read from the pipe and not yet taken by the main loop
+#define MKFIFO_QUEUE_SIZE 1024
+
 class Mkfifo : public NoCopy {
 public:
 	/*!
@@ -61,21 +63,21 @@ public:
 	bool update(std::string &output);
 private:
 	// indicates the state of the Mkfifo
-	bool is_active = false;
-	// size of the buffer
+	std::atomic<bool> is_active{false};
+	// size of the buffer, a command can't be longer
 	int buffer_size;
-	// queue containing all messages obtained from the outside
-	std::queue<std::string> from_outside;
+	// messages obtained from the outside, one command each, from the reading thread to the main loop
+	SpscQueue<std::string> from_outside{MKFIFO_QUEUE_SIZE};
 	//full name of the pipe file
 	std::string filename;
-	//mutex on the pipe IO readings
-	SDL_mutex* lock = nullptr;
-	// create thread for mkfifo
-	SDL_Thread* threadMkfifoRead;
+	// thread for mkfifo
+	std::thread threadMkfifoRead;
+	// eventfd which wakes the thread up from poll() when the Mkfifo is destroyed
+	int wakeFd = -1;
 	// function thread qui gere la lecture des données de l'extérieur
-	int thread();
-	// function what call threadMkfifoRead
-	static int thread_wrapper(void *Data);
+	void thread();
+	// hand the complete lines of pending over to the main loop, and the rest if the writer has left
+	void pushLines(std::string &pending, bool lastData);
 };
 
 #endif // IO_H
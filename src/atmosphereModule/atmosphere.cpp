@@ -28,6 +28,7 @@
 
 
 #include <string>
+#include <algorithm>
 #include "appModule/space_date.hpp"
 #include "atmosphereModule/atmosphere.hpp"
 #include "atmosphereModule/skybright.hpp"
@@ -39,6 +40,7 @@
 #include "atmosphereModule/tone_reproductor.hpp"
 #include "tools/utility.hpp"
 #include "tools/context.hpp"
+#include "tools/ThreadPool.hpp"
 #include "EntityCore/EntityCore.hpp"
 
 Atmosphere::Atmosphere()
@@ -46,30 +48,41 @@ Atmosphere::Atmosphere()
 	sky = std::make_unique<Skylight>();
 	skyb = std::make_unique<Skybright>();
 	setFaderDuration(0.f);
-	createSC_context();
 }
 
 Atmosphere::~Atmosphere()
 {
+	if (!m_atmGL)
+		return;
 	Context::instance->stagingMgr->releaseBuffer(stagingSkyColor);
 	Context::instance->indexBufferMgr->releaseBuffer(indexBuffer);
 }
 
+void Atmosphere::setResolution(unsigned int _resolution)
+{
+	assert(!m_atmGL);
+	resolution = std::clamp(_resolution, 1u, (unsigned int) SKY_MAX_RESOLUTION);
+}
+
 void Atmosphere::initGridViewport(const Projector *prj)
 {
-	stepX = (float)prj->getViewportWidth() / SKY_RESOLUTION;
-	stepY = (float)prj->getViewportHeight() / SKY_RESOLUTION;
+	stepX = (float)prj->getViewportWidth() / resolution;
+	stepY = (float)prj->getViewportHeight() / resolution;
 	viewport_left = (float)prj->getViewportPosX();
 	viewport_bottom = (float)prj->getViewportPosY();
+	gridDirty = true;
 }
 
 //initializes the point grid for the atmosphere calculation
 void Atmosphere::initGridPos()
 {
+	// the size of the buffers depends on the resolution
+	if (!m_atmGL)
+		createSC_context();
 	{
 		float *data = (float *) Context::instance->transfer->planCopy(skyPos->get());
-		for (int y=0; y<SKY_RESOLUTION+1; y++) {
-			for (int x=0; x<SKY_RESOLUTION+1; x++) {
+		for (unsigned int y=0; y<resolution+1; y++) {
+			for (unsigned int x=0; x<resolution+1; x++) {
 				*(data++) = viewport_left+x*stepX;
 				*(data++) = viewport_bottom+y*stepY;
 			}
@@ -77,10 +90,10 @@ void Atmosphere::initGridPos()
 	}
 	{
 		uint16_t *data = (uint16_t *) Context::instance->transfer->planCopy(indexBuffer);
-		for (int y=0; y<SKY_RESOLUTION; ++y) {
-			const int offset1 = y * (SKY_RESOLUTION + 1);
-			const int offset2 = offset1 + SKY_RESOLUTION+1;
-			for (int x=0; x<SKY_RESOLUTION+1; ++x) {
+		for (unsigned int y=0; y<resolution; ++y) {
+			const unsigned int offset1 = y * (resolution + 1);
+			const unsigned int offset2 = offset1 + resolution+1;
+			for (unsigned int x=0; x<resolution+1; ++x) {
 				*(data++) = x + offset1;
 				*(data++) = x + offset2;
 			}
@@ -100,8 +113,8 @@ void Atmosphere::createSC_context()
 	m_atmGL->addInput(VK_FORMAT_R32G32_SFLOAT);
 	m_atmGL->createBindingEntry(3 * sizeof(float));
 	m_atmGL->addInput(VK_FORMAT_R32G32B32_SFLOAT);
-	skyPos = m_atmGL->createBuffer(0, NB_LUM, context.globalBuffer.get());
-	skyColor = m_atmGL->createBuffer(1, NB_LUM, context.globalBuffer.get());
+	skyPos = m_atmGL->createBuffer(0, getNbLum(), context.globalBuffer.get());
+	skyColor = m_atmGL->createBuffer(1, getNbLum(), context.globalBuffer.get());
 
 	auto blendMode = BLEND_ADD;
 	blendMode.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
@@ -115,8 +128,8 @@ void Atmosphere::createSC_context()
 	pipeline->bindShader("atmosphere.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
 	pipeline->build();
 
-	indexBuffer = context.indexBufferMgr->acquireBuffer(NB_INDEX * sizeof(uint16_t));
-	stagingSkyColor = context.stagingMgr->acquireBuffer(NB_LUM * sizeof(Vec3f));
+	indexBuffer = context.indexBufferMgr->acquireBuffer(getNbIndex() * sizeof(uint16_t));
+	stagingSkyColor = context.stagingMgr->acquireBuffer(getNbLum() * sizeof(Vec3f));
 	pSkyColor = (Vec3f *) context.stagingMgr->getPtr(stagingSkyColor);
 
 	context.cmdInfo.commandBufferCount = 3;
@@ -128,7 +141,7 @@ void Atmosphere::createSC_context()
 		context.layouts.front()->bindSet(cmd, *context.uboSet);
 		VertexArray::bind(cmd, {skyPos.get(), skyColor.get()});
 		vkCmdBindIndexBuffer(cmd, indexBuffer.buffer, indexBuffer.offset, VK_INDEX_TYPE_UINT16);
-		vkCmdDrawIndexed(cmd, NB_INDEX, 1, 0, 0, 0);
+		vkCmdDrawIndexed(cmd, getNbIndex(), 1, 0, 0, 0);
 		context.frame[i]->compile(cmd);
 	}
 }
@@ -144,13 +157,12 @@ void Atmosphere::computeColor(double JD, Vec3d sunPos, Vec3d moonPos, float moon
 		atm_intensity = 0;
 		world_adaptation_luminance = 3.75f + lightPollutionLuminance;
 		milkyway_adaptation_luminance = min_mw_lum;  // brighter than without atm, since no drawing addition of atm brightness
+		gridDirty = true;
 		return;
 	} else {
 		atm_intensity = fader;
 	}
 
-	skylight_struct2 b2;
-
 	// these are for radii
 	double sun_angular_size = atan(696000./AU/sunPos.length());
 	double moon_angular_size = atan(1738./AU/moonPos.length());
@@ -202,44 +214,126 @@ void Atmosphere::computeColor(double JD, Vec3d sunPos, Vec3d moonPos, float moon
 
 	skyb->setDate(date.years, date.months, moon_phase);
 
-	Vec3d point(1., 0., 0.);
+	const SkyState state {sunPos, moonPos, moon_phase, atm_intensity,
+	                      eye->getWorldAdaptationLuminance(), eye->getDisplayAdaptationLuminance(),
+	                      prj->getMatFrameToEye(PF_LOCAL), prj->getFov(), skyb->getMoonBrightness(),
+	                      latitude, altitude, temperature, relative_humidity, date.years, date.months};
+	const unsigned int nbRows = getNbRowsToUpdate(state);
+
+	// Compute the sky color for the points of the rows to update, the rows are split between the threads
+	if (nbRows > 0) {
+		const unsigned int first = nextRow;
+		const unsigned int last = std::min(first + nbRows, resolution+1);
+		ThreadPool::shared().parallelFor(first, last, SKY_ROW_GRAIN, [&](size_t begin, size_t end) {
+			computeRows(begin, end, prj, eye, sun_pos, moon_pos);
+		});
+		nextRow = (last == resolution+1) ? 0 : last;
+		colorUpdated = true;
+	}
 
-	// Variables used to compute the average sky luminance
+	// Variables used to compute the average sky luminance, summed in the row order to stay deterministic
 	double sum_lum = 0.;
+	for (double lum : rowLum)
+		sum_lum += lum;
+
+	world_adaptation_luminance = 3.75f + lightPollutionLuminance + 3.5*sum_lum/getNbLum()*atm_intensity;
+	milkyway_adaptation_luminance = min_mw_lum*(1-atm_intensity) + 30*sum_lum/getNbLum()*atm_intensity;
+}
 
-	// Compute the sky color for every point above the ground
-	for (int x=0; x<SKY_RESOLUTION+1; x++) {
-		for (int y=0; y<SKY_RESOLUTION+1; y++) {
+bool Atmosphere::isClose(const SkyState &state, const SkyTolerance &tolerance) const
+{
+	auto closeLuminance = [&tolerance](float a, float b) {
+		return std::abs(a - b) <= tolerance.luminance * std::max(std::abs(a), std::abs(b));
+	};
+	// the positions are normalized, the length of the difference is the angle
+	return (state.sunPos - lastState.sunPos).length() <= tolerance.angle
+	       && (state.moonPos - lastState.moonPos).length() <= tolerance.angle
+	       && std::abs(state.moonPhase - lastState.moonPhase) <= tolerance.angle
+	       && std::abs(state.intensity - lastState.intensity) <= tolerance.intensity
+	       && closeLuminance(state.worldAdaptation, lastState.worldAdaptation)
+	       && closeLuminance(state.displayAdaptation, lastState.displayAdaptation);
+}
+
+// The grid is reused while the sky doesn't change more than STILL since the last computation.
+// Between STILL and SLOW, the progressive mode only computes 1/SKY_PROGRESSIVE_FRAMES of the
+// rows, the other rows are at most SKY_PROGRESSIVE_FRAMES frames late.
+unsigned int Atmosphere::getNbRowsToUpdate(const SkyState &state)
+{
+	static const SkyTolerance STILL = {1e-5, 1e-4f, 1e-4f};
+	static const SkyTolerance SLOW = {2e-4, 2e-3f, 1e-2f};
+	const unsigned int nbRows = resolution+1;
+	const unsigned int chunk = std::min((nbRows + SKY_PROGRESSIVE_FRAMES - 1) / SKY_PROGRESSIVE_FRAMES, nbRows - nextRow);
+
+	const bool sameView = !gridDirty
+	                      && std::equal(state.localToEye.r, state.localToEye.r + 16, lastState.localToEye.r)
+	                      && state.fov == lastState.fov
+	                      && state.moonBrightness == lastState.moonBrightness
+	                      && state.latitude == lastState.latitude && state.altitude == lastState.altitude
+	                      && state.temperature == lastState.temperature && state.relativeHumidity == lastState.relativeHumidity
+	                      && state.year == lastState.year && state.month == lastState.month;
+
+	if (sameView && isClose(state, STILL)) {
+		// finish the progressive update in progress
+		const unsigned int rows = std::min(staleRows, chunk);
+		staleRows -= rows;
+		return rows;
+	}
+	if (sameView && flagProgressive && isClose(state, SLOW)) {
+		lastState = state;
+		staleRows = nbRows - chunk;
+		return chunk;
+	}
+	lastState = state;
+	gridDirty = false;
+	staleRows = 0;
+	nextRow = 0;
+	rowLum.resize(nbRows);
+	return nbRows;
+}
+
+void Atmosphere::computeRows(unsigned int first, unsigned int last, const Projector* prj, const ToneReproductor * eye,
+                             const float *sun_pos, const float *moon_pos)
+{
+	const unsigned int n = resolution+1;
+	// position then color of the points of one row, component by component
+	float pos[3][SKY_MAX_RESOLUTION+1];
+	float color[3][SKY_MAX_RESOLUTION+1];
+	float cos_dist_moon[SKY_MAX_RESOLUTION+1];
+	float cos_dist_sun[SKY_MAX_RESOLUTION+1];
+	Vec3d point(1., 0., 0.);
+
+	for (unsigned int y = first; y < last; ++y) {
+		for (unsigned int x=0; x<n; x++) {
 			prj->unprojectLocal((double)viewport_left+x*stepX, (double)viewport_bottom+y*stepY,point);
 			point.normalize();
 
-			if (point[2]<=0) {
-				point[2] = -point[2];
-				// The sky below the ground is the symetric of the one above :
-				// it looks nice and gives proper values for brightness estimation
-			}
+			// The sky below the ground is the symetric of the one above :
+			// it looks nice and gives proper values for brightness estimation
+			pos[0][x] = point[0];
+			pos[1][x] = point[1];
+			pos[2][x] = std::abs(point[2]);
+		}
 
-			b2.pos[0] = point[0];
-			b2.pos[1] = point[1];
-			b2.pos[2] = point[2];
+		// Use the Skylight model for the color
+		sky->get_xyY_Valuev(pos[0], pos[1], pos[2], color[0], color[1], color[2], n);
 
-			// Use the Skylight model for the color
-			sky->get_xyY_Valuev(b2);
+		// Use the Skybright.cpp 's models for brightness which gives better results.
+		for (unsigned int x=0; x<n; x++) {
+			cos_dist_moon[x] = moon_pos[0]*pos[0][x] + moon_pos[1]*pos[1][x] + moon_pos[2]*pos[2][x];
+			cos_dist_sun[x] = sun_pos[0]*pos[0][x] + sun_pos[1]*pos[1][x] + sun_pos[2]*pos[2][x];
+		}
+		skyb->getLuminance(cos_dist_moon, cos_dist_sun, pos[2], color[2], n);
 
-			// Use the Skybright.cpp 's models for brightness which gives better results.
-			b2.color[2] = skyb->getLuminance(moon_pos[0]*b2.pos[0]+moon_pos[1]*b2.pos[1]+
-			                                 moon_pos[2]*b2.pos[2], sun_pos[0]*b2.pos[0]+sun_pos[1]*b2.pos[1]+
-			                                 sun_pos[2]*b2.pos[2], b2.pos[2]); //,cor_optoma);
+		double sum_lum = 0.;
+		for (unsigned int x=0; x<n; x++)
+			sum_lum += color[2][x];
+		rowLum[y] = sum_lum;
 
-			sum_lum+=b2.color[2];
-			eye->xyY_to_RGB(b2.color);
-			pSkyColor[x + y * (SKY_RESOLUTION + 1)].set(atm_intensity*b2.color[0],atm_intensity*b2.color[1],atm_intensity*b2.color[2]);
-		}
+		eye->xyY_to_RGB(color[0], color[1], color[2], n);
+		Vec3f *row = pSkyColor + y * n;
+		for (unsigned int x=0; x<n; x++)
+			row[x].set(atm_intensity*color[0][x], atm_intensity*color[1][x], atm_intensity*color[2][x]);
 	}
-
-	world_adaptation_luminance = 3.75f + lightPollutionLuminance + 3.5*sum_lum/NB_LUM*atm_intensity;
-	milkyway_adaptation_luminance = min_mw_lum*(1-atm_intensity) + 30*sum_lum/NB_LUM*atm_intensity;
-	sum_lum = 0.f;
 }
 
 void Atmosphere::draw()
@@ -247,11 +341,16 @@ void Atmosphere::draw()
 	if (fader.isZero())
 		return;
 
-	Context::instance->transfer->planCopyBetween(stagingSkyColor, skyColor->get());
+	// the previous grid is still in the vertex buffer if it wasn't updated
+	if (colorUpdated) {
+		Context::instance->transfer->planCopyBetween(stagingSkyColor, skyColor->get());
+		colorUpdated = false;
+	}
 	Context::instance->frame[Context::instance->frameIdx]->toExecute(cmds[Context::instance->frameIdx], PASS_MULTISAMPLE_DEPTH);
 }
 
 void Atmosphere::setModel(ATMOSPHERE_MODEL atmModel)
 {
 	sky->setComputeTypeColor(atmModel);
+	gridDirty = true;
 }
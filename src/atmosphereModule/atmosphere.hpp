@@ -50,9 +50,14 @@ class VertexArray;
 class VertexBuffer;
 class Pipeline;
 
+// default number of cells of the grid on each axis
 #define SKY_RESOLUTION 48
-#define NB_LUM ((SKY_RESOLUTION+1) * (SKY_RESOLUTION+1))
-#define NB_INDEX (((SKY_RESOLUTION+1) * 2 + 1) * SKY_RESOLUTION)
+// the grid is indexed with uint16_t and UINT16_MAX restarts the strip
+#define SKY_MAX_RESOLUTION 254
+// rows of the grid computed by one task
+#define SKY_ROW_GRAIN 4
+// number of frames over which the progressive mode refreshes the whole grid
+#define SKY_PROGRESSIVE_FRAMES 8
 
 class Atmosphere: public NoCopy {
 public:
@@ -127,9 +132,21 @@ public:
 		return lightPollutionLuminance;
 	}
 
+	//! set the number of cells of the grid on each axis, must be called before initGridPos
+	void setResolution(unsigned int _resolution);
+
 	//! builds the point display grid for the shaders
 	void initGridPos();
 
+	//! refresh only part of the grid at each frame while the sky changes slowly
+	void setFlagProgressive(bool b) {
+		flagProgressive = b;
+	}
+
+	bool getFlagProgressive() const {
+		return flagProgressive;
+	}
+
 	//! determines the viewport for the construction of the grids
 	void initGridViewport(const Projector *prj);
 
@@ -153,9 +170,49 @@ public:
 		skyb->setDefaultMoonBrightness();
 	}
 private:
+	//! inputs of the grid computation, a frame with the same inputs reuses the grid
+	struct SkyState {
+		Vec3d sunPos;
+		Vec3d moonPos;
+		float moonPhase;
+		float intensity;
+		float worldAdaptation;	//!< world adaptation luminance of the ToneReproductor
+		float displayAdaptation;
+		// the grid is always recomputed when one of these changes
+		Mat4d localToEye;
+		double fov;
+		float moonBrightness;
+		float latitude, altitude, temperature, relativeHumidity;
+		int year, month;
+	};
+
+	//! maximal difference between two SkyState of the same category of change
+	struct SkyTolerance {
+		double angle;			//!< in radian, for the sun, the moon and the moon phase
+		float intensity;
+		float luminance;		//!< relative, for the adaptation luminances
+	};
+
+	//! \return true if state is within tolerance of lastState
+	bool isClose(const SkyState &state, const SkyTolerance &tolerance) const;
+
+	//! \return the number of rows to compute from nextRow, 0 if the previous grid is still valid
+	unsigned int getNbRowsToUpdate(const SkyState &state);
+
 	//! initialize the shader parameters
 	void createSC_context();
 
+	//! compute the color of the rows [first, last) of the grid and their sum of luminance
+	void computeRows(unsigned int first, unsigned int last, const Projector* prj, const ToneReproductor * eye,
+	                 const float *sun_pos, const float *moon_pos);
+
+	unsigned int getNbLum() const {
+		return (resolution+1) * (resolution+1);
+	}
+	unsigned int getNbIndex() const {
+		return ((resolution+1) * 2 + 1) * resolution;
+	}
+
 	std::unique_ptr<Skylight> sky;
 	std::unique_ptr<Skybright> skyb;
 
@@ -175,7 +232,18 @@ private:
 	Vec3f *pSkyColor = nullptr;
 	VkCommandBuffer cmds[3];
 
+	std::vector<double> rowLum; //!< sum of the luminance of each row of the grid
+
+	// temporal reuse of the grid
+	SkyState lastState;				//!< state of the last computed rows
+	bool gridDirty = true;			//!< the whole grid must be computed at the next frame
+	bool colorUpdated = false;		//!< pSkyColor changed since the last draw
+	bool flagProgressive = false;
+	unsigned int nextRow = 0;		//!< first row of the next progressive update
+	unsigned int staleRows = 0;		//!< rows not computed with lastState yet
+
 	//variables on the grid position
+	unsigned int resolution = SKY_RESOLUTION; //!< number of cells of the grid on each axis
 	float stepX; //!< step size on the x axis
 	float stepY; //!< step size on the y-axis
 	float viewport_left; //!<spacing on the left of the grid
@@ -23,6 +23,7 @@
 
 #include <cstdio>
 #include <cmath>
+#include <algorithm>
 #include "atmosphereModule/skybright.hpp"
 #include "tools/sc_const.hpp"
 
@@ -154,6 +155,49 @@ float Skybright::getLuminance(float cos_dist_moon, float cos_dist_sun, float cos
 	//// In cd/m^2 : the 32393895 is empirical term because the
 	// lambert -> cd/m^2 formula seems to be wrong...
 }
+// Same computation in single precision and without branch, pow10 is replaced by expf
+// because the vectorized math library has no pow10
+void Skybright::getLuminance(const float *cos_dist_moon, const float *cos_dist_sun, const float *cos_dist_zenith, float * __restrict luminance, unsigned int n) const
+{
+	const float ln10 = 2.302585093f;
+	const float moon_brightness = ml_brightness;
+
+	for (unsigned int i = 0; i < n; ++i) {
+		// catch rounding errors here or end up with white flashes in some cases
+		const float cm = std::min(std::max(cos_dist_moon[i], -1.f), 1.f);
+		const float cs = std::min(std::max(cos_dist_sun[i], -1.f), 1.f);
+		const float cz = std::min(std::max(cos_dist_zenith[i], -1.f), 1.f);
+
+		const float dist_moon = acosf(cm);
+		const float dist_sun = acosf(cs);
+
+		// Air mass
+		const float X = 1.f / (cz + 0.025f*expf(-11.f*cz));
+		const float bKX = expf(-0.4f*ln10 * K * X);
+
+		// Dark night sky brightness
+		const float b_night = (0.4f+0.6f/sqrtf(0.04f + 0.96f * cz*cz)) * b_night_term * bKX;
+
+		// Moonlight brightness
+		const float FM = 18886.28f / (dist_moon + 0.01f) + expf(ln10 * (6.15f - (dist_moon+0.001f) * 1.43239f))
+		                 + 229086.77f * (1.06f + cm*cm);
+		const float b_moon = b_moon_term1 * (1.f - bKX) * (FM * C3 + 440000.f * (1.f - C3));
+
+		// Twilight brightness, dist_sun is kept away from 0 where the daylight is used anyway
+		const float b_twilight = expf(ln10 * (b_twilight_term + 0.063661977f * acosf(cz)/K)) *
+		                         (1.7453293f / std::max(dist_sun, 1e-6f)) * (1.f-bKX);
+
+		// Daylight brightness
+		const float FS = 18886.28f / (dist_sun*dist_sun*10000.0f + 0.07f) + expf(ln10 * (6.15f - (dist_sun+0.001f) * 1.43239f))
+		                 + 229086.77f * (1.06f + cs*cs);
+		const float b_daylight = 9.289663e-12f * (1.f - bKX) * (FS * C4 + 440000.f * (1.f - C4));
+
+		// Total sky brightness
+		const float b_total = b_night + (b_daylight > b_twilight ? b_twilight : b_daylight) + b_moon * moon_brightness;
+		luminance[i] = (b_total < 0.f) ? 0.f : b_total * (float) (1E-5/1.11E-15/M_PI); // cd/m^2
+	}
+}
+
 /*
 250 REM  Visual limiting magnitude
 260 BL=B(3)/1.11E-15 : REM in nanolamberts*/
@@ -50,6 +50,9 @@ public:
 	//			cos_dist_zenith = cos(angular distance between zenith and the position)
 	float getLuminance(float cos_dist_moon, float cos_dist_sun, float cos_dist_zenith);//, int cor_optoma);
 
+	// Same function for n positions, written so that the compiler vectorizes it
+	void getLuminance(const float *cos_dist_moon, const float *cos_dist_sun, const float *cos_dist_zenith, float *luminance, unsigned int n) const;
+
 	float getMoonBrightness() {
 		return m_brightness;
 	}
@@ -29,6 +29,7 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <algorithm>
 
 #include "atmosphereModule/skylight.hpp"
 #include "tools/sc_const.hpp"
@@ -262,6 +263,40 @@ void Skylight::get_xyY_Valuev(skylight_struct2& p) const
 	}
 }
 
+// Same computation without branch, the positions and the colors are split in one array per component
+// The arrays must not overlap and the members are copied first so that the compiler doesn't reload them
+void Skylight::get_xyY_Valuev(const float *posX, const float *posY, const float *posZ, float * __restrict x, float * __restrict y, float * __restrict Y, unsigned int n) const
+{
+	const float sx = sun_pos[0], sy = sun_pos[1], sz = sun_pos[2];
+	const float ax = Ax, bx = Bx, cx = Cx, dx = Dx, ex = Ex, tx = term_x;
+	const float ay = Ay, by = By, cy = Cy, dy = Dy, ey = Ey, ty = term_y;
+	const float aY = AY, bY = BY, cY = CY, dY = DY, eY = EY, tY = term_Y;
+
+	for (unsigned int i = 0; i < n; ++i) {
+		const float cos_dist_sun = std::min(std::max(sx*posX[i] + sy*posY[i] + sz*posZ[i], -1.f), 1.f);
+		const float dist_sun = std::acos(cos_dist_sun);
+		const float cos_dist_sun_q = cos_dist_sun*cos_dist_sun;
+
+		const bool above = posZ[i] > 0.f;
+		const float one_over_cos_zenith_angle = 1.f / (above ? posZ[i] : 1.f);
+		const float Fx = std::exp(bx*one_over_cos_zenith_angle);
+		const float Fy = std::exp(by*one_over_cos_zenith_angle);
+		const float FY = std::exp(bY*one_over_cos_zenith_angle);
+
+		const float colorx = tx * (1.f + ax * (above ? Fx : 0.f))
+		                     * (1.f + cx * std::exp(dx*dist_sun) + ex * cos_dist_sun_q);
+		const float colory = ty * (1.f + ay * (above ? Fy : 0.f))
+		                     * (1.f + cy * std::exp(dy*dist_sun) + ey * cos_dist_sun_q);
+		const float colorY = tY * (1.f + aY * (above ? FY : 0.f))
+		                     * (1.f + cY * std::exp(dY*dist_sun) + eY * cos_dist_sun_q);
+
+		const bool valid = colorY >= 0 && colorx >= 0 && colory >= 0;
+		x[i] = valid ? colorx : 0.25f;
+		y[i] = valid ? colory : 0.25f;
+		Y[i] = valid ? colorY : 0.f;
+	}
+}
+
 // Return the current zenith color in xyY color system
 void Skylight::getZenithColor(float * v) const
 {
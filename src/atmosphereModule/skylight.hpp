@@ -59,6 +59,8 @@ public:
 	// The position vectors MUST be normalized, and the vertical z component is the third one
 	void setParamsv(const float * sun_pos, float turbidity);
 	void get_xyY_Valuev(skylight_struct2& position) const;
+	// Same function for n positions stored component by component, written so that the compiler vectorizes it
+	void get_xyY_Valuev(const float *posX, const float *posY, const float *posZ, float *x, float *y, float *Y, unsigned int n) const;
 
 	// Compute the sky color from varius planet localisation
 	void setComputeTypeColor(ATMOSPHERE_MODEL type);
@@ -23,6 +23,7 @@
 
 #include <cstdio>
 #include <cmath>
+#include <algorithm>
 
 #include "atmosphereModule/tone_reproductor.hpp"
 #include "tools/sc_const.hpp"
@@ -117,3 +118,37 @@ void ToneReproductor::xyY_to_RGB(float* color) const
 	color[2] = 0.0134455f*X - 0.118373f*Y + 1.01527f  *Z;
 }
 
+// Same conversion without branch so that the compiler vectorizes it
+// s is 1 in photopic vision which leaves the color unchanged
+void ToneReproductor::xyY_to_RGB(float * __restrict x, float * __restrict y, float * __restrict Y, unsigned int n) const
+{
+	const float world_to_display = M_PI*0.0001f;
+
+	for (unsigned int i = 0; i < n; ++i) {
+		float cx = x[i];
+		float cy = y[i];
+		float cY = Y[i];
+
+		// 1. Hue conversion
+		const float log10Y = log10f(std::max(cY, 1e-30f));
+		const float op = std::min(std::max((log10Y + 2.f)/2.6f, 0.f), 1.f);
+		const float s = 3.f * op * op - 2 * op * op * op;
+
+		cx = (1.f - s) * 0.25f + s * cx;
+		cy = (1.f - s) * 0.25f + s * cy;
+		const float V = cY * (1.33f * (1.f + cy / cx + cx * (1.f - cx - cy)) - 1.68f);
+		cY = 0.4468f * (1.f - s) * V + s * cY;
+
+		// 2. Adapt the luminance value and scale it to fit in the RGB range [2]
+		cY = powf(powf(cY*world_to_display, alpha_wa_over_alpha_da) * term2 * one_over_maxdL, one_over_gamma);
+
+		// Convert from xyY to XZY
+		const float X = cx * cY / cy;
+		const float Z = (1.f - cx - cy) * cY / cy;
+
+		// Use a XYZ to Adobe RGB (1998) matrix which uses a D65 reference white
+		x[i] = 2.04148f  *X - 0.564977f*cY - 0.344713f *Z;
+		y[i] =-0.969258f *X + 1.87599f *cY + 0.0415557f*Z;
+		Y[i] = 0.0134455f*X - 0.118373f*cY + 1.01527f  *Z;
+	}
+}
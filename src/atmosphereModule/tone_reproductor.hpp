@@ -58,6 +58,7 @@
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
+#include <cmath>
 //#include "tools/fmath.hpp"
 
 class ToneReproductor {
@@ -70,6 +71,10 @@ public:
 	//! default value = 50 cd/m^2
 	void setDisplayAdaptationLuminance(float display_adaptation_luminance);
 
+	float getDisplayAdaptationLuminance() const {
+		return Lda;
+	}
+
 	//! Set the eye adaptation luminance for the world (and precompute what can be)
 	//! default value = 40000 cd/m^2 for Skylight
 	//! Star Light      : 0.001  cd/m^2
@@ -78,6 +83,10 @@ public:
 	//! Sun Light       : 100000 cd/m^2
 	void setWorldAdaptationLuminance(float world_adaptation_luminance);
 
+	float getWorldAdaptationLuminance() const {
+		return Lwa;
+	}
+
 	//! Set the maximum display luminance : default value = 100 cd/m^2
 	//! This value is used to scale the RGB range
 	void setMaxDisplayLuminance(float maxdL) {   //unused
@@ -97,6 +106,9 @@ public:
 	//! Convert from xyY color system to RGB
 	void xyY_to_RGB(float*) const;
 
+	//! Convert n colors stored component by component, x, y and Y are replaced by R, G and B
+	void xyY_to_RGB(float *x, float *y, float *Y, unsigned int n) const;
+
 private:
 	float Lda = 50.f;					// Display luminance adaptation (in cd/m^2)
 	float Lwa = 40000.f;				// World   luminance adaptation (in cd/m^2)
@@ -501,8 +501,6 @@ Vec3d Body::getObsJ2000Pos(const Navigator *nav) const
 
 void Body::compute_position(const double date)
 {
-	OsculatingFunctionType *oscFunc = orbit->getOsculatingFunction();
-
 	if(orbitPlot != nullptr && orbitPlot->getOrbitFader().getInterstate()) {
 		orbitPlot->computeOrbit(date);
 	}
@@ -510,15 +508,21 @@ void Body::compute_position(const double date)
 	double delta = date-lastJD;
 	delta = fabs(delta);
 
-	if(delta >= deltaJD ) {
-		if(oscFunc)
-			(*oscFunc)(date,date,ecliptic_pos);
-		else
-			orbit->positionAtTimevInVSOP87Coordinates(date,date,ecliptic_pos);
+	// the series are truncated by powers of 2 of the tolerance, a position computed far
+	// from the body must be refined when approaching it with the time stopped
+	if(delta >= deltaJD || ephemerisTolerance < positionTolerance * 0.5) {
+		orbit->positionAtTimevInVSOP87Coordinates(date,date,ecliptic_pos);
 		lastJD = date;
+		positionTolerance = ephemerisTolerance;
 	}
 }
 
+void Body::setEphemerisTolerance(double tolerance)
+{
+	ephemerisTolerance = tolerance;
+	orbit->setTolerance(tolerance);
+}
+
 // Compute the transformation matrix from the local Body coordinate to the parent Body coordinate
 void Body::compute_trans_matrix(double jd)
 {
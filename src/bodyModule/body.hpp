@@ -180,6 +180,9 @@ public:
 	//void computePositionWithoutOrbits(double date);
 	void compute_position(double date);
 
+	// Accept a position error of tolerance AU in compute_position, 0 for full precision
+	void setEphemerisTolerance(double tolerance);
+
 	// Compute the transformation matrix from the local Body coordinate to the parent Body coordinate
 	void compute_trans_matrix(double date);
 
@@ -596,6 +599,8 @@ protected:
 
 	double lastJD;
 	double deltaJD;
+	double ephemerisTolerance = 0.0;	// position error accepted from the orbit, in AU
+	double positionTolerance = 0.0;		// tolerance of the last computed position
 
 	std::unique_ptr<Orbit> orbit=nullptr;            // orbit object for this body
 	Vec3f orbit_position;    // position of the planet
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2020 of the LSS Team & Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "bodyModule/body_descriptor.hpp"
+#include "tools/log.hpp"
+
+static std::string_view trim(std::string_view s)
+{
+	while (!s.empty() && isspace((unsigned char) s.front()))
+		s.remove_prefix(1);
+	while (!s.empty() && isspace((unsigned char) s.back()))
+		s.remove_suffix(1);
+	return s;
+}
+
+BodyDescriptor::BodyDescriptor(const stringHash_t &param)
+{
+	params.reserve(param.size());
+	for (const auto &p : param)
+		params.emplace_back(p.first, p.second);
+	finalize();
+}
+
+void BodyDescriptor::finalize()
+{
+	// stable, the last of the equal keys is the value given last
+	std::stable_sort(params.begin(), params.end(), [](const auto &a, const auto &b) {
+		return a.first < b.first;
+	});
+	auto last = std::unique(params.rbegin(), params.rend(), [](const auto &a, const auto &b) {
+		return a.first == b.first;
+	});
+	params.erase(params.begin(), last.base());
+	name = get("name");
+	parent = get("parent");
+	type = get("type");
+	coordFunc = get("coord_func");
+}
+
+std::string_view BodyDescriptor::get(std::string_view key) const
+{
+	auto it = std::lower_bound(params.begin(), params.end(), key, [](const auto &p, std::string_view k) {
+		return p.first < k;
+	});
+	return (it != params.end() && it->first == key) ? it->second : std::string_view();
+}
+
+double BodyDescriptor::getDouble(std::string_view key, double defaultValue) const
+{
+	// what std::stod accepts in the files: leading spaces, sign, and a number followed by anything
+	std::string_view s = get(key);
+	while (!s.empty() && isspace((unsigned char) s.front()))
+		s.remove_prefix(1);
+	if (!s.empty() && s.front() == '+')
+		s.remove_prefix(1);
+	double value;
+	auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+	return (result.ec == std::errc()) ? value : defaultValue;
+}
+
+bool BodyDescriptor::getBool(std::string_view key, bool defaultValue) const
+{
+	std::string_view s = get(key);
+	if (s.empty())
+		return defaultValue;
+	if (s == "1")
+		return true;
+	return s.size() == 4 && std::equal(s.begin(), s.end(), "true", [](char a, char b) {
+		return tolower((unsigned char) a) == b;
+	});
+}
+
+stringHash_t BodyDescriptor::toHash() const
+{
+	stringHash_t param;
+	for (const auto &p : params)
+		param.emplace_hint(param.end(), p.first, p.second);
+	return param;
+}
+
+BodyFile::~BodyFile()
+{
+	release();
+}
+
+void BodyFile::release()
+{
+	bodies.clear();
+#ifndef WIN32
+	if (mapStart)
+		munmap(mapStart, mapSize);
+#endif
+	mapStart = nullptr;
+	mapSize = 0;
+	fileData.reset();
+}
+
+bool BodyFile::load(const std::string &fileName)
+{
+	release();
+	const char *data = nullptr;
+	size_t size = 0;
+#ifndef WIN32
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) {
+		cLog::get()->write("BodyFile, error opening file " + fileName, LOG_TYPE::L_ERROR);
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		size = st.st_size;
+		void *ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (ptr != MAP_FAILED) {
+			mapStart = ptr;
+			mapSize = size;
+			data = (const char *) ptr;
+		}
+	}
+	close(fd);
+#endif
+	if (!data) {
+		std::ifstream fileIn(fileName, std::ios::binary | std::ios::ate);
+		if (!fileIn.is_open()) {
+			cLog::get()->write("BodyFile, error opening file " + fileName, LOG_TYPE::L_ERROR);
+			return false;
+		}
+		size = fileIn.tellg();
+		fileIn.seekg(0);
+		fileData = std::make_unique<char[]>(size);
+		fileIn.read(fileData.get(), size);
+		if (!fileIn) {
+			cLog::get()->write("BodyFile, error reading file " + fileName, LOG_TYPE::L_ERROR);
+			fileData.reset();
+			return false;
+		}
+		data = fileData.get();
+	}
+#ifndef WIN32
+	if (mapStart)
+		madvise(mapStart, mapSize, MADV_SEQUENTIAL);
+#endif
+	parse(std::string_view(data, size));
+	return true;
+}
+
+void BodyFile::parse(std::string_view text)
+{
+	bodies.clear();
+	BodyDescriptor body;
+	size_t pos = 0;
+	while (pos < text.size()) {
+		size_t end = text.find('\n', pos);
+		if (end == std::string_view::npos)
+			end = text.size();
+		std::string_view line = text.substr(pos, end - pos);
+		pos = end + 1;
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+		if (line.size() < 2 || line.front() == '#')
+			continue;
+		if (line.front() == '[') {
+			if (!body.empty()) {
+				body.finalize();
+				bodies.push_back(std::move(body));
+				body = BodyDescriptor();
+			}
+			continue;
+		}
+		const size_t equal = line.find('=');
+		if (equal != std::string_view::npos)
+			body.add(trim(line.substr(0, equal)), trim(line.substr(equal + 1)));
+	}
+	if (!body.empty()) {
+		body.finalize();
+		bodies.push_back(std::move(body));
+	}
+}
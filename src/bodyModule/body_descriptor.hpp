@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 of the LSS Team & Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// parameters of a body read from ssystem.ini without copy
+
+#ifndef _BODY_DESCRIPTOR_HPP_
+#define _BODY_DESCRIPTOR_HPP_
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "tools/utility.hpp"
+#include "tools/no_copy.hpp"
+
+/**
+ * \class BodyDescriptor
+ * \brief parameters of one body, as views on the text holding them
+ *
+ * The parameters are sorted by name once, a lookup is a binary search which neither
+ * allocates nor inserts the missing names, and the numbers are read without exception.
+ * The text must outlive the descriptor: the mapped file, or the hash it was built from.
+ */
+class BodyDescriptor {
+public:
+	BodyDescriptor() = default;
+	//! view on the parameters of a hash
+	explicit BodyDescriptor(const stringHash_t &param);
+
+	//! add a parameter, a parameter given twice keeps its last value
+	void add(std::string_view key, std::string_view value) {
+		params.emplace_back(key, value);
+	}
+	//! sort the parameters and read the common ones, to call once every parameter is added
+	void finalize();
+	bool empty() const {
+		return params.empty();
+	}
+
+	//! value of the parameter, empty if it isn't given
+	std::string_view get(std::string_view key) const;
+	std::string getStr(std::string_view key) const {
+		return std::string(get(key));
+	}
+	double getDouble(std::string_view key, double defaultValue = 0) const;
+	float getFloat(std::string_view key, float defaultValue = 0) const {
+		return getDouble(key, defaultValue);
+	}
+	//! true for "true" or "1" in any case
+	bool getBool(std::string_view key, bool defaultValue = false) const;
+	//! copy of the parameters
+	stringHash_t toHash() const;
+
+	std::string_view name;
+	std::string_view parent;
+	std::string_view type;
+	std::string_view coordFunc;
+
+private:
+	std::vector<std::pair<std::string_view, std::string_view>> params;
+};
+
+/**
+ * \class BodyFile
+ * \brief body file (ssystem.ini) mapped in memory and split in one descriptor per section
+ *
+ * Each section starts with a [title] line and holds "key = value" lines, # starts a comment.
+ */
+class BodyFile : public NoCopy {
+public:
+	BodyFile() = default;
+	~BodyFile();
+
+	//! map the file and split it, return false if it can't be read
+	bool load(const std::string &fileName);
+	//! split a text, which must outlive the descriptors
+	void parse(std::string_view text);
+
+	const std::vector<BodyDescriptor> &getBodies() const {
+		return bodies;
+	}
+
+private:
+	void release();
+	std::vector<BodyDescriptor> bodies;
+	void *mapStart = nullptr;
+	size_t mapSize = 0;
+	std::unique_ptr<char[]> fileData; // used when mmap isn't available
+};
+
+#endif // _BODY_DESCRIPTOR_HPP_
@@ -0,0 +1,435 @@
+/*
+* This source is the property of Immersive Adventure
+* http://immersiveadventure.net/
+*
+* It has been developped by part of the LSS Team.
+* For further informations, contact:
+*
+* albertpla@immersiveadventure.net
+*
+* This source code mustn't be copied or redistributed
+* without the authorization of Immersive Adventure
+* (c) 2017 - 2020 all rights reserved
+*
+*/
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "bodyModule/ephemeris_cache.hpp"
+#include "../planetsephems/stellplanet.h"
+#include "tools/log.hpp"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define EPHEMERIS_CACHE_NATIVE false
+#else
+#define EPHEMERIS_CACHE_NATIVE true
+#endif
+
+// The series interpolate their elements between close dates, calling them
+// this far from a node forces an exact evaluation of the node.
+#define EPHEMERIS_FIT_KICK 100.0
+
+namespace {
+
+struct EphemerisParameters {
+	const char *name;
+	PositionFunctionType *func;
+	double segmentDays;
+	unsigned int nbCoefficients;
+};
+
+// Segment lengths keep the approximation within 1 km of the series over the
+// covered range, the worst ones being dione, ariel and neptune (0.9 km).
+const EphemerisParameters cachedEphemeris[] = {
+	{"mercury_special", &get_mercury_helio_coordsv, 16, 16},
+	{"venus_special", &get_venus_helio_coordsv, 64, 16},
+	{"earth_special", &get_earth_helio_coordsv, 16, 16},
+	{"emb_special", &get_emb_helio_coordsv, 64, 16},
+	{"mars_special", &get_mars_helio_coordsv, 64, 16},
+	{"jupiter_special", &get_jupiter_helio_coordsv, 64, 16},
+	{"saturn_special", &get_saturn_helio_coordsv, 64, 16},
+	{"uranus_special", &get_uranus_helio_coordsv, 64, 16},
+	{"neptune_special", &get_neptune_helio_coordsv, 64, 16},
+	{"pluto_special", &get_pluto_helio_coordsv, 1024, 16},
+	{"lunar_special", &get_lunar_parent_coordsv, 16, 16},
+	{"phobos_special", &get_phobos_parent_coordsv, 0.25, 16},
+	{"deimos_special", &get_deimos_parent_coordsv, 1, 16},
+	{"io_special", &get_io_parent_coordsv, 1, 16},
+	{"europa_special", &get_europa_parent_coordsv, 1, 16},
+	{"ganymede_special", &get_ganymede_parent_coordsv, 1, 16},
+	{"calisto_special", &get_callisto_parent_coordsv, 4, 16},
+	{"mimas_special", &get_mimas_parent_coordsv, 1, 16},
+	{"enceladus_special", &get_enceladus_parent_coordsv, 1, 16},
+	{"tethys_special", &get_tethys_parent_coordsv, 4, 20},
+	{"dione_special", &get_dione_parent_coordsv, 4, 16},
+	{"rhea_special", &get_rhea_parent_coordsv, 4, 16},
+	{"titan_special", &get_titan_parent_coordsv, 4, 16},
+	{"hyperion_special", &get_hyperion_parent_coordsv, 4, 16},
+	{"iapetus_special", &get_iapetus_parent_coordsv, 4, 16},
+	{"miranda_special", &get_miranda_parent_coordsv, 1, 16},
+	{"ariel_special", &get_ariel_parent_coordsv, 4, 16},
+	{"umbriel_special", &get_umbriel_parent_coordsv, 4, 16},
+	{"titania_special", &get_titania_parent_coordsv, 4, 16},
+	{"oberon_special", &get_oberon_parent_coordsv, 4, 16},
+};
+
+const EphemerisParameters *findParameters(const std::string &name)
+{
+	for (const EphemerisParameters &param : cachedEphemeris) {
+		if (name == param.name)
+			return &param;
+	}
+	return nullptr;
+}
+
+uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + EPHEMERIS_CACHE_ALIGN - 1) / EPHEMERIS_CACHE_ALIGN * EPHEMERIS_CACHE_ALIGN;
+}
+
+} // namespace
+
+// ChebyshevEphemeris
+
+ChebyshevEphemeris::ChebyshevEphemeris(const std::string &_name, PositionFunctionType *_func, double _segmentDays, unsigned int _nbCoefficients) :
+	name(_name), func(_func), segmentDays(_segmentDays), nbCoefficients(_nbCoefficients)
+{
+	const unsigned int nbSegments = ceil((EPHEMERIS_CACHE_END - EPHEMERIS_CACHE_BEGIN) / segmentDays);
+	nbPages = (nbSegments + EPHEMERIS_PAGE_SEGMENTS - 1) / EPHEMERIS_PAGE_SEGMENTS;
+	pageSize = EPHEMERIS_PAGE_SEGMENTS + EPHEMERIS_PAGE_SEGMENTS * 3 * nbCoefficients * sizeof(double);
+	pages = std::make_unique<std::atomic<char *>[]>(nbPages);
+	for (unsigned int i = 0; i < nbPages; ++i)
+		pages[i].store(nullptr, std::memory_order_relaxed);
+}
+
+ChebyshevEphemeris::~ChebyshevEphemeris()
+{}
+
+bool ChebyshevEphemeris::position(double jd, double xyz[3])
+{
+	if (!(jd >= EPHEMERIS_CACHE_BEGIN && jd < EPHEMERIS_CACHE_END))
+		return false;
+
+	const double t = (jd - EPHEMERIS_CACHE_BEGIN) / segmentDays;
+	const uint32_t segment = t;
+	const unsigned int slot = segment % EPHEMERIS_PAGE_SEGMENTS;
+	char *page = pages[segment / EPHEMERIS_PAGE_SEGMENTS].load(std::memory_order_acquire);
+	if (!page || !std::atomic_ref<char>(page[slot]).load(std::memory_order_acquire))
+		page = fill(segment);
+
+	// Clenshaw evaluation of the series on [-1, 1]
+	const double *coefficients = (const double *) (page + EPHEMERIS_PAGE_SEGMENTS) + slot * 3 * nbCoefficients;
+	const double x = 2.0 * (t - segment) - 1.0;
+	for (int axis = 0; axis < 3; ++axis) {
+		const double *c = coefficients + axis * nbCoefficients;
+		double b1 = 0.0;
+		double b2 = 0.0;
+		for (unsigned int j = nbCoefficients - 1; j >= 1; --j) {
+			const double b0 = 2.0 * x * b1 - b2 + c[j];
+			b2 = b1;
+			b1 = b0;
+		}
+		xyz[axis] = x * b1 - b2 + c[0];
+	}
+	return true;
+}
+
+char *ChebyshevEphemeris::fill(uint32_t segment)
+{
+	std::lock_guard<std::mutex> guard(EphemerisCache::getFitMutex());
+	const unsigned int pageIndex = segment / EPHEMERIS_PAGE_SEGMENTS;
+	const unsigned int slot = segment % EPHEMERIS_PAGE_SEGMENTS;
+	char *page = pages[pageIndex].load(std::memory_order_relaxed);
+	if (!page) {
+		ownedPages.push_back(std::make_unique<char[]>(pageSize));
+		page = ownedPages.back().get();
+		pages[pageIndex].store(page, std::memory_order_release);
+	}
+	if (!std::atomic_ref<char>(page[slot]).load(std::memory_order_relaxed)) {
+		fit(EPHEMERIS_CACHE_BEGIN + segment * segmentDays, (double *) (page + EPHEMERIS_PAGE_SEGMENTS) + slot * 3 * nbCoefficients);
+		std::atomic_ref<char>(page[slot]).store(1, std::memory_order_release);
+		modified = true;
+	}
+	return page;
+}
+
+void ChebyshevEphemeris::fit(double jd0, double *coefficients) const
+{
+	const unsigned int n = nbCoefficients;
+	double values[EPHEMERIS_MAX_COEFFICIENTS][3];
+	double kick[3];
+	for (unsigned int k = 0; k < n; ++k) {
+		const double x = cos(M_PI * (k + 0.5) / n);
+		const double jd = jd0 + (x + 1.0) * 0.5 * segmentDays;
+		func(jd + EPHEMERIS_FIT_KICK, kick);
+		func(jd, values[k]);
+	}
+	for (unsigned int j = 0; j < n; ++j) {
+		const double factor = (j == 0 ? 1.0 : 2.0) / n;
+		double sum[3] = {0.0, 0.0, 0.0};
+		for (unsigned int k = 0; k < n; ++k) {
+			const double w = cos(M_PI * j * (k + 0.5) / n);
+			sum[0] += values[k][0] * w;
+			sum[1] += values[k][1] * w;
+			sum[2] += values[k][2] * w;
+		}
+		for (int axis = 0; axis < 3; ++axis)
+			coefficients[axis * n + j] = sum[axis] * factor;
+	}
+}
+
+// EphemerisCache
+
+EphemerisCache *EphemerisCache::singleton = nullptr;
+std::mutex EphemerisCache::fitMutex;
+
+void EphemerisCache::open(const std::string &fileName)
+{
+	if (singleton)
+		return;
+	singleton = new EphemerisCache(fileName);
+}
+
+void EphemerisCache::close()
+{
+	if (!singleton)
+		return;
+	singleton->save();
+	delete singleton;
+	singleton = nullptr;
+}
+
+EphemerisCache::EphemerisCache(const std::string &_fileName) : fileName(_fileName)
+{
+	map();
+}
+
+EphemerisCache::~EphemerisCache()
+{
+	ephemeris.clear();
+	unmap();
+}
+
+ChebyshevEphemeris *EphemerisCache::getEphemeris(const std::string &ephemerisName)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	auto it = ephemeris.find(ephemerisName);
+	if (it != ephemeris.end())
+		return it->second.get();
+	return create(ephemerisName);
+}
+
+ChebyshevEphemeris *EphemerisCache::create(const std::string &ephemerisName)
+{
+	const EphemerisParameters *param = findParameters(ephemerisName);
+	if (!param)
+		return nullptr;
+	std::unique_ptr<ChebyshevEphemeris> &eph = ephemeris[ephemerisName];
+	eph = std::make_unique<ChebyshevEphemeris>(ephemerisName, param->func, param->segmentDays, param->nbCoefficients);
+	return eph.get();
+}
+
+void EphemerisCache::unmap()
+{
+#ifndef WIN32
+	if (mapStart)
+		munmap(mapStart, mapSize);
+#endif
+	mapStart = nullptr;
+	mapSize = 0;
+	fileData.reset();
+}
+
+void EphemerisCache::map()
+{
+	if (!EPHEMERIS_CACHE_NATIVE) {
+		cLog::get()->write("EphemerisCache, cache file needs a little-endian host", LOG_TYPE::L_WARNING);
+		return;
+	}
+	if (!std::filesystem::exists(fileName)) {
+		cLog::get()->write("EphemerisCache, no cache file " + fileName + ", the segments will be computed on use");
+		return;
+	}
+
+	char *data = nullptr;
+	size_t size = 0;
+#ifndef WIN32
+	int fd = ::open(fileName.c_str(), O_RDONLY);
+	if (fd >= 0) {
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size >= (off_t) sizeof(EphemerisCacheHeader)) {
+			size = st.st_size;
+			// private writable mapping, the missing segments of a page are fitted in place
+			void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			if (ptr != MAP_FAILED) {
+				mapStart = ptr;
+				mapSize = size;
+				data = (char *) ptr;
+			}
+		}
+		::close(fd);
+	}
+#endif
+	if (!data) {
+		std::ifstream fileIn(fileName, std::ios::binary | std::ios::ate);
+		if (!fileIn.is_open()) {
+			cLog::get()->write("EphemerisCache, error opening file " + fileName, LOG_TYPE::L_WARNING);
+			return;
+		}
+		size = fileIn.tellg();
+		fileIn.seekg(0);
+		fileData = std::make_unique<char[]>(size);
+		fileIn.read(fileData.get(), size);
+		if (!fileIn) {
+			cLog::get()->write("EphemerisCache, error reading file " + fileName, LOG_TYPE::L_ERROR);
+			unmap();
+			return;
+		}
+		data = fileData.get();
+	}
+
+	EphemerisCacheHeader header;
+	bool valid = size >= sizeof(header);
+	if (valid) {
+		memcpy(&header, data, sizeof(header));
+		valid = memcmp(header.magic, EPHEMERIS_CACHE_MAGIC, sizeof(header.magic)) == 0
+			&& header.version == EPHEMERIS_CACHE_VERSION
+			&& header.begin == EPHEMERIS_CACHE_BEGIN && header.end == EPHEMERIS_CACHE_END
+			&& sizeof(header) + (uint64_t) header.nbEphemeris * sizeof(EphemerisCacheEntry) <= size;
+	}
+	if (!valid) {
+		cLog::get()->write("EphemerisCache, " + fileName + " isn't a valid cache file, it will be rebuilt", LOG_TYPE::L_WARNING);
+		unmap();
+		return;
+	}
+
+	const EphemerisCacheEntry *entries = (const EphemerisCacheEntry *) (data + sizeof(header));
+	unsigned int nbPages = 0;
+	for (uint32_t i = 0; i < header.nbEphemeris; ++i) {
+		const EphemerisCacheEntry &entry = entries[i];
+		const std::string name(entry.name, strnlen(entry.name, sizeof(entry.name)));
+		const EphemerisParameters *param = findParameters(name);
+		// the entries computed with other parameters are dropped
+		if (!param || ephemeris.count(name) || entry.segmentDays != param->segmentDays || entry.nbCoefficients != param->nbCoefficients)
+			continue;
+		ChebyshevEphemeris *eph = create(name);
+		if (entry.nbPages != eph->getNbPages() || entry.directoryOffset % sizeof(uint64_t) != 0
+			|| entry.directoryOffset + (uint64_t) entry.nbPages * sizeof(uint64_t) > size) {
+			ephemeris.erase(name);
+			continue;
+		}
+		const uint64_t *directory = (const uint64_t *) (data + entry.directoryOffset);
+		for (uint32_t page = 0; page < entry.nbPages; ++page) {
+			if (directory[page] && directory[page] % sizeof(double) == 0 && directory[page] + eph->getPageSize() <= size) {
+				eph->setPage(page, data + directory[page]);
+				++nbPages;
+			}
+		}
+	}
+	cLog::get()->write("EphemerisCache, " + fileName + (mapStart ? " mapped: " : " read: ") + std::to_string(ephemeris.size()) + " ephemeris, " + std::to_string(nbPages) + " pages");
+}
+
+bool EphemerisCache::save()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	std::lock_guard<std::mutex> fitGuard(fitMutex);
+
+	bool modified = false;
+	for (const auto &it : ephemeris)
+		modified = modified || it.second->isModified();
+	if (!modified)
+		return true;
+	if (!EPHEMERIS_CACHE_NATIVE)
+		return false;
+
+	// layout of the file
+	EphemerisCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, EPHEMERIS_CACHE_MAGIC, sizeof(header.magic));
+	header.version = EPHEMERIS_CACHE_VERSION;
+	header.nbEphemeris = ephemeris.size();
+	header.begin = EPHEMERIS_CACHE_BEGIN;
+	header.end = EPHEMERIS_CACHE_END;
+
+	std::vector<EphemerisCacheEntry> entries(ephemeris.size());
+	std::vector<std::vector<uint64_t>> directories(ephemeris.size());
+	uint64_t offset = sizeof(header) + entries.size() * sizeof(EphemerisCacheEntry);
+	unsigned int i = 0;
+	for (const auto &it : ephemeris) {
+		const ChebyshevEphemeris &eph = *it.second;
+		EphemerisCacheEntry &entry = entries[i++];
+		memset(&entry, 0, sizeof(entry));
+		strncpy(entry.name, eph.getName().c_str(), sizeof(entry.name) - 1);
+		entry.segmentDays = eph.getSegmentDays();
+		entry.nbCoefficients = eph.getNbCoefficients();
+		entry.nbPages = eph.getNbPages();
+		entry.directoryOffset = offset;
+		offset += entry.nbPages * sizeof(uint64_t);
+	}
+	offset = alignOffset(offset);
+	i = 0;
+	for (const auto &it : ephemeris) {
+		const ChebyshevEphemeris &eph = *it.second;
+		std::vector<uint64_t> &directory = directories[i++];
+		directory.assign(eph.getNbPages(), 0);
+		for (unsigned int page = 0; page < eph.getNbPages(); ++page) {
+			if (eph.getPage(page)) {
+				directory[page] = offset;
+				offset = alignOffset(offset + eph.getPageSize());
+			}
+		}
+	}
+
+	// the mapping still reads the previous file, write beside it and replace it once complete
+	const std::string tmpName = fileName + ".tmp";
+	std::ofstream file(tmpName, std::ios::binary | std::ios::out);
+	if (!file.is_open()) {
+		cLog::get()->write("EphemerisCache, error writing " + tmpName, LOG_TYPE::L_ERROR);
+		return false;
+	}
+	const char padding[EPHEMERIS_CACHE_ALIGN] = {};
+	file.write((const char *) &header, sizeof(header));
+	file.write((const char *) entries.data(), entries.size() * sizeof(EphemerisCacheEntry));
+	offset = sizeof(header) + entries.size() * sizeof(EphemerisCacheEntry);
+	for (const std::vector<uint64_t> &directory : directories) {
+		file.write((const char *) directory.data(), directory.size() * sizeof(uint64_t));
+		offset += directory.size() * sizeof(uint64_t);
+	}
+	unsigned int nbPages = 0;
+	i = 0;
+	for (const auto &it : ephemeris) {
+		const ChebyshevEphemeris &eph = *it.second;
+		const std::vector<uint64_t> &directory = directories[i++];
+		for (unsigned int page = 0; page < eph.getNbPages(); ++page) {
+			if (directory[page]) {
+				file.write(padding, directory[page] - offset);
+				file.write(eph.getPage(page), eph.getPageSize());
+				offset = directory[page] + eph.getPageSize();
+				++nbPages;
+			}
+		}
+	}
+	file.close();
+	if (file.fail()) {
+		cLog::get()->write("EphemerisCache, error writing " + tmpName, LOG_TYPE::L_ERROR);
+		return false;
+	}
+	std::error_code ec;
+	std::filesystem::rename(tmpName, fileName, ec);
+	if (ec) {
+		cLog::get()->write("EphemerisCache, error replacing " + fileName + ": " + ec.message(), LOG_TYPE::L_ERROR);
+		return false;
+	}
+	cLog::get()->write("EphemerisCache, " + std::to_string(nbPages) + " pages saved in " + fileName);
+	return true;
+}
@@ -0,0 +1,176 @@
+/*
+* This source is the property of Immersive Adventure
+* http://immersiveadventure.net/
+*
+* It has been developped by part of the LSS Team.
+* For further informations, contact:
+*
+* albertpla@immersiveadventure.net
+*
+* This source code mustn't be copied or redistributed
+* without the authorization of Immersive Adventure
+* (c) 2017 - 2020 all rights reserved
+*
+*/
+//! \file ephemeris_cache.hpp
+//! \brief Chebyshev approximation of the planetsephems series
+
+#ifndef EPHEMERIS_CACHE_HPP
+#define EPHEMERIS_CACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bodyModule/orbit.hpp"
+#include "tools/no_copy.hpp"
+
+/**
+ * The cache file is a little-endian file made of
+ *
+ * | EphemerisCacheHeader | EphemerisCacheEntry[nbEphemeris] | directories | pages |
+ *
+ * The directory of an ephemeris holds the file offset of each of its pages,
+ * 0 for the pages which were never computed. A page is made of
+ * EPHEMERIS_PAGE_SEGMENTS ready bytes followed by the coefficients of its
+ * segments, each segment stores nbCoefficients values for x, then y, then z.
+ */
+#define EPHEMERIS_CACHE_MAGIC "SCEPHCHB"
+#define EPHEMERIS_CACHE_VERSION 1
+#define EPHEMERIS_CACHE_ALIGN 64
+#define EPHEMERIS_PAGE_SEGMENTS 16
+#define EPHEMERIS_MAX_COEFFICIENTS 32
+// covered range: 1600-01-01 to 2400-01-01
+#define EPHEMERIS_CACHE_BEGIN 2305447.5
+#define EPHEMERIS_CACHE_END 2597641.5
+
+struct EphemerisCacheHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t nbEphemeris;
+	double begin;
+	double end;
+};
+
+struct EphemerisCacheEntry {
+	char name[32];
+	double segmentDays;
+	uint32_t nbCoefficients;
+	uint32_t nbPages;
+	uint64_t directoryOffset;
+};
+
+/*! \class ChebyshevEphemeris
+ * \brief piecewise Chebyshev approximation of one ephemeris function
+ *
+ * \details The covered range is cut in segments of segmentDays days, the
+ * coefficients of a segment are fitted the first time a date falls into it.
+ */
+class ChebyshevEphemeris : public NoCopy {
+public:
+	ChebyshevEphemeris(const std::string &name, PositionFunctionType *func, double segmentDays, unsigned int nbCoefficients);
+	~ChebyshevEphemeris();
+
+	//! \brief compute the position at jd from the segment holding jd
+	//! \return false if jd is outside the covered range
+	bool position(double jd, double xyz[3]);
+
+	const std::string &getName() const {
+		return name;
+	}
+	double getSegmentDays() const {
+		return segmentDays;
+	}
+	unsigned int getNbCoefficients() const {
+		return nbCoefficients;
+	}
+	unsigned int getNbPages() const {
+		return nbPages;
+	}
+	size_t getPageSize() const {
+		return pageSize;
+	}
+
+	//! \return true if segments were fitted since the ephemeris was created
+	bool isModified() const {
+		return modified;
+	}
+
+	//! \return the page, nullptr if none of its segments were computed
+	const char *getPage(unsigned int page) const {
+		return pages[page].load(std::memory_order_acquire);
+	}
+	//! \brief use a page read from a cache file, must be called before any position()
+	void setPage(unsigned int page, char *data) {
+		pages[page].store(data, std::memory_order_release);
+	}
+
+private:
+	char *fill(uint32_t segment);
+	void fit(double jd0, double *coefficients) const;
+
+	std::string name;
+	PositionFunctionType *func;
+	double segmentDays;
+	unsigned int nbCoefficients;
+	unsigned int nbPages;
+	size_t pageSize;
+	std::unique_ptr<std::atomic<char *>[]> pages;
+	std::vector<std::unique_ptr<char[]>> ownedPages;
+	bool modified = false;
+};
+
+/*! \class EphemerisCache
+ * \brief owner of the ChebyshevEphemeris and of their cache file
+ *
+ * \details The cache only exists once open() was called, the computed segments
+ * are written back to the file by close().
+ */
+class EphemerisCache : public NoCopy {
+public:
+	//! \brief create the cache and map fileName if it exists
+	static void open(const std::string &fileName);
+	//! \brief save the cache and release it
+	static void close();
+
+	//! \return the cache, nullptr if it isn't open
+	static EphemerisCache *get() {
+		return singleton;
+	}
+
+	//! \return the approximation of the ephemeris of SpecialOrbit, nullptr if it isn't cached
+	ChebyshevEphemeris *getEphemeris(const std::string &ephemerisName);
+
+	//! \brief write all the computed segments in the cache file
+	bool save();
+
+	//! planetsephems isn't reentrant, every call to its functions from the cache holds this lock
+	static std::mutex &getFitMutex() {
+		return fitMutex;
+	}
+
+private:
+	EphemerisCache(const std::string &fileName);
+	~EphemerisCache();
+
+	ChebyshevEphemeris *create(const std::string &ephemerisName);
+	void map();
+	void unmap();
+
+	static EphemerisCache *singleton;
+	static std::mutex fitMutex;
+
+	std::string fileName;
+	std::mutex lock;
+	std::map<std::string, std::unique_ptr<ChebyshevEphemeris>> ephemeris;
+	// mapped file
+	void *mapStart = nullptr;
+	size_t mapSize = 0;
+	std::unique_ptr<char[]> fileData; // used when mmap isn't available
+};
+
+#endif
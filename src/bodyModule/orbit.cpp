@@ -14,6 +14,7 @@
 
 #include "bodyModule/solve.hpp"
 #include "bodyModule/orbit.hpp"
+#include "bodyModule/ephemeris_cache.hpp"
 #include "../planetsephems/stellplanet.h"
 #include "tools/vecmath.hpp"
 
@@ -799,11 +800,13 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 	if (ephemerisName=="mercury_special") {
 		positionFunction = &get_mercury_helio_coordsv;
 		osculatingFunction = &get_mercury_helio_osculating_coords;
+		toleranceFunction = &set_mercury_helio_tolerance;
 	}
 
 	if (ephemerisName=="venus_special") {
 		positionFunction = &get_venus_helio_coordsv;
 		osculatingFunction = &get_venus_helio_osculating_coords;
+		toleranceFunction = &set_venus_helio_tolerance;
 	}
 
 	if (ephemerisName=="earth_special") {
@@ -816,16 +819,19 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 	if (ephemerisName=="emb_special") {
 		positionFunction = &get_emb_helio_coordsv;
 		osculatingFunction = &get_emb_helio_osculating_coords;
+		toleranceFunction = &set_emb_helio_tolerance;
 	}
 
 	if (ephemerisName=="lunar_special") {
 		positionFunction = &get_lunar_parent_coordsv;
+		toleranceFunction = &set_lunar_parent_tolerance;
 		m_UseParentPrecession = false;
 	}
 
 	if (ephemerisName=="mars_special") {
 		positionFunction = &get_mars_helio_coordsv;
 		osculatingFunction = &get_mars_helio_osculating_coords;
+		toleranceFunction = &set_mars_helio_tolerance;
 	}
 
 	if (ephemerisName=="phobos_special")
@@ -837,6 +843,7 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 	if (ephemerisName=="jupiter_special") {
 		positionFunction = &get_jupiter_helio_coordsv;
 		osculatingFunction = &get_jupiter_helio_osculating_coords;
+		toleranceFunction = &set_jupiter_helio_tolerance;
 	}
 
 	if (ephemerisName=="europa_special")
@@ -854,6 +861,7 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 	if (ephemerisName=="saturn_special") {
 		positionFunction = &get_saturn_helio_coordsv;
 		osculatingFunction = &get_saturn_helio_osculating_coords;
+		toleranceFunction = &set_saturn_helio_tolerance;
 		stable = false;
 	}
 
@@ -884,6 +892,7 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 	if (ephemerisName=="uranus_special") {
 		positionFunction = &get_uranus_helio_coordsv;
 		osculatingFunction = &get_uranus_helio_osculating_coords;
+		toleranceFunction = &set_uranus_helio_tolerance;
 		stable = false;
 	}
 
@@ -905,6 +914,7 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 	if (ephemerisName=="neptune_special") {
 		positionFunction = &get_neptune_helio_coordsv;
 		osculatingFunction = &get_neptune_helio_osculating_coords;
+		toleranceFunction = &set_neptune_helio_tolerance;
 		stable = false;
 	}
 
@@ -913,6 +923,11 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 
 	// \todo better error checking
 
+	if (positionFunction && EphemerisCache::get())
+		cache = EphemerisCache::get()->getEphemeris(ephemerisName);
+	// the segments of the cache are fitted on the full series
+	if (cache)
+		toleranceFunction = nullptr;
 }
 
 
@@ -923,6 +938,9 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 // parent_rot_obliquity and parent_rot_ascendingnode must be supplied.
 void SpecialOrbit::positionAtTimevInVSOP87Coordinates(double JD0, double JD, double* v) const
 {
+	// the osculating orbit at JD is the position at JD
+	if (cache && JD0 == JD && cache->position(JD, v))
+		return;
 	if(osculatingFunction) (*osculatingFunction)(JD0, JD, v);
 	else positionFunction(JD, v);
 }
@@ -17,8 +17,11 @@
 // The callback type for the external position computation function
 typedef void (PositionFunctionType)(double jd,double xyz[3]);
 typedef void (OsculatingFunctionType)(double jd0,double jd,double xyz[3]);
+// The callback type for the precision of the external position computation, in AU
+typedef void (ToleranceFunctionType)(double tolerance);
 
 class Body;
+class ChebyshevEphemeris;
 
 class Orbit {
 public:
@@ -64,6 +67,14 @@ public:
 		return true;
 	}
 
+	// Accept a position error of tolerance AU if it makes the computation faster, 0 for full precision
+	virtual void setTolerance(double) {}
+
+	// Can the position be computed while other threads compute other orbits
+	virtual bool isReentrant() const {
+		return true;
+	}
+
 	virtual std::string saveOrbit() const = 0;
 
 private:
@@ -205,12 +216,26 @@ public:
 	virtual bool useParentPrecession(double) const {
 		return m_UseParentPrecession;
 	}
+
+	// Truncate the series of the ephemeris, the cached ephemeris are always exact enough
+	virtual void setTolerance(double tolerance) {
+		if (toleranceFunction)
+			toleranceFunction(tolerance);
+	}
+
+	// planetsephems keeps its state in static variables
+	virtual bool isReentrant() const {
+		return false;
+	}
+
 	virtual std::string saveOrbit() const;
 
 
 private:
 	PositionFunctionType *positionFunction;
 	OsculatingFunctionType *osculatingFunction;
+	ToleranceFunctionType *toleranceFunction = nullptr;
+	ChebyshevEphemeris *cache = nullptr; // approximation of positionFunction, if EphemerisCache is open
 	bool stable;  // does not osculate noticeably for performance caching orbit visualization
 	bool m_UseParentPrecession;
 };
@@ -239,6 +264,14 @@ public:
 	// Do the body coordinates precess with the parent?
 	virtual bool useParentPrecession(double jd) const;
 
+	virtual void setTolerance(double tolerance) {
+		primary->setTolerance(tolerance);
+	}
+
+	virtual bool isReentrant() const {
+		return primary->isReentrant();
+	}
+
 	virtual std::string saveOrbit() const;
 
 private:
@@ -285,6 +318,15 @@ public:
 		secondary = second;
 	}
 
+	// the secondary orbit has its own body, hence its own tolerance
+	virtual void setTolerance(double tolerance) {
+		barycenter->setTolerance(tolerance);
+	}
+
+	virtual bool isReentrant() const {
+		return barycenter->isReentrant() && (!secondary || secondary->isReentrant());
+	}
+
 	virtual std::string saveOrbit() const;
 
 private:
@@ -368,6 +410,11 @@ public:
 		return false;
 	}
 
+	// the position depends on the positions of bodyA and bodyB
+	bool isReentrant() const {
+		return false;
+	}
+
 	std::string saveOrbit() const;
 
 private:
@@ -14,6 +14,7 @@
 */
 
 #include "bodyModule/orbit_creator_cor.hpp"
+#include "bodyModule/body_descriptor.hpp"
 #include "bodyModule/solarsystem.hpp"
 #include "bodyModule/orbit.hpp"
 #include "tools/log.hpp"
@@ -28,10 +29,10 @@ OrbitCreatorEliptic::OrbitCreatorEliptic(std::shared_ptr<OrbitCreator> _next, co
 	psystem = _psystem;
 }
 
-std::unique_ptr<Orbit> OrbitCreatorEliptic::handle(stringHash_t params) const
+std::unique_ptr<Orbit> OrbitCreatorEliptic::handle(const BodyDescriptor &params) const
 {
 
-	if(params["coord_func"] != "ell_orbit") {
+	if(params.coordFunc != "ell_orbit") {
 		if(next != nullptr)
 			return next->handle(params);
 		else {
@@ -40,16 +41,16 @@ std::unique_ptr<Orbit> OrbitCreatorEliptic::handle(stringHash_t params) const
 		}
 	}
 
-	std::shared_ptr<Body> parent = psystem->searchByEnglishName(params["parent"]);
+	std::shared_ptr<Body> parent = psystem->searchByEnglishName(std::string(params.parent));
 
 	double parent_rot_obliquity = 0.0;
 	double parent_rot_asc_node = 0.0;
 	double parent_rot_J2000_longitude = 0.0;
 
 	if(!parent) {
-		parent_rot_obliquity = Utility::strToDouble(params["parent_rot_obliquity"], 0.0);
-		parent_rot_asc_node = Utility::strToDouble(params["parent_rot_asc_node"], 0.0);
-		parent_rot_J2000_longitude = Utility::strToDouble(params["parent_rot_J2000_longitude"], 0.0);
+		parent_rot_obliquity = params.getDouble("parent_rot_obliquity", 0.0);
+		parent_rot_asc_node = params.getDouble("parent_rot_asc_node", 0.0);
+		parent_rot_J2000_longitude = params.getDouble("parent_rot_J2000_longitude", 0.0);
 	}
 	else {
 
@@ -73,14 +74,14 @@ std::unique_ptr<Orbit> OrbitCreatorEliptic::handle(stringHash_t params) const
 		}
 	}
 
-	double period = Utility::strToDouble(params["orbit_period"]);
-	double epoch = Utility::strToDouble(params["orbit_epoch"],J2000);
-	double semi_major_axis = Utility::strToDouble(params["orbit_semimajoraxis"])/AU;
-	double eccentricity = Utility::strToDouble(params["orbit_eccentricity"]);
-	double inclination = Utility::strToDouble(params["orbit_inclination"])*M_PI/180.;
-	double ascending_node = Utility::strToDouble(params["orbit_ascendingnode"])*M_PI/180.;
-	double long_of_pericenter = Utility::strToDouble(params["orbit_longofpericenter"])*M_PI/180.;
-	double mean_longitude = Utility::strToDouble(params["orbit_meanlongitude"])*M_PI/180.;
+	double period = params.getDouble("orbit_period");
+	double epoch = params.getDouble("orbit_epoch", J2000);
+	double semi_major_axis = params.getDouble("orbit_semimajoraxis")/AU;
+	double eccentricity = params.getDouble("orbit_eccentricity");
+	double inclination = params.getDouble("orbit_inclination")*M_PI/180.;
+	double ascending_node = params.getDouble("orbit_ascendingnode")*M_PI/180.;
+	double long_of_pericenter = params.getDouble("orbit_longofpericenter")*M_PI/180.;
+	double mean_longitude = params.getDouble("orbit_meanlongitude")*M_PI/180.;
 
 	double arg_of_pericenter = long_of_pericenter - ascending_node;
 	double anomaly_at_epoch = mean_longitude - (arg_of_pericenter + ascending_node);
@@ -103,28 +104,28 @@ OrbitCreatorComet::OrbitCreatorComet(std::shared_ptr<OrbitCreator> _next, const
 	psystem = _psystem;
 }
 
-std::unique_ptr<Orbit> OrbitCreatorComet::handle(stringHash_t params) const
+std::unique_ptr<Orbit> OrbitCreatorComet::handle(const BodyDescriptor &params) const
 {
 
-	if(params["coord_func"] != "comet_orbit") {
+	if(params.coordFunc != "comet_orbit") {
 		if(next != nullptr)
 			return next->handle(params);
 		else {
-			cLog::get()->write("OrbitCreatorComet::handle unknown type : " + params["coord_func"]);
+			cLog::get()->write("OrbitCreatorComet::handle unknown type : " + std::string(params.coordFunc));
 			return nullptr;
 		}
 	}
 
-	std::shared_ptr<Body> parent = psystem->searchByEnglishName(params["parent"]);
+	std::shared_ptr<Body> parent = psystem->searchByEnglishName(std::string(params.parent));
 
 	double parent_rot_obliquity = 0.0;
 	double parent_rot_asc_node = 0.0;
 	double parent_rot_J2000_longitude = 0.0;
 
 	if(!parent) {
-		parent_rot_obliquity = Utility::strToDouble(params["parent_rot_obliquity"]);
-		parent_rot_asc_node = Utility::strToDouble(params["parent_rot_asc_node"]);
-		parent_rot_J2000_longitude = Utility::strToDouble(params["parent_rot_J2000_longitude"]);
+		parent_rot_obliquity = params.getDouble("parent_rot_obliquity");
+		parent_rot_asc_node = params.getDouble("parent_rot_asc_node");
+		parent_rot_J2000_longitude = params.getDouble("parent_rot_J2000_longitude");
 	}
 	else {
 		parent_rot_obliquity = parent && parent->get_parent()
@@ -149,14 +150,14 @@ std::unique_ptr<Orbit> OrbitCreatorComet::handle(stringHash_t params) const
 
 
 	// Read the orbital elements
-	const double eccentricity = Utility::strToDouble(params["orbit_eccentricity"],0.0);
+	const double eccentricity = params.getDouble("orbit_eccentricity", 0.0);
 
-	double pericenter_distance = Utility::strToDouble(params["orbit_pericenterdistance"],-1e100);
+	double pericenter_distance = params.getDouble("orbit_pericenterdistance", -1e100);
 
 	double semi_major_axis;
 
 	if (pericenter_distance <= 0.0) {
-		semi_major_axis = Utility::strToDouble(params["orbit_semimajoraxis"],-1e100);
+		semi_major_axis = params.getDouble("orbit_semimajoraxis", -1e100);
 
 		if (semi_major_axis <= -1e100) {
 			cLog::get()->write("OrbitCreatorComet::handle you must provide orbit_pericenterdistance or orbit_semimajoraxis");
@@ -175,10 +176,10 @@ std::unique_ptr<Orbit> OrbitCreatorComet::handle(stringHash_t params) const
 		                  ? 0.0 // parabolic orbits have no semi_major_axis
 		                  : pericenter_distance / (1.0-eccentricity);
 	}
-	double mean_motion = Utility::strToDouble(params["orbit_meanmotion"],-1e100);
+	double mean_motion = params.getDouble("orbit_meanmotion", -1e100);
 	double period;
 	if (mean_motion <= -1e100) {
-		period = Utility::strToDouble(params["orbit_period"],-1e100);
+		period = params.getDouble("orbit_period", -1e100);
 		if (period <= -1e100) {
 			if (parent->get_parent()) {
 				cLog::get()->write("OrbitCreatorComet::handle When the parent body is not the Sun\nyou must provide orbit_MeanMotion or orbit_Period");
@@ -199,11 +200,11 @@ std::unique_ptr<Orbit> OrbitCreatorComet::handle(stringHash_t params) const
 		mean_motion *= (M_PI/180.0);
 	}
 
-	double time_at_pericenter = Utility::strToDouble(params["orbit_timeatpericenter"],-1e100);
+	double time_at_pericenter = params.getDouble("orbit_timeatpericenter", -1e100);
 
 	if (time_at_pericenter <= -1e100) {
-		const double epoch = Utility::strToDouble(params["orbit_epoch"],-1e100);
-		double mean_anomaly = Utility::strToDouble(params["orbit_meananomaly"],-1e100);
+		const double epoch = params.getDouble("orbit_epoch", -1e100);
+		double mean_anomaly = params.getDouble("orbit_meananomaly", -1e100);
 		if (epoch <= -1e100 || mean_anomaly <= -1e100) {
 			cLog::get()->write("OrbitCreatorComet::handle when you do not provide orbit_TimeAtPericenter, you must provide both orbit_Epoch and orbit_MeanAnomaly");
 			return nullptr;
@@ -214,9 +215,9 @@ std::unique_ptr<Orbit> OrbitCreatorComet::handle(stringHash_t params) const
 		}
 	}
 
-	const double inclination = Utility::strToDouble(params["orbit_inclination"])*(M_PI/180.0);
-	const double ascending_node = Utility::strToDouble(params["orbit_ascendingnode"])*(M_PI/180.0);
-	const double arg_of_pericenter = Utility::strToDouble(params["orbit_argofpericenter"])*(M_PI/180.0);
+	const double inclination = params.getDouble("orbit_inclination")*(M_PI/180.0);
+	const double ascending_node = params.getDouble("orbit_ascendingnode")*(M_PI/180.0);
+	const double arg_of_pericenter = params.getDouble("orbit_argofpericenter")*(M_PI/180.0);
 
 	return std::make_unique<CometOrbit>(
 	           pericenter_distance, eccentricity,
@@ -230,10 +231,10 @@ std::unique_ptr<Orbit> OrbitCreatorComet::handle(stringHash_t params) const
 OrbitCreatorSpecial::OrbitCreatorSpecial(std::shared_ptr<OrbitCreator> next) :
 	OrbitCreator(next) { }
 
-std::unique_ptr<Orbit> OrbitCreatorSpecial::handle(stringHash_t params) const
+std::unique_ptr<Orbit> OrbitCreatorSpecial::handle(const BodyDescriptor &params) const
 {
 
-	std::unique_ptr<SpecialOrbit> sorb = std::make_unique<SpecialOrbit>(params["coord_func"]);
+	std::unique_ptr<SpecialOrbit> sorb = std::make_unique<SpecialOrbit>(std::string(params.coordFunc));
 
 	if(!sorb->isValid()) {
 		if(next != nullptr)
@@ -253,10 +254,10 @@ OrbitCreatorBary::OrbitCreatorBary(std::shared_ptr<OrbitCreator> _next, ProtoSys
 	psystem = _psystem;
 }
 
-std::unique_ptr<Orbit> OrbitCreatorBary::handle(stringHash_t params) const
+std::unique_ptr<Orbit> OrbitCreatorBary::handle(const BodyDescriptor &params) const
 {
 
-	if(params["coord_func"] != "barycenter") {
+	if(params.coordFunc != "barycenter") {
 		if(next != nullptr)
 			return next->handle(params);
 		else {
@@ -265,23 +266,23 @@ std::unique_ptr<Orbit> OrbitCreatorBary::handle(stringHash_t params) const
 		}
 	}
 
-	if(params["a"].empty() || params["b"].empty()) {
+	if(params.get("a").empty() || params.get("b").empty()) {
 		cLog::get()->write("OrbitCreatorBary::handle missing barycenter coefficients");
 		return nullptr;
 	}
 
-	if(params["body_A"].empty() || params["body_B"].empty()) {
+	if(params.get("body_A").empty() || params.get("body_B").empty()) {
 		cLog::get()->write("OrbitCreatorBary::handle missing parents");
 		return nullptr;
 	}
 
-	std::shared_ptr<Body> bodyA = psystem->searchByEnglishName(params["body_A"]);
-	std::shared_ptr<Body> bodyB = psystem->searchByEnglishName(params["body_B"]);
+	std::shared_ptr<Body> bodyA = psystem->searchByEnglishName(params.getStr("body_A"));
+	std::shared_ptr<Body> bodyB = psystem->searchByEnglishName(params.getStr("body_B"));
 
 	if(bodyA == nullptr || bodyB == nullptr) {
 		cLog::get()->write("OrbitCreatorBary::couldn't find one of the bodies");
 		return nullptr;
 	}
 
-	return std::make_unique<BarycenterOrbit>(bodyA, bodyB, stod(params["a"]), stod(params["b"]));
+	return std::make_unique<BarycenterOrbit>(bodyA, bodyB, params.getDouble("a"), params.getDouble("b"));
 }
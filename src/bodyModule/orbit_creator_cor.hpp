@@ -23,6 +23,7 @@
 class Orbit;
 class SolarSystem;
 class ProtoSystem;
+class BodyDescriptor;
 
 class OrbitCreator {
 public:
@@ -31,7 +32,7 @@ public:
 		next = _next;
 	}
 
-	virtual std::unique_ptr<Orbit> handle(stringHash_t param)const = 0;
+	virtual std::unique_ptr<Orbit> handle(const BodyDescriptor &param) const = 0;
 
 protected:
 	std::shared_ptr<OrbitCreator> next = nullptr;
@@ -41,7 +42,7 @@ class OrbitCreatorEliptic : public OrbitCreator {
 public:
 	OrbitCreatorEliptic() = delete;
 	OrbitCreatorEliptic(std::shared_ptr<OrbitCreator> next, const ProtoSystem * ssystem);
-	virtual std::unique_ptr<Orbit> handle(stringHash_t params)const;
+	virtual std::unique_ptr<Orbit> handle(const BodyDescriptor &params) const;
 
 private :
 	const ProtoSystem * psystem;
@@ -51,7 +52,7 @@ class OrbitCreatorComet : public OrbitCreator {
 public:
 	OrbitCreatorComet() = delete;
 	OrbitCreatorComet(std::shared_ptr<OrbitCreator> next, const ProtoSystem * ssystem);
-	virtual std::unique_ptr<Orbit> handle(stringHash_t params)const;
+	virtual std::unique_ptr<Orbit> handle(const BodyDescriptor &params) const;
 
 private :
 	const ProtoSystem * psystem;
@@ -61,14 +62,14 @@ class OrbitCreatorSpecial : public OrbitCreator {
 public:
 	OrbitCreatorSpecial() = delete;
 	OrbitCreatorSpecial(std::shared_ptr<OrbitCreator>);
-	virtual std::unique_ptr<Orbit> handle(stringHash_t params) const;
+	virtual std::unique_ptr<Orbit> handle(const BodyDescriptor &params) const;
 };
 
 class OrbitCreatorBary : public OrbitCreator {
 public:
 	OrbitCreatorBary() = delete;
 	OrbitCreatorBary(std::shared_ptr<OrbitCreator>, ProtoSystem * _psystem);
-	virtual std::unique_ptr<Orbit> handle(stringHash_t params) const;
+	virtual std::unique_ptr<Orbit> handle(const BodyDescriptor &params) const;
 
 private:
 	ProtoSystem * psystem;
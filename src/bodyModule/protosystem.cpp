@@ -22,8 +22,9 @@
  *
  */
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <fstream>
 #include <string>
 
 #include "bodyModule/solarsystem.hpp"
@@ -43,6 +44,7 @@
 #include "tools/object.hpp"
 #include "tools/context.hpp"
 #include "interfaceModule/base_command_interface.hpp"
+#include "bodyModule/body_descriptor.hpp"
 
 #define EARTH_MASS 5.976e24
 #define LUNAR_MASS 7.354e22
@@ -111,35 +113,17 @@ void ProtoSystem::load(Object &obj)
 // Init and load the solar system data
 void ProtoSystem::load(const std::string& planetfile)
 {
-	stringHash_t bodyParams;
-
-	std::ifstream fileBody (planetfile.c_str() , std::ifstream::in);
-	if(fileBody) {
-		std::string ligne;
-		while(getline(fileBody , ligne)) {
-			if (ligne.size() < 2)
-				continue;
-			if (ligne[0] != '[' ) {
-				if (ligne[ligne.length() - 1] == '\r')
-					ligne.pop_back();
-				if (ligne[0]!='#' && ligne.size() != 0) {
-					int pos = ligne.find('=',0);
-					std::string p1=ligne.substr(0,pos-1);
-					std::string p2=ligne.substr(pos+2,ligne.size());
-					bodyParams[p1]=p2;
-				}
-			} else {
-				if (bodyParams.size() !=0) {
-					//TODO recover this error if there is one!
-					addBody(std::move(bodyParams), false);  // config file bodies are not deletable
-				}
-			}
+	BodyFile file;
+	if (file.load(planetfile)) {
+		const std::vector<BodyDescriptor> &bodies = file.getBodies();
+		sortedRenderedBodies.reserve(sortedRenderedBodies.size() + bodies.size());
+		for (const BodyDescriptor &body : bodies) {
+			//TODO recover this error if there is one!
+			addBody(body, false);  // config file bodies are not deletable
 		}
-		if (!bodyParams.empty())
-			addBody(std::move(bodyParams), false);  // config file bodies are not deletable
-		fileBody.close();
-	} else
-		cLog::get()->write("Unable to open file "+ planetfile, LOG_TYPE::L_ERROR);
+		// the bodies shown are sorted once at the next computeDraw
+		fullSortNeeded = true;
+	}
 
 	cLog::get()->write("(solar system loaded)", LOG_TYPE::L_INFO);
 	cLog::get()->mark();
@@ -190,6 +174,7 @@ void ProtoSystem::removeBodyNoSatellite(std::map<std::string, BodyContainer>::it
 	hideBody(it->second.body.get());
 	anchorManager->removeAnchor(it->second.body);
 	systemBodies.erase(it);
+	bodyLevelsChanged = true;
 }
 
 bool ProtoSystem::removeSupplementalBodies(const std::string &name)
@@ -471,11 +456,14 @@ constexpr uint32_t casify(const char *data) {
 
 #define CASE(name, type) case casify(name): return type
 
-BODY_TYPE ProtoSystem::setPlanetType (const std::string &str)
+BODY_TYPE ProtoSystem::setPlanetType (std::string_view str)
 {
 	if (str.size() < 3)
 		return UNKNOWN;
-	switch (*(const uint32_t *) str.data()) {
+	// the view isn't terminated, the 4th byte of a 3 letters type is set to 0 as in casify
+	uint32_t key = 0;
+	memcpy(&key, str.data(), std::min<size_t>(str.size(), 4));
+	switch (key) {
 		CASE("Sun", SUN);
 		CASE("Star", STAR);
 		CASE("Planet", PLANET);
@@ -498,16 +486,21 @@ BODY_TYPE ProtoSystem::setPlanetType (const std::string &str)
 // This is a the private method
 void ProtoSystem::addBody(stringHash_t param, bool deletable)
 {
-	// Avoid string copy and map search
-	const std::string &englishName = param["name"];
-	const std::string &str_parent = param["parent"];
-	const std::string &funcname = param["coord_func"];
+	addBody(BodyDescriptor(param), deletable);
+}
+
+// Init and load one solar system object from its descriptor
+void ProtoSystem::addBody(const BodyDescriptor &param, bool deletable)
+{
+	const std::string englishName(param.name);
+	const std::string str_parent(param.parent);
+	const std::string funcname(param.coordFunc);
 	// p is a pointer used for the object that will be finally integrated in the list of stars that body_mgr manages
 	std::shared_ptr<Body> p, parent;
 
 	cLog::get()->write("Loading new Stellar System object... " + englishName, LOG_TYPE::L_INFO);
 	// set the Body type: ie what it is in universe
-	BODY_TYPE typePlanet = setPlanetType(param["type"]);
+	BODY_TYPE typePlanet = setPlanetType(param.type);
 
 	// do not add if no name or no parent or no typePlanet
 	if (englishName.empty()) {
@@ -543,12 +536,12 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 	// determination of the orbit of the star
 	//
 	std::unique_ptr<Orbit> orb;
-	bool close_orbit = Utility::strToBool(param["close_orbit"], 1);
+	bool close_orbit = param.getBool("close_orbit", 1);
 	bool bound_to_surface = false;
 	float parentSideralDay = 1;
 	float parentOffset = 0;
 	// default value of -1 means unused
-	double orbit_bounding_radius = Utility::strToDouble(param["orbit_bounding_radius"], -1);
+	double orbit_bounding_radius = param.getDouble("orbit_bounding_radius", -1);
 	if (funcname=="earth_custom") {
 		// Special case to take care of Earth-Moon Barycenter at a higher level than in ephemeris library
 
@@ -575,7 +568,7 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 		}
 
 		orb = std::make_unique<MixedOrbit>(std::move(sorb),
-		                     Utility::strToDouble(param["orbit_period"]),
+		                     param.getDouble("orbit_period"),
 		                     SpaceDate::JulianDayFromDateTime(-10000, 1, 1, 1, 1, 1),
 		                     SpaceDate::JulianDayFromDateTime(10000, 1, 1, 1, 1, 1),
 		                     EARTH_MASS + LUNAR_MASS,
@@ -583,16 +576,16 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 		                     false);
 
 	} else if (funcname == "still_orbit") {
-		orb = std::make_unique<stillOrbit>(Utility::strToDouble(param["orbit_x"]),
-		                     Utility::strToDouble(param["orbit_y"]),
-		                     Utility::strToDouble(param["orbit_z"]));
+		orb = std::make_unique<stillOrbit>(param.getDouble("orbit_x"),
+		                     param.getDouble("orbit_y"),
+		                     param.getDouble("orbit_z"));
 	} else if (funcname == "location_orbit") {
 		parentSideralDay = parent->getSiderealDay();
 		parentOffset = parent->getSiderealTime(J2000);
 		orb = std::make_unique<LocationOrbit>(
-			Utility::strToDouble(param["orbit_lon"]),
-			Utility::strToDouble(param["orbit_lat"]),
-			Utility::strToDouble(param["orbit_alt"]),
+			param.getDouble("orbit_lon"),
+			param.getDouble("orbit_lat"),
+			param.getDouble("orbit_alt"),
 			parent->getRadius(),
 			parentSideralDay,
 			parent->getSiderealTime(0)
@@ -608,7 +601,7 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 		}
 	}
 
-	if(param["coord_func"] == "ell_orbit"){
+	if(funcname == "ell_orbit"){
 		orbit_bounding_radius = orb->getBoundingRadius();
 	}
 
@@ -616,24 +609,24 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 	// end orbit determination
 	//
 
-	auto bodyColor = std::make_unique<BodyColor>(param["color"], param["label_color"], param["orbit_color"], param["trail_color"]);
+	auto bodyColor = std::make_unique<BodyColor>(param.getStr("color"), param.getStr("label_color"), param.getStr("orbit_color"), param.getStr("trail_color"));
 
-	float solLocalDay= Utility::strToDouble(param["sol_local_day"],1.0);
+	float solLocalDay= param.getDouble("sol_local_day", 1.0);
 
 	// Create the Body and add it to the list
 	BodyTexture bodyTexture {
-		.tex_map = param["tex_map"],
+		.tex_map = param.getStr("tex_map"),
 		.tex_map_alternative = {},
-		.tex_norm = param["tex_normal"],
-		.tex_night = param["tex_night"],
-		.tex_specular = param["tex_specular"],
-		.tex_heightmap = param["tex_heightmap"],
-		.tex_skin =  param["tex_skin"]
+		.tex_norm = param.getStr("tex_normal"),
+		.tex_night = param.getStr("tex_night"),
+		.tex_specular = param.getStr("tex_specular"),
+		.tex_heightmap = param.getStr("tex_heightmap"),
+		.tex_skin =  param.getStr("tex_skin")
 	};
 
 	ObjL *currentOBJ;
 	if (typePlanet != ARTIFICIAL) {
-		const std::string &modelName = param["model_name"];
+		const std::string modelName = param.getStr("model_name");
 		if (modelName.empty()) {
 			currentOBJ = objLMgr->selectDefault();
 		} else {
@@ -646,22 +639,22 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 		case CENTER: {
 			auto p_center = std::make_shared<Center>(parent,
 			                englishName,
-			                Utility::strToBool(param["halo"]),
-			                Utility::strToDouble(param["radius"])/AU,
-			                Utility::strToDouble(param["oblateness"], 0.0),
+			                param.getBool("halo"),
+			                param.getDouble("radius")/AU,
+			                param.getDouble("oblateness", 0.0),
 			                std::move(bodyColor),
 			                solLocalDay,
-			                Utility::strToDouble(param["albedo"]),
+			                param.getDouble("albedo"),
 			                std::move(orb),
 			                close_orbit,
 			                currentOBJ,
 			                orbit_bounding_radius,
 			  				bodyTexture);
 			//update of sun's big_halo texture
-			std::string bighalotexfile = param["tex_big_halo"];
+			std::string bighalotexfile = param.getStr("tex_big_halo");
 			if (!bighalotexfile.empty()) {
-				p_center->setBigHalo(bighalotexfile, param["path"]);
-				p_center->setHaloSize(Utility::strToDouble(param["big_halo_size"], 50.f));
+				p_center->setBigHalo(bighalotexfile, param.getStr("path"));
+				p_center->setHaloSize(param.getDouble("big_halo_size", 50.f));
 			}
 
 			bodyTrace = p_center;
@@ -672,22 +665,22 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 		case SUN : {
 			auto p_sun = std::make_shared<Sun>(parent,
 			                englishName,
-			                Utility::strToBool(param["halo"]),
-			                Utility::strToDouble(param["radius"])/AU,
-			                Utility::strToDouble(param["oblateness"], 0.0),
+			                param.getBool("halo"),
+			                param.getDouble("radius")/AU,
+			                param.getDouble("oblateness", 0.0),
 			                std::move(bodyColor),
 			                solLocalDay,
-			                Utility::strToDouble(param["albedo"]),
+			                param.getDouble("albedo"),
 			                std::move(orb),
 			                close_orbit,
 			                currentOBJ,
 			                orbit_bounding_radius,
 			  				bodyTexture);
 			//update of sun's big_halo texture
-			std::string bighalotexfile = param["tex_big_halo"];
+			std::string bighalotexfile = param.getStr("tex_big_halo");
 			if (!bighalotexfile.empty()) {
-				p_sun->setBigHalo(bighalotexfile, param["path"]);
-				p_sun->setHaloSize(Utility::strToDouble(param["big_halo_size"], 50.f));
+				p_sun->setBigHalo(bighalotexfile, param.getStr("path"));
+				p_sun->setHaloSize(param.getDouble("big_halo_size", 50.f));
 			}
 
 			if (!parent) {
@@ -700,22 +693,22 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 		case STAR :  {
 			auto p_sun = std::make_shared<BodyStar>(parent,
 			                englishName,
-			                Utility::strToBool(param["halo"]),
-			                Utility::strToDouble(param["radius"])/AU,
-			                Utility::strToDouble(param["oblateness"], 0.0),
+			                param.getBool("halo"),
+			                param.getDouble("radius")/AU,
+			                param.getDouble("oblateness", 0.0),
 			                std::move(bodyColor),
 			                solLocalDay,
-			                Utility::strToDouble(param["albedo"]),
+			                param.getDouble("albedo"),
 			                std::move(orb),
 			                close_orbit,
 			                currentOBJ,
 			                orbit_bounding_radius,
 			  				bodyTexture);
 			//update of sun's big_halo texture
-			std::string bighalotexfile = param["tex_big_halo"];
+			std::string bighalotexfile = param.getStr("tex_big_halo");
 			if (!bighalotexfile.empty()) {
-				p_sun->setBigHalo(bighalotexfile, param["path"]);
-				p_sun->setHaloSize(Utility::strToDouble(param["big_halo_size"], 50.f));
+				p_sun->setBigHalo(bighalotexfile, param.getStr("path"));
+				p_sun->setHaloSize(param.getDouble("big_halo_size", 50.f));
 			}
 
 			if (!parent) {
@@ -728,14 +721,14 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 		case ARTIFICIAL:
 			p = std::make_shared<Artificial>(std::move(parent),
 							  englishName,
-							  Utility::strToBool(param["halo"]),
-							  Utility::strToDouble(param["radius"])/AU,
+							  param.getBool("halo"),
+							  param.getDouble("radius")/AU,
 			                  std::move(bodyColor),
 			                  solLocalDay,
-			                  Utility::strToDouble(param["albedo"]),
+			                  param.getDouble("albedo"),
 							  std::move(orb),
 			                  close_orbit,
-			                  param["model_name"],
+			                  param.getStr("model_name"),
 			                  deletable,
 			                  orbit_bounding_radius,
 							  bodyTexture);
@@ -743,12 +736,12 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 		case MOON:
 			p = std::make_shared<Moon>(std::move(parent),
 			                  englishName,
-			                  Utility::strToBool(param["halo"]),
-			                  Utility::strToDouble(param["radius"])/AU,
-			                  Utility::strToDouble(param["oblateness"], 0.0),
+			                  param.getBool("halo"),
+			                  param.getDouble("radius")/AU,
+			                  param.getDouble("oblateness", 0.0),
 			                  std::move(bodyColor),
 			                  solLocalDay,
-			                  Utility::strToDouble(param["albedo"]),
+			                  param.getDouble("albedo"),
 			                  std::move(orb),
 			                  close_orbit,
 			                  currentOBJ,
@@ -761,12 +754,12 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 			std::shared_ptr<BigBody> p_big = std::make_shared<BigBody>(std::move(parent),
 			                    englishName,
 			                    typePlanet,
-			                    Utility::strToBool(param["halo"]),
-			                    Utility::strToDouble(param["radius"])/AU,
-			                    Utility::strToDouble(param["oblateness"], 0.0),
+			                    param.getBool("halo"),
+			                    param.getDouble("radius")/AU,
+			                    param.getDouble("oblateness", 0.0),
 			                    std::move(bodyColor),
 			                    solLocalDay,
-			                    Utility::strToDouble(param["albedo"]),
+			                    param.getDouble("albedo"),
 			                    std::move(orb),
 			                    close_orbit,
 			                    currentOBJ,
@@ -774,10 +767,10 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 								bodyTexture
 								);
 
-			if (Utility::strToBool(param["rings"], 0)) {
-				const double r_min = Utility::strToDouble(param["ring_inner_size"])/AU;
-				const double r_max = Utility::strToDouble(param["ring_outer_size"])/AU;
-				p_big->setRings(std::make_unique<Ring>(r_min,r_max,param["tex_ring"],ringsInit));
+			if (param.getBool("rings", 0)) {
+				const double r_min = param.getDouble("ring_inner_size")/AU;
+				const double r_max = param.getDouble("ring_outer_size")/AU;
+				p_big->setRings(std::make_unique<Ring>(r_min,r_max,param.getStr("tex_ring"),ringsInit));
 			}
 			p = std::move(p_big);
 		}
@@ -788,69 +781,69 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 			p = std::make_shared<SmallBody>(std::move(parent),
 			                        englishName,
 			                        typePlanet,
-			                        Utility::strToBool(param["halo"]),
-			                        Utility::strToDouble(param["radius"])/AU,
-			                        Utility::strToDouble(param["oblateness"], 0.0),
+			                        param.getBool("halo"),
+			                        param.getDouble("radius")/AU,
+			                        param.getDouble("oblateness", 0.0),
 			                        std::move(bodyColor),
 			                        solLocalDay,
-			                        Utility::strToDouble(param["albedo"]),
+			                        param.getDouble("albedo"),
 			                        std::move(orb),
 			                        close_orbit,
 			                        currentOBJ,
 			                        orbit_bounding_radius,
 									bodyTexture);
-			if (!param["apparent_magnitude"].empty() && !param["slope"].empty()) {
+			if (!param.get("apparent_magnitude").empty() && !param.get("slope").empty()) {
 				auto &b = static_cast<SmallBody&>(*p);
-				b.setAbsoluteMagnitudeAndSlope(Utility::strToFloat(param["apparent_magnitude"]), Utility::strToFloat(param["slope"]));
+				b.setAbsoluteMagnitudeAndSlope(param.getFloat("apparent_magnitude"), param.getFloat("slope"));
 				b.bindTail({
-					Utility::strToFloat(param["gaz_tail_trace_jd"], 1),
-					Utility::strToFloat(param["gaz_tail_ejection_force"], 30),
-					Utility::strToFloat(param["gaz_tail_ejection_linearity"], 1),
+					param.getFloat("gaz_tail_trace_jd", 1),
+					param.getFloat("gaz_tail_ejection_force", 30),
+					param.getFloat("gaz_tail_ejection_linearity", 1),
 					Vec3f{
-						Utility::strToFloat(param["gaz_tail_radius_xx_coef"], -1),
-						Utility::strToFloat(param["gaz_tail_radius_x_coef"], 0.5),
-						Utility::strToFloat(param["gaz_tail_radius_base_coef"], 2),
+						param.getFloat("gaz_tail_radius_xx_coef", -1),
+						param.getFloat("gaz_tail_radius_x_coef", 0.5),
+						param.getFloat("gaz_tail_radius_base_coef", 2),
 					},
 					Vec3f{
-						Utility::strToFloat(param["gaz_tail_color_red"], 0.3),
-						Utility::strToFloat(param["gaz_tail_color_green"], 0.3),
-						Utility::strToFloat(param["gaz_tail_color_blue"], 0.7),
+						param.getFloat("gaz_tail_color_red", 0.3),
+						param.getFloat("gaz_tail_color_green", 0.3),
+						param.getFloat("gaz_tail_color_blue", 0.7),
 					}
 				});
 				b.bindTail({
-					Utility::strToFloat(param["dust_tail_trace_jd"], 30),
-					Utility::strToFloat(param["dust_tail_ejection_force"], 0.5),
-					Utility::strToFloat(param["dust_tail_ejection_linearity"], 1),
+					param.getFloat("dust_tail_trace_jd", 30),
+					param.getFloat("dust_tail_ejection_force", 0.5),
+					param.getFloat("dust_tail_ejection_linearity", 1),
 					Vec3f{
-						Utility::strToFloat(param["dust_tail_radius_xx_coef"], -2),
-						Utility::strToFloat(param["dust_tail_radius_x_coef"], 1),
-						Utility::strToFloat(param["dust_tail_radius_base_coef"], 2),
+						param.getFloat("dust_tail_radius_xx_coef", -2),
+						param.getFloat("dust_tail_radius_x_coef", 1),
+						param.getFloat("dust_tail_radius_base_coef", 2),
 					},
 					Vec3f{
-						Utility::strToFloat(param["dust_tail_color_red"], 0.5),
-						Utility::strToFloat(param["dust_tail_color_green"], 0.5),
-						Utility::strToFloat(param["dust_tail_color_blue"], 0.5),
+						param.getFloat("dust_tail_color_red", 0.5),
+						param.getFloat("dust_tail_color_green", 0.5),
+						param.getFloat("dust_tail_color_blue", 0.5),
 					}
 				});
-				if (!param["extra_tail_trace_jd"].empty()) {
+				if (!param.get("extra_tail_trace_jd").empty()) {
 					b.bindTail({
-						Utility::strToFloat(param["extra_tail_trace_jd"], 30),
-						Utility::strToFloat(param["extra_tail_ejection_force"], 0.5),
-						Utility::strToFloat(param["extra_tail_ejection_linearity"], 1),
+						param.getFloat("extra_tail_trace_jd", 30),
+						param.getFloat("extra_tail_ejection_force", 0.5),
+						param.getFloat("extra_tail_ejection_linearity", 1),
 						Vec3f{
-							Utility::strToFloat(param["extra_tail_radius_xx_coef"], -2),
-							Utility::strToFloat(param["extra_tail_radius_x_coef"], 1),
-							Utility::strToFloat(param["extra_tail_radius_base_coef"], 2),
+							param.getFloat("extra_tail_radius_xx_coef", -2),
+							param.getFloat("extra_tail_radius_x_coef", 1),
+							param.getFloat("extra_tail_radius_base_coef", 2),
 						},
 						Vec3f{
-							Utility::strToFloat(param["extra_tail_color_red"], 0.5),
-							Utility::strToFloat(param["extra_tail_color_green"], 0.5),
-							Utility::strToFloat(param["extra_tail_color_blue"], 0.5),
+							param.getFloat("extra_tail_color_red", 0.5),
+							param.getFloat("extra_tail_color_green", 0.5),
+							param.getFloat("extra_tail_color_blue", 0.5),
 						}
 					});
 				}
-				if (!param["halo_alpha_override"].empty() && !param["halo_scale_override"].empty()) {
-					b.overrideHalo(Utility::strToFloat(param["halo_alpha_override"]), Utility::strToFloat(param["halo_scale_override"]));
+				if (!param.get("halo_alpha_override").empty() && !param.get("halo_scale_override").empty()) {
+					b.overrideHalo(param.getFloat("halo_alpha_override"), param.getFloat("halo_scale_override"));
 				}
 			}
 			break;
@@ -862,37 +855,37 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 		return;
 	}
 
-	if (!param["has_atmosphere"].empty() || !param["atmosphere_lim_landscape"].empty()) {
+	if (!param.get("has_atmosphere").empty() || !param.get("atmosphere_lim_landscape").empty()) {
 		AtmosphereParams* tmp = nullptr;
 		tmp = new(AtmosphereParams);
-		tmp->hasAtmosphere = Utility::strToBool(param["has_atmosphere"], false);
-		tmp->modelAtmosphere = setAtmosphere(param["atmosphere_model"]);
-		tmp->tableAtmosphere = param["atmosphere_ext_model"];
-		tmp->atmosphereRadiusFactor = param["atmosphere_radius_factor"].empty() ? 1.05 : Utility::strToDouble(param["atmosphere_radius_factor"]);
-		tmp->limInf = Utility::strToFloat(param["atmosphere_lim_inf"], 40000.f);
-		tmp->limSup = Utility::strToFloat(param["atmosphere_lim_sup"], 80000.f);
-		tmp->limLandscape = Utility::strToFloat(param["atmosphere_lim_landscape"], 10000.f);
+		tmp->hasAtmosphere = param.getBool("has_atmosphere", false);
+		tmp->modelAtmosphere = setAtmosphere(param.getStr("atmosphere_model"));
+		tmp->tableAtmosphere = param.getStr("atmosphere_ext_model");
+		tmp->atmosphereRadiusFactor = param.get("atmosphere_radius_factor").empty() ? 1.05 : param.getDouble("atmosphere_radius_factor");
+		tmp->limInf = param.getFloat("atmosphere_lim_inf", 40000.f);
+		tmp->limSup = param.getFloat("atmosphere_lim_sup", 80000.f);
+		tmp->limLandscape = param.getFloat("atmosphere_lim_landscape", 10000.f);
 		tmp->atmColor.set(
-			Utility::strToFloat(param["atmosphere_ambient_r"]),
-			Utility::strToFloat(param["atmosphere_ambient_g"]),
-			Utility::strToFloat(param["atmosphere_ambient_b"])
+			param.getFloat("atmosphere_ambient_r"),
+			param.getFloat("atmosphere_ambient_g"),
+			param.getFloat("atmosphere_ambient_b")
 		);
-		tmp->sunDeviation = sin(Utility::strToFloat(param["atmosphere_sun_deviation"])*M_PI/180);
-		tmp->atmDeviation = sin(Utility::strToFloat(param["atmosphere_ambient_deviation"])*M_PI/180);
+		tmp->sunDeviation = sin(param.getFloat("atmosphere_sun_deviation")*M_PI/180);
+		tmp->atmDeviation = sin(param.getFloat("atmosphere_ambient_deviation")*M_PI/180);
 		p->setAtmosphereParams(tmp);
 	}
 
 
 	// Use J2000 N pole data if available
-	double rot_obliquity = Utility::strToDouble(param["rot_obliquity"],0.)*M_PI/180.;
-	double rot_asc_node  = Utility::strToDouble(param["rot_equator_ascending_node"],0.)*M_PI/180.;
+	double rot_obliquity = param.getDouble("rot_obliquity", 0.)*M_PI/180.;
+	double rot_asc_node  = param.getDouble("rot_equator_ascending_node", 0.)*M_PI/180.;
 
 	// In J2000 coordinates
-	double J2000_npole_ra = Utility::strToDouble(param["rot_pole_ra"],0.)*M_PI/180.;
-	double J2000_npole_de = Utility::strToDouble(param["rot_pole_de"],0.)*M_PI/180.;
+	double J2000_npole_ra = param.getDouble("rot_pole_ra", 0.)*M_PI/180.;
+	double J2000_npole_de = param.getDouble("rot_pole_de", 0.)*M_PI/180.;
 
 	// NB: north pole needs to be defined by right hand rotation rule
-	if (param["rot_pole_ra"] != "" || param["rot_pole_de"] != "") {
+	if (!param.get("rot_pole_ra").empty() || !param.get("rot_pole_de").empty()) {
 		// cout << "Using north pole data for " << englishName << endl;
 		Vec3d J2000_npole;
 		Utility::spheToRect(J2000_npole_ra,J2000_npole_de,J2000_npole);
@@ -911,24 +904,24 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 	if (bound_to_surface) {
 		p->set_rotation_elements(
 			parentSideralDay,
-			Utility::strToDouble(param["rot_rotation_offset"],0.) + parentOffset,
+			param.getDouble("rot_rotation_offset", 0.) + parentOffset,
 			J2000,
-			M_PI_2 - Utility::strToDouble(param["orbit_lat"]) * (M_PI / 180.), // X rotation in radian
-			Utility::strToDouble(param["orbit_lon"]) * (M_PI / 180.), // Z rotation in radian
+			M_PI_2 - param.getDouble("orbit_lat") * (M_PI / 180.), // X rotation in radian
+			param.getDouble("orbit_lon") * (M_PI / 180.), // Z rotation in radian
 			parentSideralDay,
-			Utility::strToDouble(param["orbit_visualization_period"],0.),
-			Utility::strToDouble(param["axial_tilt"], 0.)
+			param.getDouble("orbit_visualization_period", 0.),
+			param.getDouble("axial_tilt", 0.)
 		);
 	} else {
 		p->set_rotation_elements(
-			Utility::strToDouble(param["rot_periode"], Utility::strToDouble(param["orbit_period"], 24.))/24.,
-			Utility::strToDouble(param["rot_rotation_offset"],0.),
-			Utility::strToDouble(param["rot_epoch"], J2000),
+			param.getDouble("rot_periode", param.getDouble("orbit_period", 24.))/24.,
+			param.getDouble("rot_rotation_offset", 0.),
+			param.getDouble("rot_epoch", J2000),
 			rot_obliquity,
 			rot_asc_node,
-			Utility::strToDouble(param["rot_precession_rate"],0.)*M_PI/(180*36525),
-			Utility::strToDouble(param["orbit_visualization_period"],0.),
-			Utility::strToDouble(param["axial_tilt"], 0.)
+			param.getDouble("rot_precession_rate", 0.)*M_PI/(180*36525),
+			param.getDouble("orbit_visualization_period", 0.),
+			param.getDouble("axial_tilt", 0.)
 		);
 	}
 
@@ -944,7 +937,7 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 	anchorManager->addAnchor(englishName, p);
 	p->updateBoundingRadii();
 
-	bool isHidden = Utility::strToBool(param["hidden"], 0);
+	bool isHidden = param.getBool("hidden", 0);
 	if (!isHidden)
 		showBody(p.get());
 
@@ -953,6 +946,29 @@ void ProtoSystem::addBody(stringHash_t param, bool deletable)
 		.isDeleteable = deletable,
 		.initialHidden = isHidden,
 	}));
+	bodyLevelsChanged = true;
+}
+
+const std::vector<ProtoSystem::BodyLevel> &ProtoSystem::getBodyLevels()
+{
+	if (!bodyLevelsChanged)
+		return bodyLevels;
+
+	bodyLevels.clear();
+	for (auto &v : systemBodies) {
+		Body *body = v.second.body.get();
+		size_t depth = 0;
+		for (Body *p = body->getParent(); p; p = p->getParent())
+			++depth;
+		if (bodyLevels.size() <= depth)
+			bodyLevels.resize(depth + 1);
+		if (body->getOrbit()->isReentrant())
+			bodyLevels[depth].parallel.push_back(body);
+		else
+			bodyLevels[depth].serial.push_back(body);
+	}
+	bodyLevelsChanged = false;
+	return bodyLevels;
 }
 
 void ProtoSystem::initialSolarSystemBodies()
@@ -1006,6 +1022,15 @@ void ProtoSystem::computeDraw(const Projector *prj, const Navigator *nav)
 	if (sortedRenderedBodies.size() < 2)
 		return; // Nothing to sort
 
+	if (fullSortNeeded) {
+		// many bodies were added in no order, the bubble sort would be quadratic
+		std::stable_sort(sortedRenderedBodies.begin(), sortedRenderedBodies.end(), [](Body *a, Body *b) {
+			return a->getDistance() > b->getDistance();
+		});
+		fullSortNeeded = false;
+		return;
+	}
+
 	// Use dual bubble sort algorithm - average complexity of O(N) as bodies stay mostly sorted between frames
 	// This come with a higher complexity at the frame newly showing multiple bodies (due to addBody or setPlanetHidden)
 	Body ** const begin = sortedRenderedBodies.data() - 1;
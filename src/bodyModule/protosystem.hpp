@@ -31,6 +31,7 @@
 #include "tools/ScModule.hpp"
 #include "bodyModule/body.hpp"
 #include <set>
+#include <string_view>
 
 class OrbitCreator;
 class SSystemIterator;
@@ -42,6 +43,7 @@ class Observer;
 class TimeMgr;
 class Body;
 class Translator;
+class BodyDescriptor;
 
 class ProtoSystem: public NoCopy, public ModuleFont {
     friend class SSystemIterator;
@@ -58,7 +60,7 @@ public:
 
 	void update(int delta_time, const Navigator* nav, const TimeMgr* timeMgr);
 
-	//! Load the bodies data from a file
+	//! Load the bodies data from a file, the bodies are added in one batch
 	void load(const std::string& planetfile);
 
 	//! Load the bodies data from an object
@@ -74,11 +76,8 @@ public:
 
 	//! Return the matching planet pointer if exists or nullptr
 	inline std::shared_ptr<Body> searchByEnglishName(const std::string &planetEnglishName) const {
-        try {
-            return systemBodies.at(planetEnglishName).body;
-        } catch (...) {
-            return nullptr;
-        }
+        auto it = systemBodies.find(planetEnglishName);
+        return (it == systemBodies.end()) ? nullptr : it->second.body;
     }
 
 	//removes a body and its satellites
@@ -192,6 +191,14 @@ public:
     inline Body *getCenterOfInterest() const {
         return mainBody;
     }
+
+    struct BodyLevel {
+        std::vector<Body *> serial; // bodies whose orbit isn't reentrant
+        std::vector<Body *> parallel;
+    };
+
+    //! Bodies grouped by depth in the hierarchy, the parents of a level are in the previous levels
+    const std::vector<BodyLevel> &getBodyLevels();
 protected:
     inline void hideBody(Body *body) {
         if (renderedBodies.erase(body))
@@ -217,16 +224,21 @@ protected:
 	bool flagHideSatellites = false;
 
 	// load one object from a hash
-	virtual void addBody(stringHash_t param, bool deletable);
+	void addBody(stringHash_t param, bool deletable);
+	// load one object from its descriptor
+	virtual void addBody(const BodyDescriptor &param, bool deletable);
     void showBodyRecursive(Body *body);
     void hideBodyRecursive(Body *body);
 
 	// determine the planet type: Sun, planet, moon, dwarf, asteroid ...
-	BODY_TYPE setPlanetType (const std::string &str);
+	BODY_TYPE setPlanetType (std::string_view str);
 
 	std::map<std::string, BodyContainer> systemBodies; //Map containing the bodies and related information. the key is their english name
 	std::set<Body *> renderedBodies; //Contains bodies that are not hidden
     std::vector<Body *> sortedRenderedBodies;
+    std::vector<BodyLevel> bodyLevels; // built from systemBodies by getBodyLevels
+    bool bodyLevelsChanged = true;
+    bool fullSortNeeded = false; // set by load, sortedRenderedBodies is sorted from scratch
 };
 
 #endif
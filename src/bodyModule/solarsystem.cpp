@@ -35,6 +35,7 @@
 #include "navModule/navigator.hpp"
 #include "coreModule/projector.hpp"
 #include "tools/utility.hpp"
+#include "bodyModule/body_descriptor.hpp"
 #include <fstream>
 #include "tools/log.hpp"
 //#include "tools/fmath.hpp"
@@ -79,12 +80,12 @@ void SolarSystem::registerFont(s_font* _font)
 
 // Init and load one solar system object
 // This is a the private method
-void SolarSystem::addBody(stringHash_t param, bool deletable)
+void SolarSystem::addBody(const BodyDescriptor &param, bool deletable)
 {
-	const std::string englishName = param["name"];
-	BODY_TYPE typePlanet = setPlanetType(param["type"]);
+	const std::string englishName(param.name);
+	BODY_TYPE typePlanet = setPlanetType(param.type);
 
-	ProtoSystem::addBody(std::move(param), deletable);
+	ProtoSystem::addBody(param, deletable);
 
 	if (typePlanet == SUN && englishName == "Sun") {
 		sun = std::dynamic_pointer_cast<Sun>(systemBodies["Sun"].body);
@@ -150,7 +150,7 @@ private:
 
 
 	// load one object from a hash
-	virtual void addBody(stringHash_t param, bool deletable) override;
+	virtual void addBody(const BodyDescriptor &param, bool deletable) override;
 
 
 	std::shared_ptr<Sun> sun=nullptr; //return the Sun
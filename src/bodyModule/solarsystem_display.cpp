@@ -34,6 +34,7 @@
 #include "tools/draw_helper.hpp"
 #include "EntityCore/Core/FrameMgr.hpp"
 #include "EntityCore/Resource/Pipeline.hpp"
+#include "tools/ThreadPool.hpp"
 
 SolarSystemDisplay *SolarSystemDisplay::instance = nullptr;
 
@@ -44,6 +45,11 @@ SolarSystemDisplay::SolarSystemDisplay(ProtoSystem * _ssystem)
     ssystem = _ssystem;
 }
 
+SolarSystemDisplay::~SolarSystemDisplay()
+{
+    instance = nullptr;
+}
+
 void SolarSystemDisplay::computePreDraw(const Projector * prj, const Navigator * nav)
 {
 	if (!getFlagShow())
@@ -338,21 +344,70 @@ void SolarSystemDisplay::draw(Projector * prj, const Navigator * nav, const Obse
 	prj->setClippingPlanes(backup.znear, backup.zfar);  // Restore old clipping planes
 }
 
+void SolarSystemDisplay::setEphemerisPixelAngle(double angle)
+{
+	if (angle <= 0 && ephemerisPixelAngle > 0) {
+		for (auto &v : *ssystem)
+			v.second.body->setEphemerisTolerance(0);
+	}
+	ephemerisPixelAngle = angle;
+}
+
+// Light travel time between the body and home_pos, in days
+static inline double lightTravelTime(const Body *body, const Vec3d &home_pos)
+{
+	return (body->get_heliocentric_ecliptic_pos()-home_pos).length()
+	       * (149597870000.0 / (299792458.0 * 86400));
+}
+
+// Call f on every body, the bodies are split between the threads when there are enough of them
+template<class F>
+void SolarSystemDisplay::forEachBody(const std::vector<Body *> &bodies, F &&f)
+{
+	if (bodies.size() <= BODY_PARALLEL_GRAIN) {
+		for (Body *body : bodies)
+			f(body);
+		return;
+	}
+	ThreadPool::shared().parallelFor(0, bodies.size(), BODY_PARALLEL_GRAIN, [&bodies, &f](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i)
+			f(bodies[i]);
+	});
+}
+
 // Compute the position for every elements of the solar system.
-// The order is not important since the position is computed relatively to the mother body
+// The position is computed relatively to the mother body, the levels are only needed by the
+// light travel time which reads the heliocentric position of the parents.
+// The bodies whose orbit use planetsephems are computed by the calling thread only.
 void SolarSystemDisplay::computePositions(double date,const Observer *obs)
 {
-	if (flag_light_travel_time) {
+	const auto &levels = ssystem->getBodyLevels();
+
+	if (ephemerisPixelAngle > 0) {
+		// an error of a quarter of pixel isn't visible, the distances come from the previous positions
 		const Vec3d home_pos(obs->getHeliocentricPosition(date));
 		for (auto &v : *ssystem) {
-			const double light_speed_correction =
-			    (v.second.body->get_heliocentric_ecliptic_pos()-home_pos).length()
-			    * (149597870000.0 / (299792458.0 * 86400));
-			v.second.body->compute_position(date-light_speed_correction);
+			const double distance = (v.second.body->get_heliocentric_ecliptic_pos()-home_pos).length();
+			v.second.body->setEphemerisTolerance(distance * ephemerisPixelAngle * 0.25);
+		}
+	}
+
+	if (flag_light_travel_time) {
+		const Vec3d home_pos(obs->getHeliocentricPosition(date));
+		for (auto &level : levels) {
+			for (Body *body : level.serial)
+				body->compute_position(date-lightTravelTime(body, home_pos));
+			forEachBody(level.parallel, [date, &home_pos](Body *body) {
+				body->compute_position(date-lightTravelTime(body, home_pos));
+			});
 		}
 	} else {
-		for (auto &v : *ssystem) {
-			v.second.body->compute_position(date);
+		for (auto &level : levels) {
+			for (Body *body : level.serial)
+				body->compute_position(date);
+			forEachBody(level.parallel, [date](Body *body) {
+				body->compute_position(date);
+			});
 		}
 	}
 
@@ -361,20 +416,27 @@ void SolarSystemDisplay::computePositions(double date,const Observer *obs)
 
 
 // Compute the transformation matrix for every elements of the solar system.
-// The elements have to be ordered hierarchically, eg. it's important to compute earth before moon.
+// The positions are all computed, so the matrices don't depend on each other.
 void SolarSystemDisplay::computeTransMatrices(double date,const Observer * obs)
 {
+	const auto &levels = ssystem->getBodyLevels();
+
 	if (flag_light_travel_time) {
 		const Vec3d home_pos(obs->getHeliocentricPosition(date));
-		for (auto &v : *ssystem) {
-			const double light_speed_correction =
-			    (v.second.body->get_heliocentric_ecliptic_pos()-home_pos).length()
-			    * (149597870000.0 / (299792458.0 * 86400));
-			v.second.body->compute_trans_matrix(date-light_speed_correction);
+		for (auto &level : levels) {
+			for (Body *body : level.serial)
+				body->compute_trans_matrix(date-lightTravelTime(body, home_pos));
+			forEachBody(level.parallel, [date, &home_pos](Body *body) {
+				body->compute_trans_matrix(date-lightTravelTime(body, home_pos));
+			});
 		}
 	} else {
-		for (auto &v : *ssystem) {
-			v.second.body->compute_trans_matrix(date);
+		for (auto &level : levels) {
+			for (Body *body : level.serial)
+				body->compute_trans_matrix(date);
+			forEachBody(level.parallel, [date](Body *body) {
+				body->compute_trans_matrix(date);
+			});
 		}
 	}
 }
@@ -26,6 +26,10 @@
 #define _SOLARSYSTEM_DISPLAY_
 
 #include <vector>
+#include <memory>
+
+// number of bodies of a level computed by one task
+#define BODY_PARALLEL_GRAIN 64
 
 class ProtoSystem;
 class Projector;
@@ -51,9 +55,7 @@ class Body;
 class SolarSystemDisplay {
 public:
     SolarSystemDisplay(ProtoSystem * _ssystem);
-    ~SolarSystemDisplay() {
-        instance = nullptr;
-    }
+    ~SolarSystemDisplay();
 
     void changeSystem(ProtoSystem * _ssystem) {
 		ssystem = _ssystem;
@@ -87,6 +89,10 @@ public:
 		flag_light_travel_time = b;
 	}
 
+	//! Set the angle of a pixel in radian, the ephemeris are truncated to the precision
+	//! visible with this angle. 0 computes the full ephemeris
+	void setEphemerisPixelAngle(double angle);
+
 	//! Compute the position for every elements of the solar system.
 	//! home_planet is needed for light travel time computation
 	void computePositions(double date,const Observer *obs);
@@ -99,11 +105,15 @@ public:
 
     static SolarSystemDisplay *instance;
 private:
+    template<class F>
+    void forEachBody(const std::vector<Body *> &bodies, F &&f);
+
     ProtoSystem * ssystem;
     Body *mainBody = nullptr;
 
 	bool flagShow= true;
 	bool flag_light_travel_time = false;
+	double ephemerisPixelAngle = 0.0;
 
     struct depthBucket {
 		double znear;
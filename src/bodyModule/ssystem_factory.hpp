@@ -111,6 +111,10 @@ public:
         return ssystemDisplay->getFlagLightTravelTime();
     }
 
+    void setEphemerisPixelAngle(double angle) {
+        ssystemDisplay->setEphemerisPixelAngle(angle);
+    }
+
     void startTrails(bool b) {
         currentSystem->startTrails(b);
     }
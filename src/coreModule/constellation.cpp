@@ -103,7 +103,11 @@ void Constellation::drawLines(const Projector* prj, std::vector<float> &vLinesPo
 {
 	if (!line_fader.getInterstate()) return;
 
-	Vec3d gettemp1,gettemp2,startemp1,startemp2;
+	// the first star then the points of the orthodromy, projected in one call
+	const int npoints=10;
+	Vec3d points[npoints+2];
+	Vec3d win[npoints+2];
+	uint8_t visible[npoints+2];
 	double ra1,de1,ra2,de2,rat,det;
 
 	for (unsigned int i=0; i<nb_segments; ++i) {
@@ -113,8 +117,7 @@ void Constellation::drawLines(const Projector* prj, std::vector<float> &vLinesPo
 		if ((abs(ra2-ra1)>0.000001) && (abs(de2-de1)>0.000001)) {
 		  if ((ra2-ra1)>M_PI) ra1+=2*M_PI;
 		  if ((ra1-ra2)>M_PI) ra2+=2*M_PI;
-		  Utility::spheToRect(ra1,de1, gettemp1);
-		  int npoints=10;
+		  Utility::spheToRect(ra1,de1, points[0]);
 		  float delta=(ra1-ra2)/(npoints);
 		  for(int i=0; i<=npoints ; i++) {
 			rat=ra1-delta*i;
@@ -122,24 +125,26 @@ void Constellation::drawLines(const Projector* prj, std::vector<float> &vLinesPo
 				det=atan(((tan(de2)*sin(rat-ra1))/sin(ra2-ra1))+(tan(de1)*sin(ra2-rat))/sin(ra2-ra1));
 			else
 				det=M_PI/2.;
-			Utility::spheToRect(rat,det, gettemp2);
-			if (prj->projectJ2000LineCheck( gettemp1,startemp1, gettemp2,startemp2)) {
+			Utility::spheToRect(rat,det, points[i+1]);
+		  }
+		  prj->projectBatch(PF_J2000, points, win, visible, npoints+2);
+		  for(int i=0; i<=npoints ; i++) {
+			// same test as projectJ2000LineCheck
+			if (visible[i] && visible[i+1] && (prj->checkInViewport(win[i]) || prj->checkInViewport(win[i+1]))) {
 
-				vLinesPos.push_back(startemp1[0]);
-				vLinesPos.push_back(startemp1[1]);
+				vLinesPos.push_back(win[i][0]);
+				vLinesPos.push_back(win[i][1]);
 				vLinesColor.push_back(lineColor[0]);
 				vLinesColor.push_back(lineColor[1]);
 				vLinesColor.push_back(lineColor[2]);
 				vLinesColor.push_back(line_fader.getInterstate());
-				vLinesPos.push_back(startemp2[0]);
-				vLinesPos.push_back(startemp2[1]);
+				vLinesPos.push_back(win[i+1][0]);
+				vLinesPos.push_back(win[i+1][1]);
 				vLinesColor.push_back(lineColor[0]);
 				vLinesColor.push_back(lineColor[1]);
 				vLinesColor.push_back(lineColor[2]);
 				vLinesColor.push_back(line_fader.getInterstate());
 			}
-			gettemp1=gettemp2;
-			startemp1=startemp2;
 		  }
 	    }
 	}
@@ -296,7 +301,6 @@ void Constellation::drawBoundary(const Projector* prj, std::vector<float> &vBoun
 	if (!boundary_fader.getInterstate()) return;
 
 	unsigned int i, j, size;
-	Vec3d pt1, pt2;
 	std::vector<Vec3f> *points;
 
 	if (singleSelected) size = isolatedBoundarySegments.size();
@@ -306,8 +310,14 @@ void Constellation::drawBoundary(const Projector* prj, std::vector<float> &vBoun
 		if (singleSelected) points = isolatedBoundarySegments[i];
 		else points = sharedBoundarySegments[i];
 
+		boundaryWin.resize(points->size());
+		boundaryVisible.resize(points->size());
+		prj->projectBatch(PF_J2000, points->data(), boundaryWin.data(), boundaryVisible.data(), points->size());
 		for (j=0; j<points->size()-1; j += 2) {
-			if (prj->projectJ2000LineCheck(points->at(j),pt1,points->at(j+1),pt2)) {
+			// same test as projectJ2000LineCheck
+			if (boundaryVisible[j] && boundaryVisible[j+1] && (prj->checkInViewport(boundaryWin[j]) || prj->checkInViewport(boundaryWin[j+1]))) {
+				const Vec3d &pt1 = boundaryWin[j];
+				const Vec3d &pt2 = boundaryWin[j+1];
 
 				vBoundariesPos.push_back(pt1[0]);
 				vBoundariesPos.push_back(pt1[1]);
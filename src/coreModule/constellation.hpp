@@ -211,6 +211,8 @@ private:
 
 	std::vector<std::vector<Vec3f> *> isolatedBoundarySegments;
 	std::vector<std::vector<Vec3f> *> sharedBoundarySegments;
+	std::vector<Vec3d> boundaryWin; //!< boundary points projected by drawBoundary
+	std::vector<uint8_t> boundaryVisible;
 
 	Vec3f lineColor;
 	Vec3f labelColor;
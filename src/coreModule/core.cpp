@@ -51,6 +51,7 @@
 #include "coreModule/starLines.hpp"
 #include "bodyModule/ssystem_factory.hpp"
 #include "bodyModule/body_trace.hpp"
+#include "bodyModule/ephemeris_cache.hpp"
 #include "eventModule/CoreEvent.hpp"
 #include "eventModule/event_recorder.hpp"
 #include "coreModule/meteor_mgr.hpp"
@@ -71,6 +72,8 @@
 #include "EntityCore/EntityCore.hpp"
 #include "coreModule/tully.hpp"
 #include "coreModule/volumObj3D.hpp"
+#include "tools/startup_graph.hpp"
+#include "tools/ThreadPool.hpp"
 
 Core::Core(int width, int height, std::shared_ptr<Media> _media, std::shared_ptr<FontFactory> _fontFactory, const mBoost::callback<void, std::string>& recordCallback, std::shared_ptr<Observer> _observatory) :
 	skyTranslator(AppSettings::Instance()->getLanguageDir(), ""),
@@ -217,6 +220,7 @@ Core::~Core()
 	// s_font::deleteShader();
 	//delete ssystem;
 	delete ssystemFactory;
+	EphemerisCache::close();
 	//delete skyloc;
 	//skyloc = nullptr;
 	Object::deleteTextures(); // Unload the pointer textures
@@ -271,44 +275,72 @@ void Core::init(const InitParser& conf)
 
 	// Start splash with no fonts due to font collection delays
 	if (firstTime) {
+		// the loadings which don't use the vulkan context run on workers meanwhile the others
+		StartupGraph startup;
 		// Init the solar system first
-		ssystemFactory->iniColor( conf.getStr(SCS_COLOR, SCK_PLANET_HALO_COLOR),
-							conf.getStr(SCS_COLOR, SCK_PLANET_NAMES_COLOR),
-							conf.getStr(SCS_COLOR, SCK_PLANET_ORBITS_COLOR),
-							conf.getStr(SCS_COLOR, SCK_OBJECT_TRAILS_COLOR));
-
-		ssystemFactory->iniTess( conf.getInt(SCS_RENDERING, SCK_MIN_TES_LEVEL),
-							conf.getInt(SCS_RENDERING, SCK_MAX_TES_LEVEL),
-							conf.getInt(SCS_RENDERING, SCK_PLANET_ALTIMETRY_LEVEL),
-							conf.getInt(SCS_RENDERING, SCK_MOON_ALTIMETRY_LEVEL),
-							conf.getInt(SCS_RENDERING, SCK_EARTH_ALTIMETRY_LEVEL));
-
-		ssystemFactory->modelRingInit(conf.getInt(SCS_RENDERING, SCK_RINGS_LOW),
-		                         conf.getInt(SCS_RENDERING, SCK_RINGS_MEDIUM),
-		                         conf.getInt(SCS_RENDERING, SCK_RINGS_HIGH));
-
-		ssystemFactory->iniTextures();
-
-		ssystemFactory->load(AppSettings::Instance()->getUserDir() + "ssystem.ini");
-
-		ssystemFactory->anchorManagerInit(conf);
-		//TODO Oli: remember to use file selection class.
-		ssystemFactory->loadGalacticSystem(AppSettings::Instance()->getUserDir(), "galactic.ini");
+		startup.add("ssystem setup", {}, [&]() {
+			ssystemFactory->iniColor( conf.getStr(SCS_COLOR, SCK_PLANET_HALO_COLOR),
+								conf.getStr(SCS_COLOR, SCK_PLANET_NAMES_COLOR),
+								conf.getStr(SCS_COLOR, SCK_PLANET_ORBITS_COLOR),
+								conf.getStr(SCS_COLOR, SCK_OBJECT_TRAILS_COLOR));
+
+			ssystemFactory->iniTess( conf.getInt(SCS_RENDERING, SCK_MIN_TES_LEVEL),
+								conf.getInt(SCS_RENDERING, SCK_MAX_TES_LEVEL),
+								conf.getInt(SCS_RENDERING, SCK_PLANET_ALTIMETRY_LEVEL),
+								conf.getInt(SCS_RENDERING, SCK_MOON_ALTIMETRY_LEVEL),
+								conf.getInt(SCS_RENDERING, SCK_EARTH_ALTIMETRY_LEVEL));
+
+			ssystemFactory->modelRingInit(conf.getInt(SCS_RENDERING, SCK_RINGS_LOW),
+			                         conf.getInt(SCS_RENDERING, SCK_RINGS_MEDIUM),
+			                         conf.getInt(SCS_RENDERING, SCK_RINGS_HIGH));
+
+			ssystemFactory->iniTextures();
+		}, STARTUP_MAIN_THREAD);
+		startup.add("ephemeris cache", {}, [&]() {
+			if (conf.getBoolean(SCS_ASTRO, SCK_FLAG_EPHEMERIS_CACHE))
+				EphemerisCache::open(AppSettings::Instance()->getUserDir() + "ephemeris.cache");
+		});
+		startup.add("solar system", {"ssystem setup", "ephemeris cache"}, [&]() {
+			ssystemFactory->load(AppSettings::Instance()->getUserDir() + "ssystem.ini");
+		}, STARTUP_MAIN_THREAD);
+		startup.add("anchors", {"solar system"}, [&]() {
+			ssystemFactory->anchorManagerInit(conf);
+		}, STARTUP_MAIN_THREAD);
+		startup.add("galactic system", {"anchors"}, [&]() {
+			//TODO Oli: remember to use file selection class.
+			ssystemFactory->loadGalacticSystem(AppSettings::Instance()->getUserDir(), "galactic.ini");
+		}, STARTUP_MAIN_THREAD);
 		// Init stars
-		hip_stars->iniColorTable();
-		hip_stars->readColorTable();
-		hip_stars->init(conf);
-
+		startup.add("hip stars", {}, [&]() {
+			hip_stars->iniColorTable();
+			hip_stars->readColorTable();
+			hip_stars->loadCatalogs(conf);
+		});
+		startup.add("hip stars texture", {"hip stars"}, [&]() {
+			hip_stars->loadTexture();
+		}, STARTUP_MAIN_THREAD);
 		// Init nebulas
-		nebulas->loadDeepskyObject(AppSettings::Instance()->getUserDir() + "deepsky_objects.fab");
-
-		Landscape::createSC_context();
-		landscape->setSlices(conf.getInt(SCS_RENDERING, SCK_LANDSCAPE_SLICES));
-		landscape->setStacks(conf.getInt(SCS_RENDERING, SCK_LANDSCAPE_STACKS));
-		setLandscape(initialvalue.initial_landscapeName);
-
-		starNav->loadData(AppSettings::Instance()->getUserDir() + "hip2007.txt", false);
-		starLines->loadCat(AppSettings::Instance()->getUserDir() + "asterism.txt", false);
+		startup.add("nebulas", {}, [&]() {
+			nebulas->loadDeepskyObject(AppSettings::Instance()->getUserDir() + "deepsky_objects.fab");
+		}, STARTUP_MAIN_THREAD);
+		// the landscape is checked against the home body of the observatory
+		startup.add("landscape", {"anchors"}, [&]() {
+			Landscape::createSC_context();
+			landscape->setSlices(conf.getInt(SCS_RENDERING, SCK_LANDSCAPE_SLICES));
+			landscape->setStacks(conf.getInt(SCS_RENDERING, SCK_LANDSCAPE_STACKS));
+			setLandscape(initialvalue.initial_landscapeName);
+		}, STARTUP_MAIN_THREAD);
+		// both are compiled in the cache directory at the first start
+		startup.add("star navigator", {}, [&]() {
+			starNav->prepareCachedData(AppSettings::Instance()->getUserDir() + "hip2007.txt");
+		});
+		startup.add("star navigator buffers", {"star navigator"}, [&]() {
+			starNav->build();
+		}, STARTUP_MAIN_THREAD);
+		startup.add("star lines", {}, [&]() {
+			starLines->loadCachedCat(AppSettings::Instance()->getUserDir() + "asterism.txt");
+		});
+		startup.run(ThreadPool::shared());
 	}
 
 	// Astro section
@@ -317,6 +349,7 @@ void Core::init(const InitParser& conf)
 	hip_stars->setScale(conf.getDouble (SCS_STARS, SCK_STAR_SCALE));
 	hip_stars->setFlagTwinkle(conf.getBoolean(SCS_STARS, SCK_FLAG_STAR_TWINKLE));
 	hip_stars->setTwinkleAmount(conf.getDouble (SCS_STARS, SCK_STAR_TWINKLE_AMOUNT));
+	hip_stars->setFlagParallelDraw(conf.getBoolean(SCS_STARS, SCK_FLAG_STAR_PARALLEL_DRAW));
 	hip_stars->setMaxMagName(conf.getDouble (SCS_STARS, SCK_MAX_MAG_STAR_NAME));
 	hip_stars->setMagScale(conf.getDouble (SCS_STARS, SCK_STAR_MAG_SCALE));
 
@@ -341,6 +374,7 @@ void Core::init(const InitParser& conf)
 	ssystemFactory->setFlagHints(conf.getBoolean(SCS_ASTRO, SCK_FLAG_PLANETS_HINTS));
 	ssystemFactory->setFlagPlanetsOrbits(conf.getBoolean(SCS_ASTRO, SCK_FLAG_PLANETS_ORBITS));
 	ssystemFactory->setFlagLightTravelTime(conf.getBoolean(SCS_ASTRO, SCK_FLAG_LIGHT_TRAVEL_TIME));
+	flagEphemerisTruncation = conf.getBoolean(SCS_ASTRO, SCK_FLAG_EPHEMERIS_TRUNCATION);
 	ssystemFactory->setFlagTrails(conf.getBoolean(SCS_ASTRO, SCK_FLAG_OBJECT_TRAILS));
 	ssystemFactory->startTrails(conf.getBoolean(SCS_ASTRO, SCK_FLAG_OBJECT_TRAILS));
 	nebulas->setFlagShow(conf.getBoolean(SCS_ASTRO,SCK_FLAG_NEBULA));
@@ -380,6 +414,7 @@ void Core::init(const InitParser& conf)
 		milky_way->defineZodiacalState(AppSettings::Instance()->getTextureDir() + conf.getStr(SCS_ASTRO,SCK_ZODIACAL_LIGHT_TEXTURE), conf.getDouble(SCS_ASTRO,SCK_ZODIACAL_INTENSITY));
 		milky_way->setFaderDuration(conf.getInt(SCS_ASTRO,SCK_MILKY_WAY_FADER_DURATION));
 
+		atmosphere->setResolution(conf.getInt(SCS_RENDERING, SCK_ATMOSPHERE_RESOLUTION));
 		atmosphere->initGridViewport(projection);
 		atmosphere->initGridPos();
 
@@ -479,6 +514,7 @@ void Core::init(const InitParser& conf)
 	atmosphere->setFaderDuration(conf.getDouble(SCS_VIEWING,SCK_ATMOSPHERE_FADE_DURATION));
 	atmosphere->setDefaultFaderDuration(conf.getDouble(SCS_VIEWING,SCK_ATMOSPHERE_FADE_DURATION));
 	atmosphere->setDefaultMoonBrightness(conf.getDouble(SCS_VIEWING,SCK_MOON_BRIGHTNESS));
+	atmosphere->setFlagProgressive(conf.getBoolean(SCS_RENDERING,SCK_FLAG_ATMOSPHERE_PROGRESSIVE));
 	ssystemFactory->setDefaultSunBrightness(conf.getDouble(SCS_VIEWING,SCK_SUN_BRIGHTNESS));
 
 	// Viewing section
@@ -1369,6 +1405,7 @@ void Core::saveCurrentConfig(InitParser &conf)
 	conf.setBoolean(SCS_VIEWING, SCK_FLAG_STAR_PICK, hip_stars->getFlagIsolateSelected());
 	conf.setBoolean(SCS_STARS , SCK_FLAG_STAR_TWINKLE, hip_stars->getFlagTwinkle());
 	conf.setDouble(SCS_STARS , SCK_STAR_TWINKLE_AMOUNT, hip_stars->getTwinkleAmount());
+	conf.setBoolean(SCS_STARS , SCK_FLAG_STAR_PARALLEL_DRAW, hip_stars->getFlagParallelDraw());
 	conf.setDouble(SCS_STARS , SCK_STAR_LIMITING_MAG, hip_stars->getMagConverterMaxScaled60DegMag());
 	// Color section
 	conf.setStr    (SCS_COLOR, SCK_AZIMUTHAL_COLOR, Utility::vec3fToStr(skyGridMgr->getColor(SKYGRID_TYPE::GRID_ALTAZIMUTAL)));
@@ -1993,6 +2030,9 @@ void Core::update(int delta_time) {
 		const float deltaSeconds = delta_time / 1000.f;
 	   	updateList.remove_if([deltaSeconds](auto *obj){return obj->update(deltaSeconds);});
 	}
+	// angle of a pixel in radian
+	if (flagEphemerisTruncation)
+		ssystemFactory->setEphemerisPixelAngle(projection->getFov() * (M_PI / 180.) / (2. * projection->getViewportRadius()));
 }
 
 void Core::lookAnchor(const std::string &name, double duration)
@@ -593,6 +593,7 @@ private:
 	bool FlagManualZoom;				// Define whether auto zoom can go further
 	bool firstTime= true;               // For init to track if reload or first time setup
 	bool flagEnableTransition = true;
+	bool flagEphemerisTruncation = false;	// truncate the ephemeris to the precision of a pixel
 	ViewZoomMove vzm;					// var for ViewZoomMove
 	float InitFov;						// Default viewing FOV
 	Vec3d InitViewPos;					// Default viewing direction
@@ -696,10 +696,18 @@ void CoreLink::starNavigatorLoadOther(const std::string &fileName){
 	core->starNav->loadOtherData(fileName);
 }
 
+void CoreLink::starNavigatorLoadMapped(const std::string &fileName){
+	core->starNav->loadMappedData(fileName);
+}
+
 void CoreLink::starNavigatorSave(const std::string &fileName, bool binaryMode){
 	core->starNav->saveData(fileName, binaryMode);
 }
 
+void CoreLink::starNavigatorSaveMapped(const std::string &fileName){
+	core->starNav->saveMappedData(fileName);
+}
+
 void CoreLink::starNavigatorHideStar(int hip){
 	core->starNav->hideStar(hip);
 }
@@ -227,8 +227,12 @@ public:
 
 	void starNavigatorLoadOther(const std::string &fileName);
 
+	void starNavigatorLoadMapped(const std::string &fileName);
+
 	void starNavigatorSave(const std::string &fileName, bool binaryMode);
 
+	void starNavigatorSaveMapped(const std::string &fileName);
+
 	void starNavigatorHideStar(int hip);
 
 	void starNavigatorShowStar(int hip);
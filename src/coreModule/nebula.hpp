@@ -160,6 +160,10 @@ public:
 	void setXY(const Projector *prj) {
 		prj->projectJ2000(XYZ, XY);
 	}
+	//! set the position on screen projected by the caller
+	void setXY(const Vec3d &win) {
+		XY = win;
+	}
 
 	static void setHintsBrightness(float _hintsBrightness) {
 		hintsBrightness = _hintsBrightness;
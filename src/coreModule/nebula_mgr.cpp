@@ -185,42 +185,52 @@ void NebulaMgr::draw(const Projector* prj, const Navigator * nav, ToneReproducto
 	float *data = (float *) Context::instance->transfer->beginPlanCopy(vertexHint->get().size);
 	nbDraw = 0;
 	Nebula::beginDraw(prj);
+	// project the position of the nebulae to draw in one call
+	drawnNebulas.clear();
+	drawnPos.clear();
 	for (const auto &n : nebGrid) {
 		// improve performance by skipping if too small to see
 		if ( n->getAngularSize()>size_limit|| (hintsFader && n->getMag() <= getMaxMagHints())) {
-			// Refactor this by refactoring projectJ2000 and his dependencies
-			//prj->projectJ2000(n->XYZ_, win);
-			n->setXY(prj);
+			drawnNebulas.push_back(n.get());
+			drawnPos.push_back(n->XYZ_);
+		}
+	}
+	drawnXY.resize(drawnPos.size());
+	drawnVisible.resize(drawnPos.size());
+	prj->projectBatch(PF_J2000, drawnPos.data(), drawnXY.data(), drawnVisible.data(), drawnPos.size());
 
-			if (n->getAngularSize()>size_limit) {
-				n->drawTex(prj, nav, eye, sky_brightness, flagBright);
-			}
+	for (size_t i = 0; i < drawnNebulas.size(); ++i) {
+		Nebula *n = drawnNebulas[i];
+		n->setXY(drawnXY[i]);
 
-			if (textFader) {
-				if (isolateSelected) {
-					const std::string nebula_name = n->getNameI18n();
-					if (selected_nebulas.count(nebula_name)) {
-						n->drawName(prj, labelColor, font);
-					}
-				} else
+		if (n->getAngularSize()>size_limit) {
+			n->drawTex(prj, nav, eye, sky_brightness, flagBright);
+		}
+
+		if (textFader) {
+			if (isolateSelected) {
+				const std::string nebula_name = n->getNameI18n();
+				if (selected_nebulas.count(nebula_name)) {
 					n->drawName(prj, labelColor, font);
-			}
+				}
+			} else
+				n->drawName(prj, labelColor, font);
+		}
 
-			//~ cout << "drawhint " << n->getEnglishName() << endl;
-			if ( n->getAngularSize()<size_limit && nbDraw < MAX_HINT) {
-				if (!displaySpecificHint)
-					n->drawHint(prj, nav, data, nbDraw, displaySpecificHint, circleColor, getPictoSize());
-				else {
-					bool displayPicto = false;
-					if (isolateSelected) {
-						const std::string nebula_name = n->getNameI18n();
-						if (selected_nebulas.count(nebula_name))
-							displayPicto = true;
-					}
-					else
+		//~ cout << "drawhint " << n->getEnglishName() << endl;
+		if ( n->getAngularSize()<size_limit && nbDraw < MAX_HINT) {
+			if (!displaySpecificHint)
+				n->drawHint(prj, nav, data, nbDraw, displaySpecificHint, circleColor, getPictoSize());
+			else {
+				bool displayPicto = false;
+				if (isolateSelected) {
+					const std::string nebula_name = n->getNameI18n();
+					if (selected_nebulas.count(nebula_name))
 						displayPicto = true;
-					n->drawHint(prj, nav, data, nbDraw, displayPicto, circleColor, getPictoSize());
 				}
+				else
+					displayPicto = true;
+				n->drawHint(prj, nav, data, nbDraw, displayPicto, circleColor, getPictoSize());
 			}
 		}
 	}
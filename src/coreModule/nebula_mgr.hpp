@@ -244,6 +244,10 @@ private:
 	typedef SphereGrid<std::unique_ptr<Nebula>> nebGrid_t;
 	#endif
 	nebGrid_t nebGrid;
+	std::vector<Nebula *> drawnNebulas;	//!< nebulae of the visible zones drawn by draw
+	std::vector<Vec3f> drawnPos;		//!< their J2000 position
+	std::vector<Vec3d> drawnXY;			//!< their position on screen, projected in one call
+	std::vector<uint8_t> drawnVisible;
 
 	float maxMagHints;				//!< Define maximum magnitude at which nebulae hints are displayed
 
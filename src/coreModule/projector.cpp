@@ -223,6 +223,66 @@ bool Projector::projectCustom(const Vec3d &v,Vec3d &win, const Mat4d &mat) const
 
 }
 
+const Mat4d &Projector::getMatFrameToEye(PROJECTION_FRAME frame) const
+{
+	switch (frame) {
+		case PF_EARTH_EQU_FIXED:
+			return mat_earth_equ_to_eye_fixed;
+		case PF_EARTH_ECLIPTIC:
+			return mat_earth_ecliptic_to_eye;
+		case PF_J2000:
+			return mat_j2000_to_eye;
+		case PF_J2000_GALACTIC:
+			return mat_galactic_to_eye;
+		case PF_HELIO:
+			return mat_helio_to_eye;
+		case PF_LOCAL:
+			return mat_local_to_eye;
+		default:
+			return mat_earth_equ_to_eye;
+	}
+}
+
+// Same computation as projectCustom without branch, the points on the axis of view
+// (rq1 == 0) have x == y == 0, so that they land on the viewport center
+template<class V>
+void Projector::projectBatchCustom(const Mat4d &mat, const V *in, Vec3d *out, uint8_t *visible, size_t n) const
+{
+	const double *m = mat.r;
+	const double scale = fisheye_scale_factor * viewport_radius;
+	const double cx = viewport_center[0];
+	const double cy = viewport_center[1];
+	const double depthScale = 1.0 / (zFar-zNear);
+	const double znear = zNear;
+
+	for (size_t i = 0; i < n; ++i) {
+		const double vx = in[i][0], vy = in[i][1], vz = in[i][2];
+		const double x = m[0]*vx + m[4]*vy +  m[8]*vz + m[12];
+		const double y = m[1]*vx + m[5]*vy +  m[9]*vz + m[13];
+		const double z = m[2]*vx + m[6]*vy + m[10]*vz + m[14];
+		const double rq1 = x*x+y*y;
+		const bool centered = (rq1 <= 0);
+		const double oneoverh = 1.0/sqrt(centered ? 1.0 : rq1);
+		const double a = M_PI_2 + atan(z*oneoverh);
+		const double f = a * scale * oneoverh;
+
+		out[i][0] = cx + x * f;
+		out[i][1] = cy + y * f;
+		out[i][2] = centered ? ((z < 0.0) ? 1.0 : -1e99) : (sqrt(rq1+z*z) - znear) * depthScale;
+		visible[i] = centered ? (z < 0.0) : (a < 0.97*M_PI);
+	}
+}
+
+void Projector::projectBatch(PROJECTION_FRAME frame, const Vec3d *in, Vec3d *out, uint8_t *visible, size_t n) const
+{
+	projectBatchCustom(getMatFrameToEye(frame), in, out, visible, n);
+}
+
+void Projector::projectBatch(PROJECTION_FRAME frame, const Vec3f *in, Vec3d *out, uint8_t *visible, size_t n) const
+{
+	projectBatchCustom(getMatFrameToEye(frame), in, out, visible, n);
+}
+
 bool Projector::projectCustomFixedFov(const Vec3d &v,Vec3d &win, const Mat4d &mat) const
 {
 	win[0] = mat.r[0]*v[0] + mat.r[4]*v[1] +  mat.r[8]*v[2] + mat.r[12];
@@ -309,6 +369,11 @@ void Projector::setModelViewMatrices(	const Mat4d& _mat_earth_equ_to_eye,
 	mat_dome = _mat_dome;
 	mat_dome_fixed = _mat_dome_fixed;
 
+	static const Mat4d earthEquToEcliptic = Mat4d::xrotation(23.4392803055555555556*(M_PI/180));
+	static const Mat4d j2000ToGalactic = Mat4d::zrotation(14.8595*(M_PI/180))*Mat4d::yrotation(-61.8717*(M_PI/180))*Mat4d::zrotation(55.5*(M_PI/180));
+	mat_earth_ecliptic_to_eye = mat_earth_equ_to_eye*earthEquToEcliptic;
+	mat_galactic_to_eye = mat_j2000_to_eye*j2000ToGalactic;
+
 	inv_mat_earth_equ_to_eye = (mat_projection*mat_earth_equ_to_eye).fastInverse();
 	inv_mat_earth_equ_to_eye_fixed = (mat_projection*mat_earth_equ_to_eye).fastInverse();
 	inv_mat_j2000_to_eye = (mat_projection*mat_j2000_to_eye).fastInverse();
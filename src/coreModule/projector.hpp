@@ -31,10 +31,24 @@
 #include "starModule/sphere_geometry.hpp"
 //#include "tools/fmath.hpp"
 #include "tools/no_copy.hpp"
+#include <cstdint>
+#include <cstddef>
 
 
 class s_font;
 
+//! Reference frames of the points projected by Projector::projectBatch
+enum PROJECTION_FRAME : uint8_t {
+	PF_EARTH_EQU = 0,
+	PF_EARTH_EQU_FIXED,
+	PF_EARTH_ECLIPTIC,
+	PF_J2000,
+	PF_J2000_GALACTIC,
+	PF_HELIO,
+	PF_LOCAL,
+	PF_COUNT
+};
+
 // Class which handle projection modes and projection matrix
 // Overide some function usually handled by glu
 class Projector: public NoCopy  {
@@ -54,6 +68,10 @@ public:
 		return viewport_radius;
 	}
 
+	double getFisheyeScaleFactor(void) const {
+		return fisheye_scale_factor;
+	}
+
 	void setViewportDisk(int w, int h);
 
 	int getViewportPosX(void) const {
@@ -134,12 +152,19 @@ public:
 		return projectCustom(v, win, mat_earth_equ_to_eye);
 	}
 	inline bool projectEarthEcliptic(const Vec3d& v, Vec3d& win) const {
-		return projectCustom(v, win, mat_earth_equ_to_eye*Mat4d::xrotation(23.4392803055555555556*(M_PI/180)));
+		return projectCustom(v, win, mat_earth_ecliptic_to_eye);
 	}
 	inline bool projectJ2000Galactic(const Vec3d& v, Vec3d& win) const {
-		return projectCustom(v, win, mat_j2000_to_eye*Mat4d::zrotation(14.8595*(M_PI/180))*Mat4d::yrotation(-61.8717*(M_PI/180))*Mat4d::zrotation(55.5*(M_PI/180)));
+		return projectCustom(v, win, mat_galactic_to_eye);
 	}
 
+	//! Project n points given in frame, visible[i] receives what projectCustom would return for in[i]
+	void projectBatch(PROJECTION_FRAME frame, const Vec3d* in, Vec3d* out, uint8_t* visible, size_t n) const;
+	void projectBatch(PROJECTION_FRAME frame, const Vec3f* in, Vec3d* out, uint8_t* visible, size_t n) const;
+
+	//! Modelview matrix of the frame, updated by setModelViewMatrices
+	const Mat4d &getMatFrameToEye(PROJECTION_FRAME frame) const;
+
 	inline bool projectEarthEquFixed(const Vec3d& v, Vec3d& win) const {
 		return projectCustom(v, win, mat_earth_equ_to_eye_fixed);
 	}
@@ -218,7 +243,8 @@ public:
 	// Same function but using a custom modelview matrix
 	bool projectCustom(const Vec3d& v, Vec3d& win, const Mat4d& mat) const;
 
-	bool projectCustomCheck(const Vec3f& v, Vec3d& win, const Mat4d& mat) const  {
+	// v stays in double, as a float unit vector is off by several pixels at the minimal fov
+	bool projectCustomCheck(const Vec3d& v, Vec3d& win, const Mat4d& mat) const  {
 		return (projectCustom(v, win, mat) && checkInViewport(win));
 	}
 
@@ -294,6 +320,8 @@ protected:
 	Mat4d mat_earth_equ_to_eye;		// Modelview Matrix for earth equatorial projection
 	Mat4d mat_earth_equ_to_eye_fixed;		// Modelview Matrix for earth equatorial projection
 	Mat4d mat_j2000_to_eye;         // for precessed equ coords
+	Mat4d mat_earth_ecliptic_to_eye;	// mat_earth_equ_to_eye rotated by the obliquity
+	Mat4d mat_galactic_to_eye;		// mat_j2000_to_eye rotated to the galactic frame
 	Mat4d mat_helio_to_eye;			// Modelview Matrix for earth equatorial projection
 	Mat4d mat_local_to_eye;			// Modelview Matrix for earth equatorial projection
 	Mat4d inv_mat_earth_equ_to_eye;	// Inverse of mat_projection*mat_earth_equ_to_eye
@@ -312,6 +340,9 @@ protected:
 	// m is here the already inverted full tranfo matrix
 	void unproject(double x, double y, const Mat4d& m, Vec3d& v) const;
 
+	template<class V>
+	void projectBatchCustom(const Mat4d& mat, const V* in, Vec3d* out, uint8_t* visible, size_t n) const;
+
 	// Automove
 	auto_zoom zoom_move;		// Current auto movement
 	bool flag_auto_zoom;		// Define if autozoom is on or off
@@ -222,33 +222,23 @@ void SkyGrid::draw(const Projector* prj)
     uFrag->get().color = color;
     uFrag->get().fader = fader.getInterstate();
 
-	switch (gtype) {
-		case EQUATORIAL:
-			*uMat = prj->getMatEarthEquToEye();
-			break;
-		case ECLIPTIC :
-			*uMat = prj->getMatEarthEquToEye()* Mat4f::xrotation(23.4392803055555555556*(M_PI/180));
-			break;
-		case GALACTIC :
-			*uMat = prj->getMatJ2000ToEye()* Mat4f::zrotation(14.8595*(M_PI/180))*Mat4f::yrotation(-61.8717*(M_PI/180))*Mat4f::zrotation(55.5*(M_PI/180));
-			break;
-		case ALTAZIMUTAL :
-			*uMat = prj->getMatLocalToEye();
-			break;
-		default:
-			return; //for GCC
-	}
+	*uMat = prj->getMatFrameToEye(frame).convert();
 
     Context::instance->frame[Context::instance->frameIdx]->toExecute(cmds[Context::instance->frameIdx], PASS_BACKGROUND);
 
 	// text plot.
+	projected.resize(nb_alt_segment+1);
+	visible.resize(nb_alt_segment+1);
 	for (unsigned int nm=0; nm<nb_meridian; ++nm) {
 
 		Vec4f Color (color[0],color[1],color[2],fader.getInterstate());
 		Mat4f MVP = prj->getMatProjectionOrtho2D();
 
+		prj->projectBatch(frame, alt_points[nm], projected.data(), visible.data(), nb_alt_segment+1);
 		for (unsigned int i=1; i<nb_alt_segment-1; ++i) {
-			if ((prj->*proj_func)(alt_points[nm][i], pt1) && (prj->*proj_func)(alt_points[nm][i+1], pt2) ) {
+			if (visible[i] && visible[i+1]) {
+				pt1 = projected[i];
+				pt2 = projected[i+1];
 
 				static char str[255];	// TODO use c++ string
 
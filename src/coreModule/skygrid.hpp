@@ -115,7 +115,7 @@ protected:
 		ALTAZIMUTAL
 	};
 	SKY_GRID_TYPE gtype;
-	bool (Projector::*proj_func)(const Vec3d&, Vec3d&) const;
+	PROJECTION_FRAME frame;
 
 	static unsigned int nbPointsToDraw;
 	static VertexArray *m_dataGL;
@@ -142,6 +142,8 @@ private:
 	unsigned int nb_azi_segment;
 	Vec3f color;
 	Vec3f** alt_points;
+	std::vector<Vec3d> projected; // alt_points of one meridian projected on the screen
+	std::vector<uint8_t> visible;
 	Vec3f** azi_points;
 	bool internalNav;
 	bool internalAstronomical;
@@ -155,7 +157,7 @@ public:
 	               double _radius = 1., unsigned int _nb_alt_segment = 18, unsigned int _nb_azi_segment = 144)
 		:SkyGrid(_nb_meridian, _nb_parallel, _radius, _nb_alt_segment, _nb_azi_segment) {
 		gtype = EQUATORIAL;
-		proj_func = &Projector::projectEarthEqu;
+		frame = PF_EARTH_EQU;
 	}
 };
 
@@ -166,7 +168,7 @@ public:
 	             double _radius = 1., unsigned int _nb_alt_segment = 18, unsigned int _nb_azi_segment = 144)
 		:SkyGrid(_nb_meridian, _nb_parallel, _radius, _nb_alt_segment, _nb_azi_segment) {
 		gtype = ECLIPTIC;
-		proj_func = &Projector::projectEarthEcliptic;
+		frame = PF_EARTH_ECLIPTIC;
 	}
 };
 
@@ -177,7 +179,7 @@ public:
 	                double _radius = 1., unsigned int _nb_alt_segment = 18, unsigned int _nb_azi_segment = 144)
 		:SkyGrid(_nb_meridian, _nb_parallel, _radius, _nb_alt_segment, _nb_azi_segment) {
 		gtype = ALTAZIMUTAL;
-		proj_func = &Projector::projectLocal;
+		frame = PF_LOCAL;
 	}
 };
 
@@ -188,7 +190,7 @@ public:
 	             double _radius = 1., unsigned int _nb_alt_segment = 18, unsigned int _nb_azi_segment = 144)
 		:SkyGrid(_nb_meridian, _nb_parallel, _radius, _nb_alt_segment, _nb_azi_segment) {
 		gtype = GALACTIC;
-		proj_func = &Projector::projectJ2000Galactic;
+		frame = PF_J2000_GALACTIC;
 	}
 };
 #endif // __SKYGRID_H__
@@ -118,6 +118,15 @@ void SkyLine::rebuildCommand(int idx)
 	needUpdate[idx] = false;
 }
 
+void SkyLine::insertPolyline(const Projector *prj, const Vec3f *points, unsigned int nbPoints)
+{
+	projectPoints(prj, frame, points, nbPoints);
+	for (unsigned int i=0; i+1 < nbPoints; i++) {
+		if (visible[i] && visible[i+1])
+			insert_all(vecDrawPos, projected[i][0], projected[i][1], projected[i+1][0], projected[i+1][1]);
+	}
+}
+
 void SkyLine::drawSkylineGL(const Vec4f& Color)
 {
 	if (nbVertex != vecDrawPos.size() / 2)
@@ -166,16 +175,16 @@ SkyLine_Pole::SkyLine_Pole(SKY_LINE_POLE_TYPE _line_pole_type, double _radius =
 	line_pole_type = _line_pole_type;
 	switch (line_pole_type) {
 		case POLE:
-			proj_func = &Projector::projectEarthEqu;
+			frame = PF_EARTH_EQU;
 			break;
 		case ECLIPTIC_POLE:
-			proj_func = &Projector::projectEarthEcliptic;
+			frame = PF_EARTH_ECLIPTIC;
 			break;
 		case GALACTIC_POLE:
-			proj_func = &Projector::projectJ2000Galactic;
+			frame = PF_J2000_GALACTIC;
 			break;
 		default :
-			proj_func = &Projector::projectEarthEqu;
+			frame = PF_EARTH_EQU;
 	}
 }
 
@@ -195,19 +204,11 @@ void SkyLine_Pole::draw(const Projector *prj,const Navigator *nav, const TimeMgr
 	for (unsigned int i=0; i<51; ++i) {
 		Utility::spheToRect((float)i/(50)*2.f*M_PI,radius*M_PI/180.f, circlep[i]);
 	}
-	for (int i=0; i < 50; i++) {
-		if ((prj->*proj_func)(circlep[i], pt1) && (prj->*proj_func)(circlep[i+1], pt2) ) {
-			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
-		}
-	}
+	insertPolyline(prj, circlep, 51);
 	for (unsigned int i=0; i<51; ++i) {
 		Utility::spheToRect((float)i/(50)*2.f*M_PI, -radius*M_PI/180.f,circlep[i]);
 	}
-	for (int i=0; i < 50; i++) {
-		if ((prj->*proj_func)(circlep[i], pt1) && (prj->*proj_func)(circlep[i+1], pt2) ) {
-			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
-		}
-	}
+	insertPolyline(prj, circlep, 51);
 
 	drawSkylineGL(Color);
 
@@ -232,7 +233,7 @@ SkyLine_Zodiac::SkyLine_Zodiac(double _radius , unsigned int _nb_segment ):
 	zod[7]="CAPRICORNUS";
 	zod[8]=" AQUARIUS";
 	zod[9]="    PISCES";
-	proj_func = &Projector::projectEarthEqu;
+	frame = PF_EARTH_EQU;
 	derivation=0;
 }
 
@@ -261,8 +262,9 @@ void SkyLine_Zodiac::draw(const Projector *prj,const Navigator *nav, const TimeM
 			delta=j*4*M_PI/180.;
 			Utility::spheToRect(atan2(sin(alpha), sin(inclination)*cos(alpha)-cos(inclination)*tan(delta)+1.0E-20)+M_PI/2.0, asin(sin(delta)*sin(inclination)+cos(delta)*cos(inclination)*cos(alpha)), punts[j+4]);
 		}
+		projectPoints(prj, frame, punts, 9);
 		for (int j=0; j<8; j++) {
-			if ((prj->*proj_func)(punts[j], pt1) && (prj->*proj_func)(punts[j+1], pt2) ) {
+			if (projectedSegment(j, j+1)) {
 
 				insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 			}
@@ -276,8 +278,9 @@ void SkyLine_Zodiac::draw(const Projector *prj,const Navigator *nav, const TimeM
 		delta=16*M_PI/180.;
 		Utility::spheToRect(atan2(sin(alpha),sin(inclination)*cos(alpha)-cos(inclination)*tan(delta)+1.0E-20)+M_PI/2.0,asin(sin(delta)*sin(inclination)+cos(delta)*cos(inclination)*cos(alpha)),punts[i]);
 	}
+	projectPoints(prj, frame, punts, 49);
 	for (int i=0; i < 48; i++) {
-		if ((prj->*proj_func)(punts[i], pt1) && (prj->*proj_func)(punts[i+1], pt2) ) {
+		if (projectedSegment(i, i+1)) {
 
 			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 
@@ -311,12 +314,7 @@ void SkyLine_Zodiac::draw(const Projector *prj,const Navigator *nav, const TimeM
 		delta=-16*M_PI/180.;
 		Utility::spheToRect(atan2(sin(alpha),sin(inclination)*cos(alpha)-cos(inclination)*tan(delta)+1.0E-20)+M_PI/2.0,asin(sin(delta)*sin(inclination)+cos(delta)*cos(inclination)*cos(alpha)),punts[i]);
 	}
-	for (int i=0; i < 48; i++) {
-		if ((prj->*proj_func)(punts[i], pt1) && (prj->*proj_func)(punts[i+1], pt2) ) {
-
-			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
-		}
-	}
+	insertPolyline(prj, punts, 49);
 
 	drawSkylineGL(Color);
 
@@ -330,7 +328,7 @@ SkyLine_CircumPolar::SkyLine_CircumPolar(double _radius = 1., unsigned int _nb_s
 	SkyLine(_radius, _nb_segment)
 {
 	inclination =0;
-	proj_func = &Projector::projectEarthEqu;
+	frame = PF_EARTH_EQU;
 	Mat4f rotation = Mat4f::xrotation(inclination*M_PI/180.f);
 
 	// Points to draw along the circle
@@ -367,17 +365,19 @@ void SkyLine_CircumPolar::draw(const Projector *prj,const Navigator *nav, const
 		//Vec3f punts[3*nb_segment+3];
 		inclination *= sign;
 
-		for (unsigned int i=0; i<nb_segment; i += 2) {
-			for (unsigned int j=0; j<nb_segment+1; ++j) {
-				Utility::spheToRect((float)j/(nb_segment)*2.f*M_PI, inclination, points[j+nb_segment+1]);
-				points[j+nb_segment+1] *= radius;
-			}
+		for (unsigned int j=0; j<nb_segment+1; ++j) {
+			Utility::spheToRect((float)j/(nb_segment)*2.f*M_PI, inclination, points[j+nb_segment+1]);
+			points[j+nb_segment+1] *= radius;
+		}
+		projectPoints(prj, frame, points+nb_segment+1, nb_segment+1);
+		projectPoints(prj, frame, punts+nb_segment+1, nb_segment+1, nb_segment+1);
 
-			if((prj->*proj_func)(points[nb_segment+1+i], pt1) && (prj->*proj_func)(points[nb_segment+1+i+1], pt2)) {
+		for (unsigned int i=0; i<nb_segment; i += 2) {
+			if(projectedSegment(i, i+1)) {
 
 				insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 			}
-			if((prj->*proj_func)(punts[nb_segment+1+i], pt1) && (prj->*proj_func)(punts[nb_segment+1+i+1], pt2)) {
+			if(projectedSegment(nb_segment+1+i, nb_segment+1+i+1)) {
 
 				insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 			}
@@ -399,13 +399,13 @@ SkyLine_Analemme::SkyLine_Analemme(SKY_LINE_ANALEMME_TYPE _line_analemme_type =
 	line_analemme_type = _line_analemme_type;
 	switch (line_analemme_type) {
 		case ANALEMMALINE:
-			proj_func = &Projector::projectEarthEqu;
+			frame = PF_EARTH_EQU;
 			break;
 		case ANALEMMA:
-			proj_func = &Projector::projectEarthEquFixed;
+			frame = PF_EARTH_EQU_FIXED;
 			break;
 		default :
-			proj_func = &Projector::projectEarthEqu;
+			frame = PF_EARTH_EQU;
 	}
 	float tmp_ana_ad[93] = {
 		90.7365,91.1986,91.6318,92.0298,92.3875,92.7002,92.9632,93.173,93.3276,93.4268,93.4721,93.4663,93.4124,
@@ -465,12 +465,7 @@ void SkyLine_Analemme::draw(const Projector *prj,const Navigator *nav, const Tim
 	}
 
 
-	for (int i=0; i < 92; i++) {
-		if ((prj->*proj_func)(analemma[i], pt1) && (prj->*proj_func)(analemma[i+1], pt2) ) {
-
-			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
-		}
-	}
+	insertPolyline(prj, analemma, 93);
 
 	drawSkylineGL(Color);
 
@@ -483,7 +478,7 @@ void SkyLine_Analemme::draw(const Projector *prj,const Navigator *nav, const Tim
 SkyLine_Galactic_Center::SkyLine_Galactic_Center( double _radius = 1., unsigned int _nb_segment = 48):
 	SkyLine(_radius, _nb_segment)
 {
-	proj_func = &Projector::projectJ2000Galactic;
+	frame = PF_J2000_GALACTIC;
 	inclination=0*M_PI/180.;
 	derivation = 90*M_PI/180.;
 }
@@ -508,12 +503,7 @@ void SkyLine_Galactic_Center::draw(const Projector *prj,const Navigator *nav, co
 			delta=268.5*M_PI/180.;
 			Utility::spheToRect(atan2(sin(alpha),sin(inclination)*cos(alpha)-cos(inclination)*tan(delta)+1.0E-20)+(j*M_PI),asin(sin(delta)*sin(inclination)+cos(delta)*cos(inclination)*cos(alpha)),punts[i]);
 		}
-		for (int i=0; i < 48; i++) {
-			if ((prj->*proj_func)(punts[i], pt1) && (prj->*proj_func)(punts[i+1], pt2) ) {
-
-				insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
-			}
-		}
+		insertPolyline(prj, punts, 49);
 	}
 
 	drawSkylineGL(Color);
@@ -527,7 +517,7 @@ void SkyLine_Galactic_Center::draw(const Projector *prj,const Navigator *nav, co
 SkyLine_Vernal::SkyLine_Vernal( double _radius = 1., unsigned int _nb_segment = 48):
 	SkyLine(_radius, _nb_segment)
 {
-	proj_func = &Projector::projectEarthEqu;
+	frame = PF_EARTH_EQU;
 	inclination=0*M_PI/180.;
 	derivation = 90*M_PI/180.;
 }
@@ -552,12 +542,7 @@ void SkyLine_Vernal::draw(const Projector *prj,const Navigator *nav, const TimeM
 			delta=268.5*M_PI/180.;
 			Utility::spheToRect(atan2(sin(alpha),sin(inclination)*cos(alpha)-cos(inclination)*tan(delta)+1.0E-20)+(j*M_PI),asin(sin(delta)*sin(inclination)+cos(delta)*cos(inclination)*cos(alpha)),punts[i]);
 		}
-		for (int i=0; i < 48; i++) {
-			if ((prj->*proj_func)(punts[i], pt1) && (prj->*proj_func)(punts[i+1], pt2) ) {
-
-				insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
-			}
-		}
+		insertPolyline(prj, punts, 49);
 	}
 	drawSkylineGL(Color);
 
@@ -572,7 +557,7 @@ void SkyLine_Vernal::draw(const Projector *prj,const Navigator *nav, const TimeM
 SkyLine_Greenwich::SkyLine_Greenwich(double _radius = 1., unsigned int _nb_segment = 48) :
 	SkyLine(_radius, _nb_segment)
 {
-	proj_func = &Projector::projectEarthEquFixed;
+	frame = PF_EARTH_EQU_FIXED;
 }
 
 SkyLine_Greenwich::~SkyLine_Greenwich()
@@ -594,18 +579,14 @@ void SkyLine_Greenwich::draw(const Projector *prj,const Navigator *nav, const Ti
 	for (unsigned int i=0; i<60; i++) {
 		Utility::spheToRect(-2*longitude,(float)i/59*(2*M_PI),punts[i]);
 	}
-	for (int i=0; i < 59; i++) {
-		if ((prj->*proj_func)(punts[i], pt1) && (prj->*proj_func)(punts[i+1], pt2) ) {
-
-			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
-		}
-	}
+	insertPolyline(prj, punts, 60);
 
 	Utility::spheToRect(-2*longitude,(((45.0/59.f)*2*M_PI)+(1*latitude)) ,punt[0]);
 	Utility::spheToRect(-2*longitude,(((46.0/59.f)*2*M_PI)+(1*latitude)) ,punt[1]);
 
 	//TODO all this for a single text ?????
-	if ((prj->*proj_func)(punt[1],pt1) && (prj->*proj_func)(punt[0],pt2) ) {
+	projectPoints(prj, frame, punt, 2);
+	if (projectedSegment(1, 0)) {
 		const double dx = pt2[0]-pt1[0];
 		const double dy = pt2[1]-pt1[1];
 		const double dq = dx*dx+dy*dy;
@@ -634,7 +615,7 @@ void SkyLine_Greenwich::draw(const Projector *prj,const Navigator *nav, const Ti
 SkyLine_Aries::SkyLine_Aries(double _radius = 1., unsigned int _nb_segment = 48) :
 	SkyLine(_radius, _nb_segment)
 {
-	proj_func = &Projector::projectEarthEqu;
+	frame = PF_EARTH_EQU;
 }
 
 SkyLine_Aries::~SkyLine_Aries()
@@ -655,16 +636,12 @@ void SkyLine_Aries::draw(const Projector *prj,const Navigator *nav, const TimeMg
 	for (unsigned int i=0; i<60; i++) {
 		Utility::spheToRect(0,(float)i/59*(2*M_PI),punts[i]);
 	}
-	for (int i=0; i < 59; i++) {
-		if ((prj->*proj_func)(punts[i], pt1) && (prj->*proj_func)(punts[i+1], pt2) ) {
-
-			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
-		}
-	}
+	insertPolyline(prj, punts, 60);
 	Utility::spheToRect(0,(((45.0/59.f)*2*M_PI)+(1*latitude)) ,punt[0]);
 	Utility::spheToRect(0,(((46.0/59.f)*2*M_PI)+(1*latitude)) ,punt[1]);
 
-	if ((prj->*proj_func)(punt[1],pt1) &&(prj->*proj_func)(punt[0],pt2) ) {
+	projectPoints(prj, frame, punt, 2);
+	if (projectedSegment(1, 0)) {
 		const double dx = pt2[0]-pt1[0];
 		const double dy = pt2[1]-pt1[1];
 		const double dq = dx*dx+dy*dy;
@@ -693,7 +670,7 @@ void SkyLine_Aries::draw(const Projector *prj,const Navigator *nav, const TimeMg
 SkyLine_Meridian::SkyLine_Meridian(double _radius = 1., unsigned int _nb_segment = 48):
 	SkyLine(_radius, _nb_segment)
 {
-	proj_func = &Projector::projectLocal;
+	frame = PF_LOCAL;
 	inclination = 90;
 
 	Mat4f rotation = Mat4f::xrotation(inclination*M_PI/180.f);
@@ -727,12 +704,13 @@ void SkyLine_Meridian::draw(const Projector *prj,const Navigator *nav, const Tim
 		Utility::spheToRect((float)j/(nb_segment)*2.f*M_PI, inclination, points[j+nb_segment+1]);
 		points[j+nb_segment+1] *= radius;
 	}
+	projectPoints(prj, frame, points, 2*nb_segment+2);
 
 	for (unsigned int i=0; i<nb_segment; ++i) {
 		if ((internalNav) || (internalAstronomical)) {
 			inclination=70*M_PI/180.;
 
-			if((prj->*proj_func)(points[nb_segment+1+i], pt1) && (prj->*proj_func)(points[nb_segment+1+i+1], pt2)) {
+			if(projectedSegment(nb_segment+1+i, nb_segment+1+i+1)) {
 
 				insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 
@@ -783,7 +761,7 @@ void SkyLine_Meridian::draw(const Projector *prj,const Navigator *nav, const Tim
 			}
 		}
 
-		if ((prj->*proj_func)(points[i], pt1) && (prj->*proj_func)(points[i+1], pt2) ) {
+		if (projectedSegment(i, i+1)) {
 			const double dx = pt1[0]-pt2[0];
 			const double dy = pt1[1]-pt2[1];
 			const double dq = dx*dx+dy*dy;
@@ -854,13 +832,13 @@ SkyLine_Equator::SkyLine_Equator(SKY_LINE_EQUATOR_LINE _line_equator_type, doubl
 
 	switch (line_equator_type) {
 		case EQUATOR :
-			proj_func = &Projector::projectEarthEqu;
+			frame = PF_EARTH_EQU;
 			break;
 		case GALACTIC_EQUATOR :
-			proj_func = &Projector::projectJ2000Galactic;
+			frame = PF_J2000_GALACTIC;
 			break;
 		default :
-			proj_func = &Projector::projectEarthEqu;
+			frame = PF_EARTH_EQU;
 	}
 
 	inclination=0.;
@@ -897,11 +875,12 @@ void SkyLine_Equator::draw(const Projector *prj,const Navigator *nav, const Time
 			points[j+nb_segment+1] *= radius;
 		}
 	}
+	projectPoints(prj, frame, points, 2*nb_segment+2);
 	for (unsigned int i=0; i<nb_segment; ++i) {
 		if ((internalNav) || (internalAstronomical)) {
 			inclination=70*M_PI/180.;
 
-			if((prj->*proj_func)(points[nb_segment+1+i], pt1) && (prj->*proj_func)(points[nb_segment+1+i+1], pt2)) {
+			if(projectedSegment(nb_segment+1+i, nb_segment+1+i+1)) {
 
 				insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 
@@ -943,7 +922,7 @@ void SkyLine_Equator::draw(const Projector *prj,const Navigator *nav, const Time
 			}
 		}
 
-		if ((prj->*proj_func)(points[i], pt1) && (prj->*proj_func)(points[i+1], pt2) ) {
+		if (projectedSegment(i, i+1)) {
 			const double dx = pt1[0]-pt2[0];
 			const double dy = pt1[1]-pt2[1];
 			const double dq = dx*dx+dy*dy;
@@ -1028,7 +1007,7 @@ void SkyLine_Equator::draw(const Projector *prj,const Navigator *nav, const Time
 SkyLine_Tropic::SkyLine_Tropic(double _radius = 1., unsigned int _nb_segment = 48):
 	SkyLine(_radius, _nb_segment)
 {
-	proj_func = &Projector::projectEarthEqu;
+	frame = PF_EARTH_EQU;
 	points = new Vec3f[3*nb_segment+3];
 	inclination=0;
 	Mat4f rotation = Mat4f::xrotation(inclination*M_PI/180.f);
@@ -1061,18 +1040,18 @@ void SkyLine_Tropic::draw(const Projector *prj,const Navigator *nav, const TimeM
 	// StateGL::enable(GL_BLEND);
 	// StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal transparency mode
 
-	for (unsigned int i=0; i<nb_segment; ++i) {
-		inclination=observatory->getHomeBody()->getAxialTilt()*M_PI/180.;
-
-		for (unsigned int j=0; j<nb_segment+1; ++j) {
-			Utility::spheToRect((float)j/(nb_segment)*2.f*M_PI, inclination, points[j+nb_segment+1]);
-			points[j+nb_segment+1] *= radius;
-			Utility::spheToRect((float)j/(nb_segment)*2.f*M_PI, -inclination, points[j+2*nb_segment+2]);
-			points[j+2*nb_segment+2] *= radius;
-		}
+	inclination=observatory->getHomeBody()->getAxialTilt()*M_PI/180.;
+	for (unsigned int j=0; j<nb_segment+1; ++j) {
+		Utility::spheToRect((float)j/(nb_segment)*2.f*M_PI, inclination, points[j+nb_segment+1]);
+		points[j+nb_segment+1] *= radius;
+		Utility::spheToRect((float)j/(nb_segment)*2.f*M_PI, -inclination, points[j+2*nb_segment+2]);
+		points[j+2*nb_segment+2] *= radius;
+	}
+	projectPoints(prj, frame, points, 3*nb_segment+3);
 
+	for (unsigned int i=0; i<nb_segment; ++i) {
 		// Draw equator
-		if ((prj->*proj_func)(points[i], pt1) && (prj->*proj_func)(points[i+1], pt2) ) {
+		if (projectedSegment(i, i+1)) {
 
 			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 
@@ -1099,7 +1078,7 @@ void SkyLine_Tropic::draw(const Projector *prj,const Navigator *nav, const TimeM
 			}
 		}
 
-		if((prj->*proj_func)(points[nb_segment+1+i], pt1) && (prj->*proj_func)(points[nb_segment+1+i+1], pt2)) {
+		if(projectedSegment(nb_segment+1+i, nb_segment+1+i+1)) {
 
 			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 
@@ -1125,7 +1104,7 @@ void SkyLine_Tropic::draw(const Projector *prj,const Navigator *nav, const TimeM
 				insert_all(vecDrawPos, tmp[0], tmp[1]);
 			}
 
-			if( (prj->*proj_func)(points[2*nb_segment+2+i], pt1) && (prj->*proj_func)(points[2*nb_segment+2+i+1], pt2)) {
+			if(projectedSegment(2*nb_segment+2+i, 2*nb_segment+2+i+1)) {
 
 				insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 			}
@@ -1169,7 +1148,7 @@ void SkyLine_Tropic::draw(const Projector *prj,const Navigator *nav, const TimeM
 SkyLine_Ecliptic::SkyLine_Ecliptic(double _radius = 1., unsigned int _nb_segment = 48):
 	SkyLine(_radius, _nb_segment)
 {
-	proj_func = &Projector::projectJ2000;
+	frame = PF_J2000;
 	inclination = 23.4392803055555555556;  //useless ?
 }
 
@@ -1194,16 +1173,15 @@ void SkyLine_Ecliptic::draw(const Projector *prj,const Navigator *nav, const Tim
 
 	// start labeling from the vernal equinox
 	const double corr = draw_labels ? (atan2(m.r[4],m.r[0]) - 2.68*M_PI/6) : 0.0;
-	Vec3d point(radius*cos(corr),radius*sin(corr),0.0);
-	point.transfo4d(m);
-	bool prev_on_screen = prj->projectEarthEqu(point,pt1);
+	for (unsigned int i=0; i<365+1; ++i) {
+		const double phi = corr+2*i*M_PI/365;
+		points[i].set(radius*cos(phi),radius*sin(phi),0.0);
+		points[i].transfo4d(m);
+	}
+	projectPoints(prj, PF_EARTH_EQU, points, 365+1);
 
 	for (unsigned int i=1; i<365+1; ++i) {
-		const double phi = corr+2*i*M_PI/365;
-		Vec3d point(radius*cos(phi),radius*sin(phi),0.0);
-		point.transfo4d(m);
-		const bool on_screen = prj->projectEarthEqu(point,pt2);
-		if (on_screen && prev_on_screen) {
+		if (projectedSegment(i-1, i)) {
 			const double dx = pt2[0]-pt1[0];
 			const double dy = pt2[1]-pt1[1];
 			const double dq = dx*dx+dy*dy;
@@ -1290,8 +1268,6 @@ void SkyLine_Ecliptic::draw(const Projector *prj,const Navigator *nav, const Tim
 				font->print(0,-10,oss.str(), Color, MVP*TRANSFO ,1);
 			}
 		}
-		prev_on_screen = on_screen;
-		pt1 = pt2;
 	}
 
 	drawSkylineGL(Color);
@@ -1307,7 +1283,7 @@ void SkyLine_Ecliptic::draw(const Projector *prj,const Navigator *nav, const Tim
 SkyLine_Precession::SkyLine_Precession(double _radius = 1., unsigned int _nb_segment = 48):
 	SkyLine(_radius, _nb_segment)
 {
-	proj_func = &Projector::projectJ2000;
+	frame = PF_J2000;
 }
 
 SkyLine_Precession::~SkyLine_Precession()
@@ -1332,20 +1308,19 @@ void SkyLine_Precession::draw(const Projector *prj,const Navigator *nav, const T
 
 	const double corr = draw_labels ? (atan2(m.r[4],m.r[0]) - 2.68*M_PI/6) : 0.0;
 
-	bool prev_on_screen;
-
 	for(int pole=1; pole>=-1; pole-=2) {
 
-		Vec3d point(radius*cos(corr),radius*sin(corr),pole*radius*2.3213f);
-		point.transfo4d(m);
-		prev_on_screen = prj->projectEarthEqu(point,pt1);
-
+		points[0].set(radius*cos(corr),radius*sin(corr),pole*radius*2.3213f);
+		points[0].transfo4d(m);
 		for (unsigned int i=0; i<104+1; ++i) {
 			const double phi = corr+2*(i-0.5)*M_PI/104;
-			Vec3d point(radius*cos(phi),radius*sin(phi),pole*radius*2.3213f);
-			point.transfo4d(m);
-			const bool on_screen = prj->projectEarthEqu(point,pt2);
-			if (on_screen && prev_on_screen) {
+			points[i+1].set(radius*cos(phi),radius*sin(phi),pole*radius*2.3213f);
+			points[i+1].transfo4d(m);
+		}
+		projectPoints(prj, PF_EARTH_EQU, points, 104+2);
+
+		for (unsigned int i=0; i<104+1; ++i) {
+			if (projectedSegment(i, i+1)) {
 				const double dx = pt2[0]-pt1[0];
 				const double dy = pt2[1]-pt1[1];
 				const double dq = dx*dx+dy*dy;
@@ -1398,8 +1373,6 @@ void SkyLine_Precession::draw(const Projector *prj,const Navigator *nav, const T
 					insert_all(vecDrawPos, tmp[0], tmp[1]);
 				}
 			}
-			prev_on_screen = on_screen;
-			pt1 = pt2;
 		}
 	}
 
@@ -1417,7 +1390,7 @@ SkyLine_Vertical::SkyLine_Vertical(double _radius = 1., unsigned int _nb_segment
 	SkyLine(_radius, _nb_segment)
 {
 	circlep = new Vec3f[nb_segment+1];
-	proj_func = &Projector::projectLocal;
+	frame = PF_LOCAL;
 }
 
 SkyLine_Vertical::~SkyLine_Vertical()
@@ -1438,9 +1411,10 @@ void SkyLine_Vertical::draw(const Projector *prj,const Navigator *nav, const Tim
 	for (unsigned int i=0; i<nb_segment+1; ++i) {
 		Utility::spheToRect(M_PI_2, ((float)i/nb_segment*M_PI),circlep[i]);
 	}
+	projectPoints(prj, frame, circlep, nb_segment+1);
 
 	for (unsigned int i=0; i < nb_segment; i++) {
-		if ((prj->*proj_func)(circlep[i], pt1) && (prj->*proj_func)(circlep[i+1], pt2) ) {
+		if (projectedSegment(i, i+1)) {
 
 			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 
@@ -1497,7 +1471,7 @@ void SkyLine_Vertical::draw(const Projector *prj,const Navigator *nav, const Tim
 SkyLine_Zenith::SkyLine_Zenith(double _radius = 1., unsigned int _nb_segment = 48):
 	SkyLine(_radius, _nb_segment)
 {
-	proj_func = &Projector::projectLocal;
+	frame = PF_LOCAL;
 }
 
 SkyLine_Zenith::~SkyLine_Zenith()
@@ -1521,13 +1495,17 @@ void SkyLine_Zenith::draw(const Projector *prj,const Navigator *nav, const TimeM
 		Utility::spheToRect((float)i/(50)*2.f*M_PI, -(0.993f*M_PI-M_PI_2),circlen[i]);
 	}
 
+	// circlep from 0, circlen from 51, punts from 102
+	projectPoints(prj, frame, circlep, 51);
+	projectPoints(prj, frame, circlen, 51, 51);
+
 	for (int i=0; i < 50; i++) {
-		if ((prj->*proj_func)(circlep[i], pt1) && (prj->*proj_func)(circlep[i+1], pt2) ) {
+		if (projectedSegment(i, i+1)) {
 
 			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 
 		}
-		if ((prj->*proj_func)(circlen[i], pt1) && (prj->*proj_func)(circlen[i+1], pt2) ) {
+		if (projectedSegment(51+i, 51+i+1)) {
 
 			insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 		}
@@ -1537,11 +1515,12 @@ void SkyLine_Zenith::draw(const Projector *prj,const Navigator *nav, const TimeM
 	Utility::spheToRect((float)37.5/(50)*2.f*M_PI, 0.993f*M_PI-M_PI_2,punts[1]);
 	Utility::spheToRect(0,0.992f*M_PI-M_PI_2,punts[2]);
 
-	if ((prj->*proj_func)(punts[0],pt1) && (prj->*proj_func)(punts[1],pt2) ) {
+	projectPoints(prj, frame, punts, 2, 102);
+	if (projectedSegment(102, 103)) {
 
 		insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 	}
-	if ((prj->*proj_func)(circlep[25],pt1) && (prj->*proj_func)(circlep[0],pt2) ) {
+	if (projectedSegment(25, 0)) {
 
 		insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 	}
@@ -1549,7 +1528,8 @@ void SkyLine_Zenith::draw(const Projector *prj,const Navigator *nav, const TimeM
 	Utility::spheToRect(0.98*M_PI, M_PI_2,punts[0]);
 	Utility::spheToRect(M_PI, M_PI_2,punts[1]);
 
-	if ((prj->*proj_func)(punts[0],pt1) && (prj->*proj_func)(punts[1],pt2) ) {
+	projectPoints(prj, frame, punts, 2, 102);
+	if (projectedSegment(102, 103)) {
 		const double dx = pt2[0]-pt1[0];
 		const double dy = pt2[1]-pt1[1];
 		const double dq = dx*dx+dy*dy;
@@ -1573,11 +1553,12 @@ void SkyLine_Zenith::draw(const Projector *prj,const Navigator *nav, const TimeM
 	Utility::spheToRect((float)37.5/(50)*2.f*M_PI, -(0.993f*M_PI-M_PI_2),punts[1]);
 	Utility::spheToRect(0, -(0.992f*M_PI-M_PI_2),punts[2]);
 
-	if ((prj->*proj_func)(punts[0],pt1) && (prj->*proj_func)(punts[1],pt2) ) {
+	projectPoints(prj, frame, punts, 2, 102);
+	if (projectedSegment(102, 103)) {
 
 		insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 	}
-	if ((prj->*proj_func)(circlen[25],pt1) && (prj->*proj_func)(circlen[0],pt2) ) {
+	if (projectedSegment(51+25, 51)) {
 
 		insert_all(vecDrawPos, pt1[0], pt1[1], pt2[0], pt2[1]);
 	}
@@ -1585,7 +1566,8 @@ void SkyLine_Zenith::draw(const Projector *prj,const Navigator *nav, const TimeM
 	Utility::spheToRect(0.98*M_PI, -M_PI_2,punts[0]);
 	Utility::spheToRect(M_PI, -M_PI_2,punts[1]);
 
-	if ((prj->*proj_func)(punts[0],pt1) && (prj->*proj_func)(punts[1],pt2) ) {
+	projectPoints(prj, frame, punts, 2, 102);
+	if (projectedSegment(102, 103)) {
 		const double dx = pt2[0]-pt1[0];
 		const double dy = pt2[1]-pt1[1];
 		const double dq = dx*dx+dy*dy;
@@ -99,11 +99,28 @@ public:
 	void rebuildCommand(int idx);
 protected:
 	void drawSkylineGL(const Vec4f& Color);
+	//! Project the points given in pointFrame in one call, into projected and visible from index first
+	template<class V>
+	void projectPoints(const Projector *prj, PROJECTION_FRAME pointFrame, const V *points, unsigned int nbPoints, unsigned int first = 0) {
+		projected.resize(first + nbPoints);
+		visible.resize(first + nbPoints);
+		prj->projectBatch(pointFrame, points, projected.data() + first, visible.data() + first, nbPoints);
+	}
+	//! Segment between the projected points i and j, pt1 and pt2 receive them as two chained projectCustom would
+	bool projectedSegment(unsigned int i, unsigned int j) const {
+		pt1 = projected[i];
+		if (!visible[i])
+			return false;
+		pt2 = projected[j];
+		return visible[j];
+	}
+	//! Add the segments of the polyline whose both ends are visible, the points are projected in one call
+	void insertPolyline(const Projector *prj, const Vec3f *points, unsigned int nbPoints);
 
 	double radius;
 	unsigned int nb_segment;
 	Vec3f color;
-	bool (Projector::*proj_func)(const Vec3d&, Vec3d&) const;
+	PROJECTION_FRAME frame = PF_EARTH_EQU;
 	LinearFader fader;
 	bool internalNav;
 	bool internalAstronomical;
@@ -131,6 +148,8 @@ protected:
 
 	std::vector<float> vecDrawPos;
 	std::vector<float> vecDrawMVPPos;
+	std::vector<Vec3d> projected; // points projected by projectPoints
+	std::vector<uint8_t> visible;
 };
 
 //--------------------------------------------------------------------------
@@ -333,6 +352,7 @@ private:
 	mutable Mat4d m;
 	mutable bool draw_labels;
 	mutable double inclination;
+	Vec3d points[365+1];
 };
 
 
@@ -348,7 +368,7 @@ public:
 private:
 	mutable Mat4d m;
 	mutable bool draw_labels;
-
+	Vec3d points[104+2];
 };
 
 
@@ -17,11 +17,15 @@
 #include <sstream>
 #include <fstream>
 #include <string>
+#include <cstring>
+#include <cstddef>
+#include <filesystem>
 
 
 #include "coreModule/starLines.hpp"
 #include "tools/utility.hpp"
 #include "tools/log.hpp"
+#include "tools/app_settings.hpp"
 #include "coreModule/projector.hpp"
 #include "navModule/navigator.hpp"
 //#include "tools/ia.hpp"
@@ -79,6 +83,35 @@ bool StarLines::loadCat(const std::string& fileName, bool useBinary) noexcept
 		return this->loadHipCat(fileName);
 }
 
+#define STARLINES_CACHE_MAGIC "SCASTERI"
+#define STARLINES_CACHE_VERSION 1
+
+struct StarLinesCacheHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t count;
+	SourceKey source;
+};
+
+struct StarLinesCacheRecord {
+	int32_t hip;
+	float x, y, z;	// as in HIP_data
+};
+
+bool StarLines::loadCachedCat(const std::string& fileName) noexcept
+{
+	const std::string cacheName = AppSettings::Instance()->getCacheDir() + std::filesystem::path(fileName).filename().string() + ".bin";
+	if (loadHipCacheCat(cacheName, fileName))
+		return true;
+	const size_t first = HIP_data.size();
+	if (!loadHipCat(fileName))
+		return false;
+	SourceKey source;
+	if (source.read(fileName))
+		saveHipCacheCat(cacheName, source, first);
+	return true;
+}
+
 bool StarLines::saveCat(const std::string& fileName, bool useBinary) noexcept
 {
 	if (useBinary)
@@ -180,6 +213,70 @@ bool StarLines::saveHipBinCat(const std::string& fileName) noexcept
 	return true;
 }
 
+bool StarLines::loadHipCacheCat(const std::string& cacheName, const std::string& source) noexcept
+{
+	std::ifstream fileIn(cacheName, std::ios::binary | std::ios::ate);
+	if (!fileIn.is_open())
+		return false;
+	const uint64_t size = fileIn.tellg();
+	fileIn.seekg(0);
+	StarLinesCacheHeader header;
+	fileIn.read((char *) &header, sizeof(header));
+	if (!fileIn || memcmp(header.magic, STARLINES_CACHE_MAGIC, sizeof(header.magic)) != 0
+		|| header.version != STARLINES_CACHE_VERSION
+		|| size != sizeof(header) + (uint64_t) header.count * sizeof(StarLinesCacheRecord)) {
+		cLog::get()->write("StarLines, " + cacheName + " isn't a valid cache", LOG_TYPE::L_WARNING);
+		return false;
+	}
+	const int64_t mtime = header.source.mtime;
+	if (!header.source.matches(source)) {
+		cLog::get()->write("StarLines, " + cacheName + " is out of date with " + source);
+		return false;
+	}
+	std::vector<StarLinesCacheRecord> records(header.count);
+	fileIn.read((char *) records.data(), records.size() * sizeof(StarLinesCacheRecord));
+	if (!fileIn) {
+		cLog::get()->write("StarLines error reading "+cacheName, LOG_TYPE::L_ERROR);
+		return false;
+	}
+	fileIn.close();
+	// same content with another date, the date is kept so that the source isn't hashed at the next start
+	if (header.source.mtime != mtime && !header.source.writeTo(cacheName, offsetof(StarLinesCacheHeader, source)))
+		cLog::get()->write("StarLines, can't update the date of the source in " + cacheName, LOG_TYPE::L_WARNING);
+	HIP_data.reserve(HIP_data.size() + records.size());
+	for (const auto &r : records)
+		HIP_data.emplace_back(r.hip, Vec3f(r.x, r.y, r.z));
+	cLog::get()->write("StarLines cache "+cacheName+", stars readed "+ std::to_string(records.size()), LOG_TYPE::L_DEBUG);
+	return true;
+}
+
+bool StarLines::saveHipCacheCat(const std::string& cacheName, const SourceKey& source, size_t first) noexcept
+{
+	StarLinesCacheHeader header;
+	memcpy(header.magic, STARLINES_CACHE_MAGIC, sizeof(header.magic));
+	header.version = STARLINES_CACHE_VERSION;
+	header.count = HIP_data.size() - first;
+	header.source = source;
+	std::vector<StarLinesCacheRecord> records;
+	records.reserve(header.count);
+	for (size_t i = first; i < HIP_data.size(); ++i)
+		records.push_back({HIP_data[i].first, HIP_data[i].second[0], HIP_data[i].second[1], HIP_data[i].second[2]});
+
+	// written beside the cache and renamed, a broken cache is never read
+	const std::string tmpName = cacheName + ".tmp";
+	std::ofstream fileOut(tmpName, std::ios::binary | std::ios::trunc);
+	fileOut.write((const char *) &header, sizeof(header));
+	fileOut.write((const char *) records.data(), records.size() * sizeof(StarLinesCacheRecord));
+	fileOut.close();
+	std::error_code ec;
+	if (fileOut.fail() || (std::filesystem::rename(tmpName, cacheName, ec), ec)) {
+		cLog::get()->write("StarLines error writing "+cacheName, LOG_TYPE::L_ERROR);
+		std::filesystem::remove(tmpName, ec);
+		return false;
+	}
+	return true;
+}
+
 bool StarLines::loadHipBinCat(const std::string& fileName) noexcept
 {
 	//std::cout << "StarLines::loadHipBinCatalogue " << fileName << std::endl;
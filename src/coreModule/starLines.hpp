@@ -24,6 +24,7 @@
 //
 
 #include "tools/no_copy.hpp"
+#include "tools/source_key.hpp"
 #include "EntityCore/Resource/SharedBuffer.hpp"
 
 using HIPpos = std::pair<int, Vec3f>;
@@ -95,6 +96,11 @@ public:
 	//! \return true if everything is oki, false otherwise
 	bool loadCat(const std::string& fileName, bool useBinary) noexcept;
 
+	//! \brief reads the text catalog of the brightest stars from its compiled copy in the cache directory
+	//! the copy is compiled from the text when it is missing or out of date
+	//! \return true if everything is oki, false otherwise
+	bool loadCachedCat(const std::string& fileName) noexcept;
+
 	//! \brief save the catalog of the brightest stars
 	//! \return true if all is oki, false otherwise
 	bool saveCat(const std::string& fileName, bool useBinary) noexcept;
@@ -126,6 +132,10 @@ protected:
 	//! save the binary catalog of the brightest stars
 	//! \return true if everything is oki, false otherwise
 	bool saveHipBinCat(const std::string& fileName) noexcept;
+	//! reads the compiled copy of source, false if it is missing or out of date
+	bool loadHipCacheCat(const std::string& cacheName, const std::string& source) noexcept;
+	//! writes the stars from first in a compiled copy of a text catalog
+	bool saveHipCacheCat(const std::string& cacheName, const SourceKey& source, size_t first) noexcept;
 
 	// display shader
 	//std::unique_ptr<shaderProgram> shaderStarLines;
@@ -373,6 +373,7 @@ void Tully::buildVertexSplit()
 		planeOrder = 0;
 	}
 	std::memcpy(Context::instance->transfer->planCopy(vertexPoints->get()), sortedDataTully.data(), vertexPoints->get().size);
+	squareGrid.build(sortedDataTully.data(), nbGalaxy);
 }
 
 void Tully::setTexture(const std::string& tex_file)
@@ -396,61 +397,56 @@ void Tully::setTexture(const std::string& tex_file)
 
 bool Tully::compTmpTully(const tmpTully &a,const tmpTully &b)
 {
-	if (a.planeSide < b.planeSide)
-		return true;
-	return (a.distance > b.distance);
+	// plane side first, then from back to front
+	if (a.planeSide != b.planeSide)
+		return (a.planeSide < b.planeSide);
+	if (a.distance != b.distance)
+		return (a.distance > b.distance);
+	return (a.index < b.index);
 }
 
 void Tully::computeSquareGalaxies(Vec3f camPosition)
 {
-	float x,y,z,a,b,c,distance, radius;
-
-	a = camPosition[0];
-	b = camPosition[1];
-	c = camPosition[2];
+	const float a = camPosition[0];
+	const float b = camPosition[1];
+	const float c = camPosition[2];
 	int squareOffset = 0;
-	for(unsigned int i=0; i< nbGalaxy;i++) {
-		x=sortedDataTully[8*i];
-		y=sortedDataTully[8*i+1];
-		z=sortedDataTully[8*i+2];
 
-		//only galaxies large enough to be displayed are selected
-        distance=sqrt((x-a)*(x-a)+(y-b)*(y-b)+(z-c)*(z-c));
-		radius = 3.0/(distance*sortedDataTully[8*i+7]);
+	lTmpTully.clear();
+	// only the galaxies of the cells around the camera can be large enough to be displayed
+	squareGrid.forEachCandidate(camPosition, [&](const TullyGrid::Entry &galaxy) {
+		const float x = galaxy.x;
+		const float y = galaxy.y;
+		const float z = galaxy.z;
+		const float distance=sqrt((x-a)*(x-a)+(y-b)*(y-b)+(z-c)*(z-c));
+		const float radius = 3.0/(distance*galaxy.scale);
 		if (radius<2)
-			continue;
+			return;
 
-		/* OPTIMISATION : radius < 2 means that d²< (3/2scale)² */
 		tmpTully tmp;
-		tmp.position = Vec3f(x,y,z);
-		tmp.distance = distance;
+		tmp.position[0] = x;
+		tmp.position[1] = y;
+		tmp.position[2] = z;
+		tmp.texture = galaxy.texture;
 		tmp.radius = radius;
-		tmp.texture = sortedDataTully[8*i+6];
-		tmp.planeSide = (i >= drawDataPointFirstOffset) ^ planeOrder;
+		tmp.distance = distance;
+		tmp.index = galaxy.index;
+		tmp.planeSide = (galaxy.index >= drawDataPointFirstOffset) ^ planeOrder;
 		squareOffset += !tmp.planeSide;
 		lTmpTully.push_back(tmp);
-	}
+	});
 	int vertexCount = lTmpTully.size();
-	// printf("list size: %i\n", lTmpTully.size());
-	lTmpTully.sort(compTmpTully);
-
-	float *data = nullptr;
-	if (vertexCount)
-	 	data = (float *) Context::instance->transfer->planCopy(vertexSquare->get(), 0, vertexCount * 5 * sizeof(float));
-
-	for (int i = 0; i < 2; ++i) {
-		for (std::list<tmpTully>::iterator it=lTmpTully.begin(); it!=lTmpTully.end(); ++it) {
-			if ((*it).planeSide == i) {
-				memcpy(data, (float *) (*it).position, 3 * sizeof(float));
-				data += 3;
-				*(data++) = (*it).texture;
-				*(data++) = (*it).radius;
-			}
+	// the whole order is needed, the squares are blended from back to front
+	std::sort(lTmpTully.begin(), lTmpTully.end(), compTmpTully);
+
+	if (vertexCount) {
+		float *data = (float *) Context::instance->transfer->planCopy(vertexSquare->get(), 0, vertexCount * 5 * sizeof(float));
+		for (const tmpTully &tmp : lTmpTully) {
+			memcpy(data, &tmp, 5 * sizeof(float));
+			data += 5;
 		}
 	}
 
-	lTmpTully.clear();	//data become useless
-
 	if (includeObject) {
 		drawData->get()[0].vertexCount = squareOffset;
 		drawData->get()[1].vertexCount = vertexCount - squareOffset;
@@ -28,7 +28,6 @@
 #include <string>
 #include <fstream>
 #include <vector>
-#include <list>
 #include <memory>
 
 #include "tools/fader.hpp"
@@ -36,6 +35,7 @@
 #include "tools/vecmath.hpp"
 #include "EntityCore/Resource/SharedBuffer.hpp"
 #include "tools/object_base.hpp"
+#include "coreModule/tullyGrid.hpp"
 
 //! Class which manages the Tully Galaxies catalog
 
@@ -160,18 +160,22 @@ private:
 	// Hold the data as they are stored in vertexPoints
 	std::vector<float> sortedDataTully;
 
+	// galaxies drawn as squares, only sortedDataTully is indexed
+	TullyGrid squareGrid;
+
 	struct tmpTully {
-		Vec3f position;
-		Vec3f color;
-		float distance;
-		float radius;
+		// the first 5 floats (position, texture, radius) are the vertex of vertexSquare
+		float position[3];
 		float texture;
+		float radius;
+		float distance;
+		uint32_t index;
 		uint8_t planeSide;
-		std::string name;
 	};
 	static bool compTmpTully(const tmpTully &a,const tmpTully &b);
 
-	std::list<tmpTully> lTmpTully;
+	// reused from frame to frame to avoid allocations
+	std::vector<tmpTully> lTmpTully;
 
 	//return the number of galaxies read from the catalog(s)
 	unsigned int nbGalaxy;
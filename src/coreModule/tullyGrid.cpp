@@ -0,0 +1,62 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2017-2020 of the LSS Team & Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of the LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include "coreModule/tullyGrid.hpp"
+
+void TullyGrid::build(const float *data, unsigned int nbGalaxy)
+{
+	layers.clear();
+
+	std::vector<float> scales;
+	for (unsigned int i = 0; i < nbGalaxy; ++i)
+		scales.push_back(data[8*i+7]);
+	std::sort(scales.begin(), scales.end());
+	scales.erase(std::unique(scales.begin(), scales.end()), scales.end());
+
+	std::vector<std::pair<uint64_t, uint32_t>> keys;
+	for (float scale : scales) {
+		if (!(scale > 0))
+			continue;
+		Layer &layer = layers.emplace_back();
+		layer.invCellSize = scale / TULLY_SQUARE_REACH;
+
+		keys.clear();
+		for (unsigned int i = 0; i < nbGalaxy; ++i) {
+			const float *galaxy = data + 8*i;
+			if (galaxy[7] != scale)
+				continue;
+			keys.emplace_back(makeKey(coord(galaxy[0], layer.invCellSize), coord(galaxy[1], layer.invCellSize), coord(galaxy[2], layer.invCellSize)), i);
+		}
+		std::sort(keys.begin(), keys.end());
+
+		layer.entries.reserve(keys.size());
+		for (auto &key : keys) {
+			const float *galaxy = data + 8*key.second;
+			if (layer.cells.empty() || layer.cells.back().key != key.first)
+				layer.cells.push_back({key.first, (uint32_t) layer.entries.size(), (uint32_t) layer.entries.size()});
+			layer.entries.push_back({galaxy[0], galaxy[1], galaxy[2], galaxy[7], galaxy[6], key.second});
+			++layer.cells.back().last;
+		}
+	}
+}
@@ -0,0 +1,120 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2017-2020 of the LSS Team & Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of the LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#ifndef ___TULLY_GRID_HPP___
+#define ___TULLY_GRID_HPP___
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include "tools/vecmath.hpp"
+
+//! A galaxy is drawn as a square when 3/(distance*scale) >= 2
+#define TULLY_SQUARE_REACH 1.5f
+
+/*! \class TullyGrid
+ * \brief static spatial index of the galaxies which can be drawn as squares
+ *
+ * \details The galaxies are grouped by scale, a galaxy of scale s is only drawn
+ * as a square within TULLY_SQUARE_REACH/s of the camera. Every scale has its own
+ * uniform grid whose cell size is this reach, so only the 3x3x3 cells around the
+ * camera can hold such galaxies. Only the occupied cells are stored, sorted by key.
+ */
+class TullyGrid {
+public:
+	struct Entry {
+		float x, y, z;
+		float scale;
+		float texture;
+		uint32_t index; // index of the galaxy in the indexed data
+	};
+
+	//! \brief index nbGalaxy galaxies stored as x,y,z,r,g,b,texture,scale
+	void build(const float *data, unsigned int nbGalaxy);
+
+	//! \brief call f(entry) for every galaxy which may be drawn as a square seen from camPos
+	//! \details it is a superset of the galaxies within their reach, the caller does the exact test
+	template<class F>
+	void forEachCandidate(const Vec3f &camPos, F &&f) const;
+
+	unsigned int getNbCells() const {
+		unsigned int n = 0;
+		for (const Layer &layer : layers)
+			n += layer.cells.size();
+		return n;
+	}
+
+private:
+	struct Cell {
+		uint64_t key;
+		uint32_t first;
+		uint32_t last;
+		bool operator<(uint64_t k) const {
+			return key < k;
+		}
+	};
+	struct Layer {
+		float invCellSize;
+		std::vector<Cell> cells;
+		std::vector<Entry> entries; // sorted by cell
+	};
+
+	static int64_t coord(float v, float invCellSize) {
+		return (int64_t) std::floor(v * invCellSize);
+	}
+	// 21 bits per axis, enough for every cell of a catalogue of a few thousand Mpc
+	static uint64_t makeKey(int64_t i, int64_t j, int64_t k) {
+		constexpr int64_t offset = 1 << 20;
+		constexpr uint64_t mask = (1 << 21) - 1;
+		return (((uint64_t) (i + offset) & mask) << 42) | (((uint64_t) (j + offset) & mask) << 21) | ((uint64_t) (k + offset) & mask);
+	}
+
+	std::vector<Layer> layers;
+};
+
+template<class F>
+void TullyGrid::forEachCandidate(const Vec3f &camPos, F &&f) const
+{
+	for (const Layer &layer : layers) {
+		const int64_t ci = coord(camPos[0], layer.invCellSize);
+		const int64_t cj = coord(camPos[1], layer.invCellSize);
+		const int64_t ck = coord(camPos[2], layer.invCellSize);
+		for (int64_t i = ci - 1; i <= ci + 1; ++i) {
+			for (int64_t j = cj - 1; j <= cj + 1; ++j) {
+				// the 3 cells along k are consecutive keys
+				const uint64_t firstKey = makeKey(i, j, ck - 1);
+				const uint64_t lastKey = makeKey(i, j, ck + 1);
+				auto it = std::lower_bound(layer.cells.begin(), layer.cells.end(), firstKey);
+				for (; it != layer.cells.end() && it->key <= lastKey; ++it) {
+					for (uint32_t e = it->first; e < it->last; ++e)
+						f(layer.entries[e]);
+				}
+			}
+		}
+	}
+}
+
+#endif // ___TULLY_GRID_HPP___
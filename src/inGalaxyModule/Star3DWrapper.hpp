@@ -29,7 +29,7 @@
 
 class Star3DWrapper : public ObjectBase {
 public:
-    Star3DWrapper(starInfo *star, Vec3f pos) : star(star), pos(pos) {}
+    Star3DWrapper(const starInfo &star, Vec3f pos) : star(star), pos(pos) {}
     virtual ~Star3DWrapper() = default;
 
     virtual void retain() override {
@@ -57,16 +57,16 @@ public:
 	}
 
     virtual std::string getEnglishName() const override {
-        return StarNavigator::getStarName(star->HIP);
+        return StarNavigator::getStarName(star.HIP);
     }
 
     virtual void getRaDeValue(const Navigator *nav,double *ra, double *de) const override {
-        *ra = star->pmRA;
-        *de = star->pmDE;
+        *ra = star.pmRA;
+        *de = star.pmDE;
     }
 
     virtual Vec3d getEarthEquPos(const Navigator *nav) const override {
-        auto tmp = star->posXYZ;
+        auto tmp = star.posXYZ;
         tmp[0] = -tmp[0];
         tmp = nav->helioToEarthPosEqu(Mat4f::xrotation(-M_PI_2-23.4392803055555555556*M_PI/180) * tmp);
         return tmp;
@@ -79,15 +79,15 @@ public:
     virtual float getMag(const Navigator *nav) const override;
 
     float getBV(void) const {
-		return star->B_V;
+		return star.B_V;
 	}
 
     virtual Vec3f getRGB() const override {
-		return StarNavigator::bvToColor(star->B_V);
+		return StarNavigator::bvToColor(star.B_V);
 	}
 private:
     int refCount = 0;
     // observer's position in parsec
-    starInfo *star;
+    starInfo star;
 	Vec3f pos;
 };
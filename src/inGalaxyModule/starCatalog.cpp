@@ -0,0 +1,335 @@
+/*
+* This source is the property of Immersive Adventure
+* http://immersiveadventure.net/
+*
+* It has been developped by part of the LSS Team.
+* For further informations, contact:
+*
+* albertpla@immersiveadventure.net
+*
+* This source code mustn't be copied or redistributed
+* without the authorization of Immersive Adventure
+* (c) 2017 - 2020 all rights reserved
+*
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cstddef>
+#include <cmath>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "inGalaxyModule/starCatalog.hpp"
+#include "inGalaxyModule/starManager.hpp"
+#include "tools/log.hpp"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define STAR_CATALOG_NATIVE false
+#else
+#define STAR_CATALOG_NATIVE true
+#endif
+
+static const size_t columnSize[SCC_COUNT] = {
+	sizeof(float), sizeof(float), sizeof(float), sizeof(float),
+	sizeof(float), sizeof(float), sizeof(float),
+	sizeof(uint32_t), sizeof(uint8_t)
+};
+
+static uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + STAR_CATALOG_ALIGN - 1) / STAR_CATALOG_ALIGN * STAR_CATALOG_ALIGN;
+}
+
+StarCatalog::StarCatalog()
+{}
+
+StarCatalog::~StarCatalog()
+{
+	clear();
+}
+
+void StarCatalog::clear()
+{
+#ifndef WIN32
+	if (mapStart)
+		munmap(mapStart, mapSize);
+#endif
+	mapStart = nullptr;
+	mapSize = 0;
+	fileData.reset();
+	ownedFloat = std::vector<float>();
+	ownedHip = std::vector<uint32_t>();
+	ownedBv = std::vector<uint8_t>();
+	ownedCubes = std::vector<StarCatalogCube>();
+	hidden = std::vector<bool>();
+	hipIndex = std::vector<std::pair<uint32_t, unsigned int>>();
+	posX = posY = posZ = mag = pmRA = pmDE = pc = nullptr;
+	hip = nullptr;
+	bv = nullptr;
+	cubes = nullptr;
+	nbStars = nbCubes = 0;
+}
+
+void StarCatalog::build(const StarManager &mgr)
+{
+	clear();
+	uint64_t totalStars = 0;
+	for (HyperCube *hc : mgr.getHyperCubeList())
+		for (Cube *c : hc->getCubeList())
+			totalStars += c->getNbStars();
+
+	ownedFloat.resize(7 * totalStars);
+	ownedHip.resize(totalStars);
+	ownedBv.resize(totalStars);
+	hidden.resize(totalStars);
+	float *col[7];
+	for (int i = 0; i < 7; ++i)
+		col[i] = ownedFloat.data() + i * totalStars;
+
+	uint32_t n = 0;
+	for (HyperCube *hc : mgr.getHyperCubeList()) {
+		for (Cube *c : hc->getCubeList()) {
+			StarCatalogCube cube {{hc->getCx(), hc->getCy(), hc->getCz()}, {c->getCx(), c->getCy(), c->getCz()}, n, 0, {0, 0, 0}, 0, 500};
+			Vec3f minPos(1e30, 1e30, 1e30);
+			Vec3f maxPos(-1e30, -1e30, -1e30);
+			for (const starInfo *si : c->getStarList()) {
+				col[SCC_POS_X][n] = si->posXYZ[0];
+				col[SCC_POS_Y][n] = si->posXYZ[1];
+				col[SCC_POS_Z][n] = si->posXYZ[2];
+				col[SCC_MAG][n] = si->mag;
+				col[SCC_PM_RA][n] = si->pmRA;
+				col[SCC_PM_DE][n] = si->pmDE;
+				col[SCC_PC][n] = si->pc;
+				ownedHip[n] = si->HIP;
+				ownedBv[n] = std::min(std::max(si->B_V, 0), 127);
+				hidden[n] = !si->show;
+				cube.minMag = std::min(cube.minMag, si->mag);
+				for (int i = 0; i < 3; ++i) {
+					minPos[i] = std::min(minPos[i], si->posXYZ[i]);
+					maxPos[i] = std::max(maxPos[i], si->posXYZ[i]);
+				}
+				++n;
+			}
+			cube.count = n - cube.first;
+			if (cube.count == 0)
+				continue;
+			Vec3f center = (minPos + maxPos) * 0.5f;
+			for (uint32_t i = cube.first; i < n; ++i) {
+				Vec3f d(col[SCC_POS_X][i] - center[0], col[SCC_POS_Y][i] - center[1], col[SCC_POS_Z][i] - center[2]);
+				cube.radius = std::max(cube.radius, d.length());
+			}
+			memcpy(cube.center, (const float *) center, sizeof(cube.center));
+			ownedCubes.push_back(cube);
+		}
+	}
+
+	posX = col[SCC_POS_X];
+	posY = col[SCC_POS_Y];
+	posZ = col[SCC_POS_Z];
+	mag = col[SCC_MAG];
+	pmRA = col[SCC_PM_RA];
+	pmDE = col[SCC_PM_DE];
+	pc = col[SCC_PC];
+	hip = ownedHip.data();
+	bv = ownedBv.data();
+	cubes = ownedCubes.data();
+	nbStars = n;
+	nbCubes = ownedCubes.size();
+}
+
+bool StarCatalog::map(const std::string &fileName, const std::string &source)
+{
+	clear();
+	if (!STAR_CATALOG_NATIVE) {
+		cLog::get()->write("StarCatalog, mapped catalogue needs a little-endian host " + fileName, LOG_TYPE::L_ERROR);
+		return false;
+	}
+
+	const char *data = nullptr;
+	size_t size = 0;
+#ifndef WIN32
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) {
+		cLog::get()->write("StarCatalog, error opening file " + fileName, LOG_TYPE::L_WARNING);
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size >= (off_t) sizeof(StarCatalogHeader)) {
+		size = st.st_size;
+		void *ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (ptr != MAP_FAILED) {
+			mapStart = ptr;
+			mapSize = size;
+			data = (const char *) ptr;
+		}
+	}
+	close(fd);
+#endif
+	if (!data) {
+		std::ifstream fileIn(fileName, std::ios::binary | std::ios::ate);
+		if (!fileIn.is_open()) {
+			cLog::get()->write("StarCatalog, error opening file " + fileName, LOG_TYPE::L_WARNING);
+			return false;
+		}
+		size = fileIn.tellg();
+		fileIn.seekg(0);
+		fileData = std::make_unique<char[]>(size);
+		fileIn.read(fileData.get(), size);
+		if (!fileIn) {
+			cLog::get()->write("StarCatalog, error reading file " + fileName, LOG_TYPE::L_ERROR);
+			clear();
+			return false;
+		}
+		data = fileData.get();
+	}
+
+	StarCatalogHeader header;
+	bool valid = size >= sizeof(header);
+	if (valid) {
+		memcpy(&header, data, sizeof(header));
+		valid = memcmp(header.magic, STAR_CATALOG_MAGIC, sizeof(header.magic)) == 0
+			&& header.version == STAR_CATALOG_VERSION && header.headerSize == sizeof(header)
+			&& header.nbStars <= UINT32_MAX && header.nbCubes <= header.nbStars
+			&& header.cubeOffset % alignof(StarCatalogCube) == 0
+			&& header.cubeOffset + header.nbCubes * sizeof(StarCatalogCube) <= size;
+	}
+	for (unsigned int i = 0; valid && i < SCC_COUNT; ++i) {
+		valid = header.columnOffset[i] % columnSize[i] == 0
+			&& header.columnOffset[i] + header.nbStars * columnSize[i] <= size;
+	}
+	if (valid) {
+		const StarCatalogCube *cubeTable = (const StarCatalogCube *) (data + header.cubeOffset);
+		for (uint64_t i = 0; valid && i < header.nbCubes; ++i)
+			valid = (uint64_t) cubeTable[i].first + cubeTable[i].count <= header.nbStars;
+	}
+	if (!valid) {
+		cLog::get()->write("StarCatalog, " + fileName + " isn't a valid mapped catalogue", LOG_TYPE::L_ERROR);
+		clear();
+		return false;
+	}
+	if (!source.empty()) {
+		const int64_t mtime = header.source.mtime;
+		if (!header.source.matches(source)) {
+			cLog::get()->write("StarCatalog, " + fileName + " is out of date with " + source);
+			clear();
+			return false;
+		}
+		// same content with another date, the date is kept so that the source isn't hashed at the next start
+		if (header.source.mtime != mtime && !header.source.writeTo(fileName, offsetof(StarCatalogHeader, source)))
+			cLog::get()->write("StarCatalog, can't update the date of the source in " + fileName, LOG_TYPE::L_WARNING);
+	}
+
+	posX = (const float *) (data + header.columnOffset[SCC_POS_X]);
+	posY = (const float *) (data + header.columnOffset[SCC_POS_Y]);
+	posZ = (const float *) (data + header.columnOffset[SCC_POS_Z]);
+	mag = (const float *) (data + header.columnOffset[SCC_MAG]);
+	pmRA = (const float *) (data + header.columnOffset[SCC_PM_RA]);
+	pmDE = (const float *) (data + header.columnOffset[SCC_PM_DE]);
+	pc = (const float *) (data + header.columnOffset[SCC_PC]);
+	hip = (const uint32_t *) (data + header.columnOffset[SCC_HIP]);
+	bv = (const uint8_t *) (data + header.columnOffset[SCC_B_V]);
+	cubes = (const StarCatalogCube *) (data + header.cubeOffset);
+	nbStars = header.nbStars;
+	nbCubes = header.nbCubes;
+	hidden.assign(nbStars, false);
+
+	cLog::get()->write("StarCatalog, " + fileName + (mapStart ? " mapped: " : " read: ") + std::to_string(nbStars) + " stars in " + std::to_string(nbCubes) + " cubes");
+	return true;
+}
+
+bool StarCatalog::save(const std::string &fileName, const SourceKey &source) const
+{
+	cLog::get()->write("StarCatalog::save " + fileName, LOG_TYPE::L_DEBUG);
+	if (!STAR_CATALOG_NATIVE) {
+		cLog::get()->write("StarCatalog, mapped catalogue needs a little-endian host " + fileName, LOG_TYPE::L_ERROR);
+		return false;
+	}
+	std::ofstream file(fileName, std::ios::binary | std::ios::out);
+	if (!file.is_open()) {
+		cLog::get()->write("StarCatalog, error writing " + fileName, LOG_TYPE::L_ERROR);
+		return false;
+	}
+
+	StarCatalogHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, STAR_CATALOG_MAGIC, sizeof(header.magic));
+	header.version = STAR_CATALOG_VERSION;
+	header.headerSize = sizeof(header);
+	header.nbCubes = nbCubes;
+	header.nbStars = nbStars;
+	header.source = source;
+	header.cubeOffset = alignOffset(sizeof(header));
+	uint64_t offset = header.cubeOffset + nbCubes * sizeof(StarCatalogCube);
+	for (unsigned int i = 0; i < SCC_COUNT; ++i) {
+		header.columnOffset[i] = alignOffset(offset);
+		offset = header.columnOffset[i] + nbStars * columnSize[i];
+	}
+
+	const void *columns[SCC_COUNT] = {posX, posY, posZ, mag, pmRA, pmDE, pc, hip, bv};
+	const char padding[STAR_CATALOG_ALIGN] = {};
+	file.write((const char *) &header, sizeof(header));
+	file.write(padding, header.cubeOffset - sizeof(header));
+	file.write((const char *) cubes, nbCubes * sizeof(StarCatalogCube));
+	offset = header.cubeOffset + nbCubes * sizeof(StarCatalogCube);
+	for (unsigned int i = 0; i < SCC_COUNT; ++i) {
+		file.write(padding, header.columnOffset[i] - offset);
+		file.write((const char *) columns[i], nbStars * columnSize[i]);
+		offset = header.columnOffset[i] + nbStars * columnSize[i];
+	}
+	file.close();
+	if (file.fail()) {
+		cLog::get()->write("StarCatalog, error writing " + fileName, LOG_TYPE::L_ERROR);
+		return false;
+	}
+	cLog::get()->write("StarCatalog, " + std::to_string(nbStars) + " stars saved in " + fileName);
+	return true;
+}
+
+void StarCatalog::exportTo(StarManager &mgr) const
+{
+	for (unsigned int i = 0; i < nbStars; ++i) {
+		starInfo *si = new starInfo(getStarInfo(i));
+		mgr.addHcStar(si);
+	}
+}
+
+int StarCatalog::findStar(unsigned int HIPName) const
+{
+	if (hipIndex.size() != nbStars) {
+		hipIndex.resize(nbStars);
+		for (unsigned int i = 0; i < nbStars; ++i)
+			hipIndex[i] = {hip[i], i};
+		// the first star of a HIP comes first, as with a linear search
+		std::sort(hipIndex.begin(), hipIndex.end());
+	}
+	auto it = std::lower_bound(hipIndex.begin(), hipIndex.end(), std::make_pair((uint32_t) HIPName, 0u));
+	if (it == hipIndex.end() || it->first != HIPName)
+		return -1;
+	return it->second;
+}
+
+starInfo StarCatalog::getStarInfo(unsigned int index) const
+{
+	starInfo si;
+	si.HIP = hip[index];
+	si.posXYZ = Vec3f(posX[index], posY[index], posZ[index]);
+	si.pmRA = pmRA[index];
+	si.pmDE = pmDE[index];
+	si.mag = mag[index];
+	si.B_V = bv[index];
+	si.pc = pc[index];
+	si.show = !hidden[index];
+	return si;
+}
+
+void StarCatalog::showAll()
+{
+	hidden.assign(nbStars, false);
+}
@@ -0,0 +1,165 @@
+/*
+* This source is the property of Immersive Adventure
+* http://immersiveadventure.net/
+*
+* It has been developped by part of the LSS Team.
+* For further informations, contact:
+*
+* albertpla@immersiveadventure.net
+*
+* This source code mustn't be copied or redistributed
+* without the authorization of Immersive Adventure
+* (c) 2017 - 2020 all rights reserved
+*
+*/
+
+#ifndef STARCATALOG_HPP
+#define STARCATALOG_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "tools/no_copy.hpp"
+#include "tools/source_key.hpp"
+
+struct starInfo;
+class StarManager;
+
+/**
+ * The mapped catalogue is a little-endian file made of
+ *
+ * | StarCatalogHeader | StarCatalogCube[nbCubes] | columns |
+ *
+ * Each column holds one field for all the stars, the stars of a cube are
+ * contiguous (StarCatalogCube::first, StarCatalogCube::count) and every
+ * column starts on a STAR_CATALOG_ALIGN boundary so that it can be used
+ * directly from the mapping.
+ */
+#define STAR_CATALOG_MAGIC "SCSTARNV"
+#define STAR_CATALOG_VERSION 3
+#define STAR_CATALOG_ALIGN 64
+
+enum StarCatalogColumn : uint32_t {
+	SCC_POS_X = 0,	// float, position in parsec
+	SCC_POS_Y,		// float
+	SCC_POS_Z,		// float
+	SCC_MAG,		// float, absolute magnitude
+	SCC_PM_RA,		// float
+	SCC_PM_DE,		// float
+	SCC_PC,			// float, distance to the sun in parsec
+	SCC_HIP,		// uint32_t, name of the star
+	SCC_B_V,		// uint8_t, color index (0..127)
+	SCC_COUNT
+};
+
+struct StarCatalogHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t headerSize;
+	uint64_t nbCubes;
+	uint64_t nbStars;
+	uint64_t cubeOffset;
+	uint64_t columnOffset[SCC_COUNT];
+	SourceKey source;	// text catalogue this one was compiled from, zero if none
+};
+
+struct StarCatalogCube {
+	int32_t hcPos[3];	// hypercube owning this cube
+	int32_t cubePos[3];	// position of the cube
+	uint32_t first;		// index of the first star of the cube
+	uint32_t count;		// number of stars in the cube
+	float center[3];	// bounding sphere of the stars of the cube
+	float radius;
+	float minMag;		// smallest absolute magnitude of the stars of the cube
+};
+
+/*! \class StarCatalog
+ * \brief star store of StarNavigator, one array per field of the stars
+ *
+ * \details The columns are either built from a StarManager or read in place
+ * from a mapped catalogue file, in which case no memory is allocated per star.
+ */
+class StarCatalog : public NoCopy {
+public:
+	StarCatalog();
+	~StarCatalog();
+
+	//! \brief copy all the stars of the manager in the columns
+	void build(const StarManager &mgr);
+	//! \brief map a catalogue saved by save()
+	//! \param source if not empty, the catalogue must have been compiled from this file as it is now
+	//! \return false if the file is missing or isn't a valid catalogue
+	bool map(const std::string &fileName, const std::string &source = "");
+	//! \brief save the columns in the mapped catalogue format
+	//! \param source key of the file the stars were read from
+	bool save(const std::string &fileName, const SourceKey &source = SourceKey()) const;
+	//! \brief add all the stars of the catalogue in the manager
+	void exportTo(StarManager &mgr) const;
+	//! \brief release the columns
+	void clear();
+
+	//! \return true if the columns come from a catalogue file instead of a StarManager
+	bool isMapped() const {
+		return mapStart != nullptr || fileData;
+	}
+
+	unsigned int size() const {
+		return nbStars;
+	}
+
+	unsigned int getNbCubes() const {
+		return nbCubes;
+	}
+
+	const StarCatalogCube *getCubes() const {
+		return cubes;
+	}
+
+	// columns
+	const float *posX = nullptr;
+	const float *posY = nullptr;
+	const float *posZ = nullptr;
+	const float *mag = nullptr;
+	const float *pmRA = nullptr;
+	const float *pmDE = nullptr;
+	const float *pc = nullptr;
+	const uint32_t *hip = nullptr;
+	const uint8_t *bv = nullptr;
+
+	//! \return index of the star named HIPName, -1 if it doesn't exist
+	//! the index by HIP is sorted on the first call
+	int findStar(unsigned int HIPName) const;
+	//! \brief rebuild the starInfo of the star at index
+	starInfo getStarInfo(unsigned int index) const;
+
+	bool isShown(unsigned int index) const {
+		return !hidden[index];
+	}
+	void setShow(unsigned int index, bool show) {
+		hidden[index] = !show;
+	}
+	void showAll();
+
+private:
+	// columns memory when built from a StarManager
+	std::vector<float> ownedFloat;
+	std::vector<uint32_t> ownedHip;
+	std::vector<uint8_t> ownedBv;
+	std::vector<StarCatalogCube> ownedCubes;
+	// mapped file
+	void *mapStart = nullptr;
+	size_t mapSize = 0;
+	std::unique_ptr<char[]> fileData; // used when mmap isn't available
+
+	const StarCatalogCube *cubes = nullptr;
+	unsigned int nbStars = 0;
+	unsigned int nbCubes = 0;
+	// stars hidden with hideStar, the columns themselves are read-only
+	std::vector<bool> hidden;
+	// (HIP, index) of every star sorted by HIP, built by findStar
+	mutable std::vector<std::pair<uint32_t, unsigned int>> hipIndex;
+};
+
+#endif
@@ -108,30 +108,24 @@ HyperCube::HyperCube(int x, int y, int z) :hcSize(HCSIZE), min(9999), max(0)
 void HyperCube::addCube(Cube *c)
 {
 	cubeList.push_back( c );
+	cubeIndex.emplace(CubeCoord{c->getCx(), c->getCy(), c->getCz()}, c);
 	nbrCubes=nbrCubes+1;
 }
 
 unsigned int HyperCube::getNbrStars()
 {
 	unsigned tmp = 0;
-	std::vector<Cube*> list = getCubeList();
-	for(std::vector<Cube*>::iterator i = list.begin(); i!= list.end(); ++i) {
-		tmp = tmp+ (*i)->getNbStars();
+	for(Cube *cube : cubeList) {
+		tmp = tmp+ cube->getNbStars();
 	}
 	return tmp;
 }
 
 //Determine if a cube exists, if so return a pointer
-Cube* HyperCube::cubeExist(int a, int b, int c)
+Cube* HyperCube::cubeExist(int a, int b, int c) const
 {
-	std::vector<Cube*> list = getCubeList();
-	for(std::vector<Cube*>::iterator i = list.begin(); i!= list.end(); ++i) {
-		Cube *cube = *i;
-		if( ( (*i)->getCx() == a) && ( (*i)->getCy() == b) && ( (*i)->getCz() == c) ) {
-			return cube;
-		}
-	}
-	return nullptr;
+	auto it = cubeIndex.find(CubeCoord{a, b, c});
+	return (it != cubeIndex.end()) ? it->second : nullptr;
 }
 
 //Find in which cube the star is located
@@ -203,6 +197,7 @@ StarManager::StarManager():nbrCubes(0), nbrHyperCubes(0), MinMagnitude(500)
 void StarManager::addHyperCube(HyperCube *hcb)
 {
 	hyperCubeList.push_back( hcb );
+	hyperCubeIndex.emplace(CubeCoord{hcb->getCx(), hcb->getCy(), hcb->getCz()}, hcb);
 	nbrHyperCubes++;
 }
 
@@ -219,9 +214,8 @@ StarManager::~StarManager()
 unsigned int StarManager::getNbrStars()
 {
 	unsigned int tmp = 0;
-	std::vector<HyperCube*> list = getHyperCubeList();
-	for(std::vector<HyperCube*>::iterator i = list.begin(); i!= list.end(); ++i) {
-		tmp = tmp + (*i)->getNbrStars();
+	for(HyperCube *hc : hyperCubeList) {
+		tmp = tmp + hc->getNbrStars();
 	}
 	return tmp;
 }
@@ -489,8 +483,8 @@ bool StarManager::saveStarBinCatalog(const std::string &fileName)
 		file.write((char *)&z, sizeof(z));
 		file.write((char *)&nbr, sizeof(nbr));
 
-		std::vector<Cube*> List = (*hc)->getCubeList();
-		for(std::vector<Cube*>::iterator c = List.begin(); c!= List.end(); ++c) {
+		const std::vector<Cube*> &List = (*hc)->getCubeList();
+		for(std::vector<Cube*>::const_iterator c = List.begin(); c!= List.end(); ++c) {
 
 			//~ file << "C" << " " << (*c)->getCx() << " " <<(*c)->getCy() << " " << (*c)->getCz() << " " << (*c)->getNbStars() << std::endl;
 			file.put('C');
@@ -504,8 +498,8 @@ bool StarManager::saveStarBinCatalog(const std::string &fileName)
 			file.write((char *)&z, sizeof(z));
 			file.write((char *)&nbr, sizeof(nbr));
 
-			std::vector<starInfo*> List2 = (*c)->getStarList();
-			for(std::vector<starInfo*>::iterator star = List2.begin(); star!= List2.end(); ++star) {
+			const std::vector<starInfo*> &List2 = (*c)->getStarList();
+			for(std::vector<starInfo*>::const_iterator star = List2.begin(); star!= List2.end(); ++star) {
 				file.put('S');
 				nbrS++;
 				nbr = (*star)->HIP;
@@ -557,13 +551,13 @@ bool StarManager::saveStarCatalog(const std::string &fileName)
 
 		file << "H" << " " << (*hc)->getCx() << " " << (*hc)->getCy() << " " << (*hc)->getCz() << " " << (*hc)->getNbrCubes() << std::endl;
 
-		std::vector<Cube*> List = (*hc)->getCubeList();
-		for(std::vector<Cube*>::iterator c = List.begin(); c!= List.end(); ++c) {
+		const std::vector<Cube*> &List = (*hc)->getCubeList();
+		for(std::vector<Cube*>::const_iterator c = List.begin(); c!= List.end(); ++c) {
 
 			file << "C" << " " << (*c)->getCx() << " " <<(*c)->getCy() << " " << (*c)->getCz() << " " << (*c)->getNbStars() << std::endl;
 
-			std::vector<starInfo*> List2 = (*c)->getStarList();
-			for(std::vector<starInfo*>::iterator star = List2.begin(); star!= List2.end(); ++star) {
+			const std::vector<starInfo*> &List2 = (*c)->getStarList();
+			for(std::vector<starInfo*>::const_iterator star = List2.begin(); star!= List2.end(); ++star) {
 
 				file << "S" << " " << (*star)->HIP << " " << (*star)->posXYZ[0] << " " << (*star)->posXYZ[1] << " " << (*star)->posXYZ[2] << " " << (*star)->pmRA << " " << (*star)->pmDE << " " << (*star)->mag << " " << (*star)->B_V << " " << (*star)->pc << std::endl;
 			}
@@ -575,16 +569,10 @@ bool StarManager::saveStarCatalog(const std::string &fileName)
 }
 
 //Determine if a hypercube exists, if so return a pointer
-HyperCube* StarManager::hcExist(int a, int b, int c)
+HyperCube* StarManager::hcExist(int a, int b, int c) const
 {
-	std::vector<HyperCube*> list = getHyperCubeList();
-	for(std::vector<HyperCube*>::iterator i = list.begin(); i!= list.end(); ++i) {
-
-		if (((*i)->getCx()== a) && ((*i)->getCy()== b) && ((*i)->getCz()== c) ) {
-			return (*i);
-		}
-	}
-	return nullptr;
+	auto it = hyperCubeIndex.find(CubeCoord{a, b, c});
+	return (it != hyperCubeIndex.end()) ? it->second : nullptr;
 }
 
 
@@ -922,10 +910,10 @@ void StarManager::MagStarStatistiques()
 	for(int i=0; i< MAG_PAS; i++)
 		statMagStars[i]=0;
 	for(std::vector<HyperCube*>::iterator i = hyperCubeList.begin(); i!= hyperCubeList.end(); ++i) {
-		std::vector<Cube*> List = (*i)->getCubeList();
-		for(std::vector<Cube*>::iterator j = List.begin(); j!= List.end(); ++j) {
-			std::vector<starInfo*> List2 = (*j)->getStarList();
-			for (std::vector<starInfo*>::iterator k = List2.begin(); k!= List2.end(); ++k) {
+		const std::vector<Cube*> &List = (*i)->getCubeList();
+		for(std::vector<Cube*>::const_iterator j = List.begin(); j!= List.end(); ++j) {
+			const std::vector<starInfo*> &List2 = (*j)->getStarList();
+			for (std::vector<starInfo*>::const_iterator k = List2.begin(); k!= List2.end(); ++k) {
 				int tmp=(40+(*k)->mag)/5;
 				if (tmp<0) tmp=0;
 				if (tmp+1>MAG_PAS) tmp=MAG_PAS-1;
@@ -962,8 +950,8 @@ bool StarManager::verificationData()
 		}
 
 		//verification of cubes
-		std::vector<Cube*> List = (*i)->getCubeList();
-		for(std::vector<Cube*>::iterator j = List.begin(); j!= List.end(); ++j) {
+		const std::vector<Cube*> &List = (*i)->getCubeList();
+		for(std::vector<Cube*>::const_iterator j = List.begin(); j!= List.end(); ++j) {
 			Cube *tmp2 = (*j);
 
 			if (tmp2->getCx() %CUBESIZE !=0 || tmp2->getCy() %CUBESIZE !=0 || tmp2->getCz() %CUBESIZE !=0 ) {
@@ -1025,10 +1013,10 @@ bool StarManager::saveAsterismStarsPosition(const std::string &fileNameIn,const
 starInfo* StarManager::findStar(unsigned int HIPName)
 {
 	for(std::vector<HyperCube*>::iterator hc = hyperCubeList.begin(); hc!= hyperCubeList.end(); ++hc) {
-		std::vector<Cube*> List = (*hc)->getCubeList();
-		for(std::vector<Cube*>::iterator c = List.begin(); c!= List.end(); ++c) {
-			std::vector<starInfo*> List2 = (*c)->getStarList();
-			for(std::vector<starInfo*>::iterator star = List2.begin(); star!= List2.end(); ++star) {
+		const std::vector<Cube*> &List = (*hc)->getCubeList();
+		for(std::vector<Cube*>::const_iterator c = List.begin(); c!= List.end(); ++c) {
+			const std::vector<starInfo*> &List2 = (*c)->getStarList();
+			for(std::vector<starInfo*>::const_iterator star = List2.begin(); star!= List2.end(); ++star) {
 				if ((*star)->HIP == HIPName)
 					return (*star);
 			}
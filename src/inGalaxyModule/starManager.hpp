@@ -30,7 +30,9 @@
 #define NBR_PAS_STATHC 8
 #define MAG_PAS 12
 
+#include <cstdint>
 #include <vector>
+#include <unordered_map>
 #include "tools/vecmath.hpp"
 //#include "tools/ia.hpp"
 
@@ -50,6 +52,24 @@ struct starInfo {
 // GPU need posXYZ, mag, B_V (COMPACT = 4 float, 1 int)
 // CPU need HIP
 
+//! \struct CubeCoord
+//! \brief clé de la table de hachage des cubes et des hypercubes : coordonnées entières du centre
+struct CubeCoord {
+	int x, y, z;
+	bool operator==(const CubeCoord &other) const {
+		return x == other.x && y == other.y && z == other.z;
+	}
+};
+
+struct CubeCoordHash {
+	size_t operator()(const CubeCoord &c) const {
+		uint64_t h = (uint64_t)(uint32_t)c.x * 0x9E3779B97F4A7C15ull;
+		h ^= (uint64_t)(uint32_t)c.y * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+		h ^= (uint64_t)(uint32_t)c.z * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+		return h;
+	}
+};
+
 
 //! \class Cube
 //! \brief la classe cube va contenir les étoiles
@@ -93,7 +113,7 @@ public:
 	}
 
 	//! \brief getter sur la lsite des étoiles du cube
-	std::vector<starInfo*> getStarList() {
+	const std::vector<starInfo*> &getStarList() const {
 		return starList;
 	}
 
@@ -137,7 +157,7 @@ public:
 	}
 
 	//! \return return the cube list for an hyperCube
-	std::vector<Cube*> getCubeList() {
+	const std::vector<Cube*> &getCubeList() const {
 		return cubeList;
 	}
 
@@ -162,7 +182,7 @@ public:
 
 	//! \brief Vérifie qu'un cube existe en coordonnée (a,b,c)
 	//! \return pointeur sur le cube s'il existe nullptr sinon
-	Cube* cubeExist(int a, int b, int c);
+	Cube* cubeExist(int a, int b, int c) const;
 
 	//! \brief ajoute une étoile dans l'Hypercube, crée un cube si besoin
 	void addCubeStar(starInfo* star);
@@ -185,6 +205,7 @@ protected:
 	int c_y;
 	int c_z;
 	std::vector<Cube*> cubeList;
+	std::unordered_map<CubeCoord, Cube*, CubeCoordHash> cubeIndex; //!< accès direct aux cubes par leurs coordonnées
 	int min,max;
 	float MinMagnitude;
 	static unsigned int NbTotalHyperCube;
@@ -225,7 +246,7 @@ public:
 	int getNbrCubes();
 
 	//! \return return the hypercube list which is in the starManager
-	std::vector<HyperCube*> getHyperCubeList() {
+	const std::vector<HyperCube*> &getHyperCubeList() const {
 		return hyperCubeList;
 	}
 
@@ -251,7 +272,7 @@ public:
 	bool saveStarBinCatalog(const std::string &fileName);
 
 	//! \brief Détermine si un hypercube existe, si oui retourne un pointeur sur ce dernier
-	HyperCube* hcExist(int a, int b, int c);
+	HyperCube* hcExist(int a, int b, int c) const;
 
 	//! \brief Ajoute une étoile dans starManager
 	void addHcStar(starInfo* star);
@@ -280,6 +301,7 @@ public:
 
 protected:
 	std::vector<HyperCube*> hyperCubeList;
+	std::unordered_map<CubeCoord, HyperCube*, CubeCoordHash> hyperCubeIndex; //!< accès direct aux hypercubes par leurs coordonnées
 	int nbrCubes;
 	int nbrHyperCubes;
 	float MinMagnitude;
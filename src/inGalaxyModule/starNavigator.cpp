@@ -18,13 +18,17 @@
 #include <fstream>
 #include <cmath>
 #include <thread>
+#include <algorithm>
+#include <filesystem>
 
 
 #include "inGalaxyModule/starNavigator.hpp"
 #include "inGalaxyModule/starManager.hpp"
+#include "inGalaxyModule/starCatalog.hpp"
 #include "tools/utility.hpp"
 #include "tools/s_texture.hpp"
 #include "tools/log.hpp"
+#include "tools/app_settings.hpp"
 #include "tools/ThreadPool.hpp"
 #include "atmosphereModule/tone_reproductor.hpp"
 #include "coreModule/projector.hpp"
@@ -38,6 +42,10 @@
 static float magnitude_max = 6.5;
 
 #define DELTA_PARSEC 0.005
+// smallest packet given to the thread pool, in stars
+#define MIN_STARS_PER_PACKET 8192
+// packets per thread, to balance the work when cubes are culled
+#define PACKETS_PER_THREAD 4
 
 //////////////////// PARAMETRES STARS //////////////////////////////////////////
 static float fov_stars = 60.f;
@@ -61,14 +69,13 @@ std::map<std::string,int> StarNavigator::common_names_index_i18n;
 StarNavigator::StarNavigator() : nbStars(0)
 {
 	starMgr = std::make_unique<StarManager>();
+	catalog = std::make_unique<StarCatalog>();
 
 	createSC_context();
 	starTexture = new s_texture("star16x16.png",TEX_LOAD_TYPE_PNG_SOLID,false);  // Load star texture no mipmap
 	set->bindTexture(starTexture->getTexture(), 0);
 	old_pos = v3fNull;
 
-	pool= new ThreadPool(std::thread::hardware_concurrency());
-
 	computeRCMagTable();
 }
 
@@ -110,6 +117,7 @@ void StarNavigator::createSC_context()
 
 void StarNavigator::loadRawData(const std::string &fileName) noexcept
 {
+	unmapCatalog();
 	starMgr->loadStarRaw(fileName);
 	starMgr->loadStarBinCatalog(fileName);
 	setListGlobalStarVisible();
@@ -117,12 +125,14 @@ void StarNavigator::loadRawData(const std::string &fileName) noexcept
 
 void StarNavigator::loadOtherData(const std::string &fileName) noexcept
 {
+	unmapCatalog();
 	starMgr->loadOtherStar(fileName);
 	setListGlobalStarVisible();
 }
 
 void StarNavigator::loadData(const std::string &fileName, bool binaryData) noexcept
 {
+	unmapCatalog();
 	if (binaryData)
 		starMgr->loadStarBinCatalog(fileName);
 	else
@@ -130,6 +140,75 @@ void StarNavigator::loadData(const std::string &fileName, bool binaryData) noexc
 	setListGlobalStarVisible();
 }
 
+void StarNavigator::loadMappedData(const std::string &fileName) noexcept
+{
+	// the current stars are kept if the file can't be mapped
+	auto mapped = std::make_unique<StarCatalog>();
+	if (!mapped->map(fileName))
+		return;
+	// the mapped stars replace the current ones
+	catalog = std::move(mapped);
+	starMgr = std::make_unique<StarManager>();
+	maxStars = catalog->size();
+	needComputeRCMagTable = true;
+	build();
+}
+
+void StarNavigator::loadCachedData(const std::string &fileName) noexcept
+{
+	prepareCachedData(fileName);
+	build();
+}
+
+void StarNavigator::prepareCachedData(const std::string &fileName) noexcept
+{
+	const std::string cacheName = AppSettings::Instance()->getCacheDir() + std::filesystem::path(fileName).filename().string() + ".bin";
+	starMgr = std::make_unique<StarManager>();
+	if (!catalog->map(cacheName, fileName)) {
+		cLog::get()->write("StarNavigator, compiling " + fileName + " into " + cacheName);
+		SourceKey source;
+		if (!starMgr->loadStarCatalog(fileName) || !source.read(fileName)) {
+			catalog->build(*starMgr);
+			maxStars = catalog->size();
+			needComputeRCMagTable = true;
+			return;
+		}
+		catalog->build(*starMgr);
+		// written beside the cache and renamed, a broken cache is never mapped
+		std::error_code ec;
+		if (catalog->save(cacheName + ".tmp", source))
+			std::filesystem::rename(cacheName + ".tmp", cacheName, ec);
+		// the stars are used from the cache like at the next start
+		if (!catalog->map(cacheName, fileName)) {
+			// map() emptied the catalog, the stars are kept from the text file
+			catalog->build(*starMgr);
+			maxStars = catalog->size();
+			needComputeRCMagTable = true;
+			return;
+		}
+		starMgr = std::make_unique<StarManager>();
+	}
+	maxStars = catalog->size();
+	needComputeRCMagTable = true;
+}
+
+void StarNavigator::unmapCatalog()
+{
+	if (!catalog->isMapped())
+		return;
+	catalog->exportTo(*starMgr);
+	catalog->clear();
+}
+
+void StarNavigator::clear()
+{
+	starMgr = std::make_unique<StarManager>();
+	catalog->clear();
+	maxStars = 0;
+	nbStars = 0;
+	needComputeRCMagTable = true;
+}
+
 //! Load common names from file
 int StarNavigator::loadCommonNames(const std::string& commonNameFile)
 {
@@ -199,15 +278,20 @@ void StarNavigator::updateI18n(Translator& trans)
 
 void StarNavigator::saveData(const std::string &fileName, bool binaryData) noexcept
 {
+	unmapCatalog();
 	if (binaryData)
 		starMgr->saveStarBinCatalog(fileName);
 	else
 		starMgr->saveStarCatalog(fileName);
 }
 
+void StarNavigator::saveMappedData(const std::string &fileName) noexcept
+{
+	catalog->save(fileName);
+}
+
 StarNavigator::~StarNavigator()
 {
-	delete pool;
 }
 
 void StarNavigator::clearBuffer()
@@ -216,9 +300,6 @@ void StarNavigator::clearBuffer()
 	starVec = (float *) Context::instance->transfer->beginPlanCopy(maxStars * 7 * sizeof(float));
 }
 
-starInfo* StarNavigator::getStarInfo(unsigned int HIPName) const {
-	return starMgr->findStar(HIPName);
-}
 
 std::string StarNavigator::getStarName(unsigned int HIPName) {
 	std::string name = common_names_map_i18n[HIPName];
@@ -230,31 +311,8 @@ std::string StarNavigator::getStarName(unsigned int HIPName) {
 
 void StarNavigator::setListGlobalStarVisible()
 {
-	std::vector<HyperCube*> hcList = starMgr->getHyperCubeList();
-	std::vector<HyperCube*> hcGlobalVisible;
-	std::vector<Cube*> cubeGlobalVisible;
-	std::vector<HyperCube*> hcVisible;
-	std::vector<Cube*> cubeVisible;
-
-	for(std::vector<HyperCube*>::iterator i = hcList.begin(); i != hcList.end(); ++i) {
-		HyperCube *hc = *i;
-
-		hcGlobalVisible.push_back(hc);
-		std::vector<Cube*> cubeList = hc->getCubeList();
-
-		for(std::vector<Cube*>::iterator j = cubeList.begin(); j != cubeList.end(); ++j) {
-			Cube *c = *j;
-
-			cubeGlobalVisible.push_back(c);
-			std::vector<starInfo*> stars = c->getStarList();
-
-			for(std::vector<starInfo*>::iterator k = stars.begin(); k != stars.end(); ++k) {
-				starInfo *si = *k;
-				listGlobalStarVisible.push_back(si);
-			}
-		}
-	}
-	maxStars = listGlobalStarVisible.size();
+	catalog->build(*starMgr);
+	maxStars = catalog->size();
 	build();
 }
 
@@ -455,7 +513,7 @@ int StarNavigator::computeRCMag(float mag, const ToneReproductor *eye, float rc_
 //pos indicates the position of the camera
 void StarNavigator::computePosition(Vec3f posI) noexcept
 {
-	if (listGlobalStarVisible.size()<1)
+	if (maxStars<1)
 		return;
 
 	pos=Mat4f::xrotation(M_PI_2+23.4392803055555555556*M_PI/180)*posI;
@@ -471,20 +529,39 @@ void StarNavigator::computePosition(Vec3f posI) noexcept
 	old_pos = pos;
 	clearBuffer();
 
-	unsigned int nbPaquets= 40;
-	for(unsigned int i=0; i<nbPaquets; i++)
-		this->results.emplace_back( pool->enqueue( StarNavigator::threadWrapper, this, maxStars*i/nbPaquets, maxStars*(i+1)/nbPaquets) );
-
-	for(auto && result: results)
-		result.get();
-	results.clear();
+	TaskGroup group(ThreadPool::shared());
+	for(unsigned int i=0; i+1<packetCubes.size(); i++)
+		group.run([this, i] { computeChunk(i); });
+	group.wait();
 
 	Context::instance->transfer->endPlanCopy(vertex->get(), nbStars * 7 * sizeof(float));
 	drawData->get().vertexCount = nbStars;
 }
 
+void StarNavigator::splitPackets()
+{
+	// the thread waiting on the group computes packets too
+	const unsigned int nbThreads = ThreadPool::shared().size() + 1;
+	const unsigned int nbPackets = std::max(1u, std::min(nbThreads * PACKETS_PER_THREAD, maxStars / MIN_STARS_PER_PACKET));
+	const StarCatalogCube *cubes = catalog->getCubes();
+	const unsigned int nbCubes = catalog->getNbCubes();
+
+	packetCubes.clear();
+	packetCubes.push_back(0);
+	uint64_t stars = 0;
+	for (unsigned int c = 0; c < nbCubes; ++c) {
+		stars += cubes[c].count;
+		if (stars >= (uint64_t) maxStars * packetCubes.size() / nbPackets)
+			packetCubes.push_back(c + 1);
+	}
+	if (packetCubes.back() != nbCubes)
+		packetCubes.push_back(nbCubes);
+	packetVertices.resize(packetCubes.size() - 1);
+}
+
 void StarNavigator::build()
 {
+	splitPackets();
 	Context &context = *Context::instance;
 	vertex.reset();
 	vertex = m_dataGL->createBuffer(0, maxStars * 7, context.globalBuffer.get());
@@ -499,71 +576,85 @@ void StarNavigator::build()
 	}
 }
 
-bool StarNavigator::computeChunk(unsigned int first, unsigned int last)
+bool StarNavigator::computeChunk(unsigned int packet)
 {
 	float rayon;
 	int indice;
 	float intensite;
 
-	for(unsigned int i = first; i != last; ++i) {
-		starInfo *si = listGlobalStarVisible[i];
+	const StarCatalog &cat = *catalog;
+	const StarCatalogCube *cubes = cat.getCubes();
+	std::vector<float> &vertices = packetVertices[packet];
+	vertices.clear();
 
-		float x = -si->posXYZ[0];
-		float y = si->posXYZ[1];
-		float z = si->posXYZ[2];
+	// Roll off star size limit as fov decreases to match planet halo scale
+	RangeMap<float> rmap(180, 1, -starSizeLimit, -(starSizeLimit + objectSizeLimit));
+	const float rolloff = -rmap.Map(fov);
 
-		if (si->show == false)
+	for(unsigned int c = packetCubes[packet]; c != packetCubes[packet+1]; ++c) {
+		const StarCatalogCube &cube = cubes[c];
+
+		// no star of the cube is closer than the border of its bounding sphere
+		float dx = -cube.center[0]-pos[0];
+		float dy = cube.center[1]-pos[1];
+		float dz = cube.center[2]-pos[2];
+		float nearest = sqrt(dx*dx + dy*dy + dz*dz) - cube.radius;
+		if (nearest > 0 && cube.minMag+5*(log10(nearest)-1) >= magnitude_max)
 			continue;
 
-		//test magnitude if magnitude too low, the star will not be displayed
-		float dist =sqrt((x-pos[0])*(x-pos[0]) + (y-pos[1])*(y-pos[1]) +(z-pos[2])*(z-pos[2]));
-		float mag_v = si->mag+5*(log10(dist)-1);
-		if ( mag_v  < magnitude_max) {
+		const unsigned int last = cube.first + cube.count;
+		for(unsigned int i = cube.first; i != last; ++i) {
+			float x = -cat.posX[i];
+			float y = cat.posY[i];
+			float z = cat.posZ[i];
 
-			//calculation of the radius and luminous intensity
-			mag_v= round(mag_v*1000)/1000;
-			indice = (int)((mag_v-(-4.0))/0.05);
+			if (!cat.isShown(i))
+				continue;
 
-			if (indice<0)
-				indice=0;
+			//test magnitude if magnitude too low, the star will not be displayed
+			float dist =sqrt((x-pos[0])*(x-pos[0]) + (y-pos[1])*(y-pos[1]) +(z-pos[2])*(z-pos[2]));
+			float mag_v = cat.mag[i]+5*(log10(dist)-1);
+			if ( mag_v  < magnitude_max) {
 
-			if (indice>256-1)
-				indice=255;
+				//calculation of the radius and luminous intensity
+				mag_v= round(mag_v*1000)/1000;
+				indice = (int)((mag_v-(-4.0))/0.05);
 
-			rayon =rc_mag_table[2*indice];
-			intensite = rc_mag_table[2*indice+1];
+				if (indice<0)
+					indice=0;
 
-			if (intensite <0.01)
-				continue;
+				if (indice>256-1)
+					indice=255;
 
-			// Output of hip_star_mgr::drawStar
-			float magC = 2.f*rayon;
-			// Roll off star size limit as fov decreases to match planet halo scale
-			RangeMap<float> rmap(180, 1, -starSizeLimit, -(starSizeLimit + objectSizeLimit));
-			float rolloff = -rmap.Map(fov);
-			if( magC > rolloff )
-				magC = rolloff;
-			//END
+				rayon =rc_mag_table[2*indice];
+				intensite = rc_mag_table[2*indice+1];
 
-			if (magC <0.2)
-				continue;
+				if (intensite <0.01)
+					continue;
+
+				// Output of hip_star_mgr::drawStar
+				float magC = 2.f*rayon;
+				if( magC > rolloff )
+					magC = rolloff;
+				//END
 
+				if (magC <0.2)
+					continue;
 
-			//Determination of the color
-			Vec3f tcolor = color_table[si->B_V]*intensite ;
+				//Determination of the color
+				Vec3f tcolor = color_table[cat.bv[i] & 127]*intensite ;
 
-			// There must be no concurrent access to the same vulkan memory
-			accessTab.lock();
-			++nbStars;
-			*(starVec++) = x;
-			*(starVec++) = y;
-			*(starVec++) = z;
-			memcpy(starVec, (float *) tcolor, 3 * sizeof(float));
-			starVec += 3;
-			*(starVec++) = magC/2;
-			accessTab.unlock();
+				vertices.insert(vertices.end(), {x, y, z, tcolor[0], tcolor[1], tcolor[2], magC/2});
+			}
 		}
 	}
+
+	// There must be no concurrent access to the same vulkan memory
+	accessTab.lock();
+	memcpy(starVec, vertices.data(), vertices.size() * sizeof(float));
+	starVec += vertices.size();
+	nbStars += vertices.size() / 7;
+	accessTab.unlock();
 	return true;
 }
 
@@ -576,13 +667,13 @@ std::vector<ObjectBaseP> StarNavigator::searchAround(Vec3d v, double limitFov, c
 	v.normalize();
 	limitFov = limitFov * (M_PI/180.);
 	double cosLimitFov = cos(limitFov);
-	for (auto &star: listGlobalStarVisible) {
-		auto tmp = nav->helioToEarthPosEqu(Mat4f::xrotation(-M_PI_2-23.4392803055555555556*M_PI/180) * star->posXYZ);
+	for (unsigned int i = 0; i < maxStars; ++i) {
+		auto tmp = nav->helioToEarthPosEqu(Mat4f::xrotation(-M_PI_2-23.4392803055555555556*M_PI/180) * Vec3f(catalog->posX[i], catalog->posY[i], catalog->posZ[i]));
 		tmp[0] = -tmp[0];
 		tmp.normalize();
 		float dotProduct = tmp.dot(v);
 		if (dotProduct > cosLimitFov)
-			result.push_back(new Star3DWrapper(star, pos));
+			result.push_back(new Star3DWrapper(catalog->getStarInfo(i), pos));
 	}
 	return result;
 }
@@ -617,13 +708,14 @@ void StarNavigator::draw(const Navigator * nav, const Projector* prj, bool scali
 
 	const float names_brightness = fader.getInterstate() * names_fader;
 
-	for (auto &s: listGlobalStarVisible) {
-		Vec3f spos(-s->posXYZ[0], s->posXYZ[1], s->posXYZ[2]);
+	const StarCatalog &cat = *catalog;
+	for (unsigned int i = 0; i < maxStars; ++i) {
+		Vec3f spos(-cat.posX[i], cat.posY[i], cat.posZ[i]);
 		float dist = (spos - pos).length();
-		float mag_v = s->mag+5*(log10(dist)-1);
+		float mag_v = cat.mag[i]+5*(log10(dist)-1);
 
 		if (mag_v < maxMagStarName) {
-			const std::string starname = getStarName(s->HIP);
+			const std::string starname = getStarName(cat.hip[i]);
 			if (!starname.empty()) {
 
 				if (scaling)
@@ -633,9 +725,10 @@ void StarNavigator::draw(const Navigator * nav, const Projector* prj, bool scali
 				Vec3d screenposd;
 				prj->projectEarthEqu(spos, screenposd);
 
-				Vec4f Color(HipStarMgr::color_table[s->B_V][0]*0.75,
-							HipStarMgr::color_table[s->B_V][1]*0.75,
-							HipStarMgr::color_table[s->B_V][2]*0.75,
+				const int b_v = cat.bv[i] & 127;
+				Vec4f Color(HipStarMgr::color_table[b_v][0]*0.75,
+							HipStarMgr::color_table[b_v][1]*0.75,
+							HipStarMgr::color_table[b_v][2]*0.75,
 							names_brightness);
 				starNameToDraw.push_back(std::make_tuple(screenposd[0],screenposd[1], starname, Color));
 			}
@@ -653,18 +746,33 @@ void StarNavigator::drawRaw(const Mat4f &matrix) const noexcept
 
 void StarNavigator::hideStar(unsigned int hip)
 {
-	if (starInfo *si = getStarInfo(hip))
-		si->show = false;
+	setStarShow(hip, false);
 }
 
 void StarNavigator::showStar(unsigned int hip)
 {
-	if (starInfo *si = getStarInfo(hip))
-		si->show = true;
+	setStarShow(hip, true);
+}
+
+void StarNavigator::setStarShow(unsigned int hip, bool show)
+{
+	// called each frame for the selected star, the catalog holds every star of the StarManager
+	const int index = catalog->findStar(hip);
+	if (index < 0 || catalog->isShown(index) == show)
+		return;
+	catalog->setShow(index, show);
+	// kept in the StarManager for the next build of the catalog
+	if (!catalog->isMapped()) {
+		if (starInfo *si = starMgr->findStar(hip))
+			si->show = show;
+	}
 }
 
 void StarNavigator::showAllStar()
 {
-	for(starInfo *si : listGlobalStarVisible)
-		si->show = true;
+	catalog->showAll();
+	for (HyperCube *hc : starMgr->getHyperCubeList())
+		for (Cube *c : hc->getCubeList())
+			for (starInfo *si : c->getStarList())
+				si->show = true;
 }
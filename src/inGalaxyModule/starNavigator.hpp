@@ -53,6 +53,7 @@ class Set;
 class s_texture;
 struct starInfo;
 class StarManager;
+class StarCatalog;
 
 typedef std::tuple<double, double, const std::string , const Vec4f > starDBtoDraw;
 
@@ -70,6 +71,12 @@ public:
 	void loadRawData(const std::string &fileName) noexcept;
 	void loadOtherData(const std::string &fileName) noexcept;
 	void loadData(const std::string &fileName, bool binaryData) noexcept;
+	//! Map a catalogue saved by saveMappedData, the stars are used in place
+	void loadMappedData(const std::string &fileName) noexcept;
+	//! Load a text catalogue through its compiled copy in the cache directory, compiled at the first call
+	void loadCachedData(const std::string &fileName) noexcept;
+	//! First part of loadCachedData, without build(): doesn't use the vulkan context
+	void prepareCachedData(const std::string &fileName) noexcept;
 
 	//! Loads common names for stars from a file.
 	//! Called when the SkyCulture is updated.
@@ -77,6 +84,8 @@ public:
 	int loadCommonNames(const std::string& commonNameFile);
 
 	void saveData(const std::string &fileName, bool binaryData) noexcept;
+	//! Save the loaded stars in the mapped catalogue format
+	void saveMappedData(const std::string &fileName) noexcept;
 	/*! /fn
 	 * \brief displays the stars of the catalog on the screen
 	 * \param nav for marker change matrices
@@ -166,12 +175,7 @@ public:
 		return names_fader.finalState();
 	}
 
-	void clear(){
-		listGlobalStarVisible.clear();
-		needComputeRCMagTable = true;
-	}
-
-	starInfo* getStarInfo(unsigned int HIPName) const;
+	void clear();
 
 	static std::string getStarName(unsigned int HIPName);
 
@@ -220,13 +224,17 @@ private:
 
 	//precalculation of the color table
 	void computeRCMagTable();
-	//list of stars to display from the StarManager
-	std::vector<starInfo*> listGlobalStarVisible;
-	// size of the listGlobalStarVisible
-	unsigned int maxStars;
+	//stars to display, built from the StarManager or mapped from a file
+	std::unique_ptr<StarCatalog> catalog;
+	// size of the catalog
+	unsigned int maxStars = 0;
 	int nbStars;
-	//function to set listGlobalStarVisible
+	//function to rebuild the catalog from the StarManager
 	void setListGlobalStarVisible();
+	//move the stars of a mapped catalog into the StarManager
+	void unmapCatalog();
+	//show or hide the star named hip, in the catalog and in the StarManager
+	void setStarShow(unsigned int hip, bool show);
 	//function to set buffers for shaders to zero
 	void clearBuffer();
 
@@ -244,7 +252,13 @@ private:
 	//mutex on display buffers
 	std::mutex accessTab;
 	// sub-function for computePosition threads
-	bool computeChunk(unsigned int first, unsigned int last);
+	bool computeChunk(unsigned int packet);
+	// split the cubes of the catalog in packets of similar star count
+	void splitPackets();
+	// first cube of each packet, the last value is the number of cubes
+	std::vector<unsigned int> packetCubes;
+	// vertices computed by each packet
+	std::vector<std::vector<float>> packetVertices;
 
 	float mag_shift = 0.f;	//<stars, mag_converter_mag_schift>
 	float max_mag= 6.5f;		//<stars, mag_converter_max_mag>
@@ -259,12 +273,6 @@ private:
 	static std::map<std::string, int> common_names_index_i18n;
 
 	bool needComputeRCMagTable = true;
-
-	static bool threadWrapper(StarNavigator *a, int first, unsigned int last)
-		{return a->computeChunk(first, last);};
-
-	ThreadPool *pool=nullptr;
-	std::vector< std::future<bool> > results;
 };
 
 #endif
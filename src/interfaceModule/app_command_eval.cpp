@@ -1,4 +1,5 @@
 #include "interfaceModule/app_command_eval.hpp"
+#include "scriptModule/script_command.hpp"
 #include "coreModule/coreLink.hpp"
 #include "tools/utility.hpp"
 #include "tools/log.hpp"
@@ -52,18 +53,47 @@ AppCommandEval::~AppCommandEval()
 	this->deleteVar();
 }
 
+int AppCommandEval::getVariableIndex(const std::string &name)
+{
+	auto it = variableIndex.find(name);
+	if (it != variableIndex.end())
+		return it->second;
+	variables.emplace_back();
+	variableIndex.emplace(name, variables.size() - 1);
+	return variables.size() - 1;
+}
+
+const AppCommandEval::Variable *AppCommandEval::findVariable(const std::string &name) const
+{
+	auto it = variableIndex.find(name);
+	if (it == variableIndex.end() || !variables[it->second].defined)
+		return nullptr;
+	return &variables[it->second];
+}
+
+AppCommandEval::Variable &AppCommandEval::setVariable(const std::string &name)
+{
+	Variable &variable = variables[getVariableIndex(name)];
+	variable.defined = true;
+	return variable;
+}
+
+std::string AppCommandEval::evalVariableString(const Variable &variable)
+{
+	double v = evalDouble(variable.value);
+	if (v == trunc(v))
+		return std::to_string(evalInt(variable.value));
+	else
+		return variable.value;
+}
+
 std::string AppCommandEval::evalString(const std::string &var)
 {
-	auto var_it = variables.find(var);
-	if (var_it == variables.end()) //not found so we return the value of the string
+	const Variable *variable = findVariable(var);
+	if (variable == nullptr) //not found so we return the value of the string
 		return var;
-	else {// found returns the value of what is stored in memory
-		double v = evalDouble(var_it->second);
-		if (v == trunc(v))
-			return std::to_string(evalInt(var_it->second));
-		else
-			return var_it->second;
-		}
+	else // found returns the value of what is stored in memory
+		return evalVariableString(*variable);
 }
 
 double AppCommandEval::evalDouble(const std::string &var)
@@ -71,13 +101,13 @@ double AppCommandEval::evalDouble(const std::string &var)
 	// capture context with reservedVariables Elitit-40
 	auto reservedVar = m_reservedVar.find(var);
 	if (reservedVar != m_reservedVar.end())
-		return evalReservedVariable(var);
+		return evalReservedVariable(reservedVar->second);
 
-	auto var_it = variables.find(var);
-	if (var_it == variables.end()) //not found so we return the value of the string
+	const Variable *variable = findVariable(var);
+	if (variable == nullptr) //not found so we return the value of the string
 		return Utility::strToDouble(var);
 	else // found returns the value of what is stored in memory
-		return Utility::strToDouble(var_it->second);
+		return Utility::strToDouble(variable->value);
 }
 
 int AppCommandEval::evalInt(const std::string &var)
@@ -86,7 +116,67 @@ int AppCommandEval::evalInt(const std::string &var)
 	return (int) tmp;
 }
 
-void AppCommandEval::define(const std::string& mArg, const std::string& mValue)
+// the reserved variables come first, as in evalDouble, then the numeric literals
+// a numeric literal is never looked up as a variable name
+void AppCommandEval::resolve(ScriptArgument &argument)
+{
+	auto reservedVar = m_reservedVar.find(argument.value);
+	if (reservedVar != m_reservedVar.end()) {
+		argument.kind = SC_ARGUMENT::RESERVED;
+		argument.index = (int) reservedVar->second;
+		return;
+	}
+	argument.number = Utility::strToDouble(argument.value);
+	size_t length = 0;
+	try {
+		std::stod(argument.value, &length);
+	} catch (...) {
+		length = 0;
+	}
+	if (length > 0 && length == argument.value.size()) {
+		argument.kind = SC_ARGUMENT::NUMBER;
+	} else {
+		argument.kind = SC_ARGUMENT::VARIABLE;
+		argument.index = getVariableIndex(argument.value);
+	}
+}
+
+std::string AppCommandEval::evalString(const ScriptArgument &argument)
+{
+	switch (argument.kind) {
+		case SC_ARGUMENT::TEXT:
+			return evalString(argument.value);
+		case SC_ARGUMENT::VARIABLE:
+			if (variables[argument.index].defined)
+				return evalVariableString(variables[argument.index]);
+			return argument.value;
+		default:
+			return argument.value;
+	}
+}
+
+double AppCommandEval::evalDouble(const ScriptArgument &argument)
+{
+	switch (argument.kind) {
+		case SC_ARGUMENT::NUMBER:
+			return argument.number;
+		case SC_ARGUMENT::RESERVED:
+			return evalReservedVariable((SC_RESERVED_VAR) argument.index);
+		case SC_ARGUMENT::VARIABLE:
+			if (variables[argument.index].defined)
+				return Utility::strToDouble(variables[argument.index].value);
+			return argument.number;
+		default:
+			return evalDouble(argument.value);
+	}
+}
+
+int AppCommandEval::evalInt(const ScriptArgument &argument)
+{
+	return (int) evalDouble(argument);
+}
+
+void AppCommandEval::define(const std::string& mArg, const ScriptArgument& mValue)
 {
 	auto reservedVar = m_reservedVar.find(mArg);
 	if (reservedVar != m_reservedVar.end()) {
@@ -95,11 +185,11 @@ void AppCommandEval::define(const std::string& mArg, const std::string& mValue)
 		return;
 	}
 	//std::cout << "C_define : " <<  mArg.c_str() << " => " << mValue.c_str() << std::endl;
-	if (mValue == "random") {
+	if (mValue.value == "random") {
 		//std::cout << "C_define random: min " <<  min_random << " max " << max_random << std::endl;
 		float value = (float)rand()/RAND_MAX* (max_random-min_random)+ min_random;
 		//std::cout << "C_define random: value " <<  value  << std::endl;
-		variables[mArg] = std::to_string(value);
+		setVariable(mArg).value = std::to_string(value);
 	} else {
 		//~ printf("mValue = %s\n", mValue.c_str());
 		// std::cout << "This value of mValue is " << evalDouble(mValue) << std::endl;
@@ -108,48 +198,48 @@ void AppCommandEval::define(const std::string& mArg, const std::string& mValue)
 		//if (v == trunc(v))
 		//	variables[mArg] = std::to_string(evalInt(mValue));
 		//else
-			variables[mArg] = std::to_string(v);
+			setVariable(mArg).value = std::to_string(v);
 	//	this->printVar();
 	}
 }
 
-void AppCommandEval::commandAdd(const std::string& mArg, const std::string& mValue)
+void AppCommandEval::commandAdd(const std::string& mArg, const ScriptArgument& mValue)
 {
 	this->evalOps(mArg,mValue, f_add);
 }
 
-void AppCommandEval::commandSub(const std::string& mArg, const std::string& mValue)
+void AppCommandEval::commandSub(const std::string& mArg, const ScriptArgument& mValue)
 {
 	this->evalOps(mArg,mValue, f_sub);
 }
 
-void AppCommandEval::commandMul(const std::string& mArg, const std::string& mValue)
+void AppCommandEval::commandMul(const std::string& mArg, const ScriptArgument& mValue)
 {
 	this->evalOps(mArg,mValue, f_mul);
 }
 
-void AppCommandEval::commandDiv(const std::string& mArg, const std::string& mValue)
+void AppCommandEval::commandDiv(const std::string& mArg, const ScriptArgument& mValue)
 {
 	this->evalOps(mArg,mValue, f_div);
 }
 
-void AppCommandEval::commandTan(const std::string& mArg, const std::string& mValue)
+void AppCommandEval::commandTan(const std::string& mArg, const ScriptArgument& mValue)
 {
 	this->evalOps(mArg,mValue, f_tan);
 }
 
-void AppCommandEval::commandTrunc(const std::string& mArg, const std::string& mValue)
+void AppCommandEval::commandTrunc(const std::string& mArg, const ScriptArgument& mValue)
 {
 	this->evalOps(mArg,mValue, f_trunc);
 }
 
-void AppCommandEval::commandSin(const std::string& mArg, const std::string& mValue)
+void AppCommandEval::commandSin(const std::string& mArg, const ScriptArgument& mValue)
 {
 	this->evalOps(mArg,mValue, f_sin);
 }
 
 
-void AppCommandEval::evalOps(const std::string& mArg, const std::string& mValue, std::function<double(double,double)> f)
+void AppCommandEval::evalOps(const std::string& mArg, const ScriptArgument& mValue, std::function<double(double,double)> f)
 {
 	// capture context with reservedVariables Elitit-40
 	auto reservedVar = m_reservedVar.find(mArg);
@@ -158,17 +248,17 @@ void AppCommandEval::evalOps(const std::string& mArg, const std::string& mValue,
 		setReservedVariable(mArg,tmp);
 	}
 
-	auto var_it = variables.find(mArg);
-	if (var_it == variables.end()) { //not found so we return the value of the string
+	const Variable *variable = findVariable(mArg);
+	if (variable == nullptr) { //not found so we return the value of the string
 		//std::cout << "not possible to operate with undefined variable so define to null from ops" << std::endl;
 		cLog::get()->write("Not possible to operate with undefined variable so define to null from ops", LOG_TYPE::L_WARNING , LOG_FILE::SCRIPT);
-		variables[mArg] = Utility::strToDouble (mValue);
+		setVariable(mArg).value = Utility::strToDouble (mValue.value);
 	} else { // trouvé on renvoie la valeur de ce qui est stocké en mémoire
-		double v = f( Utility::strToDouble( variables[mArg] ) , this->evalDouble(mValue));
+		double v = f( Utility::strToDouble( variable->value ) , this->evalDouble(mValue));
 		//if (v == trunc(v))
 		//	variables[mArg] = std::to_string(evalInt(mValue));
 		//else
-			variables[mArg] = std::to_string(v);
+			setVariable(mArg).value = std::to_string(v);
 	}
 }
 
@@ -194,12 +284,12 @@ void AppCommandEval::commandMul(const std::string& mArg, const std::string& mVal
 	}
 }*/
 
-void AppCommandEval::commandRandomMin(const std::string& mValue)
+void AppCommandEval::commandRandomMin(const ScriptArgument& mValue)
 {
 	min_random = evalDouble(mValue);
 }
 
-void AppCommandEval::commandRandomMax(const std::string& mValue)
+void AppCommandEval::commandRandomMax(const ScriptArgument& mValue)
 {
 	max_random = evalDouble(mValue);
 }
@@ -209,28 +299,40 @@ void AppCommandEval::printVar()
 {
 	//std::cout << "+++++++++++++++++" << std::endl;
 	cLog::get()->mark( LOG_FILE::SCRIPT);
-	if (variables.size() == 0){
+	bool empty = true;
+	for (auto var_it = variableIndex.begin(); var_it != variableIndex.end(); ++var_it)	{
+		const Variable &variable = variables[var_it->second];
+		if (!variable.defined)
+			continue;
+		//std::cout << var_it->first << " => " << var_it->second << '\n';
+		cLog::get()->write(var_it->first + " => " + variable.value, LOG_TYPE::L_INFO , LOG_FILE::SCRIPT);
+		empty = false;
+	}
+	if (empty){
 		//std::cout << "No variable available" << std::endl;
 		cLog::get()->write("Not variable available", LOG_TYPE::L_INFO , LOG_FILE::SCRIPT);
 	}
-	else {
-		for (auto var_it = variables.begin(); var_it != variables.end(); ++var_it)	{
-			//std::cout << var_it->first << " => " << var_it->second << '\n';
-			cLog::get()->write(var_it->first + " => " + var_it->second, LOG_TYPE::L_INFO , LOG_FILE::SCRIPT);
-		}
-	}
 	//std::cout << "-----------------" << std::endl;
 	cLog::get()->mark(LOG_FILE::SCRIPT);
 }
 
 void AppCommandEval::deleteVar()
 {
-	variables.clear();
+	// the slots stay, the compiled commands keep their index
+	for (Variable &variable : variables) {
+		variable.value.clear();
+		variable.defined = false;
+	}
 }
 
 double AppCommandEval::evalReservedVariable(const std::string &var)
 {
-	switch (m_reservedVar[var]) {
+	return evalReservedVariable(m_reservedVar[var]);
+}
+
+double AppCommandEval::evalReservedVariable(SC_RESERVED_VAR var)
+{
+	switch (var) {
 		case  SC_RESERVED_VAR::LONGITUDE : {
 			double lon = coreLink->observatoryGetLongitude() + 180;
 			lon = lon - 360 * floor(lon / 360.);
@@ -284,7 +386,7 @@ double AppCommandEval::evalReservedVariable(const std::string &var)
 				return coreLink->getLanguage();
 		default:
 			//std::cout << "Unknown reserved variable " << var << ". Default 0.0 is returned." << std::endl;
-			cLog::get()->write("Unknown reserved variable " + var +". Default 0.0 is returned.", LOG_TYPE::L_WARNING , LOG_FILE::SCRIPT);
+			cLog::get()->write("Unknown reserved variable " + std::to_string((int) var) +". Default 0.0 is returned.", LOG_TYPE::L_WARNING , LOG_FILE::SCRIPT);
 			return 0.0;
 	}
 }
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <functional>
 #include <memory>
 #include "interfaceModule/base_command_interface.hpp"
@@ -44,6 +45,8 @@ class CoreLink;
 * - Otherwise, it is a number. 
 *
 */
+struct ScriptArgument;
+
 class AppCommandEval : public NoCopy{
 public: 
 	// constructor
@@ -58,26 +61,33 @@ public:
 	//! transform as possible the parameter to int
 	int evalInt(const std::string &var);
 
+	//! type the value of a compiled argument: number, reserved variable or user variable
+	void resolve(ScriptArgument &argument);
+	//! same as the string versions for an argument typed by resolve
+	std::string evalString(const ScriptArgument &argument);
+	double evalDouble(const ScriptArgument &argument);
+	int evalInt(const ScriptArgument &argument);
+
 	//! create a string variable with value 
-	void define(const std::string& mArg, const std::string& mValue);
+	void define(const std::string& mArg, const ScriptArgument& mValue);
 	//! first becomes first added by the second
-	void commandAdd(const std::string& mArg, const std::string& mValue);
+	void commandAdd(const std::string& mArg, const ScriptArgument& mValue);
 	//! first becomes first substracted by the second
-	void commandSub(const std::string& mArg, const std::string& mValue);
+	void commandSub(const std::string& mArg, const ScriptArgument& mValue);
 	//! first becomes first multiplied by the second
-	void commandMul(const std::string& mArg, const std::string& mValue);
+	void commandMul(const std::string& mArg, const ScriptArgument& mValue);
 	//! first becomes first divided by the second
-	void commandDiv(const std::string& mArg, const std::string& mValue);
+	void commandDiv(const std::string& mArg, const ScriptArgument& mValue);
 	//! first becomes tangent of the second
-	void commandTan(const std::string& mArg, const std::string& mValue);
+	void commandTan(const std::string& mArg, const ScriptArgument& mValue);
 	//! first becomes trunc of the second
-	void commandTrunc(const std::string& mArg, const std::string& mValue);
+	void commandTrunc(const std::string& mArg, const ScriptArgument& mValue);
 	//! first becomes sine of the second
-	void commandSin(const std::string& mArg, const std::string& mValue);
+	void commandSin(const std::string& mArg, const ScriptArgument& mValue);
 	//! fix the minimum random value for the internal random generator 
-	void commandRandomMin(const std::string& mValue);
+	void commandRandomMin(const ScriptArgument& mValue);
 	//! fix the maximum random value for the internal random generator
-	void commandRandomMax(const std::string& mValue);
+	void commandRandomMax(const ScriptArgument& mValue);
 	//! delete all variables defined with function define
 	void deleteVar();
 	//! print all defined variables on console
@@ -88,13 +98,28 @@ private:
 	void initReservedVariable();
 	//! specific reserved variable evaluator
 	double evalReservedVariable(const std::string &var);
+	double evalReservedVariable(SC_RESERVED_VAR var);
 	//! specific function to set new value to reserved variable if possible.
 	void setReservedVariable(const std::string &var, double value);
 	//! fonction operator to avoid code duplication
-	void evalOps(const std::string& mArg, const std::string& mValue, std::function<double(double,double)> f);
+	void evalOps(const std::string& mArg, const ScriptArgument& mValue, std::function<double(double,double)> f);
 	
+	//! variable of the scripting engine, its slot stays when it is deleted as compiled commands refer to it
+	struct Variable {
+		std::string value;
+		bool defined = false;
+	};
+	//! slot of the variable, created if needed
+	int getVariableIndex(const std::string &name);
+	//! the variable if it is defined, nullptr otherwise
+	const Variable *findVariable(const std::string &name) const;
+	//! the variable, defined if it wasn't
+	Variable &setVariable(const std::string &name);
+	std::string evalVariableString(const Variable &variable);
+
 	//variables used in the scripting engine
-	std::map<const std::string, std::string> variables;
+	std::map<const std::string, int> variableIndex;
+	std::vector<Variable> variables;
 	// map of system variables accessible through CoreLink
 	std::map<const std::string, SC_RESERVED_VAR> m_reservedVar;
 	// reverse map to avoid no reseach time
@@ -104,58 +104,23 @@ void AppCommandInterface::deleteVar()
 	appEval->deleteVar();
 }
 
-int AppCommandInterface::parseCommand(const std::string &command_line, std::string &command, stringHash_t &arguments)
+void AppCommandInterface::compileCommand(const std::string &commandline, ScriptCommand &compiled) const
 {
-  	std::string str = command_line;
-
-	// transformation of the beginning of character strings by deleting spaces and tabs at the beginning of the string
-	while (str[0]==' ' || str[0]=='\t') {
-        str.erase(0,1);
-		//std::cout << str << std::endl;
-	}
-
-	// transformation of user strings of the form "text" to "text
-  	std::size_t found = str.find(" \" ");
-  	while(found!=std::string::npos) {
-  		str.erase(found+2,1);
-		found = str.find(" \" ");
-  	}
-
-	std::istringstream commandstr( str );
-	std::string key, value;
-	char nextc;
-
-	commandstr >> command;
-	transform(command.begin(), command.end(), command.begin(), ::tolower);
-
-	while (commandstr >> key >> value ) {
-		if (value[0] == '"') {
-			// pull in all text inside quotes
-			if (value[value.length()-1] == '"') {
-				// one word in quotes
-				value = value.substr(1, value.length() -2 );
-			} else {
-				// multiple words in quotes
-				value = value.substr(1, value.length() -1 );
-
-				while (1) {
-					nextc = commandstr.get();
-					if ( nextc == '"' || !commandstr.good()) break;
-					value.push_back( nextc );
-				}
-			}
-		}
-		transform(key.begin(), key.end(), key.begin(), ::tolower);
-		arguments[key] = value;
-	}
-
-	#ifdef PARSE_DEBUG
-	cLog::get()->write("Command: " + command + "Argument hash:", LOG_TYPE::L_DEBUG);
-	for ( stringHashIter_t iter = arguments.begin(); iter != arguments.end(); ++iter ) {
-		cLog::get()->write("\t" + iter->first + " : " + iter->second, LOG_TYPE::L_DEBUG);
+	// on découpe toute la ligne en CMD {ARG1,VALUE1} {ARG2,VALUE2} ...
+	// the arguments are typed once, the variables they name are given their slot
+	compiled.parse(commandline, [this](ScriptArgument &argument) {
+		appEval->resolve(argument);
+	});
+
+	if (compiled.command == "comment") {
+		compiled.code = SC_COMMAND::SC_COMMENT;
+	} else if (compiled.command == "uncomment") {
+		compiled.code = SC_COMMAND::SC_UNCOMMENT;
+	} else {
+		auto m_commands_it = m_commands.find(compiled.command);
+		if (m_commands_it != m_commands.end())
+			compiled.code = m_commands_it->second;
 	}
-	#endif
-	return 1;  // no error checking yet
 }
 
 int AppCommandInterface::terminateScript()
@@ -172,22 +137,30 @@ int AppCommandInterface::executeCommand(const std::string &commandline )
 
 //! @brief called by script executors and transform a std::string to instruction
 int AppCommandInterface::executeCommand(const std::string &_commandline, uint64_t &wait)
+{
+	ScriptCommand compiled;
+	compileCommand(_commandline, compiled);
+	return executeCommand(compiled, wait);
+}
+
+//! @brief run a command compiled by compileCommand
+int AppCommandInterface::executeCommand(const ScriptCommand &compiled, uint64_t &wait)
 {
 	recordable = 1;  // true if command should be recorded (if recording)
 	debug_message.clear(); // initialise to empty
 	wait = 0;  // default, no wait between commands
-	commandline = _commandline;
-
-	command.clear(); // = ""; //vide l'ancienne valeur de args
-	args.clear(); //vide les anciennes valeurs de args //TODO A VERIFIER
-
-	// on découpe toute la ligne en CMD {ARG1,VALUE1} {ARG2,VALUE2} ...
-	parseCommand(commandline, command, args);
+	// compiled may be released by the command, and a nested command replaces args,
+	// arguments keeps the ones the command refers to until it returns
+	const SC_COMMAND code = compiled.code;
+	const ScriptArgs arguments = compiled.args;
+	commandline = compiled.commandline;
+	command = compiled.command;
+	args = arguments;
 
 	FilePath::fixScriptPath(scriptInterface->getScriptPath());
 
 	// If command is empty then don't bother checking all these cases
-	if( command.length() < 1  && command == "")
+	if (command.empty())
 		return 0;
 
 	cLog::get()->write("Execute_command " + commandline, LOG_TYPE::L_INFO, LOG_FILE::SCRIPT);
@@ -195,13 +168,13 @@ int AppCommandInterface::executeCommand(const std::string &_commandline, uint64_
 	//                                                 //
 	// application specific logic to run each command  //
 	//                                                 //
-	if (command =="comment")
+	if (code == SC_COMMAND::SC_COMMENT)
 		return commandComment();
 
-	if (command =="uncomment")
+	if (code == SC_COMMAND::SC_UNCOMMENT)
 		return commandUncomment();
 
-	if (command =="struct")
+	if (code == SC_COMMAND::SC_STRUCT)
 		return commandStruct();
 
 	// if (swapCommand== true || swapIfCommand == true)
@@ -211,15 +184,14 @@ int AppCommandInterface::executeCommand(const std::string &_commandline, uint64_
 	}
 	unskippable = false;
 
-	auto m_commands_it = m_commands.find(command);
-	if (m_commands_it == m_commands.end()) {
+	if (code == SC_COMMAND::SC_UNKNOWN) {
 		debug_message = _("Unrecognized or malformed command name");
 		cLog::get()->write( debug_message,LOG_TYPE::L_DEBUG, LOG_FILE::SCRIPT );
 		appInit->searchSimilarCommand(command);
 		return 0;
 	}
 
-	switch(m_commands_it->second) {
+	switch(code) {
 		case SC_COMMAND::SC_ADD : 	return commandAdd(); break;
 		case SC_COMMAND::SC_AUDIO : 	return commandAudio(); break;
 		case SC_COMMAND::SC_MODE: 	return commandModeJump(); break;
@@ -277,6 +249,9 @@ int AppCommandInterface::executeCommand(const std::string &_commandline, uint64_
 		case SC_COMMAND::SC_ZOOMR :	return commandZoom(wait); break;
 		// for g++ warning
 		case SC_COMMAND::SC_STRUCT: break;
+		case SC_COMMAND::SC_COMMENT: break;
+		case SC_COMMAND::SC_UNCOMMENT: break;
+		case SC_COMMAND::SC_UNKNOWN: break;
 	}
 	return 1;
 }
@@ -1070,13 +1045,13 @@ int AppCommandInterface::commandFlag()
 	// could loop if want to allow that syntax
 	if (args.begin() != args.end()) {
 		bool val;
-		if (setFlag( args.begin()->first, args.begin()->second, val) == false)
+		if (setFlag( args.begin()->key, args.begin()->value, val) == false)
 			debug_message = ("Unrecognized or malformed flag argument");
 
 		// rewrite command for recording so that actual state is known (rather than W_TOGGLE)
-		if (args.begin()->second == W_TOGGLE) {
+		if (args.begin()->value == W_TOGGLE) {
 			std::ostringstream oss;
-			oss << command << " " << args.begin()->first << " " << val;
+			oss << command << " " << args.begin()->key << " " << val;
 			commandline = oss.str();
 		}
 	} else
@@ -1088,7 +1063,7 @@ int AppCommandInterface::commandFlag()
 
 int AppCommandInterface::commandGet()
 {
-	std::string argStatus = args[W_STATUS];
+	const std::string &argStatus = args[W_STATUS];
 	if (!tcp) {
 		cLog::get()->write("No tcp : i can't send ", LOG_TYPE::L_WARNING);
 		return executeCommandStatus();
@@ -1120,11 +1095,11 @@ int AppCommandInterface::commandGet()
 
 int AppCommandInterface::commandSearch()
 {
-	std::string argName = args[W_NAME];
-	std::string argMaxObject = args[W_MAX_OBJECT];
+	const std::string &argName = args[W_NAME];
+	const ScriptArgument &argMaxObject = args.get(W_MAX_OBJECT);
 	if (!argName.empty()) {
 		std::string toSend;
-		if (!argMaxObject.empty()) {
+		if (!argMaxObject.value.empty()) {
 			toSend=stcore->getListMatchingObjects(argName, evalInt(argMaxObject));
 		} else {
 			toSend=stcore->getListMatchingObjects(argName);
@@ -1141,9 +1116,9 @@ int AppCommandInterface::commandSearch()
 
 int AppCommandInterface::commandPlanetScale()
 {
-	std::string argName = args[W_NAME];
-	std::string argScale = args[W_SCALE];
-	if (!argName.empty() && !argScale.empty()) {
+	const std::string &argName = args[W_NAME];
+	const ScriptArgument &argScale = args.get(W_SCALE);
+	if (!argName.empty() && !argScale.value.empty()) {
 		coreLink->planetSetSizeScale(argName, evalDouble(argScale));
 	} else
 		debug_message = _("command 'planet_scale' : missing name or scale argument");
@@ -1156,7 +1131,7 @@ int AppCommandInterface::commandWait(uint64_t &wait)
 	const auto &level = args[W_LOADING];
 	if (level.empty()) {
 		if (!args[W_DURATION].empty()) {
-			float fdelay = evalDouble(args[W_DURATION]);
+			float fdelay = evalDouble(args.get(W_DURATION));
 			if (fdelay > 0) wait = (int)(fdelay*1000);
 			return executeCommandStatus();
 		}
@@ -1187,7 +1162,7 @@ int AppCommandInterface::commandWait(uint64_t &wait)
 		if (args[W_DURATION].empty()) {
 			wait = 1;
 		} else {
-			wait = std::max(static_cast<int>(evalDouble(args[W_DURATION]) * 1000), 1);
+			wait = std::max(static_cast<int>(evalDouble(args.get(W_DURATION)) * 1000), 1);
 		}
 		return executeCommandStatus();
 	}
@@ -1197,7 +1172,7 @@ int AppCommandInterface::commandWait(uint64_t &wait)
 
 int AppCommandInterface::commandPersonal()
 {
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	if (!argAction.empty()) {
 		if (argAction == W_LOAD) {
 			std::string fileName=args[W_FILENAME];
@@ -1226,9 +1201,9 @@ int AppCommandInterface::commandPersonal()
 
 int AppCommandInterface::commandDso()
 {
-	std::string argAction = args[W_ACTION];
-	std::string argPath = args[W_PATH];
-	std::string argName = args[W_NAME];
+	const std::string &argAction = args[W_ACTION];
+	const std::string &argPath = args[W_PATH];
+	const std::string &argName = args[W_NAME];
 
 	if (!argAction.empty()) {
 		if (argAction== W_LOAD) {
@@ -1238,10 +1213,10 @@ int AppCommandInterface::commandDso()
 			else
 				path = scriptInterface->getScriptPath() + argPath;
 
-			bool status = stcore->loadNebula(evalDouble(args[W_RA]), evalDouble(args[W_DE]), evalDouble(args[W_MAGNITUDE]),
-			                                evalDouble(args[W_ANGULAR_S]), evalDouble(args[W_ROTATION]), argName,
-			                                path + args[W_FILENAME], args[W_CREDIT], evalDouble(args[W_TEXTURE]),
-			                                evalDouble(args[W_DISTANCE]),args[W_CONSTELLATION], args[W_TYPE]);
+			bool status = stcore->loadNebula(evalDouble(args.get(W_RA)), evalDouble(args.get(W_DE)), evalDouble(args.get(W_MAGNITUDE)),
+			                                evalDouble(args.get(W_ANGULAR_S)), evalDouble(args.get(W_ROTATION)), argName,
+			                                path + args[W_FILENAME], args[W_CREDIT], evalDouble(args.get(W_TEXTURE)),
+			                                evalDouble(args.get(W_DISTANCE)),args[W_CONSTELLATION], args[W_TYPE]);
 			if (status==false)
 				debug_message = "Error loading nebula.";
 			return executeCommandStatus();
@@ -1263,9 +1238,9 @@ int AppCommandInterface::commandDso()
 		return executeCommandStatus();
 	}
 
-	std::string argHidden = args[W_HIDDEN];
+	const std::string &argHidden = args[W_HIDDEN];
 	if ( !argHidden.empty() ) {
-		std::string argType = args[W_TYPE];
+		const std::string &argType = args[W_TYPE];
 		if (!argType.empty() ) {
 			if (argType == W_ALL)
 				if (Utility::isTrue(argHidden)) coreLink->dsoHideAll();
@@ -1277,7 +1252,7 @@ int AppCommandInterface::commandDso()
 			return executeCommandStatus();
 		}
 
-		std::string argConstellation = args[W_CONSTELLATION];
+		const std::string &argConstellation = args[W_CONSTELLATION];
 		if (!argConstellation.empty()) {
 			if (argConstellation == W_ALL)
 				if (Utility::isTrue(argHidden)) coreLink->dsoHideAll();
@@ -1303,15 +1278,17 @@ int AppCommandInterface::commandDso()
 
 int AppCommandInterface::commandDso3D()
 {
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	if (argAction == W_LOAD) {
+		stringHash_t param = args.toHash();
 		if (args["color_tex"].empty())
-			coreLink->dsoNavInsert(args);
+			coreLink->dsoNavInsert(param);
 		else
-			coreLink->dsoNavSetupVolumetric(args, 0);
+			coreLink->dsoNavSetupVolumetric(param, 0);
 	} else if (argAction == W_RESTART) {
 		if (args["maxobject"].empty() || args["maxobject"] == "1") {
-			coreLink->dsoNavSetupVolumetric(args, 1);
+			stringHash_t param = args.toHash();
+			coreLink->dsoNavSetupVolumetric(param, 1);
 		} else
 			coreLink->dsoNavOverrideCurrent(args["color_tex"], args["alpha_tex"], std::stoi(args["depth"]));
 	} else {
@@ -1322,7 +1299,7 @@ int AppCommandInterface::commandDso3D()
 
 int AppCommandInterface::commandDso2D()
 {
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 
 	if (!argAction.empty()) {
 		if (argAction == ACP_CN_CLEAR) {
@@ -1331,7 +1308,7 @@ int AppCommandInterface::commandDso2D()
 			return executeCommandStatus();
 		}
 		if (argAction== W_LOAD) {
-			bool status = stcore->loadDso2d(evalDouble(args[W_INDEX]), args[W_NAME], evalDouble(args[W_SIZE]), evalDouble(args[W_RA]), evalDouble(args[W_DE]), evalDouble(args[W_DISTANCE]), evalDouble(args[W_XYZ]));
+			bool status = stcore->loadDso2d(evalDouble(args.get(W_INDEX)), args[W_NAME], evalDouble(args.get(W_SIZE)), evalDouble(args.get(W_RA)), evalDouble(args.get(W_DE)), evalDouble(args.get(W_DISTANCE)), evalDouble(args.get(W_XYZ)));
 			if (status==false)
 				debug_message = "Error loading dso.";
 			return executeCommandStatus();
@@ -1346,7 +1323,7 @@ int AppCommandInterface::commandDso2D()
 
 int AppCommandInterface::commandPersoneq()
 {
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	if ( !argAction.empty()) {
 		if (argAction== W_LOAD) {
 			std::string fileName=args[W_FILENAME];
@@ -1375,7 +1352,7 @@ int AppCommandInterface::commandPersoneq()
 
 int AppCommandInterface::commandBodyTrace()
 {
-	std::string argPen = args[W_PEN];
+	const std::string &argPen = args[W_PEN];
 	if (!argPen.empty()) {
 		if (args[W_TARGET]!="") {
 			coreLink->bodyTraceBodyChange(args[W_TARGET]);
@@ -1419,7 +1396,7 @@ int AppCommandInterface::commandBodyTrace()
 
 int AppCommandInterface::commandSuntrace()
 {
-	std::string argPen = args[W_PEN];
+	const std::string &argPen = args[W_PEN];
 	if (!argPen.empty()) {
 		coreLink->bodyTraceBodyChange(args[W_SUN]);
 		if (Utility::isTrue(argPen)) {
@@ -1449,15 +1426,15 @@ int AppCommandInterface::commandColor()
 {
 	//color management
 	Vec3f Vcolor;
-	std::string argValue = args[W_VALUE];
-	std::string argR= args[W_R];
-	std::string argG= args[W_G];
-	std::string argB= args[W_B];
+	const std::string &argValue = args[W_VALUE];
+	const std::string &argR= args[W_R];
+	const std::string &argG= args[W_G];
+	const std::string &argB= args[W_B];
 	AppCommandColor testColor(Vcolor, debug_message, argValue, argR,argG, argB);
 	if (!testColor)
 		return executeCommandStatus();
 
-	std::string argProperty = args[W_PROPERTY];
+	const std::string &argProperty = args[W_PROPERTY];
 	if (argProperty.empty()) {
 		debug_message = _("Command 'color': unknown expected argument 'property'");
 		return executeCommandStatus();
@@ -1514,7 +1491,7 @@ int AppCommandInterface::commandColor()
 		case COLORCOMMAND_NAMES::CC_NEBULA_CIRCLE: 			coreLink->nebulaSetColorCircle( Vcolor ); break;
 		case COLORCOMMAND_NAMES::CC_PRECESSION_CIRCLE: 		coreLink->skyLineMgrSetColor(SKYLINE_TYPE::LINE_PRECESSION, Vcolor ); break;
 		case COLORCOMMAND_NAMES::CC_TEXT_USR_COLOR: 		media->textSetDefaultColor( Vcolor ); break;
-		case COLORCOMMAND_NAMES::CC_STAR_TABLE:				coreLink->starSetColorTable(evalInt(args[W_INDEX]), Vcolor ); break;
+		case COLORCOMMAND_NAMES::CC_STAR_TABLE:				coreLink->starSetColorTable(evalInt(args.get(W_INDEX)), Vcolor ); break;
 		default:
 		break;
 	}
@@ -1523,12 +1500,12 @@ int AppCommandInterface::commandColor()
 
 int AppCommandInterface::commandIlluminate()
 {
-	std::string argHP = args[W_HP];
-	std::string argDisplay = args[W_DISPLAY];
-	std::string argConstellation = args[W_CONSTELLATION];
+	const ScriptArgument &argHP = args.get(W_HP);
+	const std::string &argDisplay = args[W_DISPLAY];
+	const std::string &argConstellation = args[W_CONSTELLATION];
 
-	double ang_size = evalDouble(args[W_SIZE]);
-	float rotation = evalDouble(args[W_ROTATION]);
+	double ang_size = evalDouble(args.get(W_SIZE));
+	float rotation = evalDouble(args.get(W_ROTATION));
 
 	if (argDisplay=="all_constellation_on") {
 		coreLink->illuminateLoadAllConstellation(ang_size,rotation);
@@ -1539,10 +1516,10 @@ int AppCommandInterface::commandIlluminate()
 
 	//management color
 	Vec3f Vcolor;
-	std::string argValue = args[W_COLOR_VALUE];
-	std::string argR= args[W_R];
-	std::string argG= args[W_G];
-	std::string argB= args[W_B];
+	const std::string &argValue = args[W_COLOR_VALUE];
+	const std::string &argR= args[W_R];
+	const std::string &argG= args[W_G];
+	const std::string &argB= args[W_B];
 	std::string errorColor;
 	AppCommandColor testColor(Vcolor, errorColor, argValue, argR,argG, argB);
 
@@ -1559,7 +1536,7 @@ int AppCommandInterface::commandIlluminate()
 		return executeCommandStatus();
 	}
 
-	if (!argHP.empty() && Utility::isTrue(argDisplay)) {
+	if (!argHP.value.empty() && Utility::isTrue(argDisplay)) {
 
 		if (!testColor)
 			coreLink->illuminateLoad(evalInt(argHP), ang_size, rotation);
@@ -1569,7 +1546,7 @@ int AppCommandInterface::commandIlluminate()
 		return executeCommandStatus();
 	}
 
-	if (!argHP.empty() && Utility::isFalse(argDisplay)) {
+	if (!argHP.value.empty() && Utility::isFalse(argDisplay)) {
 		coreLink->illuminateRemove( evalInt(argHP));
 		return executeCommandStatus();
 	}
@@ -1584,7 +1561,7 @@ int AppCommandInterface::commandIlluminate()
 		coreLink->illuminateRemoveTex();
 		return executeCommandStatus();
 	}
-	std::string argFileName = args[W_FILENAME];
+	const std::string &argFileName = args[W_FILENAME];
 	if (!argFileName.empty()) {
 		FilePath myFile  = FilePath(argFileName, FilePath::TFP::IMAGE);
 		if (!myFile.exist()) {
@@ -1607,7 +1584,7 @@ int AppCommandInterface::commandPrint()
 	}
 	for(const auto& i : args) {
 		std::stringstream oss;
-		oss << "[" << i.first <<"] " << evalString(i.second);
+		oss << "[" << i.key <<"] " << evalString(i);
 		//std::cout << oss.str() << std::endl;
 		cLog::get()->write(oss.str(),  LOG_TYPE::L_WARNING, LOG_FILE::SCRIPT);
 		cLog::get()->write(oss.str(),  LOG_TYPE::L_WARNING);
@@ -1627,7 +1604,7 @@ int AppCommandInterface::commandSet()
 	//debug
 	for (const auto&i : args ) {
 		// std::cout << i.first << "->" << i.second << std::endl;
-		returnValue = returnValue && evalCommandSet(i.first , i.second);
+		returnValue = returnValue && evalCommandSet(i.key , i);
 	}
 	return returnValue;
 }
@@ -1649,7 +1626,7 @@ SCD_NAMES AppCommandInterface::parseCommandSet(const std::string& setName)
 }
 
 
-int AppCommandInterface::evalCommandSet(const std::string& setName, const std::string& setValue)
+int AppCommandInterface::evalCommandSet(const std::string& setName, const ScriptArgument& setValue)
 {
 	/*
 	 *	the set command format is : set SET_NAME SET_VALUE
@@ -1661,19 +1638,19 @@ int AppCommandInterface::evalCommandSet(const std::string& setName, const std::s
 	parserSet = parseCommandSet(setName);
 	// eval SET_NAME
 	switch(parserSet) {
-		case SCD_NAMES::APP_ATMOSPHERE_FADE_DURATION : if (setValue==W_DEFAULT) coreLink->atmosphereSetDefaultFadeDuration(); else coreLink->atmosphereSetFadeDuration(evalDouble(setValue)); break;
-		case SCD_NAMES::APP_MOON_BRIGHTNESS : if (setValue==W_DEFAULT) coreLink->moonSetDefaultBrightness(); else coreLink->moonSetBrightness(evalDouble(setValue)); break;
-		case SCD_NAMES::APP_SUN_BRIGHTNESS : if (setValue==W_DEFAULT) coreLink->sunSetDefaultBrightness(); else coreLink->sunSetBrightness(evalDouble(setValue)); break;
+		case SCD_NAMES::APP_ATMOSPHERE_FADE_DURATION : if (setValue.value==W_DEFAULT) coreLink->atmosphereSetDefaultFadeDuration(); else coreLink->atmosphereSetFadeDuration(evalDouble(setValue)); break;
+		case SCD_NAMES::APP_MOON_BRIGHTNESS : if (setValue.value==W_DEFAULT) coreLink->moonSetDefaultBrightness(); else coreLink->moonSetBrightness(evalDouble(setValue)); break;
+		case SCD_NAMES::APP_SUN_BRIGHTNESS : if (setValue.value==W_DEFAULT) coreLink->sunSetDefaultBrightness(); else coreLink->sunSetBrightness(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_AUTO_MOVE_DURATION : stcore->setAutoMoveDuration(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_CONSTELLATION_ART_FADE_DURATION: coreLink->constellationSetArtFadeDuration(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_CONSTELLATION_ART_INTENSITY: coreLink->constellationSetArtIntensity(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_LIGHT_POLLUTION_LIMITING_MAGNITUDE:	stcore->setLightPollutionLimitingMagnitude(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_HEADING:
-						if (setValue==W_DEFAULT) coreLink->setDefaultHeading(); else coreLink->setHeading(evalDouble(setValue)); break;
+						if (setValue.value==W_DEFAULT) coreLink->setDefaultHeading(); else coreLink->setHeading(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_HOME_PLANET:
-						if (setValue==W_DEFAULT) stcore->setHomePlanet("Earth"); else stcore->setHomePlanet(setValue); break;
+						if (setValue.value==W_DEFAULT) stcore->setHomePlanet("Earth"); else stcore->setHomePlanet(setValue.value); break;
 		case SCD_NAMES::APP_LANDSCAPE_NAME:
-						if (setValue==W_DEFAULT) stcore->setInitialLandscapeName(); else stcore->setLandscape(setValue); break;
+						if (setValue.value==W_DEFAULT) stcore->setInitialLandscapeName(); else stcore->setLandscape(setValue.value); break;
 		case SCD_NAMES::APP_LINE_WIDTH:	stapp->setLineWidth(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_MAX_MAG_NEBULA_NAME: coreLink->nebulaSetMaxMagHints(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_MAX_MAG_STAR_NAME: coreLink->starSetMaxMagName(evalDouble(setValue)); coreLink->starNavSetMaxMagName(evalDouble(setValue));break;
@@ -1681,19 +1658,19 @@ int AppCommandInterface::evalCommandSet(const std::string& setName, const std::s
 		case SCD_NAMES::APP_SUN_SCALE: coreLink->setSunScale(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_MILKY_WAY_FADER_DURATION: coreLink->milkyWaySetDuration(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_MILKY_WAY_INTENSITY:
-						if (setValue==W_DEFAULT) coreLink->milkyWayRestoreIntensity(); else coreLink->milkyWaySetIntensity(evalDouble(setValue));
+						if (setValue.value==W_DEFAULT) coreLink->milkyWayRestoreIntensity(); else coreLink->milkyWaySetIntensity(evalDouble(setValue));
 						if (coreLink->milkyWayGetIntensity()) coreLink->milkyWaySetFlag(true);
 						break;
 		case SCD_NAMES::APP_ZODIACAL_INTENSITY:
 						coreLink->milkyWaySetZodiacalIntensity(evalDouble(setValue));
 						break;
 		case SCD_NAMES::APP_MILKY_WAY_TEXTURE:
-						if(setValue==W_DEFAULT) coreLink->milkyWayRestoreDefault();	else
-							coreLink->milkyWayChangeStateWithoutIntensity(scriptInterface->getScriptPath() + setValue);
+						if(setValue.value==W_DEFAULT) coreLink->milkyWayRestoreDefault();	else
+							coreLink->milkyWayChangeStateWithoutIntensity(scriptInterface->getScriptPath() + setValue.value);
 						break;
-		case SCD_NAMES::APP_SKY_CULTURE: if (setValue==W_DEFAULT) stcore->setInitialSkyCulture(); else stcore->setSkyCultureDir(setValue); break;
-		case SCD_NAMES::APP_SKY_LOCALE:  if ( setValue==W_DEFAULT) stcore->setInitialSkyLocale(); else stcore->setSkyLanguage(setValue); break;
-		case SCD_NAMES::APP_UI_LOCALE: stapp->setAppLanguage(setValue); break;
+		case SCD_NAMES::APP_SKY_CULTURE: if (setValue.value==W_DEFAULT) stcore->setInitialSkyCulture(); else stcore->setSkyCultureDir(setValue.value); break;
+		case SCD_NAMES::APP_SKY_LOCALE:  if ( setValue.value==W_DEFAULT) stcore->setInitialSkyLocale(); else stcore->setSkyLanguage(setValue.value); break;
+		case SCD_NAMES::APP_UI_LOCALE: stapp->setAppLanguage(setValue.value); break;
 		case SCD_NAMES::APP_STAR_MAG_SCALE: coreLink->starSetMagScale(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_STAR_SIZE_LIMIT: coreLink->starSetSizeLimit(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_PLANET_SIZE_LIMIT: stcore->setPlanetsSizeLimit(evalDouble(setValue)); break;
@@ -1704,20 +1681,20 @@ int AppCommandInterface::evalCommandSet(const std::string& setName, const std::s
 		case SCD_NAMES::APP_STAR_TWINKLE_AMOUNT: coreLink->starSetTwinkleAmount(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_STAR_FADER_DURATION: coreLink->starSetDuration(evalDouble(setValue));coreLink->starNavSetDuration(evalDouble(setValue)); break;
 		case SCD_NAMES::APP_STAR_LIMITING_MAG: coreLink->starSetLimitingMag(evalDouble(setValue)); break;
-		case SCD_NAMES::APP_TIME_ZONE: spaceDate->setCustomTimezone(setValue); break;
+		case SCD_NAMES::APP_TIME_ZONE: spaceDate->setCustomTimezone(setValue.value); break;
 		case SCD_NAMES::APP_AMBIENT_LIGHT:
-						if (setValue==W_INCREMENT)
+						if (setValue.value==W_INCREMENT)
 							coreLink->uboSetAmbientLight(coreLink->uboGetAmbientLight()+0.01);
-						else if (setValue==W_DECREMENT)
+						else if (setValue.value==W_DECREMENT)
 							coreLink->uboSetAmbientLight(coreLink->uboGetAmbientLight()-0.01);
 						else
 							coreLink->uboSetAmbientLight(evalDouble(setValue));
 						break;
-		case SCD_NAMES::APP_TEXT_FADING_DURATION: media->textFadingDuration(Utility::strToFloat(setValue)); break;
+		case SCD_NAMES::APP_TEXT_FADING_DURATION: media->textFadingDuration(Utility::strToFloat(setValue.value)); break;
 		case SCD_NAMES::APP_ZOOM_OFFSET: stcore->setViewOffset(evalDouble(setValue)); break;
-		case SCD_NAMES::APP_STARTUP_TIME_MODE: stapp->setStartupTimeMode(setValue); break;
-		case SCD_NAMES::APP_DATE_DISPLAY_FORMAT: spaceDate->setDateFormatStr(setValue); break;
-		case SCD_NAMES::APP_TIME_DISPLAY_FORMAT: spaceDate->setTimeFormatStr(setValue); break;
+		case SCD_NAMES::APP_STARTUP_TIME_MODE: stapp->setStartupTimeMode(setValue.value); break;
+		case SCD_NAMES::APP_DATE_DISPLAY_FORMAT: spaceDate->setDateFormatStr(setValue.value); break;
+		case SCD_NAMES::APP_TIME_DISPLAY_FORMAT: spaceDate->setTimeFormatStr(setValue.value); break;
 		case SCD_NAMES::APP_SCREEN_FADER:
 						{	Event* event = new ScreenFaderEvent(ScreenFaderEvent::FIX, evalDouble(setValue));
 							EventRecorder::getInstance()->queue(event);
@@ -1729,7 +1706,7 @@ int AppCommandInterface::evalCommandSet(const std::string& setName, const std::s
 						debug_message = "command_'set': unknown argument";
 						//for (const auto&i : args )
 						//	std::cout << i.first << "->" << i.second << std::endl;
-						appInit->searchSimilarSet(args.begin()->first);
+						appInit->searchSimilarSet(args.begin()->key);
 						//cLog::get()->write( debug_message,LOG_TYPE::L_DEBUG, LOG_FILE::SCRIPT );
 						return executeCommandStatus();
 						break;
@@ -1750,8 +1727,8 @@ int AppCommandInterface::commandShutdown()
 
 int AppCommandInterface::commandConfiguration()
 {
-	std::string argAction = args[W_ACTION];
-	std::string argModule = args[W_MODULE];
+	const std::string &argAction = args[W_ACTION];
+	const std::string &argModule = args[W_MODULE];
 
 	if (!argModule.empty()){
 		if (argModule == W_STAR_LINES){
@@ -1807,7 +1784,7 @@ int AppCommandInterface::commandConfiguration()
 			bool binaryMode = Utility::strToBool(args[W_BINARY],false);
 
 			if (argAction ==  W_LOAD) {
-				std::string argMode = args[ACP_SC_MODE];
+				const std::string &argMode = args[ACP_SC_MODE];
 				FilePath myFile  = FilePath(evalString(argName), FilePath::TFP::DATA);
 				if (!myFile.exist()) {
 					debug_message = "command 'configuration' filename not found";
@@ -1828,6 +1805,10 @@ int AppCommandInterface::commandConfiguration()
 					if (argMode == W_OTHER) {
 						coreLink->starNavigatorLoadOther(myFile.toString());
 						return executeCommandStatus();
+					} else
+					if (argMode == W_MMAP) {
+						coreLink->starNavigatorLoadMapped(myFile.toString());
+						return executeCommandStatus();
 					} else {
 						debug_message = "command 'configuration': unknown starNavigator mode parameter";
 						return executeCommandStatus();
@@ -1835,7 +1816,10 @@ int AppCommandInterface::commandConfiguration()
 				}
 			} else
 			if (argAction == W_SAVE) {
-				coreLink->starNavigatorSave(AppSettings::Instance()->getUserDir() + argName, binaryMode);
+				if (args[ACP_SC_MODE] == W_MMAP)
+					coreLink->starNavigatorSaveMapped(AppSettings::Instance()->getUserDir() + argName);
+				else
+					coreLink->starNavigatorSave(AppSettings::Instance()->getUserDir() + argName, binaryMode);
 			} else
 				debug_message = "command 'configuration': unknown starNavigator action argument";
 		} else
@@ -1859,15 +1843,15 @@ int AppCommandInterface::commandConfiguration()
 
 int AppCommandInterface::commandConstellation()
 {
-	std::string argName = args[W_NAME];
+	const std::string &argName = args[W_NAME];
 	transform(argName.begin(),argName.end(),argName.begin(), ::toupper);
 	if (argName.empty()) {
 		debug_message = "command 'constellation': missing name";
 		return executeCommandStatus();
 	}
 
-	std::string argIntensity = args[W_INTENSITY];
-	if (!argIntensity.empty()) {
+	const ScriptArgument &argIntensity = args.get(W_INTENSITY);
+	if (!argIntensity.value.empty()) {
 		coreLink->constellationSetArtIntensity(argName, evalDouble(argIntensity));
 		return executeCommandStatus();
 	}
@@ -1879,10 +1863,10 @@ int AppCommandInterface::commandConstellation()
 	}
 
 	Vec3f Vcolor;
-	std::string argColor =  args[W_COLOR_VALUE];
-	std::string argR= args[W_R];
-	std::string argG= args[W_G];
-	std::string argB= args[W_B];
+	const std::string &argColor =  args[W_COLOR_VALUE];
+	const std::string &argR= args[W_R];
+	const std::string &argG= args[W_G];
+	const std::string &argB= args[W_B];
 	AppCommandColor testColor(Vcolor, debug_message, argColor, argR,argG, argB);
 	if (!testColor) {
 		return executeCommandStatus();
@@ -1904,8 +1888,8 @@ int AppCommandInterface::commandConstellation()
 
 int AppCommandInterface::commandExternalViewer()
 {
-	std::string argAction = args[W_ACTION];
-	std::string argFileName = args[W_FILENAME];
+	const std::string &argAction = args[W_ACTION];
+	const std::string &argFileName = args[W_FILENAME];
 
 	if (argAction==W_PLAY && !argFileName.empty()) {
 		if (argFileName.size()<5) {
@@ -1974,7 +1958,7 @@ int AppCommandInterface::commandExternalViewer()
 
 int AppCommandInterface::commandClear()
 {
-	std::string argState = args[W_STATE];
+	const std::string &argState = args[W_STATE];
 
 	if (argState == W_VARIABLE) {
 		appEval->deleteVar();
@@ -2042,21 +2026,21 @@ int AppCommandInterface::commandClear()
 
 int AppCommandInterface::commandHeading()
 {
-	std::string argHeading=args[W_AZIMUTH];
-	if (!argHeading.empty() ) {
-		if (argHeading==W_DEFAULT) {
+	const ScriptArgument &argHeading=args.get(W_AZIMUTH);
+	if (!argHeading.value.empty() ) {
+		if (argHeading.value==W_DEFAULT) {
 			coreLink->setDefaultHeading();
 			return executeCommandStatus();
 		}
 
 		double heading = evalDouble(argHeading);
-		float fdelay = evalDouble(args[W_DURATION]);
+		float fdelay = evalDouble(args.get(W_DURATION));
 		coreLink->setHeading(heading, (int)(fdelay*1000));
 		return executeCommandStatus();
 	}
-	std::string argDeltaHeading=args[W_DELTA_AZIMUTH];
-	if (!argDeltaHeading.empty() ) {
-		float fdelay = evalDouble(args[W_DURATION]);
+	const ScriptArgument &argDeltaHeading=args.get(W_DELTA_AZIMUTH);
+	if (!argDeltaHeading.value.empty() ) {
+		float fdelay = evalDouble(args.get(W_DURATION));
 		double heading = evalDouble(argDeltaHeading) + coreLink->getHeading();
 
 		heading -= floor((heading + 180.) / 360.) * 360.;
@@ -2074,21 +2058,21 @@ int AppCommandInterface::commandHeading()
 
 int AppCommandInterface::commandMeteors()
 {
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	if (argAction== W_CLEAR) {
 		coreLink->clearRadiants();
 		return executeCommandStatus();
 	}
 
-	std::string argDay = args[W_DAY];
-	if (!argDay.empty()) {
-		float argRa = !args[W_RA].empty() ? evalDouble(args[W_RA]) : 0.;
-		float argDe = !args[W_DE].empty() ? evalDouble(args[W_DE]) : 0.;
-		float argZhr = !args[W_ZHR].empty() ? evalDouble(args[W_ZHR]) : 0.;
+	const ScriptArgument &argDay = args.get(W_DAY);
+	if (!argDay.value.empty()) {
+		float argRa = !args[W_RA].empty() ? evalDouble(args.get(W_RA)) : 0.;
+		float argDe = !args[W_DE].empty() ? evalDouble(args.get(W_DE)) : 0.;
+		float argZhr = !args[W_ZHR].empty() ? evalDouble(args.get(W_ZHR)) : 0.;
 		coreLink->createRadiant(evalInt(argDay), Vec3f(argRa, argDe, argZhr));
 		return executeCommandStatus();
 	} else if (!args[W_ZHR].empty()) {
-		coreLink->setMeteorsRate(evalInt(args[W_ZHR]));
+		coreLink->setMeteorsRate(evalInt(args.get(W_ZHR)));
 	} else
 		debug_message = "command 'meteors' : no zhr argument";
 	return executeCommandStatus();
@@ -2096,19 +2080,20 @@ int AppCommandInterface::commandMeteors()
 
 int AppCommandInterface::commandLandscape()
 {
-	std::string argAction = args[W_ACTION];
-	std::string argLanding = args[W_LANDING];
+	const std::string &argAction = args[W_ACTION];
+	const std::string &argLanding = args[W_LANDING];
 	if (!argAction.empty()) {
 		if (argAction ==  W_LOAD) {
 			// textures are relative to script
-			args[W_PATH] = scriptInterface->getScriptPath();
+			stringHash_t param = args.toHash();
+			param[W_PATH] = scriptInterface->getScriptPath();
 			if (argLanding == "0")
-				stcore->loadLandscape(args, 0); //TODO retour d'erreurs
+				stcore->loadLandscape(param, 0); //TODO retour d'erreurs
 			else
-				stcore->loadLandscape(args, 1); //TODO retour d'erreurs
+				stcore->loadLandscape(param, 1); //TODO retour d'erreurs
 		} else if (argAction == W_ROTATE) {
 			if (!args[W_ROTATION].empty()) {
-				coreLink->rotateLandscape((M_PI/180.0)*evalDouble(args[W_ROTATION]));
+				coreLink->rotateLandscape((M_PI/180.0)*evalDouble(args.get(W_ROTATION)));
 				return executeCommandStatus();
 			} else {
 				debug_message = "command 'landscape' : missing rotation parameter";
@@ -2134,9 +2119,9 @@ int AppCommandInterface::commandScreenFader()
 	Event* event;
 	if (!args[W_ALPHA].empty()) {
 		if (!args[W_DURATION].empty()) {
-			event = new ScreenFaderEvent(ScreenFaderEvent::CHANGE, evalDouble(args[W_ALPHA]), evalDouble(args[W_DURATION]));
+			event = new ScreenFaderEvent(ScreenFaderEvent::CHANGE, evalDouble(args.get(W_ALPHA)), evalDouble(args.get(W_DURATION)));
 		} else {
-			event = new ScreenFaderEvent(ScreenFaderEvent::FIX, evalDouble(args[W_ALPHA]));
+			event = new ScreenFaderEvent(ScreenFaderEvent::FIX, evalDouble(args.get(W_ALPHA)));
 		}
 		EventRecorder::getInstance()->queue(event);
 	} else {
@@ -2147,7 +2132,7 @@ int AppCommandInterface::commandScreenFader()
 
 int AppCommandInterface::commandText()
 {
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 
 	if (argAction== W_CLEAR) {
 		media->textClear();
@@ -2168,7 +2153,7 @@ int AppCommandInterface::commandText()
 		return executeCommandStatus();
 	}
 
-	std::string argDisplay = args[W_DISPLAY];
+	const std::string &argDisplay = args[W_DISPLAY];
 	std::string argString = args[W_STRING];
 
 	argString = Translator::globalTranslator.translateUTF8(evalString(argString));
@@ -2191,9 +2176,9 @@ int AppCommandInterface::commandText()
 			}
 			return executeCommandStatus();
 		} else if (argAction== W_LOAD) {
-			std::string argAzimuth = args[W_AZIMUTH];
-			std::string argAltitude = args[W_ALTITUDE];
-			if( !argAzimuth.empty() && !argAltitude.empty()) {
+			const ScriptArgument &argAzimuth = args.get(W_AZIMUTH);
+			const ScriptArgument &argAltitude = args.get(W_ALTITUDE);
+			if( !argAzimuth.value.empty() && !argAltitude.value.empty()) {
 
 				//creation of parameters
 				TEXT_MGR_PARAM textParam;
@@ -2208,10 +2193,10 @@ int AppCommandInterface::commandText()
 					std::transform(textParam.textAlign.begin(), textParam.textAlign.end(),textParam.textAlign.begin(), ::toupper);
 				//color management
 				Vec3f Vcolor;
-				std::string argValue = args[W_COLOR_VALUE];
-				std::string argR= args[W_R];
-				std::string argG= args[W_G];
-				std::string argB= args[W_B];
+				const std::string &argValue = args[W_COLOR_VALUE];
+				const std::string &argR= args[W_R];
+				const std::string &argG= args[W_G];
+				const std::string &argB= args[W_B];
 				std::string msg;
 				AppCommandColor testColor(Vcolor, msg, argValue, argR,argG, argB);
 
@@ -2221,7 +2206,7 @@ int AppCommandInterface::commandText()
 				} else
 					textParam.useColor = false;
 				textParam.fader = false;
-				std::string argFader = args[W_FADER];
+				const std::string &argFader = args[W_FADER];
 				if (!argFader.empty()) {
 					if (Utility::isTrue(argFader))
 						textParam.fader = true;
@@ -2303,7 +2288,7 @@ int AppCommandInterface::commandSkyCulture()
 
 int AppCommandInterface::commandScript(uint64_t &wait)
 {
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	std::string filen = args[W_FILENAME];
 	if (filen.size() < 4 || filen[filen.size()-4] != '.')
 		filen = evalString(filen);
@@ -2345,7 +2330,7 @@ int AppCommandInterface::commandScript(uint64_t &wait)
 		return executeCommandStatus();
 	}
 
-	std::string argSpeed = args[W_SPEED];
+	const std::string &argSpeed = args[W_SPEED];
 	if (!argSpeed.empty()) {
 		if (argSpeed==W_FASTER) {
 			scriptInterface->fasterSpeed();
@@ -2364,11 +2349,11 @@ int AppCommandInterface::commandScript(uint64_t &wait)
 int AppCommandInterface::commandAudio()
 {
 	//volume management
-	std::string argVolume = args[W_VOLUME];
-	if (!argVolume.empty()) {
-		if (argVolume == W_INCREMENT) {
+	const ScriptArgument &argVolume = args.get(W_VOLUME);
+	if (!argVolume.value.empty()) {
+		if (argVolume.value == W_INCREMENT) {
 			media->audioVolumeIncrement();
-		} else if (argVolume == W_DECREMENT) {
+		} else if (argVolume.value == W_DECREMENT) {
 			media->audioVolumeDecrement();
 		} else
 			media->audioSetVolume(evalInt(argVolume));
@@ -2376,14 +2361,14 @@ int AppCommandInterface::commandAudio()
 	}
 
 	//management of audio pause in scripts
-	std::string argMusicPause= args[W_NOPAUSE];
+	const std::string &argMusicPause= args[W_NOPAUSE];
 	if (!argMusicPause.empty()) {
 		media->audioSetMusicToPause(Utility::isTrue(args[W_NOPAUSE]));
 		return executeCommandStatus();
 	}
 
 	//action management
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	if (!argAction.empty()) {
 		if (argAction ==W_DROP) {
 			media->audioMusicDrop();
@@ -2398,7 +2383,7 @@ int AppCommandInterface::commandAudio()
 			media->audioMusicResume();
 			return executeCommandStatus();
 		} else if (argAction==W_PLAY){
-			std::string argFileName = args[W_FILENAME];
+			const std::string &argFileName = args[W_FILENAME];
 			if (!argFileName.empty() ) {
 				if (FilePath myFile  = FilePath(argFileName, FilePath::TFP::AUDIO)) {
 					media->audioMusicLoad(myFile, Utility::isTrue(args[W_LOOP]));
@@ -2424,25 +2409,25 @@ int AppCommandInterface::commandAudio()
 
 int AppCommandInterface::commandImage()
 {
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	if (argAction==W_PURGE) {
 		media->imageDropAll();
 		return executeCommandStatus();
 	}
 
-	std::string argName = args[W_NAME];
-	if (argName.empty()) {
+	const ScriptArgument &argName = args.get(W_NAME);
+	if (argName.value.empty()) {
 		debug_message = _("Image argument name required.");
 		return executeCommandStatus();
 	}
 
-	std::string argFileName = args[W_FILENAME];
+	const ScriptArgument &argFileName = args.get(W_FILENAME);
 	if (argAction==W_DROP) {
-		media->imageDrop(evalString(args[W_NAME]));
+		media->imageDrop(evalString(args.get(W_NAME)));
 		return executeCommandStatus();
 	}
 
-	if (argAction== W_LOAD && !argFileName.empty()) {
+	if (argAction== W_LOAD && !argFileName.value.empty()) {
 		FilePath myFile  = FilePath(evalString(argFileName), FilePath::TFP::IMAGE);
 		if (!myFile.exist()) {
 			debug_message = _("command 'image': filename not found");
@@ -2453,7 +2438,7 @@ int AppCommandInterface::commandImage()
 			argCoordinate = W_EQUATORIAL;
 		}
 
-		std::string argProject = args[W_PROJECT];
+		const std::string &argProject = args[W_PROJECT];
 		IMG_PROJECT tmpProject = IMG_PROJECT::ONCE;
 		if (argProject==W_TWICE) {
 			tmpProject = IMG_PROJECT::TWICE;
@@ -2469,46 +2454,46 @@ int AppCommandInterface::commandImage()
 		//TODO recover an understandable error rather than an int?
 		int status = media->imageLoad(myFile.toString(), evalString(argName), argCoordinate, tmpProject , mipmap);
 		if (status!=1) {
-			debug_message = _("Unable to load image: ") + argName;
+			debug_message = _("Unable to load image: ") + argName.value;
 			return executeCommandStatus();
 		}
 	}
 
 	if (media->imageSet(evalString(argName)) != true) {
-		debug_message = _("Unable to find image: ") + argName;
+		debug_message = _("Unable to find image: ") + argName.value;
 		return executeCommandStatus();
 	}
 
 	//initialization of all variables
-	std::string argDuration = args[W_DURATION];
-	std::string argAlpha = args[W_ALPHA];
-	std::string argScale = args[W_SCALE];
-	std::string argRotation = args[W_ROTATION];
-	std::string argRatio = args[W_RATIO];
-	std::string argXpos = args[W_XPOS];
-	std::string argYpos = args[W_YPOS];
-	std::string argAltitude = args[W_ALTITUDE];
-	std::string argAzimuth = args[W_AZIMUTH];
-	std::string argPersistent = args[W_PERSISTENT];
-	std::string argAccelerate_x = args[W_ACCELERATE_ALT];
-	std::string argAccelerate_y = args[W_ACCELERATE_AZ];
-	std::string argDecelerate_x = args[W_DECELERATE_ALT];
-	std::string argDecelerate_y = args[W_DECELERATE_AZ];
-	std::string argHP = args[W_HP];
-
-	if (!argAlpha.empty())
+	const ScriptArgument &argDuration = args.get(W_DURATION);
+	const ScriptArgument &argAlpha = args.get(W_ALPHA);
+	const ScriptArgument &argScale = args.get(W_SCALE);
+	const ScriptArgument &argRotation = args.get(W_ROTATION);
+	const ScriptArgument &argRatio = args.get(W_RATIO);
+	const ScriptArgument &argXpos = args.get(W_XPOS);
+	const ScriptArgument &argYpos = args.get(W_YPOS);
+	const ScriptArgument &argAltitude = args.get(W_ALTITUDE);
+	const ScriptArgument &argAzimuth = args.get(W_AZIMUTH);
+	const std::string &argPersistent = args[W_PERSISTENT];
+	const std::string &argAccelerate_x = args[W_ACCELERATE_ALT];
+	const std::string &argAccelerate_y = args[W_ACCELERATE_AZ];
+	const std::string &argDecelerate_x = args[W_DECELERATE_ALT];
+	const std::string &argDecelerate_y = args[W_DECELERATE_AZ];
+	const ScriptArgument &argHP = args.get(W_HP);
+
+	if (!argAlpha.value.empty())
 		media->imageSetAlpha(evalDouble(argAlpha), evalDouble(argDuration));
 
-	if (!argScale.empty())
+	if (!argScale.value.empty())
 		media->imageSetScale(evalDouble(argScale), evalDouble(argDuration));
 
-	if (!argRotation.empty())
+	if (!argRotation.value.empty())
 		media->imageSetRotation(evalDouble(argRotation), evalDouble(argDuration));
 
-	if (!argRatio.empty())
+	if (!argRatio.value.empty())
 		media->imageSetRatio(evalDouble(argRatio), evalDouble(argDuration));
 
-	if (!argHP.empty()) {
+	if (!argHP.value.empty()) {
 		const float rad2deg = 180.0f/M_PI;
 		double az, alt;
 		bool isStar = stcore->getStarEarthEquPosition(evalInt(argHP), az, alt);
@@ -2519,22 +2504,22 @@ int AppCommandInterface::commandImage()
 					(argAccelerate_x==W_ON), (argDecelerate_x==W_ON),
 					(argAccelerate_y==W_ON), (argDecelerate_y==W_ON));
 		} else {
-			debug_message = _("command 'image': HP number ") + argHP + _(" is not a valid star");
+			debug_message = _("command 'image': HP number ") + argHP.value + _(" is not a valid star");
 			return executeCommandStatus();
 		}
 	}
 
-	if (!argXpos.empty() || !argYpos.empty())
-		media->imageSetLocation(evalDouble(argXpos), !argXpos.empty(),
-		                        evalDouble(argYpos), !argYpos.empty(),
+	if (!argXpos.value.empty() || !argYpos.value.empty())
+		media->imageSetLocation(evalDouble(argXpos), !argXpos.value.empty(),
+		                        evalDouble(argYpos), !argYpos.value.empty(),
 		                        evalDouble(argDuration),
 		                        (argAccelerate_x==W_ON), (argDecelerate_x==W_ON),
 		                        (argAccelerate_y==W_ON), (argDecelerate_y==W_ON));
 
 	// for more human readable scripts, as long as someone doesn't do both...
-	if (!argAltitude.empty() || !argAzimuth.empty() )
-		media->imageSetLocation(evalDouble(argAltitude), !argAltitude.empty(),
-		                        evalDouble(argAzimuth), !argAzimuth.empty(),
+	if (!argAltitude.value.empty() || !argAzimuth.value.empty() )
+		media->imageSetLocation(evalDouble(argAltitude), !argAltitude.value.empty(),
+		                        evalDouble(argAzimuth), !argAzimuth.value.empty(),
 		                        evalDouble(argDuration),
 		                        (argAccelerate_x==W_ON), (argDecelerate_x==W_ON),
 		                        (argAccelerate_y==W_ON), (argDecelerate_y==W_ON));
@@ -2547,7 +2532,7 @@ int AppCommandInterface::commandImage()
 	}
 
 
-	std::string argKeyColor = args[W_KEYCOLOR];
+	const std::string &argKeyColor = args[W_KEYCOLOR];
 	if (!argKeyColor.empty()) {
 		if (Utility::isTrue(argKeyColor))
 			media->imageSetKeyColor(true);
@@ -2556,13 +2541,13 @@ int AppCommandInterface::commandImage()
 	}
 
 	Vec3f Vcolor;
-	std::string argValue = args[W_COLOR_VALUE];
-	std::string argR= args[W_R];
-	std::string argG= args[W_G];
-	std::string argB= args[W_B];
+	const std::string &argValue = args[W_COLOR_VALUE];
+	const std::string &argR= args[W_R];
+	const std::string &argG= args[W_G];
+	const std::string &argB= args[W_B];
 	AppCommandColor testColor(Vcolor, debug_message, argValue, argR,argG,argB);
 	if (testColor) {
-		std::string argIntensity = args[W_INTENSITY];
+		const std::string &argIntensity = args[W_INTENSITY];
 		if (!argIntensity.empty())
 			media->imageSetKeyColor(Vcolor,Utility::strToDouble(argIntensity)) ;
 		else
@@ -2623,7 +2608,7 @@ int AppCommandInterface::commandSelect()
 
 int AppCommandInterface::commandDeselect()
 {
-	std::string argConstellation = args[W_CONSTELLATION];
+	const std::string &argConstellation = args[W_CONSTELLATION];
 	if ( !argConstellation.empty())
 		stcore->unsetSelectedConstellation(argConstellation);
 	else
@@ -2648,14 +2633,14 @@ int AppCommandInterface::commandUncomment()
 
 int AppCommandInterface::commandLook()
 {
-	std::string argAz  = args[W_AZIMUTH];
-	std::string argAlt = args[W_ALTITUDE];
+	const ScriptArgument &argAz  = args.get(W_AZIMUTH);
+	const ScriptArgument &argAlt = args.get(W_ALTITUDE);
 
-	if(!argAz.empty() && !argAlt.empty()){
+	if(!argAz.value.empty() && !argAlt.value.empty()){
 
-		std::string argTime = args[W_DURATION];
+		const ScriptArgument &argTime = args.get(W_DURATION);
 
-		if(argTime.empty()){
+		if(argTime.value.empty()){
 			coreLink->lookAt(evalDouble(argAz), evalDouble(argAlt));
 		}
 		else{
@@ -2666,11 +2651,11 @@ int AppCommandInterface::commandLook()
 	}
 
 	//change direction of view
-	std::string argD_az  = args[W_DELTA_AZIMUTH];
-	std::string argD_alt = args[W_DELTA_ALTITUDE];
-	if (!argD_az.empty() || !argD_alt.empty()) {
+	const ScriptArgument &argD_az  = args.get(W_DELTA_AZIMUTH);
+	const ScriptArgument &argD_alt = args.get(W_DELTA_ALTITUDE);
+	if (!argD_az.value.empty() || !argD_alt.value.empty()) {
 		// immediately change viewing direction
-		stcore->panView(evalDouble(argD_az), evalDouble(argD_alt), evalDouble(args[W_DURATION]));
+		stcore->panView(evalDouble(argD_az), evalDouble(argD_alt), evalDouble(args.get(W_DURATION)));
 	} else {
 		debug_message = _("Command 'look_at': wrong argument");
 	}
@@ -2699,7 +2684,7 @@ int AppCommandInterface::commandStarLines()
 
 int AppCommandInterface::commandPosition()
 {
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	if (argAction == W_SAVE) {
 		coreBackup->saveBackup();
 		return executeCommandStatus();
@@ -2715,8 +2700,8 @@ int AppCommandInterface::commandPosition()
 int AppCommandInterface::commandZoom(uint64_t &wait)
 {
 	double duration = Utility::strToPosDouble(args[W_DURATION]);
-	std::string argAuto = args[W_AUTO];
-	std::string argManual = args[W_MANUAL];
+	const std::string &argAuto = args[W_AUTO];
+	const std::string &argManual = args[W_MANUAL];
 
 	if (!argAuto.empty()) {
 		// auto zoom using specified or default duration
@@ -2732,13 +2717,13 @@ int AppCommandInterface::commandZoom(uint64_t &wait)
 
 	} else if (args[W_FOV]!="") {
 		// zoom to specific field of view
-		coreLink->zoomTo( evalDouble(args[W_FOV]), evalDouble(args[W_DURATION]));
+		coreLink->zoomTo( evalDouble(args.get(W_FOV)), evalDouble(args.get(W_DURATION)));
 
-	} else if (args[W_DELTA_FOV]!="") coreLink->setFov(coreLink->getFov() + evalDouble(args[W_DELTA_FOV]));
+	} else if (args[W_DELTA_FOV]!="") coreLink->setFov(coreLink->getFov() + evalDouble(args.get(W_DELTA_FOV)));
 	// should we record absolute fov instead of delta? isn't usually smooth playback
 	else if (args[W_CENTER]==W_ON) {
 		float cdelay=5;
-		if ( args[W_DURATION]!="") cdelay = evalDouble(args[W_DURATION]);
+		if ( args[W_DURATION]!="") cdelay = evalDouble(args.get(W_DURATION));
 		stcore->gotoSelectedObject();  // center view to selected objet
 		if (cdelay > 0) wait = (int)(cdelay*1000);
 	} else {
@@ -2749,13 +2734,13 @@ int AppCommandInterface::commandZoom(uint64_t &wait)
 
 int AppCommandInterface::commandTimerate()
 {
-	std::string argRate = args[W_RATE];
-	std::string argAction = args[W_ACTION];
-	std::string argStep = args[W_STEP];
-	std::string argDuration = args[W_DURATION];
+	const ScriptArgument &argRate = args.get(W_RATE);
+	const std::string &argAction = args[W_ACTION];
+	const ScriptArgument &argStep = args.get(W_STEP);
+	const std::string &argDuration = args[W_DURATION];
 
 	// NOTE: accuracy issue related to frame rate
-	if (!argRate.empty()) {
+	if (!argRate.value.empty()) {
 		if (argDuration.empty()) {
 			coreLink->timeSetFlagPause(false);
 			coreLink->timeSetSpeed(evalDouble(argRate)*JD_SECOND);
@@ -2776,7 +2761,7 @@ int AppCommandInterface::commandTimerate()
 
 		double sstep = 2.;
 
-		if( !argStep.empty() )
+		if( !argStep.value.empty() )
 			sstep = evalDouble(argStep);
 
 		if (s>=JD_SECOND) s*=sstep;
@@ -2793,7 +2778,7 @@ int AppCommandInterface::commandTimerate()
 		coreLink->timeSetFlagPause(false);
 		double sstep = 1.05;
 		if ((abs(s)<3) && (coreLink->observatoryGetAltitude()>150E9)) s=3;
-		if( !argStep.empty() )
+		if( !argStep.value.empty() )
 			sstep = evalDouble(argStep);
 
 		if (s>=JD_SECOND) s*=sstep;
@@ -2809,7 +2794,7 @@ int AppCommandInterface::commandTimerate()
 
 		double sstep = 2.;
 
-		if( !argStep.empty() )
+		if( !argStep.value.empty() )
 			sstep = evalDouble(argStep);
 
 		if (s>JD_SECOND) s/=sstep;
@@ -2825,7 +2810,7 @@ int AppCommandInterface::commandTimerate()
 		double sstep = 1.05;
 		if ((abs(s)<3) && (coreLink->observatoryGetAltitude()>150E9)) s=-3;
 
-		if( !argStep.empty() )
+		if( !argStep.value.empty() )
 			sstep = evalDouble(argStep);
 
 		if (s>JD_SECOND) s/=sstep;
@@ -2846,17 +2831,17 @@ int AppCommandInterface::commandMoveto()
 	std::string argLon = args[W_LON];
 	std::string argAlt = args[W_ALT];
 
-	std::string argDeltaLat = args[W_DELTA_LAT];
-	std::string argDeltaLon = args[W_DELTA_LON];
-	std::string argDeltaAlt = args[W_DELTA_ALT];
-	std::string argMultAlt = args[W_MULTIPLY_ALT];
+	const ScriptArgument &argDeltaLat = args.get(W_DELTA_LAT);
+	const ScriptArgument &argDeltaLon = args.get(W_DELTA_LON);
+	const ScriptArgument &argDeltaAlt = args.get(W_DELTA_ALT);
+	const ScriptArgument &argMultAlt = args.get(W_MULTIPLY_ALT);
 
 	if(argLat.empty()) argLat = args[W_LATITUDE];
 	if(argLon.empty()) argLon = args[W_LONGITUDE];
 	if(argAlt.empty()) argAlt = args[W_ALTITUDE];
 
 
-	if (argLat.empty() && argLon.empty() && argAlt.empty() && argDeltaLat.empty() && argDeltaLon.empty() && argDeltaAlt.empty() && argMultAlt.empty()) {
+	if (argLat.empty() && argLon.empty() && argAlt.empty() && argDeltaLat.value.empty() && argDeltaLon.value.empty() && argDeltaAlt.value.empty() && argMultAlt.value.empty()) {
 		debug_message = "command 'move_to' : missing lat && lon && alt";
 		return executeCommandStatus();
 	}
@@ -2889,20 +2874,20 @@ int AppCommandInterface::commandMoveto()
 		}
 	}
 
-	if (!argDeltaLat.empty()) {
+	if (!argDeltaLat.value.empty()) {
 			lat += evalDouble(argDeltaLat);
 	}
-	if (!argDeltaLon.empty()) {
+	if (!argDeltaLon.value.empty()) {
 			lon += evalDouble(argDeltaLon);
 	}
-	if (!argDeltaAlt.empty()) {
+	if (!argDeltaAlt.value.empty()) {
 		alt += evalDouble(argDeltaAlt);
 	}
-	if (!argMultAlt.empty()) {
+	if (!argMultAlt.value.empty()) {
 		alt *= evalDouble(argMultAlt);
 	}
 
-	delay = (int)(1000.*evalDouble(args[W_DURATION]));
+	delay = (int)(1000.*evalDouble(args.get(W_DURATION)));
 
 	coreLink->observerMoveTo(lat,lon,alt,delay);
 
@@ -2911,20 +2896,20 @@ int AppCommandInterface::commandMoveto()
 
 int AppCommandInterface::commandModeJump()
 {
-	std::string argJump = args[W_JUMP];
+	const std::string &argJump = args[W_JUMP];
 	if (!argJump.empty()) {
 		stapp->switchMode(argJump);
 
-		std::string argBody = args[W_BODY];
+		const std::string &argBody = args[W_BODY];
 		if (!argBody.empty())
 			stcore->setHomePlanet(argBody);
 
-		std::string argAlt = args[W_ALTITUDE];
-		if (!argAlt.empty()) {
+		const ScriptArgument &argAlt = args.get(W_ALTITUDE);
+		if (!argAlt.value.empty()) {
 			double lati = coreLink->observatoryGetLatitude();
 			double longi = coreLink->observatoryGetLongitude();
 			double alt = coreLink->observatoryGetAltitude();
-			if (argAlt[0] == '+' || argAlt[0] == '-')
+			if (argAlt.value[0] == '+' || argAlt.value[0] == '-')
 				alt += evalDouble(argAlt);
 			else
 				alt = evalDouble(argAlt);
@@ -2936,12 +2921,12 @@ int AppCommandInterface::commandModeJump()
 
 int AppCommandInterface::commandMedia()
 {
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	if (!argAction.empty() ) {
 
 		if (argAction == W_PLAY) {
 
-			std::string argLoop = args[W_LOOP];
+			const std::string &argLoop = args[W_LOOP];
 			if (!argLoop.empty()) {
 				if (Utility::isTrue(argLoop))
 					media->setLoop(true);
@@ -2959,8 +2944,8 @@ int AppCommandInterface::commandMedia()
 				return executeCommandStatus();
 			}
 			std::string videoName = args[W_VIDEONAME];
-			std::string argName =  args[W_NAME];
-			std::string argPosition = args[W_POSITION];
+			const std::string &argName =  args[W_NAME];
+			const std::string &argPosition = args[W_POSITION];
 
 			FilePath::TFP localRepertory;
 			if (type_string == W_VR360 || type_string == W_VRCUBE)
@@ -2974,7 +2959,7 @@ int AppCommandInterface::commandMedia()
 				return executeCommandStatus();
 			}
 
-			std::string argProject = args[W_PROJECT];
+			const std::string &argProject = args[W_PROJECT];
 			IMG_PROJECT tmpProject = IMG_PROJECT::ONCE;
 			if (argProject==W_TWICE) {
 				tmpProject = IMG_PROJECT::TWICE;
@@ -3027,13 +3012,13 @@ int AppCommandInterface::commandMedia()
 				}
 
 			Vec3f Vcolor;
-			std::string argValue = args[W_COLOR_VALUE];
-			std::string argR= args[W_R];
-			std::string argG= args[W_G];
-			std::string argB= args[W_B];
+			const std::string &argValue = args[W_COLOR_VALUE];
+			const std::string &argR= args[W_R];
+			const std::string &argG= args[W_G];
+			const std::string &argB= args[W_B];
 			AppCommandColor testColor(Vcolor, debug_message, argValue, argR,argG,argB);
 			if (testColor) {
-				std::string argIntensity = args[W_INTENSITY];
+				const std::string &argIntensity = args[W_INTENSITY];
 				if (!argIntensity.empty())
 					media->setKeyColor(Vcolor,Utility::strToDouble(argIntensity)) ;
 				else
@@ -3041,7 +3026,7 @@ int AppCommandInterface::commandMedia()
 			} else
 				debug_message.clear();
 
-			std::string argKeyColor = args[W_KEYCOLOR];
+			const std::string &argKeyColor = args[W_KEYCOLOR];
 			if (!argKeyColor.empty()) {
 				if (Utility::isTrue(argKeyColor)) {
 					media->setKeyColor(true);
@@ -3059,7 +3044,7 @@ int AppCommandInterface::commandMedia()
 			media->playerPause();
 			return executeCommandStatus();
 		} else if (argAction == W_JUMP) {
-			media->playerJump(evalDouble(args[W_VALUE]));
+			media->playerJump(evalDouble(args.get(W_VALUE)));
 			return executeCommandStatus();
 		} else if (argAction == W_RESTART) {
 			media->playerRestart();
@@ -3075,7 +3060,7 @@ int AppCommandInterface::commandMedia()
 
 int AppCommandInterface::commandDomemasters()
 {
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	if (!argAction.empty()) {
 		if (argAction == W_SNAPSHOT) {
 			saveScreenInterface->takeScreenShot();
@@ -3095,15 +3080,15 @@ int AppCommandInterface::commandDomemasters()
 int AppCommandInterface::commandDate()
 {
 	//case of jday
-	std::string argJday = args[W_JDAY];
-	if (!argJday.empty() ) {
+	const ScriptArgument &argJday = args.get(W_JDAY);
+	if (!argJday.value.empty() ) {
 		//TODO stcore doit renvoyer un code rectour erreur
 		coreLink->setJDay( evalDouble(argJday) );
 		return executeCommandStatus();
 	}
 
 	//case of local
-	std::string argLocal = args[W_LOCAL];
+	const std::string &argLocal = args[W_LOCAL];
 	if (!argLocal.empty() ) {
 		// ISO 8601-like format [[+/-]YYYY-MM-DD]Thh:mm:ss (no timzone offset, T is literal)
 		double jd;
@@ -3124,7 +3109,7 @@ int AppCommandInterface::commandDate()
 	}
 
 	//case of utc
-	std::string argUtc = args[W_UTC];
+	const std::string &argUtc = args[W_UTC];
 	if (!argUtc.empty()) {
 		double jd;
 		if (SpaceDate::StringToJday(argUtc, jd ) ) {
@@ -3136,8 +3121,8 @@ int AppCommandInterface::commandDate()
 	}
 
 	//case of relative
-	std::string argRelative = args[W_RELATIVE];
-	if (!argRelative.empty()) { // value is a float number of days
+	const ScriptArgument &argRelative = args.get(W_RELATIVE);
+	if (!argRelative.value.empty()) { // value is a float number of days
 		double days = evalDouble(argRelative);
 		std::shared_ptr<Body> home = coreLink->getObserverHomeBody();
 		if (home==nullptr) {
@@ -3151,24 +3136,24 @@ int AppCommandInterface::commandDate()
 	}
 
 	//case of relative_year
-	std::string argRelativeYear = args[W_RELATIVE_YEAR];
-	if (!argRelativeYear.empty()) {
+	const ScriptArgument &argRelativeYear = args.get(W_RELATIVE_YEAR);
+	if (!argRelativeYear.value.empty()) {
 		int years = evalInt(argRelativeYear);
 		stcore->setJDayRelative(years,0);
 		return executeCommandStatus();
 	}
 
 	//case of relative_month
-	std::string argRelativeMonth = args[W_RELATIVE_MONTH];
-	if (!argRelativeMonth.empty()) {
+	const ScriptArgument &argRelativeMonth = args.get(W_RELATIVE_MONTH);
+	if (!argRelativeMonth.value.empty()) {
 		int months = evalInt(argRelativeMonth);
 		stcore->setJDayRelative(0, months);
 		return executeCommandStatus();
 	}
 
 	//case of sidereal
-	std::string argSidereal = args[W_SIDEREAL];
-	if (!argSidereal.empty()) { // value is a float number of sidereal days
+	const ScriptArgument &argSidereal = args.get(W_SIDEREAL);
+	if (!argSidereal.value.empty()) { // value is a float number of sidereal days
 		double days = evalDouble(argSidereal);
 		std::shared_ptr<Body> home = coreLink->getObserverHomeBody();
 		if (home==nullptr) {
@@ -3183,7 +3168,7 @@ int AppCommandInterface::commandDate()
 	}
 
 	//case of load
-	std::string argLoad = args[ W_LOAD];
+	const std::string &argLoad = args[ W_LOAD];
 	if (!argLoad.empty()) {
 		if (argLoad == W_CURRENT) { //IIICCCCIIII
 			// set date to current date
@@ -3212,7 +3197,7 @@ int AppCommandInterface::commandDate()
 	}
 
 	//case of Sun
-	std::string argSun = args[W_SUN];
+	const std::string &argSun = args[W_SUN];
 	if (!argSun.empty()) {
 		if (argSun == W_SET) {
 			double tmp=coreLink->dateSunSet(coreLink->getJDay(), coreLink->observatoryGetLongitude(), coreLink->observatoryGetLatitude());
@@ -3241,19 +3226,19 @@ int AppCommandInterface::commandDate()
 int AppCommandInterface::commandBody()
 {
 	//share management
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	std::string argName = args[W_NAME];
     if (argName == ACP_SC_HOME_PLANET  ) argName = coreLink->getObserverHomePlanetEnglishName();
-	std::string argMode = args[ACP_SC_MODE];
+	const std::string &argMode = args[ACP_SC_MODE];
 
 	// OJM processing
 	if ((argMode=="in_universe" || argMode=="in_galaxy") && !argAction.empty()) {
 		if (argAction == W_LOAD) {
 			std::string argFileName = args[W_FILENAME];
 			argFileName = argFileName +"/"+argFileName +".ojm";
-			Vec3f Position( evalDouble(args[W_POSX]), evalDouble(args[W_POSY]), evalDouble(args[W_POSZ] ));
+			Vec3f Position( evalDouble(args.get(W_POSX)), evalDouble(args.get(W_POSY)), evalDouble(args.get(W_POSZ)));
 			FilePath myFile  = FilePath(argFileName, FilePath::TFP::MODEL3D);
-			coreLink->BodyOJMLoad(argMode, argName, myFile.toString(), myFile.getPath() , Position, evalDouble(args[W_SCALE]));
+			coreLink->BodyOJMLoad(argMode, argName, myFile.toString(), myFile.getPath() , Position, evalDouble(args.get(W_SCALE)));
 			return executeCommandStatus();
 		}
 		if (argAction == W_REMOVE) {
@@ -3266,7 +3251,7 @@ int AppCommandInterface::commandBody()
 		}
 	}
 
-	std::string argSkinUse = args[W_SKINUSE];
+	const std::string &argSkinUse = args[W_SKINUSE];
 	if (!argSkinUse.empty()) {
 		if (argSkinUse==W_TOGGLE) {
 			coreLink->planetSwitchTexMap(argName, !coreLink->planetGetSwitchTexMap(argName));
@@ -3276,7 +3261,7 @@ int AppCommandInterface::commandBody()
 		return executeCommandStatus();
 	}
 
-	std::string argSkinTex = args[W_SKINTEX];
+	const std::string &argSkinTex = args[W_SKINTEX];
 	if (!argSkinTex.empty()) {
 		coreLink->planetCreateTexSkin(argName, argSkinTex);
 		return executeCommandStatus();
@@ -3285,10 +3270,11 @@ int AppCommandInterface::commandBody()
 	if (!argAction.empty()) {
 		if (argAction ==  W_LOAD ) {
 			// textures relative to script
-			args[W_PATH] = scriptInterface->getScriptPath();
+			stringHash_t param = args.toHash();
+			param[W_PATH] = scriptInterface->getScriptPath();
 			// Load a new solar system object
-			args["tex_ring"] = args[W_PATH] + args["tex_ring"];
-			stcore->addSolarSystemBody(args);
+			param["tex_ring"] = param[W_PATH] + param["tex_ring"];
+			stcore->addSolarSystemBody(param);
 		} else if (argAction == W_DROP && argName != "") {
 			// Delete an existing object, but only if was added by a script!
 			stcore->removeSolarSystemBody( argName );
@@ -3298,9 +3284,10 @@ int AppCommandInterface::commandBody()
 		} else if (argAction == W_INITIAL  ) {
 			coreLink->initialSolarSystemBodies();
 		} else if (argAction == W_PRELOAD) {
-			auto &kt = args[W_KEEPTIME];
+			stringHash_t param = args.toHash();
+			auto &kt = param[W_KEEPTIME];
 			kt = std::to_string(Utility::strToInt(kt, 10) * stapp->getTargetFps());
-			stcore->preloadSolarSystemBody(args);
+			stcore->preloadSolarSystemBody(param);
 		} else {
 			debug_message = "command 'body' : unknown action argument";
 		}
@@ -3311,7 +3298,7 @@ int AppCommandInterface::commandBody()
 	if (!argName.empty() ) {
 
 		//under hidden case
-		std::string argHidden = args[W_HIDDEN];
+		const std::string &argHidden = args[W_HIDDEN];
 		if (!argHidden.empty()) {
 			if (Utility::isTrue(argHidden)) {
 				coreLink->setPlanetHidden(args[W_NAME], true);
@@ -3325,7 +3312,7 @@ int AppCommandInterface::commandBody()
 		}
 
 		//under case orbit
-		std::string argOrbit = args[W_ORBIT];
+		const std::string &argOrbit = args[W_ORBIT];
 		if (!argOrbit.empty()) {
 			if (Utility::isTrue(argOrbit)) {
 				coreLink->planetsSetFlagOrbits(args[W_NAME], true);
@@ -3337,15 +3324,15 @@ int AppCommandInterface::commandBody()
 		}
 
 
-		std::string argColor = args[W_COLOR];
+		const std::string &argColor = args[W_COLOR];
 		if (!argColor.empty()) {
 			//std::cout << "I receive a color info for " << argName << std::endl;
 			//color management
 			Vec3f Vcolor;
-			std::string argR= args[W_R];
-			std::string argG= args[W_G];
-			std::string argB= args[W_B];
-			std::string argColorValue = args[W_COLOR_VALUE];
+			const std::string &argR= args[W_R];
+			const std::string &argG= args[W_G];
+			const std::string &argB= args[W_B];
+			const std::string &argColorValue = args[W_COLOR_VALUE];
 			//std::cout << "RGB: " << argR << " " << argG << " " << argB << std::endl;
 			AppCommandColor testColor(Vcolor, debug_message, argColorValue, argR, argG, argB);
 			if (!testColor) {
@@ -3362,7 +3349,7 @@ int AppCommandInterface::commandBody()
 	}
 
 	if (!args[W_TESSELATION].empty()) {
-		coreLink->planetTesselation(args[W_TESSELATION], evalInt(args[W_VALUE]));
+		coreLink->planetTesselation(args[W_TESSELATION], evalInt(args.get(W_VALUE)));
 		return executeCommandStatus();
 	}
 
@@ -3411,7 +3398,7 @@ int AppCommandInterface::commandFont()
 int AppCommandInterface::commandCamera(uint64_t &wait)
 {
 	//stock management
-	std::string argAction = args[W_ACTION];
+	const std::string &argAction = args[W_ACTION];
 	std::string argName = args[W_NAME];
 
 	if (argAction.empty()) {
@@ -3432,16 +3419,16 @@ int AppCommandInterface::commandCamera(uint64_t &wait)
 
 	if(argAction == W_ALIGN_WITH){
 
-		std::string argBody = args[W_BODY];
+		const std::string &argBody = args[W_BODY];
 		if (argBody.empty()) {
 			debug_message = "command 'align_with' : missing body";
 			return executeCommandStatus();
 		}
 
-		std::string argDuration = args[W_DURATION];
+		const ScriptArgument &argDuration = args.get(W_DURATION);
 		double duration =0;
 
-		if ( ! argDuration.empty()) {
+		if ( ! argDuration.value.empty()) {
 			duration = evalDouble(argDuration);
 		}
 
@@ -3499,12 +3486,12 @@ int AppCommandInterface::commandCamera(uint64_t &wait)
 		}
 
 		if(argTarget == W_POINT){
-			std::string argX = args[W_X];
-			std::string argY = args[W_Y];
-			std::string argZ = args[W_Z];
+			const ScriptArgument &argX = args.get(W_X);
+			const ScriptArgument &argY = args.get(W_Y);
+			const ScriptArgument &argZ = args.get(W_Z);
 			std::string argTime = args[W_DURATION];
 
-			if(argX.empty() || argY.empty() || argZ.empty()){
+			if(argX.value.empty() || argY.value.empty() || argZ.value.empty()){
 				debug_message = "command 'move_to point' : missing a coordinate";
 				return executeCommandStatus();
 			}
@@ -3524,7 +3511,7 @@ int AppCommandInterface::commandCamera(uint64_t &wait)
 		}
 
 		if(argTarget == W_BODY){
-			std::string argBodyName = args[W_BODYNAME];
+			const std::string &argBodyName = args[W_BODYNAME];
 			std::string argTime = args[W_DURATION];
 
 			if(argBodyName.empty() || argTime.empty()){
@@ -3532,11 +3519,11 @@ int AppCommandInterface::commandCamera(uint64_t &wait)
 				return executeCommandStatus();
 			}
 
-			std::string argAltitude = args[W_ALTITUDE];
+			const ScriptArgument &argAltitude = args.get(W_ALTITUDE);
 
 			bool result;
 
-			if(argAltitude.empty())
+			if(argAltitude.value.empty())
 				result = coreLink->cameraMoveToBody(argBodyName, evalDouble(argTime));
 			else
 				result = coreLink->cameraMoveToBody(argBodyName, evalDouble(argTime), evalDouble(argAltitude));
@@ -3613,7 +3600,8 @@ int AppCommandInterface::commandCamera(uint64_t &wait)
 
 	if (argAction == W_CREATE) {
 		// load an anchor via script
-		bool result = coreLink->cameraAddAnchor(args);
+		stringHash_t param = args.toHash();
+		bool result = coreLink->cameraAddAnchor(param);
 		if (!result)
 			debug_message = "error creating CameraAnchor";
 		return executeCommandStatus();
@@ -3676,12 +3664,27 @@ int AppCommandInterface::evalInt (const std::string &var)
 	return appEval->evalInt(var);
 }
 
+std::string AppCommandInterface::evalString (const ScriptArgument &argument)
+{
+	return appEval->evalString(argument);
+}
+
+double AppCommandInterface::evalDouble (const ScriptArgument &argument)
+{
+	return appEval->evalDouble(argument);
+}
+
+int AppCommandInterface::evalInt (const ScriptArgument &argument)
+{
+	return appEval->evalInt(argument);
+}
+
 
 int AppCommandInterface::commandDefine()
 {
 	if (args.begin() != args.end()) {
-		std::string mArg = args.begin()->first;
-		std::string mValue = args.begin()->second;
+		const std::string &mArg = args.begin()->key;
+		const ScriptArgument &mValue = *args.begin();
 		//std::cout << "Command define : " <<  mArg.c_str() << " => " << mValue.c_str() << std::endl;
 		appEval->define(mArg,mValue);
 	} else {
@@ -3694,8 +3697,8 @@ int AppCommandInterface::commandAdd()
 {
 	// could loop if want to allow that syntax
 	if (args.begin() != args.end()) {
-		std::string mArg = args.begin()->first;
-		std::string mValue = args.begin()->second;
+		const std::string &mArg = args.begin()->key;
+		const ScriptArgument &mValue = *args.begin();
 		appEval->commandAdd(mArg,mValue);
 	} else { //est ce que ce cas peut vraiment se produire ?
 		debug_message = "unexpected error in command_addition";
@@ -3707,8 +3710,8 @@ int AppCommandInterface::commandSub()
 {
 	// could loop if want to allow that syntax
 	if (args.begin() != args.end()) {
-		std::string mArg = args.begin()->first;
-		std::string mValue = args.begin()->second;
+		const std::string &mArg = args.begin()->key;
+		const ScriptArgument &mValue = *args.begin();
 		appEval->commandSub(mArg,mValue);
 	} else { //est ce que ce cas peut vraiment se produire ?
 		debug_message = "unexpected error in command_substract";
@@ -3721,8 +3724,8 @@ int AppCommandInterface::commandMultiply()
 {
 	// could loop if want to allow that syntax
 	if (args.begin() != args.end()) {
-		std::string mArg = args.begin()->first;
-		std::string mValue = args.begin()->second;
+		const std::string &mArg = args.begin()->key;
+		const ScriptArgument &mValue = *args.begin();
 		appEval->commandMul(mArg,mValue);
 	} else {
 		debug_message = "unexpected error in command__multiply";
@@ -3734,8 +3737,8 @@ int AppCommandInterface::commandDivide()
 {
 	// could loop if want to allow that syntax
 	if (args.begin() != args.end()) {
-		std::string mArg = args.begin()->first;
-		std::string mValue = args.begin()->second;
+		const std::string &mArg = args.begin()->key;
+		const ScriptArgument &mValue = *args.begin();
 		appEval->commandDiv(mArg,mValue);
 	} else {
 		debug_message = "unexpected error in command__divide";
@@ -3747,8 +3750,8 @@ int AppCommandInterface::commandTangent()
 {
 	// could loop if want to allow that syntax
 	if (args.begin() != args.end()) {
-		std::string mArg = args.begin()->first;
-		std::string mValue = args.begin()->second;
+		const std::string &mArg = args.begin()->key;
+		const ScriptArgument &mValue = *args.begin();
 		appEval->commandTan(mArg,mValue);
 	} else {
 		debug_message = "unexpected error in command__tangent";
@@ -3760,8 +3763,8 @@ int AppCommandInterface::commandTrunc()
 {
 	// could loop if want to allow that syntax
 	if (args.begin() != args.end()) {
-		std::string mArg = args.begin()->first;
-		std::string mValue = args.begin()->second;
+		const std::string &mArg = args.begin()->key;
+		const ScriptArgument &mValue = *args.begin();
 		appEval->commandTrunc(mArg,mValue);
 	} else {
 		debug_message = "unexpected error in command__trunc";
@@ -3773,8 +3776,8 @@ int AppCommandInterface::commandSinus()
 {
 	// could loop if want to allow that syntax
 	if (args.begin() != args.end()) {
-		std::string mArg = args.begin()->first;
-		std::string mValue = args.begin()->second;
+		const std::string &mArg = args.begin()->key;
+		const ScriptArgument &mValue = *args.begin();
 		appEval->commandSin(mArg,mValue);
 	} else {
 		debug_message = "unexpected error in command__sinus";
@@ -3786,53 +3789,53 @@ int AppCommandInterface::commandStruct()
 {
 	const double error = 0.0001;
 	// if case
-	std::string argIf = args[W_IF];
-	if (!argIf.empty() && swapCommand != true) {
-		if (argIf==W_ELSE) {
+	const ScriptArgument &argIf = args.get(W_IF);
+	if (!argIf.value.empty() && swapCommand != true) {
+		if (argIf.value==W_ELSE) {
 			ifSwap->revert();
 			return executeCommandStatus();
 		}
-		if (argIf==W_END) {
+		if (argIf.value==W_END) {
 			ifSwap->pop();
 			return executeCommandStatus();
 		}
 		if (args[W_EQUAL]!=""){  // ! A==B => |A-B| > e
-			if (fabs(evalDouble(argIf) - evalDouble(args[W_EQUAL]))>error)
+			if (fabs(evalDouble(argIf) - evalDouble(args.get(W_EQUAL)))>error)
 				ifSwap->push(true);
 			else
 				ifSwap->push(false);
 			return executeCommandStatus();
 		}
 		if (args[W_DIFF]!=""){  // ! A!=B => |A-B| < e
-			if (fabs(evalDouble(argIf) - evalDouble(args[W_DIFF]))<error)
+			if (fabs(evalDouble(argIf) - evalDouble(args.get(W_DIFF)))<error)
 				ifSwap->push(true);
 			else
 				ifSwap->push(false);
 			return executeCommandStatus();
 		}
 		if (args[W_INF]!="") {
-			if (evalDouble(argIf) >= evalDouble(args[W_INF]))
+			if (evalDouble(argIf) >= evalDouble(args.get(W_INF)))
 				ifSwap->push(true);
 			else
 				ifSwap->push(false);
 			return executeCommandStatus();
 		}
 		if (args[W_INF_ZQUAL]!="") {
-			if (evalDouble(argIf) > evalDouble(args[W_INF_ZQUAL]))
+			if (evalDouble(argIf) > evalDouble(args.get(W_INF_ZQUAL)))
 				ifSwap->push(true);
 			else
 				ifSwap->push(false);
 			return executeCommandStatus();
 		}
 		if (args[W_SUP]!="") {
-			if (evalDouble(argIf) <= evalDouble(args[W_SUP]))
+			if (evalDouble(argIf) <= evalDouble(args.get(W_SUP)))
 				ifSwap->push(true);
 			else
 				ifSwap->push(false);
 			return executeCommandStatus();
 		}
 		if (args[W_SUP_EQUAL]!="") {
-			if (evalDouble(argIf) < evalDouble(args[W_SUP_EQUAL]))
+			if (evalDouble(argIf) < evalDouble(args.get(W_SUP_EQUAL)))
 				ifSwap->push(true);
 			else
 				ifSwap->push(false);
@@ -3847,7 +3850,7 @@ int AppCommandInterface::commandStruct()
 	}
 
 	//comment case
-	std::string argComment = args[W_COMMENT];
+	const std::string &argComment = args[W_COMMENT];
 	if (!argComment.empty()) {
 		if (Utility::isTrue(argComment)) {
 			return commandComment();
@@ -3857,16 +3860,16 @@ int AppCommandInterface::commandStruct()
 	}
 
 	//loop case
-	std::string argLoop = args[W_LOOP];
-	if (!argLoop.empty() && ifSwap->get() != true) {
-		if (argLoop ==W_END) {
+	const ScriptArgument &argLoop = args.get(W_LOOP);
+	if (!argLoop.value.empty() && ifSwap->get() != true) {
+		if (argLoop.value ==W_END) {
 			swapCommand = false; //cas ou nbrLoop était inférieur à 1
 			scriptInterface->setScriptLoop(false);
 			scriptInterface->initScriptIterator();
 			return executeCommandStatus();
 		}
 
-		if (argLoop ==W_BREAK) {
+		if (argLoop.value ==W_BREAK) {
 			swapCommand = false;
 			scriptInterface->resetScriptLoop();
 			return executeCommandStatus();
@@ -3894,13 +3897,13 @@ int AppCommandInterface::commandStruct()
 int AppCommandInterface::commandRandom()
 {
 	bool status = false;
-	std::string argMin = args[W_MIN];
-	if (!argMin.empty()) {
+	const ScriptArgument &argMin = args.get(W_MIN);
+	if (!argMin.value.empty()) {
 		appEval->commandRandomMin(argMin);
 		status = true;
 	}
-	std::string argMax = args[W_MAX];
-	if (!argMax.empty()) {
+	const ScriptArgument &argMax = args.get(W_MAX);
+	if (!argMax.value.empty()) {
 		appEval->commandRandomMax(argMax);
 		status = true;
 	}
@@ -3913,7 +3916,7 @@ int AppCommandInterface::commandTransition()
 {
 	std::string action = std::move(args[W_ACTION]);
 	if (action == W_SKIP) {
-		float duration = evalDouble(args[W_DURATION]);
+		float duration = evalDouble(args.get(W_DURATION));
 		if (!duration)
 			duration = 3600; // Ensure transitions complete now
 		if (!stcore->getFlagEnableTransition()) {
@@ -35,6 +35,7 @@
 #include <memory>
 #include "tools/utility.hpp"
 #include "base_command_interface.hpp"
+#include "scriptModule/script_command.hpp"
 #include "tools/no_copy.hpp"
 #include "EntityCore/Executor/AsyncLoaderMgr.hpp"
 
@@ -63,6 +64,10 @@ public:
 	void deleteVar();
 	int executeCommand(const std::string &commandline);
 	int executeCommand(const std::string &command, uint64_t &wait);
+	//! execute a command compiled by compileCommand, it can be executed again without being parsed
+	int executeCommand(const ScriptCommand &compiled, uint64_t &wait);
+	//! parse commandline and resolve its command
+	void compileCommand(const std::string &commandline, ScriptCommand &compiled) const;
 
 	void initInterfaces(std::shared_ptr<ScriptInterface> _scriptInterface, std::shared_ptr<SpaceDate> _spaceDate, std::shared_ptr<SaveScreenInterface> _saveScreenInterface);
 
@@ -141,8 +146,7 @@ protected:
 
 private:
 	FLAG_VALUES convertStrToFlagValues(const std::string &value);
-	int parseCommand(const std::string &command_line, std::string &command, stringHash_t &arguments);
-	int evalCommandSet(const std::string& setName, const std::string& setValue);
+	int evalCommandSet(const std::string& setName, const ScriptArgument& setValue);
 	SCD_NAMES parseCommandSet(const std::string& setName);
 	int executeCommandStatus();
 
@@ -151,6 +155,9 @@ private:
 	double evalDouble(const std::string &var);
 	int evalInt (const std::string &var);
 	std::string evalString (const std::string &var);
+	double evalDouble(const ScriptArgument &argument);
+	int evalInt (const ScriptArgument &argument);
+	std::string evalString (const ScriptArgument &argument);
 
 	// external classes
 	std::shared_ptr<Core> stcore;
@@ -170,7 +177,7 @@ private:
 
 	std::string commandline;
 	std::string command;
-	stringHash_t args;
+	ScriptArgs args;					//!< arguments of the running command, shared with its ScriptCommand
 	int recordable;
 	bool swapCommand;					// boolean which indicates if the instruction must be executed or not
 	bool unskippable = false;			// set to true to force execution of the next command
@@ -44,6 +44,7 @@
 #include "tools/utility.hpp"
 #include "tools/app_settings.hpp"
 #include "tools/log.hpp"
+#include "starModule/zone_array.hpp"
 #include "EntityCore/Core/VulkanMgr.hpp"
 #include "tools/s_texture.hpp"
 #include "mainModule/CPUInfo.hpp"
@@ -114,6 +115,7 @@ static void usage(const char **argv)
 {
 	std::cout << APP_NAME << std::endl;
 	std::cout << _("Usage: %s [OPTION] ...\n -v, --version \tOutput version information and exit.\n -h, --help \tDisplay this help and exit.\n");
+	std::cout << " --convert-stars CATALOGUE COPY \tWrite a native copy of a star catalogue, its stars can be mapped, and exit.\n";
 }
 
 // Check command line arguments
@@ -129,6 +131,12 @@ static void check_command_line(int argc, const char **argv)
 			exit(0);
 		}
 	}
+	if (argc == 4 && !strcmp(argv[1],"--convert-stars")) {
+		const bool converted = BigStarCatalog::ZoneArray::convert(argv[2], argv[3]);
+		if (converted)
+			std::cout << argv[3] << " written" << std::endl;
+		exit(converted ? 0 : 1);
+	}
 	if (argc > 1) {
 		std::cout << APP_NAME << std::endl;
 		std::cout << argv[0] << " don't use command line argument(s)"<< std::endl;
@@ -336,6 +344,11 @@ int main(int argc, const char *argv[])
 	signalObj->Register( SIGTERM, ISignals::NSSigTERM );
 	signalObj->Register( SIGINT, ISignals::NSSigTERM );
 	signalObj->Register( SIGQUIT, ISignals::NSSigTERM );
+	signalObj->Register( SIGSEGV, ISignals::NSSigCrash );
+	signalObj->Register( SIGABRT, ISignals::NSSigCrash );
+	signalObj->Register( SIGFPE, ISignals::NSSigCrash );
+	signalObj->Register( SIGILL, ISignals::NSSigCrash );
+	signalObj->Register( SIGBUS, ISignals::NSSigCrash );
 
 	// SC logical software start here
 	app->firstInit();
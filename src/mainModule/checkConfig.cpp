@@ -72,6 +72,7 @@ void CheckConfig::checkIoSettings()
 	tmpSettings[SCK_MKFIFO_FILE_IN]="/tmp/spacecrafter.fifo";
 	tmpSettings[SCK_MKFIFO_BUFFER_IN_SIZE]="256";
 	tmpSettings[SCK_FLAG_MASTERPUT]="false";
+	tmpSettings[SCK_SHARED_DATA_BUDGET]="4";
 	// ioSettings["mplayer_name"]="/usr/bin/mplayer";
 	// ioSettings["mplayer_mkfifo_name"]="/tmp/mplayer_mkfifo_name.fifo";
 
@@ -128,6 +129,8 @@ void CheckConfig::checkRenderingSettings()
 	tmpSettings[SCK_SELF_SHADOW_RESOLUTION]="4096";
 	tmpSettings[SCK_MAX_SHADOW_CAST]="8";
 	tmpSettings[SCK_EXPERIMENTAL_SHADOWS]="false";
+	tmpSettings[SCK_ATMOSPHERE_RESOLUTION]="48";
+	tmpSettings[SCK_FLAG_ATMOSPHERE_PROGRESSIVE]="false";
 
 	sectionSettings.push_back(SCS_RENDERING);
 	insertKeyFromTmpSettings(SCS_RENDERING);
@@ -157,6 +160,7 @@ void CheckConfig::checkStarSettings()
 	tmpSettings[SCK_STAR_TWINKLE_AMOUNT]="0.4";
 	tmpSettings[SCK_MAX_MAG_STAR_NAME]="1.5";
 	tmpSettings[SCK_FLAG_STAR_TWINKLE]="true";
+	tmpSettings[SCK_FLAG_STAR_PARALLEL_DRAW]="false";
 	tmpSettings[SCK_STAR_LIMITING_MAG]="6.5";
 	tmpSettings[SCK_MAG_CONVERTER_MIN_FOV]="0.1";
 	tmpSettings[SCK_MAG_CONVERTER_MAX_FOV]="60";
@@ -421,6 +425,8 @@ void CheckConfig::checkAstroSettings()
 	tmpSettings[SCK_MAX_MAG_NEBULA_NAME]="99";
 	tmpSettings[SCK_FLAG_OBJECT_TRAILS]="false";
 	tmpSettings[SCK_FLAG_LIGHT_TRAVEL_TIME]="true";
+	tmpSettings[SCK_FLAG_EPHEMERIS_CACHE]="false";
+	tmpSettings[SCK_FLAG_EPHEMERIS_TRUNCATION]="false";
 	tmpSettings[SCK_PLANET_SIZE_MARGINAL_LIMIT]="0";
 	tmpSettings[SCK_STAR_SIZE_LIMIT]="9";
 	tmpSettings[SCK_METEOR_RATE]="10";
@@ -66,6 +66,7 @@
 #define SCK_MKFIFO_BUFFER_IN_SIZE           "mkfifo_buffer_in_size"
 #define SCK_MPLAYER_MKFIFO_NAME             "mplayer_mkfifo_name"
 #define SCK_FLAG_MASTERPUT                  "flag_masterput"
+#define SCK_SHARED_DATA_BUDGET              "shared_data_budget"
 
 #define SCK_AUTOSCREEN                      "autoscreen"
 #define SCK_FULLSCREEN                      "fullscreen"
@@ -97,6 +98,8 @@
 #define SCK_SELF_SHADOW_RESOLUTION          "self_shadow_resolution"
 #define SCK_EXPERIMENTAL_SHADOWS            "experimental_shadows"
 #define SCK_MAX_SHADOW_CAST                 "max_shadow_cast"
+#define SCK_ATMOSPHERE_RESOLUTION           "atmosphere_resolution"
+#define SCK_FLAG_ATMOSPHERE_PROGRESSIVE     "flag_atmosphere_progressive"
 
 #define SCK_SKY_CULTURE                     "sky_culture"
 #define SCK_SKY_LOCALE                      "sky_locale"
@@ -109,6 +112,7 @@
 #define SCK_STAR_TWINKLE_AMOUNT             "star_twinkle_amount"
 #define SCK_MAX_MAG_STAR_NAME               "max_mag_star_name"
 #define SCK_FLAG_STAR_TWINKLE               "flag_star_twinkle"
+#define SCK_FLAG_STAR_PARALLEL_DRAW         "flag_star_parallel_draw"
 #define SCK_STAR_LIMITING_MAG               "star_limiting_mag"
 #define SCK_MAG_CONVERTER_MIN_FOV           "mag_converter_min_fov"
 #define SCK_MAG_CONVERTER_MAX_FOV           "mag_converter_max_fov"
@@ -304,6 +308,8 @@
 #define SCK_MAX_MAG_NEBULA_NAME             "max_mag_nebula_name"
 #define SCK_FLAG_OBJECT_TRAILS              "flag_object_trails"
 #define SCK_FLAG_LIGHT_TRAVEL_TIME          "flag_light_travel_time"
+#define SCK_FLAG_EPHEMERIS_CACHE            "flag_ephemeris_cache"
+#define SCK_FLAG_EPHEMERIS_TRUNCATION       "flag_ephemeris_truncation"
 #define SCK_PLANET_SIZE_MARGINAL_LIMIT      "planet_size_marginal_limit"
 #define SCK_STAR_SIZE_LIMIT                 "star_size_limit"
 #define SCK_METEOR_RATE                     "meteor_rate"
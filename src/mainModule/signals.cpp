@@ -74,6 +74,14 @@ void ISignals::NSSigTERM( int )
 	}
 }
 
+void ISignals::NSSigCrash( int sigid )
+{
+	cLog::emergencyFlush();
+	// with the default handler back, raising the signal again ends the process as usual
+	signal( sigid, SIG_DFL );
+	raise( sigid );
+}
+
 void ISignals::NSSigTSTP( int )
 {
 	struct sigaction restore{};
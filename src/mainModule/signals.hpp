@@ -53,6 +53,7 @@ int sigaction(int, const struct sigaction*, struct sigaction* );
 #define SIGTSTP 0
 #define SIGALRM 0
 #define SIGQUIT 0
+#define SIGBUS 0
 #define ITIMER_REAL 0
 #endif
 
@@ -69,6 +70,8 @@ public:
 	static void NSSigTSTP( int );
 	static void NSSigCONT( int );
 	static void NSSigTERM( int );
+	// Write the pending log messages then let the default handler end the process
+	static void NSSigCrash( int );
 	virtual ~ISignals();
 protected:
 	static App* m_app;
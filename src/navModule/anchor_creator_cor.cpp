@@ -17,6 +17,7 @@
 #include "anchor_point_observatory.hpp"
 #include "anchor_creator_cor.hpp"
 #include "bodyModule/orbit_creator_cor.hpp"
+#include "bodyModule/body_descriptor.hpp"
 #include "bodyModule/ssystem_factory.hpp"
 #include "navModule/anchor_point.hpp"
 #include "navModule/anchor_point_body.hpp"
@@ -127,7 +128,7 @@ std::shared_ptr<AnchorPoint> AnchorPointOrbitCreator::handle(stringHash_t params
 		}
 	}
 
-	Orbit * orbit = orbitCreator->handle(params).get();
+	Orbit * orbit = orbitCreator->handle(BodyDescriptor(params)).get();
 
 	if(orbit == nullptr) {
 		cLog::get()->write("AnchorPointOrbitCreator:: could not create orbit from given paramaters");
@@ -151,6 +151,9 @@ public:
 	const Mat4d& getJ2000ToEyeMat() const {
 		return mat_j2000_to_eye;
 	}
+	Mat4d getJ2000ToLocalMat() const {
+		return mat_earth_equ_to_local*mat_j2000_to_earth_equ;
+	}
 	//! Return fixed dome matrix (no heading adjustment)
 	const Mat4d& getDomeFixedMat() const {
 		return mat_dome_fixed;
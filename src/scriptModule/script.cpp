@@ -26,164 +26,86 @@
 #include <fstream>
 #include <cstddef>
 #include "scriptModule/script.hpp"
+#include "interfaceModule/app_command_interface.hpp"
 #include "tools/log.hpp"
 
 
-Token::Token(const std::string &s, const std::string &p)
+void Token::printToken() const
 {
-	elmt.clear();
-	path.clear();
-	pNext=nullptr;
-	elmt=s;
-	path=p;
+	cLog::get()->write("Token script : " + path + " : " + getToken(),  LOG_TYPE::L_DEBUG, LOG_FILE::SCRIPT);
 }
 
-Token::~Token()
+Script::Script(AppCommandInterface *_commander) : commander(_commander)
 {
-	if (pNext != nullptr) delete pNext;
-}
-
-void Token::printToken()
-{
-	cLog::get()->write("Token script : " + path + " : " + elmt,  LOG_TYPE::L_DEBUG, LOG_FILE::SCRIPT);
-}
-
-Script::Script()
-{
-	//cout << "Script->init()" << endl;
-	pFirst=nullptr;
-	pLast=nullptr;
-	p2First=nullptr;
-	p2Last=nullptr;
 }
 
 Script::~Script()
 {
-	if (pFirst != nullptr) delete pFirst;
 }
 
 void Script::printScript()
 {
-	Token *pMove=pFirst;
 	cLog::get()->write("Printing script: --BEGIN",  LOG_TYPE::L_DEBUG, LOG_FILE::SCRIPT);
-	while (pMove !=nullptr) {
-		cLog::get()->write("   " + pMove->getToken(),  LOG_TYPE::L_DEBUG, LOG_FILE::SCRIPT);
-		pMove=pMove->pNext;
-	}
+	for (const Token &token : tokens)
+		cLog::get()->write("   " + token.getToken(),  LOG_TYPE::L_DEBUG, LOG_FILE::SCRIPT);
 	cLog::get()->write("Printing script: --END",  LOG_TYPE::L_DEBUG, LOG_FILE::SCRIPT);
 }
 
 void Script::clean()
 {
-	if (pFirst != nullptr) delete pFirst;
-	pFirst = nullptr;
-	pLast = nullptr;
-	p2First = nullptr;
-	p2Last = nullptr;
+	tokens.clear();
 }
 
 int Script::load(const std::string &script_file, const std::string &script_path )
-{
-	if (pFirst == nullptr) {
-		//cout << "loading script "<< script_file << " when no script is playing" << endl;
-		return loadInternal(script_file, script_path ,ListPosition::first);
-	} else {
-		//cout << "loading script " << script_file << " when script is playing" << endl;
-		return loadInternal(script_file, script_path ,ListPosition::second);
-	}
-}
-
-int Script::loadInternal(const std::string &script_file,const std::string & script_path , ListPosition wp)
 {
 	//~ printf("s : %s p : %s\n", script_file.c_str() , script_path.c_str() );
-	input_file = new std::ifstream(script_file.c_str());
+	std::ifstream input_file(script_file);
 
-	if (! input_file->is_open()) {
+	if (! input_file.is_open()) {
 		cLog::get()->write("Unable to open script: " + script_file,  LOG_TYPE::L_ERROR, LOG_FILE::SCRIPT);
 		return 0;
 	}
 
-	bool is_script_empty=true;
+	// when a script is playing, the loaded one is played before what remains of it
+	std::deque<Token> loaded;
 	std::string line;
-	Token *token=nullptr;
-	while (! input_file->eof() ) {
-		getline(*input_file,line);
-
+	while (getline(input_file,line)) {
 		if ( line[0] != '#' && line[0] != 0 && line[0] != '\r' && line[0] != '\n') {
 			//cout << "[script.cpp => Line is: " << line << "]"<< endl;
-			token=new Token(line, script_path);
-			is_script_empty=false;
-			if (wp==ListPosition::first)
-				addFirst(token);
-			else
-				addSecond(token);
+			Token &token = loaded.emplace_back(line, script_path);
+			commander->compileCommand(line, token.command);
 		}
 	}
-	input_file->close();
-	if ((! is_script_empty) && (wp==ListPosition::second)) {
-		p2Last->pNext=pFirst;
-		pFirst=p2First;
-		p2Last=nullptr;
-		p2First=nullptr;
-	}
+	if (tokens.empty())
+		tokens = std::move(loaded);
+	else
+		tokens.insert(tokens.begin(), std::make_move_iterator(loaded.begin()), std::make_move_iterator(loaded.end()));
 	//printScript();
 	return 1;
 }
 
-void Script::addFirstInQueue(Token * token){
-	
-	if (pFirst == nullptr) {
-		pFirst=token;
-		pLast=token;
-	}else {
-		
-		Token * temp = pFirst;
-		pFirst = token;
-		token->pNext = temp;
-	}
-}
-
-void Script::addFirst(Token *token)
-{
-	if (pFirst == nullptr) {
-		pFirst=token;
-		pLast=token;
-	} else {
-		pLast->pNext=token;
-		pLast=pLast->pNext;
-	}
-}
-
-void Script::addSecond(Token *token)
+void Script::addFirstInQueue(const std::string &line, const std::string &path)
 {
-	if (p2First == nullptr) {
-		p2First=token;
-		p2Last=token;
-	} else {
-		p2Last->pNext=token;
-		p2Last=p2Last->pNext;
-	}
+	Token &token = tokens.emplace_front(line, path);
+	commander->compileCommand(line, token.command);
 }
 
-int Script::getFirst(std::string &command, std::string &dataDir)
+int Script::getFirst(ScriptCommand &command, std::string &dataDir)
 {
-	Token *pMove;
-	if (pFirst == nullptr) {
+	if (tokens.empty()) {
 		cLog::get()->write("End of script",  LOG_TYPE::L_INFO, LOG_FILE::SCRIPT);
-		command="script action end";
+		commander->compileCommand("script action end", command);
 		dataDir="";
 		return 0;
 	} else {
-		pMove=pFirst;
-		dataDir=pFirst->getTokenPath();
-		command=pFirst->getToken();
-		if (command=="script action end" && (pFirst->pNext != nullptr)) {
+		Token &first = tokens.front();
+		dataDir=std::move(first.path);
+		command=std::move(first.command);
+		if (command.commandline=="script action end" && tokens.size() > 1) {
 			cLog::get()->write("End of script  detected but not at end of the execution stack", LOG_TYPE::L_WARNING, LOG_FILE::SCRIPT);
 		}
 		//cout << " script.cpp : " << command << endl;
-		pFirst=pFirst->pNext;
-		pMove->pNext=nullptr;
-		delete pMove;
+		tokens.pop_front();
 		return 1;
 	}
 }
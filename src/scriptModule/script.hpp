@@ -29,35 +29,38 @@
 #ifndef _SCRIPT_H_
 #define _SCRIPT_H_
 
-#include <vector>
+#include <deque>
 #include <string>
+#include "scriptModule/script_command.hpp"
+
+class AppCommandInterface;
 
 //management of the lines of code of a script
 class Token {
 public:
 	//s: ligne of script_file p: path of script_file
-	Token(const std::string &s, const std::string &p);
-	~Token();
-	void printToken();
-	Token * pNext= nullptr;
+	Token(const std::string &s, const std::string &p) : path(p) {
+		command.commandline = s;
+	}
+	void printToken() const;
 
-	std::string getToken() const {
-		return elmt;
+	const std::string &getToken() const {
+		return command.commandline;
 	}
 
-	std::string getTokenPath() const {
+	const std::string &getTokenPath() const {
 		return path;
 	}
 
-private:
-	std::string elmt;
+	ScriptCommand command; //!< filled by AppCommandInterface::compileCommand when the script is loaded
 	std::string path;
 };
 
 //complete management of scripts
 class Script {
 public:
-	Script();
+	//! commander compiles the lines of the scripts when they are loaded
+	Script(AppCommandInterface *commander);
 	~Script();
 
 	//! displays the script content
@@ -69,37 +72,16 @@ public:
 	//! empties the stack of script instructions in memory
 	void clean();
 
-	//!returns an item from the list with its path
-	int getFirst(std::string &command, std::string &dataDir);
+	//! returns the first compiled command of the queue with its path and removes it from the queue
+	int getFirst(ScriptCommand &command, std::string &dataDir);
 
-	//! adds the given Token in first position in the command queue
-	void addFirstInQueue(Token * token);
+	//! adds the given line in first position in the command queue
+	void addFirstInQueue(const std::string &line, const std::string &path);
 
 private:
-
-	typedef enum {
-		first,
-		second
-	} ListPosition;
-
-	Token *pFirst=nullptr;
-	Token *pLast=nullptr;
-	Token *p2First=nullptr;
-	Token *p2Last=nullptr;
-	int loadInternal(const std::string &script_file , const std::string &script_path , ListPosition wp);
-
-	/* 
-	 * adds the given Token in the queue named pFirst
-	 * /!\ the value is inserted at the end of the queue
-	 * if you want to insert at the begining of the queue use addFirst_in_queue
-	 */
-	void addFirst(Token *token);
-	
-	//! adds the given Token int the queue named pSecond
-	void addSecond(Token *token);
-
-	std::ifstream *input_file=nullptr;
-	std::string the_path;
+	//! the commands to execute in order, a script loaded while playing goes in front of the remaining one
+	std::deque<Token> tokens;
+	AppCommandInterface *commander;
 };
 
 #endif
@@ -0,0 +1,129 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2014 Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include <sstream>
+#include <algorithm>
+#include "scriptModule/script_command.hpp"
+#ifdef PARSE_DEBUG
+#include "tools/log.hpp"
+#endif
+
+// a missing argument
+static const ScriptArgument noArgument{"", "", 0., SC_ARGUMENT::NUMBER};
+static const std::vector<ScriptArgument> noArguments;
+
+const ScriptArgument &ScriptArgs::get(const std::string &key) const
+{
+	const auto it = std::lower_bound(begin(), end(), key, [](const ScriptArgument &argument, const std::string &k) {
+		return argument.key < k;
+	});
+	return (it != end() && it->key == key) ? *it : noArgument;
+}
+
+ScriptArgs::const_iterator ScriptArgs::begin() const
+{
+	return list ? list->begin() : noArguments.begin();
+}
+
+ScriptArgs::const_iterator ScriptArgs::end() const
+{
+	return list ? list->end() : noArguments.end();
+}
+
+stringHash_t ScriptArgs::toHash() const
+{
+	stringHash_t hash;
+	for (const ScriptArgument &argument : *this)
+		hash.emplace_hint(hash.end(), argument.key, argument.value);
+	return hash;
+}
+
+void ScriptArgs::assign(std::vector<ScriptArgument> &&arguments)
+{
+	std::stable_sort(arguments.begin(), arguments.end(), [](const ScriptArgument &a, const ScriptArgument &b) {
+		return a.key < b.key;
+	});
+	// keep the last of the same keys, as the map did
+	auto last = std::unique(arguments.rbegin(), arguments.rend(), [](const ScriptArgument &a, const ScriptArgument &b) {
+		return a.key == b.key;
+	});
+	arguments.erase(arguments.begin(), last.base());
+	list = std::make_shared<const std::vector<ScriptArgument>>(std::move(arguments));
+}
+
+void ScriptCommand::parse(const std::string &line, const std::function<void(ScriptArgument &)> &resolve)
+{
+	commandline = line;
+	command.clear();
+	code = SC_COMMAND::SC_UNKNOWN;
+	std::vector<ScriptArgument> arguments;
+
+	// transformation of the beginning of character strings by deleting spaces and tabs at the beginning of the string
+	std::string str = line.substr(std::min(line.find_first_not_of(" \t"), line.size()));
+
+	// transformation of user strings of the form "text" to "text
+	std::size_t found = str.find(" \" ");
+	while(found!=std::string::npos) {
+		str.erase(found+2,1);
+		found = str.find(" \" ");
+	}
+
+	std::istringstream commandstr( str );
+	std::string key, value;
+	char nextc;
+
+	commandstr >> command;
+	transform(command.begin(), command.end(), command.begin(), ::tolower);
+
+	while (commandstr >> key >> value ) {
+		if (value[0] == '"') {
+			// pull in all text inside quotes
+			if (value[value.length()-1] == '"') {
+				// one word in quotes
+				value = value.substr(1, value.length() -2 );
+			} else {
+				// multiple words in quotes
+				value = value.substr(1, value.length() -1 );
+
+				while (1) {
+					nextc = commandstr.get();
+					if ( nextc == '"' || !commandstr.good()) break;
+					value.push_back( nextc );
+				}
+			}
+		}
+		transform(key.begin(), key.end(), key.begin(), ::tolower);
+		arguments.push_back({key, value});
+		if (resolve)
+			resolve(arguments.back());
+	}
+	args.assign(std::move(arguments));
+
+	#ifdef PARSE_DEBUG
+	cLog::get()->write("Command: " + command + "Argument hash:", LOG_TYPE::L_DEBUG);
+	for (const ScriptArgument &argument : args) {
+		cLog::get()->write("\t" + argument.key + " : " + argument.value, LOG_TYPE::L_DEBUG);
+	}
+	#endif
+}
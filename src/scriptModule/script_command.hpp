@@ -0,0 +1,95 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2014 Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+/* A command line parsed once, executed as many times as needed
+ *
+ */
+
+#ifndef _SCRIPT_COMMAND_H_
+#define _SCRIPT_COMMAND_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include "tools/utility.hpp"
+#include "interfaceModule/base_command_interface.hpp"
+
+//! how the value of an argument is evaluated, decided when the command is compiled
+enum class SC_ARGUMENT : char {
+	TEXT,		//!< not compiled, evaluated from its text at execution
+	NUMBER,		//!< numeric literal
+	RESERVED,	//!< reserved variable of AppCommandEval
+	VARIABLE	//!< user variable, evaluated as its text while it is not defined
+};
+
+//! argument of a command, typed once by AppCommandEval::resolve
+struct ScriptArgument {
+	std::string key;		//!< name in lower case
+	std::string value;		//!< value as written
+	double number = 0.;		//!< value read as a number
+	SC_ARGUMENT kind = SC_ARGUMENT::TEXT;
+	int index = -1;			//!< SC_RESERVED_VAR of a RESERVED value, variable slot of a VARIABLE value
+};
+
+//! arguments of a command sorted by name, the copies share them without copying
+class ScriptArgs {
+public:
+	typedef std::vector<ScriptArgument>::const_iterator const_iterator;
+
+	//! value of the argument as written, empty if it is missing
+	const std::string &operator[](const std::string &key) const {
+		return get(key).value;
+	}
+	//! typed argument, a missing one reads as an empty value of 0
+	const ScriptArgument &get(const std::string &key) const;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+	bool empty() const {
+		return begin() == end();
+	}
+
+	//! copy of the arguments for the functions taking a stringHash_t
+	stringHash_t toHash() const;
+
+	//! replace the arguments, the later key wins if a key is repeated
+	void assign(std::vector<ScriptArgument> &&list);
+private:
+	std::shared_ptr<const std::vector<ScriptArgument>> list;
+};
+
+//! command line split into its command and typed arguments
+//! AppCommandInterface::compileCommand resolves the code and the variables named by the arguments
+struct ScriptCommand {
+	//! fill commandline, command and args from the line, resolve types each argument
+	void parse(const std::string &line, const std::function<void(ScriptArgument &)> &resolve = nullptr);
+
+	std::string commandline;	//!< the line as written in the script
+	std::string command;		//!< command name in lower case
+	ScriptArgs args;			//!< arguments with their name in lower case
+	SC_COMMAND code = SC_COMMAND::SC_UNKNOWN;
+};
+
+#endif
@@ -48,7 +48,7 @@ ScriptMgr::ScriptMgr(std::shared_ptr<AppCommandInterface> command_interface,cons
 	sR.recording = false;
 	sR.record_elapsed_time = 0;
 	media = _media;
-	script= new Script();
+	script= new Script(commander);
 }
 
 ScriptMgr::~ScriptMgr()
@@ -77,8 +77,7 @@ bool ScriptMgr::playScript(const std::string &fullFileName)
  */
 bool ScriptMgr::addScriptFirst(const std::string & script)
 {
-	std::vector <Token*> commands;
-	Token *token=nullptr;
+	std::vector<std::string> commands;
 	std::istringstream iss(script);
 	std::string line;
 
@@ -91,13 +90,13 @@ bool ScriptMgr::addScriptFirst(const std::string & script)
 		}
 		// consideration of lines
 		if ( line[0] != '#' && line[0] != 0 && line[0] != '\r' && line[0] != '\n') {
-			token = new Token(line, getScriptPath());
-			commands.push_back(token);
+			commands.push_back(line);
 		}
 	}
 	//add the tokens to the queue in reverse order (since we add to the begining of the queue
+	const std::string path = getScriptPath();
 	for (auto it = commands.rbegin(); it != commands.rend(); it++){
-		this->script->addFirstInQueue(*it);
+		this->script->addFirstInQueue(*it, path);
 	}
 	return true;
 }
@@ -283,8 +282,6 @@ void ScriptMgr::update(int delta_time)
 		}
 
 		while (wait_time==0) {
-			std::string comd;
-
 			uint64_t wait=0;
 
 			if (repeatLoop) {
@@ -304,12 +301,12 @@ void ScriptMgr::update(int delta_time)
 						indiceInLoop = 0;
 					}
 				}
-			} else if ( (script->getFirst(comd,DataDir)) == 1 ) {
+			} else if ( (script->getFirst(current,DataDir)) == 1 ) {
 
 				if (isInLoop) {//we are in a loop and we have to copy the loop in a list.
-					loopVector.push_back(comd);
+					loopVector.push_back(current);
 				}
-				commander->executeCommand(comd, wait);
+				commander->executeCommand(current, wait);
 				wait_time += wait;
 			} else {
 				// script done
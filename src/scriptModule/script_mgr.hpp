@@ -37,6 +37,7 @@
 #include <vector>
 #include <memory>
 #include "tools/no_copy.hpp"
+#include "scriptModule/script_command.hpp"
 
 class AppCommandInterface;
 class Media;
@@ -177,6 +178,7 @@ private:
 	std::shared_ptr<Media> media;
 	AppCommandInterface *commander;  //!< for executing script commands
 	Script * script = nullptr; //!< currently loaded script
+	ScriptCommand current;	//!< command taken from the script
 	int64_t wait_time=0;     //!< ms until next script command should be executed
 	bool waitOnVideo=false; 			//!< if Video launch, say if script should wait on it.
 	bool isVideoPlayed = false;		 	//!< say if a video is played
@@ -185,7 +187,7 @@ private:
 	bool isInLoop=false; 		//!< we are reading the instructions of a loop
 	bool repeatLoop=false; 	//!< we are repeating a loop
 	int nbrLoop=0;		//!< number of remaining loops
-	std::vector<std::string> loopVector; //!< the vector that contains the loop instructions to be repeated
+	std::vector<ScriptCommand> loopVector; //!< the vector that contains the compiled loop instructions to be repeated
 	unsigned int indiceInLoop=0; //!< indicates the place where we are in the loop
 	bool flagSkipPause; //!< skip pause in script
 };
@@ -60,6 +60,7 @@ const std::string REP_SCREENSHOT = "screenshot";
 const std::string REP_FONT = "fonts";
 const std::string REP_AUDIO = "audio";
 const std::string REP_LOG = "log";
+const std::string REP_CACHE = "cache";
 const std::string REP_FTP = "ftp";
 const std::string REP_VFRAME = "vframes";
 const std::string REP_PICTURE = "pictures";
@@ -36,6 +36,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <cstdlib>
 #include <cassert>
 #include <iostream>
+#include <algorithm>
 #include "starModule/geodesic_grid.hpp"
 
 static const double icosahedron_G = 0.5*(1.0+sqrt(5.0));
@@ -85,7 +86,7 @@ static const TopLevelTriangle icosahedron_triangles[20] = {
 	{{ 8, 9, 5}}  //  8
 };
 
-GeodesicGrid::GeodesicGrid(const int lev) : max_level(lev<0?0:lev), lastMaxSearchlevel(-1)
+GeodesicGrid::GeodesicGrid(const int lev) : max_level(lev<0?0:lev)
 {
 	if (max_level > 0) {
 		triangles = new Triangle*[max_level+1];
@@ -104,7 +105,6 @@ GeodesicGrid::GeodesicGrid(const int lev) : max_level(lev<0?0:lev), lastMaxSearc
 	} else {
 		triangles = 0;
 	}
-	cacheSearchResult = new GeodesicSearchResult(*this);
 }
 
 GeodesicGrid::~GeodesicGrid(void)
@@ -113,8 +113,6 @@ GeodesicGrid::~GeodesicGrid(void)
 		for (int i=max_level-1; i>=0; i--) delete[] triangles[i];
 		delete[] triangles;
 	}
-	delete cacheSearchResult;
-	cacheSearchResult = nullptr;
 }
 
 void GeodesicGrid::getTriangleCorners(int lev,int index,
@@ -288,7 +286,8 @@ int GeodesicGrid::searchZone(const Vec3d &v,int search_level) const
 
 void GeodesicGrid::searchZones(const StelGeom::ConvexS& convex,
                                int **inside_list,int **border_list,
-                               int max_search_level) const
+                               int max_search_level,
+                               bool allow_inside) const
 {
 	if (max_search_level < 0) max_search_level = 0;
 	else if (max_search_level > max_level) max_search_level = max_level;
@@ -318,7 +317,7 @@ void GeodesicGrid::searchZones(const StelGeom::ConvexS& convex,
 		            corner_inside[icosahedron_triangles[i].corners[0]],
 		            corner_inside[icosahedron_triangles[i].corners[1]],
 		            corner_inside[icosahedron_triangles[i].corners[2]],
-		            inside_list,border_list,max_search_level);
+		            inside_list,border_list,max_search_level,allow_inside);
 	}
 	#if defined __STRICT_ANSI__ || !defined __GNUC__
 	delete[] halfs_used;
@@ -334,7 +333,8 @@ void GeodesicGrid::searchZones(int lev,int index,
                                const bool *corner1_inside,
                                const bool *corner2_inside,
                                int **inside_list,int **border_list,
-                               const int max_search_level) const
+                               const int max_search_level,
+                               const bool allow_inside) const
 {
 	#if defined __STRICT_ANSI__ || !defined __GNUC__
 	int *halfs_used = new int[half_spaces_used];
@@ -354,7 +354,7 @@ void GeodesicGrid::searchZones(int lev,int index,
 			halfs_used[halfs_used_count++] = i;
 		}
 	}
-	if (halfs_used_count == 0) {
+	if (halfs_used_count == 0 && allow_inside) {
 		// this triangle(lev,index) lies inside all halfspaces
 		**inside_list = index;
 		(*inside_list)++;
@@ -386,19 +386,19 @@ void GeodesicGrid::searchZones(int lev,int index,
 			searchZones(lev,index+0,
 			            convex,halfs_used,halfs_used_count,
 			            corner0_inside,edge2_inside,edge1_inside,
-			            inside_list,border_list,max_search_level);
+			            inside_list,border_list,max_search_level,allow_inside);
 			searchZones(lev,index+1,
 			            convex,halfs_used,halfs_used_count,
 			            edge2_inside,corner1_inside,edge0_inside,
-			            inside_list,border_list,max_search_level);
+			            inside_list,border_list,max_search_level,allow_inside);
 			searchZones(lev,index+2,
 			            convex,halfs_used,halfs_used_count,
 			            edge1_inside,edge0_inside,corner2_inside,
-			            inside_list,border_list,max_search_level);
+			            inside_list,border_list,max_search_level,allow_inside);
 			searchZones(lev,index+3,
 			            convex,halfs_used,halfs_used_count,
 			            edge0_inside,edge1_inside,edge2_inside,
-			            inside_list,border_list,max_search_level);
+			            inside_list,border_list,max_search_level,allow_inside);
 			#if defined __STRICT_ANSI__ || !defined __GNUC__
 			delete[] edge0_inside;
 			delete[] edge1_inside;
@@ -414,24 +414,88 @@ void GeodesicGrid::searchZones(int lev,int index,
 /*************************************************************************
  Return a search result matching the given spatial region
 *************************************************************************/
-const GeodesicSearchResult* GeodesicGrid::search(const StelGeom::ConvexS& convex, int maxSearchLevel) const
+std::shared_ptr<const GeodesicSearchResult> GeodesicGrid::search(const StelGeom::ConvexS& convex, int maxSearchLevel) const
 {
-	// Try to use the cached version
-	if (maxSearchLevel==lastMaxSearchlevel && convex==lastSearchRegion) {
-		return cacheSearchResult;
+	std::lock_guard<std::mutex> lock(searchMutex);
+	searchClock++;
+
+	// Try to use a cached version
+	CachedSearch *oldest = &searchCache[0];
+	for (CachedSearch &cached : searchCache) {
+		if (cached.result && cached.maxSearchLevel==maxSearchLevel &&
+		        (convex==cached.region || (searchMargin > 0 && covers(cached.covered, convex)))) {
+			cached.lastUse = searchClock;
+			searchHits++;
+			return cached.result;
+		}
+		if (cached.lastUse < oldest->lastUse)
+			oldest = &cached;
+	}
+
+	// Else recompute the least recently used one
+	searchMisses++;
+	// a result still held by a caller is left to it, the references are only taken under searchMutex
+	if (!oldest->result || oldest->result.use_count() > 1)
+		oldest->result = std::make_shared<GeodesicSearchResult>(*this);
+	oldest->region = convex;
+	oldest->covered = enlarge(convex, maxSearchLevel);
+	oldest->maxSearchLevel = maxSearchLevel;
+	oldest->lastUse = searchClock;
+	// the zones inside the enlarged region may be partly outside the region, the stars are then checked
+	oldest->result->search(oldest->covered, maxSearchLevel, searchMargin <= 0);
+	return oldest->result;
+}
+
+void GeodesicGrid::setSearchMargin(double zones)
+{
+	std::lock_guard<std::mutex> lock(searchMutex);
+	searchMargin = zones;
+	// the results were searched with the previous margin
+	for (CachedSearch &cached : searchCache)
+		cached.maxSearchLevel = -1;
+}
+
+// The HalfSpace (n,d) is the cap of axis n/|n| and of radius acos(d/|n|),
+// the margin increases the radius of each cap.
+// The search keeps a zone unless its corners all lie outside one HalfSpace, so the zones
+// found for the enlarged region include those found for any region that it covers.
+StelGeom::ConvexS GeodesicGrid::enlarge(const StelGeom::ConvexS& region, int maxSearchLevel) const
+{
+	if (searchMargin <= 0)
+		return region;
+	// the icosahedron edges are 63.4 degrees long, each level halves them
+	const double margin = searchMargin * 1.1071487177940904 / (1 << std::max(maxSearchLevel, 0));
+	StelGeom::ConvexS rval(region);
+	for (StelGeom::HalfSpace &half_space : rval) {
+		const double length = half_space.n.length();
+		const double radius = std::acos(std::clamp(half_space.d/length, -1.0, 1.0)) + margin;
+		half_space.n /= length;
+		half_space.d = (radius < M_PI) ? std::cos(radius) : -2.0;
+	}
+	return rval;
+}
+
+// A cap of axis a and radius r lies in the cap of axis b and radius R if angle(a,b) + r <= R
+bool GeodesicGrid::covers(const StelGeom::ConvexS& covered, const StelGeom::ConvexS& region)
+{
+	if (covered.size() != region.size())
+		return false;
+	for (size_t i=0; i<region.size(); i++) {
+		const double length = region[i].n.length();
+		const double coveredLength = covered[i].n.length();
+		const double radius = std::acos(std::clamp(region[i].d/length, -1.0, 1.0));
+		const double angle = std::acos(std::clamp(region[i].n*covered[i].n/(length*coveredLength), -1.0, 1.0));
+		if (angle + radius > std::acos(std::clamp(covered[i].d/coveredLength, -1.0, 1.0)))
+			return false;
 	}
-	// Else recompute it and update cache parameters
-	lastMaxSearchlevel = maxSearchLevel;
-	lastSearchRegion = convex;
-	cacheSearchResult->search(convex, maxSearchLevel);
-	return cacheSearchResult;
+	return true;
 }
 
 
 /*************************************************************************
  Return a search result matching the given spatial region
 *************************************************************************/
-const GeodesicSearchResult* GeodesicGrid::search(const Vec3d &e0,const Vec3d &e1,const Vec3d &e2,const Vec3d &e3,int max_search_level) const
+std::shared_ptr<const GeodesicSearchResult> GeodesicGrid::search(const Vec3d &e0,const Vec3d &e1,const Vec3d &e2,const Vec3d &e3,int max_search_level) const
 {
 	StelGeom::ConvexS c(e0, e1, e2, e3);
 	return search(c,max_search_level);
@@ -460,13 +524,14 @@ GeodesicSearchResult::~GeodesicSearchResult(void)
 }
 
 void GeodesicSearchResult::search(const StelGeom::ConvexS& convex,
-                                  int max_search_level)
+                                  int max_search_level,
+                                  bool allow_inside)
 {
 	for (int i=grid.getMaxLevel(); i>=0; i--) {
 		inside[i] = zones[i];
 		border[i] = zones[i]+GeodesicGrid::nrOfZones(i);
 	}
-	grid.searchZones(convex,inside,border,max_search_level);
+	grid.searchZones(convex,inside,border,max_search_level,allow_inside);
 }
 
 void GeodesicSearchInsideIterator::reset(void)
@@ -35,8 +35,17 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef _GEODESIC_GRID_H_
 #define _GEODESIC_GRID_H_
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include "starModule/sphere_geometry.hpp"
 
+// number of search results kept by GeodesicGrid::search
+#define GEODESIC_SEARCH_CACHE_SIZE 4
+// default margin of the searched regions, in zones of the search level
+// 0 keeps the inside zones, a search with a margin has only border zones and is slower to miss
+#define GEODESIC_SEARCH_MARGIN 0.0
+
 class GeodesicSearchResult;
 
 class GeodesicGrid {
@@ -98,20 +107,56 @@ public:
 	//! in inside[l1] for some l1 < l.
 	//! In order to restrict search depth set max_search_level < max_level,
 	//! for full search depth set max_search_level = max_level,
+	//! With allow_inside false, the zones are all returned as border zones of max_search_level or
+	//! of a lower level, as the result is also used for regions smaller than convex.
 	void searchZones(const StelGeom::ConvexS& convex,
-	                 int **inside,int **border,int max_search_level) const;
+	                 int **inside,int **border,int max_search_level,
+	                 bool allow_inside = true) const;
 
 	//! Return a search result matching the given spatial region
-	//! The result is cached, meaning that it is very fast to search the same region consecutively
+	//! The last GEODESIC_SEARCH_CACHE_SIZE results are cached, meaning that it is very fast to search
+	//! again a region which was recently searched or which is covered by the margin of a recent search.
+	//! A result searched with a margin has no inside zone, its zones may be partly outside the region.
+	//! The result stays valid as long as it is held, even if the cache reuses its slot meanwhile.
 	//! @return a GeodesicSearchResult instance which must be used with GeodesicSearchBorderIterator and GeodesicSearchInsideIterator
-	const GeodesicSearchResult* search(const StelGeom::ConvexS& convex, int max_search_level) const;
+	std::shared_ptr<const GeodesicSearchResult> search(const StelGeom::ConvexS& convex, int max_search_level) const;
 
 	//! Convenience function returning a search result matching the given spatial region
 	//! The result is cached, meaning that it is very fast to search the same region consecutively
 	//! @return a GeodesicSearchResult instance which must be used with GeodesicSearchBorderIterator and GeodesicSearchInsideIterator
-	const GeodesicSearchResult* search(const Vec3d &e0,const Vec3d &e1,const Vec3d &e2,const Vec3d &e3,int max_search_level) const;
+	std::shared_ptr<const GeodesicSearchResult> search(const Vec3d &e0,const Vec3d &e1,const Vec3d &e2,const Vec3d &e3,int max_search_level) const;
+
+	//! Set the margin added around the searched regions, in zones of the search level.
+	//! A later search of a region inside the margin, for example after a small move of the view,
+	//! reuses the result. With 0 only the same region reuses a result, and the zones lying fully
+	//! in the region are returned as inside zones.
+	void setSearchMargin(double zones);
+
+	//! Return the number of search() answered from the cache
+	unsigned long getSearchHits() const {
+		return searchHits.load(std::memory_order_relaxed);
+	}
+
+	//! Return the number of search() which needed a new search of the zones
+	unsigned long getSearchMisses() const {
+		return searchMisses.load(std::memory_order_relaxed);
+	}
 
 private:
+	//! A search result and the region it was searched for
+	struct CachedSearch {
+		StelGeom::ConvexS region;	// region given to search()
+		StelGeom::ConvexS covered;	// region with the margin, actually searched
+		int maxSearchLevel = -1;
+		unsigned long lastUse = 0;
+		std::shared_ptr<GeodesicSearchResult> result;
+	};
+
+	//! Return the region enlarged by the margin, the HalfSpace directions are normalized
+	StelGeom::ConvexS enlarge(const StelGeom::ConvexS& region, int max_search_level) const;
+	//! Return true if region lies inside covered, both must have the same number of HalfSpaces
+	static bool covers(const StelGeom::ConvexS& covered, const StelGeom::ConvexS& region);
+
 	const Vec3d& getTriangleCorner(int lev, int index, int cornerNumber) const;
 	void initTriangle(int lev,int index,
 	                  const Vec3d &c0,
@@ -131,7 +176,8 @@ private:
 	                 const bool *corner0_inside,
 	                 const bool *corner1_inside,
 	                 const bool *corner2_inside,
-	                 int **inside,int **border,int max_search_level) const;
+	                 int **inside,int **border,int max_search_level,
+	                 bool allow_inside) const;
 
 	const int max_level;
 	struct Triangle {
@@ -141,10 +187,13 @@ private:
 	// 20*(4^0+4^1+...+4^n)=20*(4*(4^n)-1)/3 triangles total
 	// 2+10*4^n corners
 
-	//! A cached search result used to avoid doing twice the same search
-	mutable GeodesicSearchResult* cacheSearchResult;
-	mutable int lastMaxSearchlevel;
-	mutable StelGeom::ConvexS lastSearchRegion;
+	//! The cached search results used to avoid doing twice the same search, least recently used first replaced
+	mutable CachedSearch searchCache[GEODESIC_SEARCH_CACHE_SIZE];
+	mutable std::mutex searchMutex;
+	mutable unsigned long searchClock = 0;
+	mutable std::atomic<unsigned long> searchHits{0};	// read without searchMutex
+	mutable std::atomic<unsigned long> searchMisses{0};
+	double searchMargin = GEODESIC_SEARCH_MARGIN;
 };
 
 class GeodesicSearchResult {
@@ -157,7 +206,7 @@ private:
 	friend class GeodesicSearchBorderIterator;
 	friend class GeodesicGrid;
 
-	void search(const StelGeom::ConvexS& convex, int max_search_level);
+	void search(const StelGeom::ConvexS& convex, int max_search_level, bool allow_inside);
 
 	const GeodesicGrid &grid;
 	int **const zones;
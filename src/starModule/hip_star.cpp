@@ -27,18 +27,18 @@
 namespace BigStarCatalog {
 
 
-std::string Star1::getNameI18n(void) const
+const std::string &Star1::getNameI18n(void) const
 {
 	if (getHip()) {
-		const std::string commonNameI18 = HipStarMgr::getCommonName(getHip());
+		const std::string &commonNameI18 = HipStarMgr::getCommonName(getHip());
 		if (!commonNameI18.empty()) return commonNameI18;
 		if (HipStarMgr::getFlagSciNames()) {
-			const std::string sciName = HipStarMgr::getSciName(getHip());
+			const std::string &sciName = HipStarMgr::getSciName(getHip());
 			if (!sciName.empty()) return sciName;
-			return "HP " + std::to_string(getHip());
+			return HipStarMgr::getHipName(getHip());
 		}
 	}
-	return "";
+	return HipStarMgr::noName;
 }
 
 
@@ -116,10 +116,15 @@ public:
 		pos.normalize();
 		return pos;
 	}
+	//! Coordinates along axis0 and axis1 of the zone, as used by getJ2000Pos
+	void getZonePos(double movement_factor, double &c0, double &c1) const {
+		c0 = (float)(getX0())+movement_factor*getDx0();
+		c1 = (float)(getX1())+movement_factor*getDx1();
+	}
 	float getBV(void) const {
 		return IndexToBV(getBVIndex());
 	}
-	std::string getNameI18n(void) const;
+	const std::string &getNameI18n(void) const;
 	void print(void);
 };
 
@@ -178,11 +183,17 @@ public :
 		pos.normalize();
 		return pos;
 	}
+	//! Coordinates along axis0 and axis1 of the zone, as used by getJ2000Pos
+	void getZonePos(double movement_factor, double &c0, double &c1) const {
+		c0 = (double)(getX0())+movement_factor*getDx0();
+		c1 = (double)(getX1())+movement_factor*getDx1();
+	}
 	float getBV(void) const {
 		return IndexToBV(getBVIndex());
 	}
-	std::string getNameI18n(void) const {
-		return "";
+	const std::string &getNameI18n(void) const {
+		static const std::string noName;
+		return noName;
 	}
 	void print(void);
 };
@@ -228,11 +239,17 @@ public:
 		pos.normalize();
 		return pos;
 	}
+	//! Coordinates along axis0 and axis1 of the zone, as used by getJ2000Pos
+	void getZonePos(double, double &c0, double &c1) const {
+		c0 = getX0();
+		c1 = getX1();
+	}
 	float getBV(void) const {
 		return IndexToBV(getBVIndex());
 	}
-	std::string getNameI18n(void) const {
-		return "";
+	const std::string &getNameI18n(void) const {
+		static const std::string noName;
+		return noName;
 	}
 	void print(void);
 };
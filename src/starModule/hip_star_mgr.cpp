@@ -30,6 +30,7 @@
 #include <math.h>
 
 #include <iostream>
+#include <chrono>
 
 #include "coreModule/projector.hpp"
 #include "coreModule/time_mgr.hpp"
@@ -49,6 +50,7 @@
 #include "atmosphereModule/tone_reproductor.hpp"
 #include "tools/translator.hpp"
 #include "tools/utility.hpp"
+#include "tools/ThreadPool.hpp"
 #include "coreModule/ubo_cam.hpp"
 #include "EntityCore/EntityCore.hpp"
 #include "EntityCore/Core/RenderMgr.hpp"
@@ -60,6 +62,8 @@ static BigStarCatalog::StringArray spectral_array;
 static BigStarCatalog::StringArray component_array;
 
 bool HipStarMgr::flagSciNames = true;
+const std::string HipStarMgr::noName;
+std::vector<std::string> HipStarMgr::hip_names;
 double HipStarMgr::current_JDay = 2451545.0;  // Default to J2000 so that constellation art shows up in correct positions at init
 std::map<int,std::string> HipStarMgr::common_names_map;
 std::map<int,std::string> HipStarMgr::common_names_map_i18n;
@@ -175,6 +179,7 @@ static void InitColorTableFromConfigFile(const InitParser &conf)
 
 
 HipStarMgr::HipStarMgr(int width,int height) :
+	selected_hip(NR_OF_HIP+1, false),
 	starTexture(),
 	hip_index(new BigStarCatalog::HipIndexStruct[NR_OF_HIP+1]),
 	mag_converter(new MagConverter(*this)),
@@ -358,6 +363,9 @@ void HipStarMgr::createShaderParams(int width,int height)
 
 HipStarMgr::~HipStarMgr(void)
 {
+	// a level being read is finished, the pending ones are skipped
+	stopLoading = true;
+	loadTasks.reset();
 	ZoneArrayMap::iterator it(zone_arrays.end());
 	while (it!=zone_arrays.begin()) {
 		--it;
@@ -395,24 +403,40 @@ HipStarMgr::~HipStarMgr(void)
 	// glDeleteVertexArrays(1,&drawFBO.vao);
 // }
 
-std::string HipStarMgr::getCommonName(int hip)
+const std::string &HipStarMgr::getCommonName(int hip)
 {
 	std::map<int,std::string>::const_iterator it(common_names_map_i18n.find(hip));
 	if (it!=common_names_map_i18n.end()) return it->second;
-	return "";
+	return noName;
 }
 
-std::string HipStarMgr::getSciName(int hip)
+const std::string &HipStarMgr::getSciName(int hip)
 {
 	std::map<int,std::string>::const_iterator it(sci_names_map_i18n.find(hip));
 	if (it!=sci_names_map_i18n.end()) return it->second;
-	return "";
+	return noName;
+}
+
+const std::string &HipStarMgr::getHipName(int hip)
+{
+	if (hip >= 0 && hip < (int) hip_names.size()) return hip_names[hip];
+	return noName;
 }
 
 void HipStarMgr::init(const InitParser &conf)
+{
+	loadCatalogs(conf);
+	loadTexture();
+}
+
+void HipStarMgr::loadCatalogs(const InitParser &conf)
 {
 	load_data(conf);
 	InitColorTableFromConfigFile(conf);
+}
+
+void HipStarMgr::loadTexture()
+{
 	// Load star texture no mipmap:
 	starTexture = new s_texture("star16x16.png",TEX_LOAD_TYPE_PNG_SOLID,false);  // Load star texture no mipmap
 	m_setStars->bindTexture(starTexture->getTexture(), 0);
@@ -441,28 +465,46 @@ void HipStarMgr::load_data(const InitParser &baseConf)
 	assert(max_geodesic_grid_level < 0);
 
 	cLog::get()->write( "Loading star data..." , LOG_TYPE::L_INFO);
+	const auto start = std::chrono::steady_clock::now();
 
 	InitParser conf;
 	conf.load(AppSettings::Instance()->getConfigDir() + "stars.ini");
+	const int deferred_level = conf.getInt("stars", "lazy_level", HIP_STAR_LAZY_LEVEL);
 
+	std::vector<std::string> cat_file_names;
 	for (int i=0; i<9; i++) {
 		char key_name[64];
 		sprintf(key_name,"cat_file_name_%02d",i);
 		const std::string cat_file_name = conf.getStr("stars",key_name).c_str();
-		if (!cat_file_name.empty()) {
-			cLog::get()->write(_("Loading catalog ") + std::string(cat_file_name) , LOG_TYPE::L_INFO);
-			BigStarCatalog::ZoneArray *const z = BigStarCatalog::ZoneArray::create(*this,cat_file_name);
-			if (z) {
-				if (max_geodesic_grid_level < z->level) {
-					max_geodesic_grid_level = z->level;
-				}
-				BigStarCatalog::ZoneArray *&pos(zone_arrays[z->level]);
-				if (pos) {
-					std::cerr << cat_file_name << ", " << z->level << ": duplicate level" << std::endl;
-					delete z;
-				} else {
-					pos = z;
-				}
+		if (!cat_file_name.empty())
+			cat_file_names.push_back(cat_file_name);
+	}
+
+	// The catalogues are opened in parallel, the deepest levels only read their zone sizes
+	loadTasks = std::make_unique<TaskGroup>(ThreadPool::shared());
+	std::vector<BigStarCatalog::ZoneArray *> created(cat_file_names.size(), nullptr);
+	{
+		TaskGroup group(ThreadPool::shared());
+		for (size_t i = 0; i < cat_file_names.size(); i++) {
+			cLog::get()->write(_("Loading catalog ") + cat_file_names[i] , LOG_TYPE::L_INFO);
+			group.run([this, &created, &cat_file_names, i, deferred_level]() {
+				created[i] = BigStarCatalog::ZoneArray::create(*this, cat_file_names[i], deferred_level);
+			});
+		}
+		group.wait();
+	}
+	for (size_t i = 0; i < created.size(); i++) {
+		BigStarCatalog::ZoneArray *const z = created[i];
+		if (z) {
+			if (max_geodesic_grid_level < z->level) {
+				max_geodesic_grid_level = z->level;
+			}
+			BigStarCatalog::ZoneArray *&pos(zone_arrays[z->level]);
+			if (pos) {
+				std::cerr << cat_file_names[i] << ", " << z->level << ": duplicate level" << std::endl;
+				delete z;
+			} else {
+				pos = z;
 			}
 		}
 	}
@@ -476,6 +518,12 @@ void HipStarMgr::load_data(const InitParser &baseConf)
 	        it != zone_arrays.end(); it++) {
 		it->second->updateHipIndex(hip_index);
 	}
+	// "HP n" names are built once, so that the draw loop never formats them
+	hip_names.assign(NR_OF_HIP+1, std::string());
+	for (int i=1; i<=NR_OF_HIP; i++) {
+		if (hip_index[i].s)
+			hip_names[i] = "HP " + std::to_string(i);
+	}
 
 	const std::string cat_hip_sp_file_name = conf.getStr("stars","cat_hip_sp_file_name").c_str();
 	if (cat_hip_sp_file_name.empty()) {
@@ -499,9 +547,11 @@ void HipStarMgr::load_data(const InitParser &baseConf)
 		}
 	}
 
+	rcmagTables.resize(2*256*zone_arrays.size());
+
 	last_max_search_level = max_geodesic_grid_level;
 	std::ostringstream oss;
-	oss <<  "finished, max_geodesic_level: " << max_geodesic_grid_level;
+	oss <<  "finished in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms, max_geodesic_level: " << max_geodesic_grid_level << ", projection kernel: " << BigStarCatalog::starBatchImplementation();
 	cLog::get()->write( oss.str() , LOG_TYPE::L_INFO);
 	cLog::get()->mark();
 }
@@ -513,6 +563,7 @@ int HipStarMgr::loadCommonNames(const std::string& commonNameFile)
 	common_names_map_i18n.clear();
 	common_names_index.clear();
 	common_names_index_i18n.clear();
+	selectionChanged = true;
 
 	cLog::get()->write("Loading star names from " + commonNameFile);
 
@@ -562,6 +613,7 @@ void HipStarMgr::loadSciNames(const std::string& sciNameFile)
 {
 	sci_names_map_i18n.clear();
 	sci_names_index_i18n.clear();
+	selectionChanged = true;
 
 	cLog::get()->write("Loading star sci names from " + sciNameFile);
 
@@ -606,9 +658,9 @@ void HipStarMgr::loadSciNames(const std::string& sciNameFile)
 	fclose(snFile);
 }
 
-int HipStarMgr::drawStar(const Projector *prj,const Vec3d &XY, const float rc_mag[2], const Vec3f &color)
+int HipStarMgr::drawStar(StarDrawTarget &target, const Projector *prj,const Vec3d &XY, const float rc_mag[2], const Vec3f &color) const
 {
-	if (nbStarsToDraw[drawIdx] >= NBR_MAX_STARS)
+	if (target.nbStars >= target.maxStars)
 		return -1;
 
 	if (rc_mag[0]<=0.f || rc_mag[1]<=0.f) {
@@ -626,18 +678,33 @@ int HipStarMgr::drawStar(const Projector *prj,const Vec3d &XY, const float rc_ma
 	if( mag > rolloff )
 		mag = rolloff;
 
+	float *&vertexData = target.vertexData;
 	*(vertexData++) = XY[0];
 	*(vertexData++) = XY[1];
-	*(vertexData++) = color[0]*rc_mag[1]*(1.-twinkle_amount*rand()/RAND_MAX);
-	*(vertexData++) = color[1]*rc_mag[1]*(1.-twinkle_amount*rand()/RAND_MAX);
-	*(vertexData++) = color[2]*rc_mag[1]*(1.-twinkle_amount*rand()/RAND_MAX);
+	if (target.deferTwinkle) {
+		*(vertexData++) = color[0]*rc_mag[1];
+		*(vertexData++) = color[1]*rc_mag[1];
+		*(vertexData++) = color[2]*rc_mag[1];
+	} else {
+		*(vertexData++) = color[0]*rc_mag[1]*(1.-twinkle_amount*rand()/RAND_MAX);
+		*(vertexData++) = color[1]*rc_mag[1]*(1.-twinkle_amount*rand()/RAND_MAX);
+		*(vertexData++) = color[2]*rc_mag[1]*(1.-twinkle_amount*rand()/RAND_MAX);
+	}
 	*(vertexData++) = mag;
 
-	nbStarsToDraw[drawIdx] += 1;
+	target.nbStars += 1;
 
 	return 0;
 }
 
+void HipStarMgr::setFlagParallelDraw(bool b)
+{
+	parallelDraw = b;
+	// the calling thread takes a shard too
+	if (parallelDraw && drawShards.empty())
+		drawShards.resize(ThreadPool::shared().size() + 1);
+}
+
 int HipStarMgr::getMaxSearchLevel(const ToneReproductor *eye, const Projector *prj) const
 {
 	int rval = -1;
@@ -716,6 +783,7 @@ int MagConverter::computeRCMag(float mag, const ToneReproductor *eye, float rc_m
 double HipStarMgr::preDraw(GeodesicGrid* grid, ToneReproductor* eye, Projector* prj, Navigator* nav, TimeMgr* timeMgr, float altitude, bool atmosphere)
 {
 	starNameToDraw.clear();
+	estimatedAllocationsPerFrame = 0;
 	double twinkle_param=1.;
 	nbStarsToDraw[drawIdx] = 0;
 	if (altitude>2000)
@@ -726,35 +794,61 @@ double HipStarMgr::preDraw(GeodesicGrid* grid, ToneReproductor* eye, Projector*
 	// If stars are turned off don't waste time below projecting all stars just to draw disembodied labels
 	if (fader.isZero())
 		return 0.;
-	vertexData = (float *) Context::instance->stagingMgr->getPtr(staging[drawIdx]);
 
 	int max_search_level = getMaxSearchLevel(eye, prj);
-	const GeodesicSearchResult* geodesic_search_result = grid->search(prj->unprojectViewport(),max_search_level);
+	const std::shared_ptr<const GeodesicSearchResult> geodesic_search_result = grid->search(prj->unprojectViewport(),max_search_level);
 
 	mag_converter->setFov(prj->getFov());
 	mag_converter->setEye(eye);
+	projectionFrame.update(prj, nav);
 
 	// Set temporary static variable for optimization
 	if (flagStarTwinkle) twinkle_amount = twinkleAmount*twinkle_param;
 	else twinkle_amount = 0;
 	const float names_brightness = fader * names_fader;
 
-	float rcmag_table[2*256];
-
-	for (ZoneArrayMap::const_iterator it(zone_arrays.begin()); it!=zone_arrays.end(); it++) {
+	drawJobs.clear();
+	++drawFrame;
+	bool complete = true;
+	bool skipped = false; // a level isn't loaded
+	int level = 0;
+	for (ZoneArrayMap::const_iterator it(zone_arrays.begin()); it!=zone_arrays.end(); it++, level++) {
 		const float mag_min = 0.001f*it->second->mag_min;
+		float *const rcmag_table = rcmagTables.data() + 2*256*level;
 
 		const float k = (0.001f*it->second->mag_range)/it->second->mag_steps;
 		for (int i=it->second->mag_steps-1; i>=0; i--) {
 			const float mag = mag_min+k*i;
 			if (mag_converter->computeRCMag(mag, eye, rcmag_table + 2*i) < 0) {
 				if (i==0) {
-					return 0.; //goto exit_loop;
+					complete = false;
+					break;
 				}
 			}
 			rcmag_table[2*i] *= fader;
 		}
+		if (!complete)
+			break;
+		if (!it->second->isLoaded()) {
+			// only this level is skipped until its stars are read, the brighter levels stand in for it
+			// and the deeper loaded levels are still drawn
+			// a level which failed to load is skipped for good, load() has logged the error once
+			if (it->second->startLoading()) {
+				loadTasks->run([this, array = it->second]() {
+					if (!stopLoading)
+						array->load();
+				});
+			}
+			skipped = true;
+			continue;
+		}
 		last_max_search_level = it->first;
+		// a level read on demand fades in instead of appearing at once
+		const float fade_in = it->second->getFadeIn(HIP_STAR_FADE_IN);
+		if (fade_in < 1.f) {
+			for (int i=0; i<it->second->mag_steps; i++)
+				rcmag_table[2*i] *= fade_in;
+		}
 
 		unsigned int max_mag_star_name = 0;
 		if (names_fader.isNonZero()) {
@@ -763,14 +857,108 @@ double HipStarMgr::preDraw(GeodesicGrid* grid, ToneReproductor* eye, Projector*
 		}
 		int zone=0;
 		for (GeodesicSearchInsideIterator it1(*geodesic_search_result,it->first); (zone = it1.next()) >= 0;) {
-			it->second->draw(zone,true,rcmag_table,prj,nav,max_mag_star_name,names_brightness, starNameToDraw,  selected_star, atmosphere, isolateSelected && !selected_star.empty());
+			it->second->willDraw(zone, drawFrame);
+			pushJob(drawJobs, {it->second, zone, true, rcmag_table, max_mag_star_name, (unsigned int) it->second->getZoneSize(zone)});
 		}
 		for (GeodesicSearchBorderIterator it1(*geodesic_search_result,it->first); (zone = it1.next()) >= 0;) {
-			it->second->draw(zone,false,rcmag_table,prj,nav,max_mag_star_name,names_brightness, starNameToDraw,  selected_star, atmosphere, isolateSelected && !selected_star.empty());
+			it->second->willDraw(zone, drawFrame);
+			pushJob(drawJobs, {it->second, zone, false, rcmag_table, max_mag_star_name, (unsigned int) it->second->getZoneSize(zone)});
 		}
+	}
+
+	const bool isolate = isolateSelected && !selected_star.empty();
+	if (isolate && selectionChanged)
+		updateSelectedHip();
+	if (parallelDraw)
+		drawJobsParallel(prj, nav, names_brightness, atmosphere, isolate);
+	else
+		drawJobsSerial(prj, nav, names_brightness, atmosphere, isolate);
+	return (complete && !skipped) ? 1. : 0.;
+}
+
+void HipStarMgr::drawJobsSerial(Projector* prj, Navigator* nav, float names_brightness, bool atmosphere, bool isolate)
+{
+	StarDrawTarget target;
+	target.vertexData = (float *) Context::instance->stagingMgr->getPtr(staging[drawIdx]);
+	target.starNames = &starNameToDraw;
+	for (const auto &job : drawJobs) {
+		job.array->draw(job.zone, job.is_inside, job.rcmag_table, prj, nav, job.max_mag_star_name, names_brightness, target, selected_hip, atmosphere, isolate);
+	}
+	nbStarsToDraw[drawIdx] = target.nbStars;
+	estimatedAllocationsPerFrame += target.estimatedAllocations;
+}
 
+//! Each worker projects a contiguous range of drawJobs into its own shard,
+//! the shards are then merged in job order and twinkle is applied during the merge,
+//! so the output is identical to drawJobsSerial as long as the vertex buffer doesn't overflow.
+void HipStarMgr::drawJobsParallel(Projector* prj, Navigator* nav, float names_brightness, bool atmosphere, bool isolate)
+{
+	unsigned int totalStars = 0;
+	for (const auto &job : drawJobs)
+		totalStars += job.nbStars;
+
+	// split drawJobs in ranges holding about the same number of stars
+	const unsigned int nbShards = drawShards.size();
+	unsigned int usedShards = 0;
+	TaskGroup group(ThreadPool::shared());
+	size_t first = 0;
+	unsigned int cumulated = 0;
+	for (unsigned int i = 0; i < nbShards && first < drawJobs.size(); ++i) {
+		const unsigned int limit = (unsigned long long) totalStars * (i + 1) / nbShards;
+		size_t last = first;
+		unsigned int shardStars = 0;
+		while (last < drawJobs.size() && (cumulated < limit || last == first || i + 1 == nbShards)) {
+			cumulated += drawJobs[last].nbStars;
+			shardStars += drawJobs[last].nbStars;
+			++last;
+		}
+		StarDrawShard &shard = drawShards[i];
+		shard.names.clear();
+		shard.nameIndex.clear();
+		const int capacity = std::min(shardStars, (unsigned int) NBR_MAX_STARS);
+		if (shard.vertices.size() < (size_t) capacity * 6) {
+			shard.vertices.resize(capacity * 6);
+			++estimatedAllocationsPerFrame;
+		}
+		shard.target = StarDrawTarget();
+		shard.target.vertexData = shard.vertices.data();
+		shard.target.maxStars = capacity;
+		shard.target.deferTwinkle = true;
+		shard.target.starNames = &shard.names;
+		shard.target.starNameIndex = &shard.nameIndex;
+		group.run([this, &shard, first, last, prj, nav, names_brightness, atmosphere, isolate]() {
+			for (size_t j = first; j < last; ++j) {
+				const StarDrawJob &job = drawJobs[j];
+				job.array->draw(job.zone, job.is_inside, job.rcmag_table, prj, nav, job.max_mag_star_name, names_brightness, shard.target, selected_hip, atmosphere, isolate);
+			}
+		});
+		++usedShards;
+		first = last;
 	}
-	return 1.;
+	group.wait();
+
+	float *vertexData = (float *) Context::instance->stagingMgr->getPtr(staging[drawIdx]);
+	int nbStars = 0;
+	for (unsigned int i = 0; i < usedShards; ++i) {
+		StarDrawShard &shard = drawShards[i];
+		const int count = std::min(shard.target.nbStars, NBR_MAX_STARS - nbStars);
+		const float *src = shard.vertices.data();
+		for (int j = 0; j < count; ++j) {
+			*(vertexData++) = *(src++);
+			*(vertexData++) = *(src++);
+			*(vertexData++) = *(src++)*(1.-twinkle_amount*rand()/RAND_MAX);
+			*(vertexData++) = *(src++)*(1.-twinkle_amount*rand()/RAND_MAX);
+			*(vertexData++) = *(src++)*(1.-twinkle_amount*rand()/RAND_MAX);
+			*(vertexData++) = *(src++);
+		}
+		for (size_t j = 0; j < shard.names.size(); ++j) {
+			if (shard.nameIndex[j] < count)
+				starNameToDraw.push_back(shard.names[j]);
+		}
+		nbStars += count;
+		estimatedAllocationsPerFrame += shard.target.estimatedAllocations;
+	}
+	nbStarsToDraw[drawIdx] = nbStars;
 }
 
 double HipStarMgr::draw(GeodesicGrid* grid, ToneReproductor* eye, Projector* prj, TimeMgr* timeMgr, float altitude)
@@ -922,10 +1110,12 @@ std::vector<ObjectBaseP > HipStarMgr::searchAround(const Vec3d& vv, double lim_f
 	e2 *= f;
 	e3 *= f;
 	// search the triangles
-	const GeodesicSearchResult* geodesic_search_result = grid->search(e0,e1,e2,e3,last_max_search_level);
+	const std::shared_ptr<const GeodesicSearchResult> geodesic_search_result = grid->search(e0,e1,e2,e3,last_max_search_level);
 	// iterate over the stars inside the triangles:
 	f = cos(lim_fov * M_PI/180.);
 	for (ZoneArrayMap::const_iterator it(zone_arrays.begin()); it!=zone_arrays.end(); it++) {
+		if (!it->second->isLoaded())
+			continue;
 		int zone;
 		for (GeodesicSearchInsideIterator it1(*geodesic_search_result,it->first); (zone = it1.next()) >= 0;) {
 			it->second->searchAround(zone,v,f,result);
@@ -943,6 +1133,7 @@ void HipStarMgr::updateI18n(Translator& trans)
 {
 	common_names_map_i18n.clear();
 	common_names_index_i18n.clear();
+	selectionChanged = true;
 	for (std::map<int,std::string>::iterator it(common_names_map.begin()); it!=common_names_map.end(); it++) {
 		const int i = it->first;
 		const std::string t(trans.translateUTF8(it->second));
@@ -1048,6 +1239,7 @@ void HipStarMgr::setSelected(Object star) {
 	} else {
 		selected_star.insert(std::pair<std::string, bool>(star.getNameI18n(), true));
 	}
+	selectionChanged = true;
 
 	int HP = getHPFromStarName(star.getNameI18n());
 	if (HP >= 0) {
@@ -1055,6 +1247,15 @@ void HipStarMgr::setSelected(Object star) {
 	}
 }
 
+//! Selection is done by name, resolve it once for every hipparcos star
+void HipStarMgr::updateSelectedHip()
+{
+	selectionChanged = false;
+	for (int hip = 0; hip <= NR_OF_HIP; ++hip) {
+		selected_hip[hip] = hip_index[hip].s && selected_star.count(hip_index[hip].s->getNameI18n());
+	}
+}
+
 int HipStarMgr::getHPFromStarName(const std::string& name) const {
 	std::string objw = name;
 	transform(objw.begin(), objw.end(), objw.begin(), ::toupper);
@@ -20,6 +20,10 @@
 #ifndef _STAR_MGR_H_
 #define _STAR_MGR_H_
 #define NBR_MAX_STARS 256000
+// the levels from this one are read when they become visible, can be set by lazy_level in stars.ini
+#define HIP_STAR_LAZY_LEVEL 3
+// duration in seconds of the fade in of a level read on demand
+#define HIP_STAR_FADE_IN 1.f
 
 #include <vector>
 #include <map>
@@ -30,6 +34,7 @@
 #include <cstdio>
 #include <tuple>
 #include <memory>
+#include <atomic>
 
 #include "tools/auto_fader.hpp"
 #include "tools/fader.hpp"
@@ -37,6 +42,7 @@
 #include "tools/object.hpp"
 #include "tools/no_copy.hpp"
 #include "tools/ScModule.hpp"
+#include "starModule/star_projection.hpp"
 #include "EntityCore/Tools/SafeQueue.hpp"
 
 #include "EntityCore/Resource/SharedBuffer.hpp"
@@ -63,6 +69,7 @@ class RenderMgr;
 class FrameMgr;
 class SyncEvent;
 class TransferMgr;
+class TaskGroup;
 
 typedef std::tuple<double, double, const std::string , const Vec4f > starDBtoDraw;
 
@@ -71,6 +78,36 @@ class ZoneArray;
 class HipIndexStruct;
 }
 
+//! Destination of the stars projected by the zone arrays.
+//! In serial mode it points directly into the staging buffer, in parallel mode
+//! each worker owns one and HipStarMgr merges them in zone order.
+struct StarDrawTarget {
+	float *vertexData = nullptr;
+	int nbStars = 0;
+	int maxStars = NBR_MAX_STARS;
+	//! when set, twinkle is not applied here but while merging, so rand() is called in the serial order
+	bool deferTwinkle = false;
+	std::vector<starDBtoDraw> *starNames = nullptr;
+	//! index of the star of each name in vertexData, -1 if the name is always kept
+	std::vector<int> *starNameIndex = nullptr;
+	//! estimated number of heap allocations performed while filling this target,
+	//! deduced from the vector capacities and the small string buffer size
+	int estimatedAllocations = 0;
+
+	void pushName(double x, double y, const std::string &name, const Vec4f &color, bool alwaysKept) {
+		if (starNames->size() == starNames->capacity())
+			++estimatedAllocations;
+		if (name.size() > std::string().capacity())
+			++estimatedAllocations; // copy of the name in starNames
+		starNames->emplace_back(x, y, name, color);
+		if (starNameIndex) {
+			if (starNameIndex->size() == starNameIndex->capacity())
+				++estimatedAllocations;
+			starNameIndex->push_back(alwaysKept ? -1 : nbStars - 1);
+		}
+	}
+};
+
 enum StarSync {
 	STAR_UNINITIALIZED, // Never used until now (thus VK_IMAGE_LAYOUT_UNDEFINED)
 	STAR_CLEAR, // Left in VK_IMAGE_LAYOUT_UNDEFINED after use
@@ -167,6 +204,11 @@ public:
 	//!
 	//! @param conf The ini parser object containing relevant settings.
 	virtual void init(const InitParser &conf);
+	//! First part of init: loads the star catalogue data and sets up the color table
+	//! Doesn't use the vulkan context, can run on a worker thread
+	void loadCatalogs(const InitParser &conf);
+	//! Second part of init: loads the star texture
+	void loadTexture();
 
 	//! draw the stars and the star selection indicator if necessary
 	virtual double draw(GeodesicGrid* grid, ToneReproductor* eye, Projector* prj, TimeMgr* timeMgr, float altitude);
@@ -265,6 +307,7 @@ public:
 	void deselect() {
 		selected_star.clear();
 		selected_stars.clear();
+		selectionChanged = true;
 	}
 
 	//! Set whether selected stars must be displayed alone
@@ -429,21 +472,39 @@ public:
 		return flagSciNames;
 	}
 
-	//! Draw a star of specified position, magnitude and color.
-	int drawStar(const Projector *prj, const Vec3d &XY, const float rc_mag[2], const Vec3f &color);
+	//! Draw a star of specified position, magnitude and color into target.
+	int drawStar(StarDrawTarget &target, const Projector *prj, const Vec3d &XY, const float rc_mag[2], const Vec3f &color) const;
+
+	//! Get the projection data shared by the zone arrays during preDraw
+	const BigStarCatalog::StarProjectionFrame &getProjectionFrame(void) const {
+		return projectionFrame;
+	}
+
+	//! Get an estimate of the number of heap allocations performed by the last preDraw
+	int getEstimatedAllocationsPerFrame(void) const {
+		return estimatedAllocationsPerFrame;
+	}
 
-	int drawStar(const Projector *prj, const Vec3d &XY, const float rc_mag[2], const Vec3f &color) const {
-		//! drawStar write to vertexData and nbStarsToDraw, thus it can't be const
-		return const_cast<HipStarMgr *>(this)->drawStar(prj, XY, rc_mag, color);
+	//! Set whether the visible zones are projected by a pool of worker threads
+	void setFlagParallelDraw(bool b);
+	//! Get whether the visible zones are projected by a pool of worker threads
+	bool getFlagParallelDraw(void) const {
+		return parallelDraw;
 	}
 
 	//! Get the (translated) common name for a star with a specified
 	//! Hipparcos catalogue number.
-	static std::string getCommonName(int hip);
+	static const std::string &getCommonName(int hip);
 
 	//! Get the (translated) scientifc name for a star with a specified
 	//! Hipparcos catalogue number.
-	static std::string getSciName(int hip);
+	static const std::string &getSciName(int hip);
+
+	//! Get the "HP n" name of a star with a specified Hipparcos catalogue number
+	static const std::string &getHipName(int hip);
+
+	//! Empty name returned by reference when a star has none
+	static const std::string noName;
 
 	static Vec3f color_table[128];
 
@@ -478,6 +539,41 @@ private:
 
 	void drawStarName( Projector* prj );
 
+	//! A zone to project, collected in the serial drawing order
+	struct StarDrawJob {
+		const BigStarCatalog::ZoneArray *array;
+		int zone;
+		bool is_inside;
+		const float *rcmag_table;
+		unsigned int max_mag_star_name;
+		unsigned int nbStars;
+	};
+	//! Local output of a worker, merged into the staging buffer
+	struct StarDrawShard {
+		std::vector<float> vertices;
+		std::vector<starDBtoDraw> names;
+		std::vector<int> nameIndex;
+		StarDrawTarget target;
+	};
+	void drawJobsSerial(Projector* prj, Navigator* nav, float names_brightness, bool atmosphere, bool isolate);
+	void drawJobsParallel(Projector* prj, Navigator* nav, float names_brightness, bool atmosphere, bool isolate);
+	//! Account for the allocation done by push_back on a full vector
+	template<typename T>
+	void pushJob(std::vector<T> &vec, T &&value) {
+		if (vec.size() == vec.capacity())
+			++estimatedAllocationsPerFrame;
+		vec.push_back(std::move(value));
+	}
+	std::vector<StarDrawJob> drawJobs;
+	unsigned int drawFrame = 1; //! counted by preDraw, for the hints on the mapped zones
+	std::vector<StarDrawShard> drawShards;
+	std::vector<float> rcmagTables; //! one table of 2*256 values per zone array
+	BigStarCatalog::StarProjectionFrame projectionFrame;
+	bool parallelDraw = false;
+	//! deferred levels read on the shared pool when they become visible
+	std::unique_ptr<TaskGroup> loadTasks;
+	std::atomic<bool> stopLoading{false};
+
 	ALinearFader names_fader;
 
 	float starSizeLimit;
@@ -493,6 +589,11 @@ private:
 	bool isolateSelected=false;
 	std::map<std::string, bool> selected_star;
 	std::vector<int> selected_stars;
+	//! selected_star indexed by HIP number, rebuilt when the selection or the star names change
+	std::vector<bool> selected_hip;
+	bool selectionChanged = true;
+	void updateSelectedHip();
+	int estimatedAllocationsPerFrame = 0;
 
 	s_texture* starTexture; //! star texture
 
@@ -516,6 +617,7 @@ private:
 	static std::map<std::string, int> common_names_index_i18n;
 
 	static std::map<int, std::string> sci_names_map_i18n;
+	static std::vector<std::string> hip_names; //! "HP n" name of each hiparcos star, indexed by hip
 	static std::map<std::string, int> sci_names_index_i18n;
 
 
@@ -531,7 +633,6 @@ private:
 	void createShaderParams(int width,int height);
 	std::unique_ptr<Texture> depthBuffer;
 	SubBuffer staging[2];
-	float *vertexData;
 	int cmds[3] {-1, -1, -1};
 	std::unique_ptr<PipelineLayout> m_layoutStars, m_layoutFBO;
 	std::unique_ptr<Pipeline> pipelineStarsClear, pipelineStarsReuse, m_pipelineFBO;
@@ -110,8 +110,8 @@ std::string StarWrapper1::getInfoString(const Navigator *nav) const
 	Utility::rectToSphe(&ra_equ,&dec_equ,equatorial_pos);
 	std::stringstream oss;
 	if (s->getHip()) {
-		const std::string commonNameI18 = HipStarMgr::getCommonName(s->getHip());
-		const std::string sciName = HipStarMgr::getSciName(s->getHip());
+		const std::string &commonNameI18 = HipStarMgr::getCommonName(s->getHip());
+		const std::string &sciName = HipStarMgr::getSciName(s->getHip());
 		if (commonNameI18!="" || sciName!="") {
 			oss << commonNameI18 << (commonNameI18 == "" ? "" : " ");
 			if (commonNameI18!="" && sciName!="") oss << "(";
@@ -168,8 +168,8 @@ std::string StarWrapper1::getShortInfoString(const Navigator *nav) const
 {
 	std::stringstream oss;
 	if (s->getHip()) {
-		const std::string commonNameI18 = HipStarMgr::getCommonName(s->getHip());
-		const std::string sciName = HipStarMgr::getSciName(s->getHip());
+		const std::string &commonNameI18 = HipStarMgr::getCommonName(s->getHip());
+		const std::string &sciName = HipStarMgr::getSciName(s->getHip());
 		if (commonNameI18!="" || sciName!="") {
 			oss << commonNameI18 << (commonNameI18 == "" ? "" : " ");
 			if (commonNameI18!="" && sciName!="") oss << "(";
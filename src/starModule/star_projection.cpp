@@ -0,0 +1,270 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2024 of the LSS Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of the LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include <cmath>
+
+#include "starModule/star_projection.hpp"
+#include "starModule/zone_data.hpp"
+#include "coreModule/projector.hpp"
+#include "navModule/navigator.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STAR_BATCH_AVX2
+#include <immintrin.h>
+#endif
+
+namespace BigStarCatalog {
+
+static void copyMatrix(double dst[12], const Mat4d &m)
+{
+	// drop the projective row, keep the translation
+	for (int col = 0; col < 4; ++col)
+		for (int row = 0; row < 3; ++row)
+			dst[col*3 + row] = m.r[col*4 + row];
+}
+
+void StarProjectionFrame::update(const Projector *prj, const Navigator *nav)
+{
+	update(prj, nav->getJ2000ToLocalMat(), nav->getLocalToEyeMat());
+}
+
+void StarProjectionFrame::update(const Projector *prj, const Mat4d &toLocal, const Mat4d &toEye)
+{
+	copyMatrix(j2000ToLocal, toLocal);
+	copyMatrix(localToEye, toEye);
+	const Vec3d center = prj->getViewportCenter();
+	centerX = center[0];
+	centerY = center[1];
+	scale = prj->getFisheyeScaleFactor() * prj->getViewportRadius();
+	minX = prj->getViewportPosX();
+	minY = prj->getViewportPosY();
+	maxX = prj->getViewportPosX() + prj->getViewportWidth();
+	maxY = prj->getViewportPosY() + prj->getViewportHeight();
+}
+
+void StarProjectionZone::set(const ZoneData *z)
+{
+	for (int i = 0; i < 3; ++i) {
+		center[i] = z->center[i];
+		axis0[i] = z->axis0[i];
+		axis1[i] = z->axis1[i];
+	}
+}
+
+// limit of Projector::projectCustom, a < 0.97*M_PI
+static const double MAX_PROJECTED_ANGLE = 0.97 * M_PI;
+
+// ===========================================================================
+//  Scalar implementation
+// ===========================================================================
+
+static void toLocalScalar(const StarProjectionFrame &frame, const StarProjectionZone &zone, StarBatch &b)
+{
+	const double *m = frame.j2000ToLocal;
+	for (int i = 0; i < STAR_BATCH_SIZE; ++i) {
+		const double px = zone.center[0] + b.c0[i] * zone.axis0[0] + b.c1[i] * zone.axis1[0];
+		const double py = zone.center[1] + b.c0[i] * zone.axis0[1] + b.c1[i] * zone.axis1[1];
+		const double pz = zone.center[2] + b.c0[i] * zone.axis0[2] + b.c1[i] * zone.axis1[2];
+		const double inv = 1.0 / std::sqrt(px*px + py*py + pz*pz);
+		b.x[i] = (m[0]*px + m[3]*py + m[6]*pz) * inv + m[9];
+		b.y[i] = (m[1]*px + m[4]*py + m[7]*pz) * inv + m[10];
+		b.z[i] = (m[2]*px + m[5]*py + m[8]*pz) * inv + m[11];
+	}
+}
+
+static unsigned int projectScalar(const StarProjectionFrame &frame, bool checkViewport, StarBatch &b)
+{
+	const double *m = frame.localToEye;
+	unsigned int mask = 0;
+	for (int i = 0; i < STAR_BATCH_SIZE; ++i) {
+		const double ex = m[0]*b.x[i] + m[3]*b.y[i] + m[6]*b.z[i] + m[9];
+		const double ey = m[1]*b.x[i] + m[4]*b.y[i] + m[7]*b.z[i] + m[10];
+		const double ez = m[2]*b.x[i] + m[5]*b.y[i] + m[8]*b.z[i] + m[11];
+		const double rq1 = ex*ex + ey*ey;
+		bool visible;
+		if (rq1 <= 0) {
+			b.winX[i] = frame.centerX;
+			b.winY[i] = frame.centerY;
+			visible = (ez < 0);
+		} else {
+			const double oneoverh = 1.0 / std::sqrt(rq1);
+			const double a = M_PI_2 + std::atan(ez * oneoverh);
+			const double f = a * frame.scale * oneoverh;
+			b.winX[i] = frame.centerX + ex * f;
+			b.winY[i] = frame.centerY + ey * f;
+			visible = (a < MAX_PROJECTED_ANGLE);
+		}
+		if (visible && checkViewport)
+			visible = (b.winX[i] > frame.minX && b.winX[i] < frame.maxX && b.winY[i] > frame.minY && b.winY[i] < frame.maxY);
+		mask |= (visible ? 1u : 0u) << i;
+	}
+	return mask;
+}
+
+// ===========================================================================
+//  AVX2 implementation
+// ===========================================================================
+
+#ifdef STAR_BATCH_AVX2
+
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+
+// Cephes atan in double, within 2 ulp like std::atan
+AVX2_TARGET static inline __m256d atanAvx2(__m256d t)
+{
+	const __m256d signMask = _mm256_set1_pd(-0.);
+	const __m256d sign = _mm256_and_pd(t, signMask);
+	const __m256d x = _mm256_andnot_pd(signMask, t);
+	const __m256d one = _mm256_set1_pd(1.);
+	const __m256d moreBits = _mm256_set1_pd(6.123233995736765886130e-17);
+
+	const __m256d big = _mm256_cmp_pd(x, _mm256_set1_pd(2.41421356237309504880), _CMP_GT_OQ);
+	const __m256d mid = _mm256_andnot_pd(big, _mm256_cmp_pd(x, _mm256_set1_pd(0.66), _CMP_GT_OQ));
+
+	__m256d xr = _mm256_blendv_pd(x, _mm256_div_pd(_mm256_sub_pd(x, one), _mm256_add_pd(x, one)), mid);
+	xr = _mm256_blendv_pd(xr, _mm256_div_pd(_mm256_set1_pd(-1.), x), big);
+	__m256d y0 = _mm256_and_pd(mid, _mm256_set1_pd(M_PI_4));
+	y0 = _mm256_blendv_pd(y0, _mm256_set1_pd(M_PI_2), big);
+	// low bits of y0, added to the polynomial before y0
+	__m256d low = _mm256_and_pd(mid, _mm256_mul_pd(moreBits, _mm256_set1_pd(0.5)));
+	low = _mm256_blendv_pd(low, moreBits, big);
+
+	const __m256d z = _mm256_mul_pd(xr, xr);
+	__m256d p = _mm256_set1_pd(-8.750608600031904122785e-1);
+	p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.615753718733365076637e1));
+	p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-7.500855792314704667340e1));
+	p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.228866684490136173410e2));
+	p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-6.485021904942025371773e1));
+	__m256d q = _mm256_add_pd(z, _mm256_set1_pd(2.485846490142306297962e1));
+	q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.650270098316988542046e2));
+	q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.328810604912902668951e2));
+	q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.853903996359136964868e2));
+	q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.945506571482613964425e2));
+	const __m256d r = _mm256_add_pd(_mm256_fmadd_pd(_mm256_mul_pd(xr, z), _mm256_div_pd(p, q), xr), low);
+
+	return _mm256_xor_pd(_mm256_add_pd(y0, r), sign);
+}
+
+// r = m[0]*x + m[3]*y + m[6]*z for the row of m starting at m
+AVX2_TARGET static inline __m256d rowAvx2(const double *m, __m256d x, __m256d y, __m256d z)
+{
+	__m256d r = _mm256_mul_pd(_mm256_set1_pd(m[0]), x);
+	r = _mm256_add_pd(r, _mm256_mul_pd(_mm256_set1_pd(m[3]), y));
+	return _mm256_add_pd(r, _mm256_mul_pd(_mm256_set1_pd(m[6]), z));
+}
+
+// 4 stars per iteration, 2 iterations per batch
+AVX2_TARGET static void toLocalAvx2(const StarProjectionFrame &frame, const StarProjectionZone &zone, StarBatch &b)
+{
+	const double *m = frame.j2000ToLocal;
+	for (int i = 0; i < STAR_BATCH_SIZE; i += 4) {
+		const __m256d c0 = _mm256_load_pd(b.c0 + i);
+		const __m256d c1 = _mm256_load_pd(b.c1 + i);
+		__m256d p[3];
+		for (int k = 0; k < 3; ++k) {
+			p[k] = _mm256_add_pd(_mm256_set1_pd(zone.center[k]), _mm256_mul_pd(c0, _mm256_set1_pd(zone.axis0[k])));
+			p[k] = _mm256_add_pd(p[k], _mm256_mul_pd(c1, _mm256_set1_pd(zone.axis1[k])));
+		}
+		__m256d len2 = _mm256_mul_pd(p[0], p[0]);
+		len2 = _mm256_add_pd(len2, _mm256_mul_pd(p[1], p[1]));
+		len2 = _mm256_add_pd(len2, _mm256_mul_pd(p[2], p[2]));
+		const __m256d inv = _mm256_div_pd(_mm256_set1_pd(1.), _mm256_sqrt_pd(len2));
+		double *out[3] = {b.x + i, b.y + i, b.z + i};
+		for (int k = 0; k < 3; ++k) {
+			const __m256d r = _mm256_mul_pd(rowAvx2(m + k, p[0], p[1], p[2]), inv);
+			_mm256_store_pd(out[k], _mm256_add_pd(r, _mm256_set1_pd(m[9 + k])));
+		}
+	}
+}
+
+AVX2_TARGET static unsigned int projectAvx2(const StarProjectionFrame &frame, bool checkViewport, StarBatch &b)
+{
+	const double *m = frame.localToEye;
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d cx = _mm256_set1_pd(frame.centerX);
+	const __m256d cy = _mm256_set1_pd(frame.centerY);
+	unsigned int mask = 0;
+	for (int i = 0; i < STAR_BATCH_SIZE; i += 4) {
+		const __m256d x = _mm256_load_pd(b.x + i);
+		const __m256d y = _mm256_load_pd(b.y + i);
+		const __m256d z = _mm256_load_pd(b.z + i);
+		const __m256d ex = _mm256_add_pd(rowAvx2(m, x, y, z), _mm256_set1_pd(m[9]));
+		const __m256d ey = _mm256_add_pd(rowAvx2(m + 1, x, y, z), _mm256_set1_pd(m[10]));
+		const __m256d ez = _mm256_add_pd(rowAvx2(m + 2, x, y, z), _mm256_set1_pd(m[11]));
+		const __m256d rq1 = _mm256_add_pd(_mm256_mul_pd(ex, ex), _mm256_mul_pd(ey, ey));
+		const __m256d onAxis = _mm256_cmp_pd(rq1, zero, _CMP_LE_OQ);
+
+		const __m256d oneoverh = _mm256_div_pd(_mm256_set1_pd(1.), _mm256_sqrt_pd(rq1));
+		const __m256d a = _mm256_add_pd(_mm256_set1_pd(M_PI_2), atanAvx2(_mm256_mul_pd(ez, oneoverh)));
+		const __m256d f = _mm256_mul_pd(_mm256_mul_pd(a, _mm256_set1_pd(frame.scale)), oneoverh);
+		const __m256d wx = _mm256_blendv_pd(_mm256_add_pd(cx, _mm256_mul_pd(ex, f)), cx, onAxis);
+		const __m256d wy = _mm256_blendv_pd(_mm256_add_pd(cy, _mm256_mul_pd(ey, f)), cy, onAxis);
+		_mm256_store_pd(b.winX + i, wx);
+		_mm256_store_pd(b.winY + i, wy);
+
+		__m256d visible = _mm256_blendv_pd(_mm256_cmp_pd(a, _mm256_set1_pd(MAX_PROJECTED_ANGLE), _CMP_LT_OQ),
+		                                   _mm256_cmp_pd(ez, zero, _CMP_LT_OQ), onAxis);
+		if (checkViewport) {
+			visible = _mm256_and_pd(visible, _mm256_cmp_pd(wx, _mm256_set1_pd(frame.minX), _CMP_GT_OQ));
+			visible = _mm256_and_pd(visible, _mm256_cmp_pd(wx, _mm256_set1_pd(frame.maxX), _CMP_LT_OQ));
+			visible = _mm256_and_pd(visible, _mm256_cmp_pd(wy, _mm256_set1_pd(frame.minY), _CMP_GT_OQ));
+			visible = _mm256_and_pd(visible, _mm256_cmp_pd(wy, _mm256_set1_pd(frame.maxY), _CMP_LT_OQ));
+		}
+		mask |= _mm256_movemask_pd(visible) << i;
+	}
+	return mask;
+}
+
+static const bool useAvx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+
+#endif /* STAR_BATCH_AVX2 */
+
+void starBatchToLocal(const StarProjectionFrame &frame, const StarProjectionZone &zone, StarBatch &batch)
+{
+	#ifdef STAR_BATCH_AVX2
+	if (useAvx2)
+		return toLocalAvx2(frame, zone, batch);
+	#endif
+	toLocalScalar(frame, zone, batch);
+}
+
+unsigned int starBatchProject(const StarProjectionFrame &frame, bool checkViewport, StarBatch &batch)
+{
+	#ifdef STAR_BATCH_AVX2
+	if (useAvx2)
+		return projectAvx2(frame, checkViewport, batch);
+	#endif
+	return projectScalar(frame, checkViewport, batch);
+}
+
+const char *starBatchImplementation()
+{
+	#ifdef STAR_BATCH_AVX2
+	if (useAvx2)
+		return "avx2";
+	#endif
+	return "scalar";
+}
+
+} // namespace BigStarCatalog
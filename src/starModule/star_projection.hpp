@@ -0,0 +1,86 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2024 of the LSS Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of the LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#ifndef _STAR_PROJECTION_HPP_
+#define _STAR_PROJECTION_HPP_
+
+#include "tools/vecmath.hpp"
+
+class Projector;
+class Navigator;
+
+namespace BigStarCatalog {
+
+struct ZoneData;
+
+//! Number of stars handled by one call of the batch kernels
+#define STAR_BATCH_SIZE 8
+
+//! Frame constant data of the batch projection
+//! Everything is in double like Projector::projectCustom: at the minimal fov a pixel is
+//! about 1e-9 rad, far below the float resolution of a unit vector.
+struct StarProjectionFrame {
+	double j2000ToLocal[12];	//! 3x4 column-major matrix
+	double localToEye[12];	//! 3x4 column-major matrix
+	double centerX, centerY;	//! viewport center in pixels
+	double scale;			//! fisheye_scale_factor * viewport_radius
+	double minX, maxX, minY, maxY; //! viewport rectangle
+
+	void update(const Projector *prj, const Navigator *nav);
+	void update(const Projector *prj, const Mat4d &toLocal, const Mat4d &toEye);
+};
+
+//! Zone constant data of the batch projection
+struct StarProjectionZone {
+	double center[3];
+	double axis0[3];
+	double axis1[3];
+
+	void set(const ZoneData *z);
+};
+
+//! Arrays of STAR_BATCH_SIZE values, lanes past the stars count are ignored
+struct alignas(32) StarBatch {
+	double c0[STAR_BATCH_SIZE];	//! position along axis0 of the zone
+	double c1[STAR_BATCH_SIZE];	//! position along axis1 of the zone
+	double x[STAR_BATCH_SIZE];	//! local position
+	double y[STAR_BATCH_SIZE];
+	double z[STAR_BATCH_SIZE];
+	double winX[STAR_BATCH_SIZE];	//! projected position
+	double winY[STAR_BATCH_SIZE];
+};
+
+//! Compute the normalized local position of the stars from their zone coordinates
+void starBatchToLocal(const StarProjectionFrame &frame, const StarProjectionZone &zone, StarBatch &batch);
+
+//! Project the local position of the stars with the fisheye projection
+//! @return a mask of the visible stars, bit i is set for the star i
+unsigned int starBatchProject(const StarProjectionFrame &frame, bool checkViewport, StarBatch &batch);
+
+//! Tell which implementation of the kernels is used ("avx2" or "scalar")
+const char *starBatchImplementation();
+
+} // namespace BigStarCatalog
+
+#endif
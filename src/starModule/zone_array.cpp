@@ -23,10 +23,13 @@
 #include "coreModule/projector.hpp"
 #include "starModule/zone_array.hpp"
 #include "starModule/geodesic_grid.hpp"
+#include "starModule/star_projection.hpp"
 #include "tools/app_settings.hpp"
 #include "tools/log.hpp"
 #include "tools/object_base.hpp"
 #include "tools/s_texture.hpp"
+#include <chrono>
+#include <filesystem>
 #ifdef __linux__
 #include <unistd.h>
 #endif
@@ -35,6 +38,23 @@ namespace BigStarCatalog {
 
 static const Vec3d north(0,0,1);
 
+// Correct a local position accounting for atmospheric refraction
+static inline void refract(Vec3d &local_pos)
+{
+	double alt, az;
+	Utility::rectToSphe(&az,&alt,local_pos);
+	//float press_temp_corr = (1013.f)/1010.f * 283.f/(273.f+10.f) / 60.f; //temperature and pressure correction based on Stellarium's code
+	const float rad2deg = 180.0f/M_PI;
+	const float deg2rad = M_PI/180.0f;
+	float ha = rad2deg*alt;
+	float r;
+	if (ha>-5.0) r = 1.02f/tan((ha+10.3f/(ha+5.11f))*deg2rad)/60.0; else r=0.0f;
+	//r = press_temp_corr * (1.f / tan((ha+7.31f/(ha+4.4f))*deg2rad) + 0.0013515f); //Bennett formula
+	ha += r;
+	alt = deg2rad*ha;
+	Utility::spheToRect(az, alt, local_pos);
+}
+
 void ZoneArray::initTriangle(int index, const Vec3d &c0, const Vec3d &c1, const Vec3d &c2)
 {
 	// initialize center,axis0,axis1:
@@ -81,21 +101,145 @@ static inline int ReadInt(FILE *f,unsigned int &x)
 #define FILE_MAGIC 0x835f040a
 #define FILE_MAGIC_OTHER_ENDIAN 0x0a045f83
 #define FILE_MAGIC_NATIVE 0x835f040b
+#define FILE_MAGIC_ALIGNED 0x835f040c // native, the stars start on STAR_FILE_ALIGNMENT
 #define MAX_MAJOR_FILE_VERSION 0
+#define MAX_FILE_LEVEL 10
+#define CONVERT_BUFFER_SIZE (1<<20)
 
 // The #warning preprocessor is not implemented on MSVC
 // #if (!defined(__GNUC__))
 // #warning Star catalogue loading has only been tested with gcc
 // #endif
 
-ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const std::string& extended_file_name)
+struct CatalogueHeader {
+	unsigned int magic,type,major,minor,level,mag_min,mag_range,mag_steps;
+};
+
+//! read the header of a catalogue, in native byte order
+static bool readHeader(FILE *f, CatalogueHeader &h)
+{
+	if (ReadInt(f,h.magic) < 0 ||
+	        ReadInt(f,h.type) < 0 ||
+	        ReadInt(f,h.major) < 0 ||
+	        ReadInt(f,h.minor) < 0 ||
+	        ReadInt(f,h.level) < 0 ||
+	        ReadInt(f,h.mag_min) < 0 ||
+	        ReadInt(f,h.mag_range) < 0 ||
+	        ReadInt(f,h.mag_steps) < 0)
+		return false;
+	if (h.magic == FILE_MAGIC_OTHER_ENDIAN) {
+		h.type = SDL_Swap32(h.type);
+		h.major = SDL_Swap32(h.major);
+		h.minor = SDL_Swap32(h.minor);
+		h.level = SDL_Swap32(h.level);
+		h.mag_min = SDL_Swap32(h.mag_min);
+		h.mag_range = SDL_Swap32(h.mag_range);
+		h.mag_steps = SDL_Swap32(h.mag_steps);
+	}
+	return true;
+}
+
+//! position of the stars in a FILE_MAGIC_ALIGNED catalogue, the zone sizes are just before
+static long alignedStarsOffset(unsigned int level)
+{
+	const long end_of_sizes = sizeof(CatalogueHeader) + sizeof(unsigned int)*GeodesicGrid::nrOfZones(level);
+	return (end_of_sizes + STAR_FILE_ALIGNMENT - 1) / STAR_FILE_ALIGNMENT * STAR_FILE_ALIGNMENT;
+}
+
+//! size of the stars of a catalogue type, 0 for an unknown type
+static size_t starSize(unsigned int type)
+{
+	switch (type) {
+		case 0: return sizeof(Star1);
+		case 1: return sizeof(Star2);
+		case 2: return sizeof(Star3);
+		default: return 0;
+	}
+}
+
+bool ZoneArray::convert(const std::string &src, const std::string &dst)
+{
+	FILE *in = fopen(src.c_str(),"rb");
+	if (in == 0) {
+		std::cerr << "ZoneArray::convert: can't open " << src << std::endl;
+		return false;
+	}
+	CatalogueHeader h;
+	if (!readHeader(in,h) || h.level > MAX_FILE_LEVEL || starSize(h.type) == 0 ||
+	        (h.magic != FILE_MAGIC && h.magic != FILE_MAGIC_OTHER_ENDIAN && h.magic != FILE_MAGIC_NATIVE && h.magic != FILE_MAGIC_ALIGNED)) {
+		std::cerr << "ZoneArray::convert: " << src << " is no star catalogue file" << std::endl;
+		fclose(in);
+		return false;
+	}
+	const unsigned int nr_of_zones = GeodesicGrid::nrOfZones(h.level);
+	const long stars_offset = alignedStarsOffset(h.level);
+	std::vector<unsigned int> zone_size(nr_of_zones);
+	uint64_t nr_of_stars = 0;
+	bool ok = (h.magic != FILE_MAGIC_ALIGNED || fseek(in, stars_offset - sizeof(unsigned int)*nr_of_zones, SEEK_SET) == 0) &&
+	          fread(zone_size.data(), sizeof(unsigned int), nr_of_zones, in) == nr_of_zones;
+	for (auto &size : zone_size) {
+		if (h.magic == FILE_MAGIC_OTHER_ENDIAN)
+			size = SDL_Swap32(size);
+		nr_of_stars += size;
+	}
+	if (ok && h.magic == FILE_MAGIC_ALIGNED)
+		ok = fseek(in, stars_offset, SEEK_SET) == 0;
+
+	// the copy is written beside dst and renamed once complete, a half written copy is never used
+	const std::string tmp = dst + ".tmp";
+	FILE *out = ok ? fopen(tmp.c_str(),"wb") : 0;
+	if (out) {
+		h.magic = FILE_MAGIC_ALIGNED;
+		const std::vector<char> padding(stars_offset - sizeof(h) - sizeof(unsigned int)*nr_of_zones, 0);
+		ok = fwrite(&h, sizeof(h), 1, out) == 1 &&
+		     fwrite(padding.data(), 1, padding.size(), out) == padding.size() &&
+		     fwrite(zone_size.data(), sizeof(unsigned int), nr_of_zones, out) == nr_of_zones;
+		// the stars are stored little endian whatever the magic, they are copied as they are
+		std::vector<char> buffer(CONVERT_BUFFER_SIZE);
+		for (uint64_t left = nr_of_stars*starSize(h.type); ok && left > 0;) {
+			const size_t n = std::min<uint64_t>(left, buffer.size());
+			ok = fread(buffer.data(), 1, n, in) == n && fwrite(buffer.data(), 1, n, out) == n;
+			left -= n;
+		}
+		ok = (fclose(out) == 0) && ok;
+		ok = ok && rename(tmp.c_str(), dst.c_str()) == 0;
+		if (!ok)
+			remove(tmp.c_str());
+	}
+	fclose(in);
+	if (!ok)
+		std::cerr << "ZoneArray::convert: writing " << dst << " from " << src << " failed" << std::endl;
+	return ok;
+}
+
+//! return the native copy of a catalogue in the cache, converted if it is missing or older than the catalogue
+//! return an empty string if the copy can't be written
+static std::string getNativeCopy(const std::string &fname)
+{
+	std::error_code ec;
+	const std::filesystem::path dir = AppSettings::Instance()->getCacheDir() + "stars";
+	const std::filesystem::path copy = dir / std::filesystem::path(fname).filename();
+	if (std::filesystem::exists(copy, ec) &&
+	        std::filesystem::last_write_time(copy, ec) >= std::filesystem::last_write_time(fname, ec) && !ec)
+		return copy.string();
+	std::filesystem::create_directories(dir, ec);
+	const auto start = std::chrono::steady_clock::now();
+	if (!ZoneArray::convert(fname, copy.string()))
+		return "";
+	std::ostringstream oss;
+	oss << fname << " converted to " << copy.string() << " in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms";
+	cLog::get()->write( oss.str() , LOG_TYPE::L_INFO);
+	return copy.string();
+}
+
+ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const std::string& extended_file_name, int deferred_level)
 {
+	const auto start = std::chrono::steady_clock::now();
 	std::string fname(extended_file_name);
-	bool use_mmap = false;
-	if (fname.find("mmap:") != std::string::npos) {
+	// the stars are always mapped, the prefix of the previous configurations is ignored
+	if (fname.find("mmap:") == 0)
 		fname = fname.substr(5);
-		use_mmap = true;
-	}
+	bool use_mmap = true;
 	try {
 		fname = AppSettings::Instance()->getDataRoot() + "stars/" + fname;
 	} catch (std::exception &e) {
@@ -108,53 +252,57 @@ ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const std::string&
 		return 0;
 	}
 	//printf("Loading %s: ",extended_file_name.c_str());
-	unsigned int magic,major,minor,type,level,mag_min,mag_range,mag_steps;
-	if (ReadInt(f,magic) < 0 ||
-	        ReadInt(f,type) < 0 ||
-	        ReadInt(f,major) < 0 ||
-	        ReadInt(f,minor) < 0 ||
-	        ReadInt(f,level) < 0 ||
-	        ReadInt(f,mag_min) < 0 ||
-	        ReadInt(f,mag_range) < 0 ||
-	        ReadInt(f,mag_steps) < 0) {
+	CatalogueHeader h;
+	if (!readHeader(f,h)) {
 		printf("bad file\n");
+		fclose(f);
 		return 0;
 	}
-	const bool byte_swap = (magic == FILE_MAGIC_OTHER_ENDIAN);
+	if (h.magic == FILE_MAGIC_OTHER_ENDIAN) {
+		// the zone sizes can't be used in place, the stars are mapped from a native copy
+		const std::string native_name = getNativeCopy(fname);
+		FILE *native = native_name.empty() ? 0 : fopen(native_name.c_str(),"rb");
+		CatalogueHeader native_header;
+		if (native && readHeader(native,native_header) && native_header.magic == FILE_MAGIC_ALIGNED) {
+			fclose(f);
+			f = native;
+			fname = native_name;
+			h = native_header;
+		} else {
+			if (native)
+				fclose(native);
+			cLog::get()->write("ZoneArray::create: no native copy of " + fname + ", its stars are read in memory", LOG_TYPE::L_WARNING);
+			use_mmap = false;
+		}
+	}
+	const bool byte_swap = (h.magic == FILE_MAGIC_OTHER_ENDIAN);
 	if (byte_swap) {
 		// ok, FILE_MAGIC_OTHER_ENDIAN, must swap
-		if (use_mmap) {
-			printf("you must convert catalogue "
-			       #if (!defined(__GNUC__))
-			       "to native format "
-			       #endif
-			       "before mmap loading\n");
-			return 0;
-		}
 		printf("byteswap ");
-		type = SDL_Swap32(type);
-		major = SDL_Swap32(major);
-		minor = SDL_Swap32(minor);
-		level = SDL_Swap32(level);
-		mag_min = SDL_Swap32(mag_min);
-		mag_range = SDL_Swap32(mag_range);
-		mag_steps = SDL_Swap32(mag_steps);
-	} else if (magic == FILE_MAGIC) {
+	} else if (h.magic == FILE_MAGIC) {
 		// ok, FILE_MAGIC
 		#if (!defined(__GNUC__))
-		if (use_mmap) {
-			// mmap only with gcc:
-			printf("you must convert catalogue to native format before mmap loading\n");
-			return 0;
-		}
+		// mmap only with gcc:
+		use_mmap = false;
 		#endif
-	} else if (magic == FILE_MAGIC_NATIVE) {
+	} else if (h.magic == FILE_MAGIC_NATIVE) {
 		// ok, will work for any architecture and any compiler
+	} else if (h.magic == FILE_MAGIC_ALIGNED && h.level <= MAX_FILE_LEVEL) {
+		// ok, the zone sizes end where the aligned stars start
+		if (fseek(f, alignedStarsOffset(h.level) - sizeof(unsigned int)*GeodesicGrid::nrOfZones(h.level), SEEK_SET) != 0) {
+			printf("bad file\n");
+			fclose(f);
+			return 0;
+		}
 	} else {
 		printf("no star catalogue file\n");
+		fclose(f);
 		return 0;
 	}
+	const unsigned int type = h.type, major = h.major, minor = h.minor, level = h.level;
+	const unsigned int mag_min = h.mag_min, mag_range = h.mag_range, mag_steps = h.mag_steps;
 	ZoneArray *rval = 0;
+	const bool deferred = ((int) level >= deferred_level);
 
 	std::ostringstream oss;
 	oss << extended_file_name << ":" << level << ":" << type << ":" << major << ":" << minor;
@@ -168,7 +316,7 @@ ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const std::string&
 				// When this assertion fails you must redefine Star1 for your compiler.
 				// Because your compiler does not pack the data, which is crucial for this application.
 				assert(sizeof(Star1) == 28);
-				rval = new ZoneArray1(f,byte_swap,use_mmap,hip_star_mgr,level, mag_min,mag_range,mag_steps);
+				rval = new ZoneArray1(f,byte_swap,use_mmap,hip_star_mgr,level, mag_min,mag_range,mag_steps, fname);
 				if (rval == 0) {
 					printf("no memory, ");
 				}
@@ -181,7 +329,7 @@ ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const std::string&
 				// When this assertion fails you must redefine Star2 for your compiler.
 				// Because your compiler does not pack the data, which is crucial for this application.
 				assert(sizeof(Star2) == 10);
-				rval = new SpecialZoneArray<Star2>(f,byte_swap,use_mmap,hip_star_mgr, level, mag_min,mag_range,mag_steps);
+				rval = new SpecialZoneArray<Star2>(f,byte_swap,use_mmap,hip_star_mgr, level, mag_min,mag_range,mag_steps, fname, deferred);
 				if (rval == 0) {
 					printf("no memory, ");
 				}
@@ -194,7 +342,7 @@ ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const std::string&
 				// When this assertion fails you must redefine Star3 for your compiler.
 				// Because your compiler does not pack the data, which is crucial for this application.
 				assert(sizeof(Star3) == 6);
-				rval = new SpecialZoneArray<Star3>(f,byte_swap,use_mmap,hip_star_mgr, level, mag_min,mag_range,mag_steps);
+				rval = new SpecialZoneArray<Star3>(f,byte_swap,use_mmap,hip_star_mgr, level, mag_min,mag_range,mag_steps, fname, deferred);
 				if (rval == 0) {
 					printf("no memory, ");
 				}
@@ -207,6 +355,10 @@ ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const std::string&
 	if (rval && rval->isInitialized()) {
 		std::ostringstream oss;
 		oss <<  "stars:  " << rval->getNrOfStars();
+		if (rval->isLoaded())
+			oss << ", level " << level << " loaded in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms";
+		else
+			oss << ", level " << level << " deferred";
 		cLog::get()->write( oss.str() , LOG_TYPE::L_INFO);
 	} else {
 		printf("initialization failed\n");
@@ -222,12 +374,32 @@ ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const std::string&
 
 
 ZoneArray::ZoneArray(const HipStarMgr &hip_star_mgr,int level, int mag_min,int mag_range,int mag_steps)
-	:level(level), mag_min(mag_min),mag_range(mag_range),mag_steps(mag_steps), star_position_scale(0.0), hip_star_mgr(hip_star_mgr), zones(0)
+	:level(level), mag_min(mag_min),mag_range(mag_range),mag_steps(mag_steps), star_position_scale(0.0), hip_star_mgr(hip_star_mgr), zones(0),
+	 use_mmap(false), stars_offset(0), state(ZONE_ARRAY_FAILED)
 {
 	nr_of_zones = GeodesicGrid::nrOfZones(level);
 	nr_of_stars = 0;
 }
 
+void ZoneArray::load(void)
+{
+	const auto start = std::chrono::steady_clock::now();
+	FILE *f = fopen(file_name.c_str(),"rb");
+	const bool loaded = f && fseek(f, stars_offset, SEEK_SET) == 0 && loadStars(f);
+	if (f)
+		fclose(f);
+	std::ostringstream oss;
+	if (loaded) {
+		loaded_time = std::chrono::steady_clock::now();
+		oss << "stars:  " << nr_of_stars << ", level " << level << " loaded in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms";
+		cLog::get()->write( oss.str() , LOG_TYPE::L_INFO);
+	} else {
+		oss << "ZoneArray::load: level " << level << " from " << file_name << " failed";
+		cLog::get()->write( oss.str() , LOG_TYPE::L_ERROR);
+	}
+	state.store(loaded ? ZONE_ARRAY_LOADED : ZONE_ARRAY_FAILED, std::memory_order_release);
+}
+
 bool ZoneArray::readStarFile(FILE *f,void *data,size_t size)
 {
 	while (size > 0) {
@@ -312,7 +484,7 @@ float ZoneArray1::checkMag(int hip)
 	return -1;
 }
 
-void ZoneArray1::draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, Navigator *nav, int max_mag_star_name, float names_brightness, std::vector<starDBtoDraw> &starNameToDraw, std::map<std::string, bool> selected_stars,  bool atmosphere, bool isolateSelected) const
+void ZoneArray1::draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, Navigator *nav, int max_mag_star_name, float names_brightness, StarDrawTarget &target, const std::vector<bool> &selected_hip,  bool atmosphere, bool isolateSelected) const
 {
 	auto *const z = getZones() + index;
 	Vec3d xy;
@@ -322,7 +494,6 @@ void ZoneArray1::draw(int index,bool is_inside, const float *rcmag_table, Projec
 	                               * ((HipStarMgr::getCurrentJDay()-d2000)/365.25)
 	                               / star_position_scale;
 	for (const auto *s = z->getStars(); s < end; s++) {
-		double alt, az;
 		Vec3d starJ2000 = s->getJ2000Pos(z,movement_factor);
 		Vec3d local_pos = nav->earthEquToLocal(nav->j2000ToEarthEqu(starJ2000));
 		int hip = s->getHip();
@@ -334,48 +505,35 @@ void ZoneArray1::draw(int index,bool is_inside, const float *rcmag_table, Projec
 		if (variableStar)
 			mag *= it->second;
 		// Correct star position accounting for atmospheric refraction
-		if (atmosphere) {
-		    Utility::rectToSphe(&az,&alt,local_pos);
-		    //float press_temp_corr = (1013.f)/1010.f * 283.f/(273.f+10.f) / 60.f; //temperature and pressure correction based on Stellarium's code
-		    const float rad2deg = 180.0f/M_PI;
-		    const float deg2rad = M_PI/180.0f;
-		    float ha = rad2deg*alt;
-		    float r;
-		    if (ha>-5.0) r = 1.02f/tan((ha+10.3f/(ha+5.11f))*deg2rad)/60.0; else r=0.0f;
-		    //r = press_temp_corr * (1.f / tan((ha+7.31f/(ha+4.4f))*deg2rad) + 0.0013515f); //Bennett formula
-		    ha += r;
-		    alt = deg2rad*ha;
-		    Utility::spheToRect(az, alt, local_pos);
-		}
+		if (atmosphere)
+			refract(local_pos);
 		if (is_inside
 		        ? prj->projectLocal(local_pos,xy)
 		        : prj->projectLocalCheck(local_pos,xy)) {
-			if (hip_star_mgr.drawStar(prj,xy,rcmag_table + 2*(mag), HipStarMgr::color_table[s->getBVIndex()]) && !variableStar) {
+			if (hip_star_mgr.drawStar(target,prj,xy,rcmag_table + 2*(mag), HipStarMgr::color_table[s->getBVIndex()]) && !variableStar) {
 				break;
 			}
 			if (!isolateSelected) {
 				if (mag < max_mag_star_name) {
-					const std::string starname = s->getNameI18n();
+					const std::string &starname = s->getNameI18n();
 					if (!starname.empty()) {
 						Vec4f Color(HipStarMgr::color_table[s->getBVIndex()][0]*0.75,
 								HipStarMgr::color_table[s->getBVIndex()][1]*0.75,
 								HipStarMgr::color_table[s->getBVIndex()][2]*0.75,
 								names_brightness);
 						// prj->printGravity180(starFont,xy[0],xy[1], starname, Color, true, 4, 4);//, false);
-						starNameToDraw.push_back(std::make_tuple(xy[0],xy[1], starname, Color));
+						target.pushName(xy[0],xy[1], starname, Color, variableStar);
 					}
 				}
-			} else {
-				const std::string starname = s->getNameI18n();
-				if (selected_stars.find(starname) != selected_stars.end()) {
-					if (!starname.empty()) {
-						Vec4f Color(HipStarMgr::color_table[s->getBVIndex()][0]*0.75,
-								HipStarMgr::color_table[s->getBVIndex()][1]*0.75,
-								HipStarMgr::color_table[s->getBVIndex()][2]*0.75,
-								names_brightness);
-						// prj->printGravity180(starFont,xy[0],xy[1], starname, Color, true, 4, 4);//, false);
-						starNameToDraw.push_back(std::make_tuple(xy[0],xy[1], starname, Color));
-					}
+			} else if (selected_hip[hip]) {
+				const std::string &starname = s->getNameI18n();
+				if (!starname.empty()) {
+					Vec4f Color(HipStarMgr::color_table[s->getBVIndex()][0]*0.75,
+							HipStarMgr::color_table[s->getBVIndex()][1]*0.75,
+							HipStarMgr::color_table[s->getBVIndex()][2]*0.75,
+							names_brightness);
+					// prj->printGravity180(starFont,xy[0],xy[1], starname, Color, true, 4, 4);//, false);
+					target.pushName(xy[0],xy[1], starname, Color, variableStar);
 				}
 			}
 		}
@@ -409,65 +567,65 @@ template<class Star> SpecialZoneArray<Star>::~SpecialZoneArray(void)
 }
 
 template<class Star>
-void SpecialZoneArray<Star>::draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, Navigator *nav, int max_mag_star_name, float names_brightness, std::vector<starDBtoDraw> &starNameToDraw, std::map<std::string, bool> selected_stars,  bool atmosphere, bool isolateSelected) const
+void SpecialZoneArray<Star>::draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, Navigator *nav, int max_mag_star_name, float names_brightness, StarDrawTarget &target, const std::vector<bool> &selected_hip,  bool atmosphere, bool isolateSelected) const
 {
 	SpecialZoneData<Star> *const z = getZones() + index;
-	Vec3d xy;
-	const Star *const end = z->getStars() + z->size;
 	const double d2000 = 2451545.0;
 	const double movement_factor = (M_PI/180)*(0.0001/3600)
 	                               * ((HipStarMgr::getCurrentJDay()-d2000)/365.25)
 	                               / star_position_scale;
-	for (const Star *s=z->getStars(); s<end; s++) {
-		double alt, az;
-		Vec3d starJ2000 = s->getJ2000Pos(z,movement_factor);
-		Vec3d local_pos = nav->earthEquToLocal(nav->j2000ToEarthEqu(starJ2000));
-		int mag = s->getMag();
+	// Stars of a zone are sorted by magnitude, those after the first one too faint to be drawn are rejected at once
+	const Star *end = z->getStars();
+	for (const Star *const zone_end = z->getStars() + z->size; end < zone_end; end++) {
+		const float *const rc_mag = rcmag_table + 2*end->getMag();
+		if (rc_mag[0]<=0.f || rc_mag[1]<=0.f)
+			break;
+	}
+	const StarProjectionFrame &frame = hip_star_mgr.getProjectionFrame();
+	StarProjectionZone zone;
+	zone.set(z);
+	StarBatch batch;
+	Vec3d xy;
+	for (const Star *first=z->getStars(); first<end; first+=STAR_BATCH_SIZE) {
+		const int n = std::min<int>(STAR_BATCH_SIZE, end - first);
+		for (int i=0; i<n; i++)
+			first[i].getZonePos(movement_factor, batch.c0[i], batch.c1[i]);
+		for (int i=n; i<STAR_BATCH_SIZE; i++)
+			batch.c0[i] = batch.c1[i] = 0.;
+		starBatchToLocal(frame, zone, batch);
 		// Correct star position accounting for atmospheric refraction
 		if (atmosphere) {
-		    Utility::rectToSphe(&az,&alt,local_pos);
-		    //float press_temp_corr = (1013.f)/1010.f * 283.f/(273.f+10.f) / 60.f; //temperature and pressure correction based on Stellarium's code
-		    const float rad2deg = 180.0f/M_PI;
-		    const float deg2rad = M_PI/180.0f;
-		    float ha = rad2deg*alt;
-		    float r;
-		    if (ha>-5.0) r = 1.02f/tan((ha+10.3f/(ha+5.11f))*deg2rad)/60.0; else r=0.0f;
-		    //r = press_temp_corr * (1.f / tan((ha+7.31f/(ha+4.4f))*deg2rad) + 0.0013515f); //Bennett formula
-		    ha += r;
-		    alt = deg2rad*ha;
-		    Utility::spheToRect(az, alt, local_pos);
+			for (int i=0; i<n; i++) {
+				Vec3d local_pos(batch.x[i], batch.y[i], batch.z[i]);
+				refract(local_pos);
+				batch.x[i] = local_pos[0];
+				batch.y[i] = local_pos[1];
+				batch.z[i] = local_pos[2];
+			}
 		}
-		if (is_inside
-		        ? prj->projectLocal(local_pos,xy)
-		        : prj->projectLocalCheck(local_pos,xy)) {
-			if (hip_star_mgr.drawStar(prj,xy,rcmag_table + 2*(mag), HipStarMgr::color_table[s->getBVIndex()])) {
-				break;
+		unsigned int visible = starBatchProject(frame, !is_inside, batch) & ((1u << n) - 1);
+		for (int i=0; visible; i++, visible >>= 1) {
+			if (!(visible & 1))
+				continue;
+			const Star *const s = first + i;
+			const int mag = s->getMag();
+			xy.set(batch.winX[i], batch.winY[i], 0.);
+			if (hip_star_mgr.drawStar(target,prj,xy,rcmag_table + 2*(mag), HipStarMgr::color_table[s->getBVIndex()])) {
+				return;
 			}
 			if (!isolateSelected) {
 				if (mag < max_mag_star_name) {
-					const std::string starname = s->getNameI18n();
+					const std::string &starname = s->getNameI18n();
 					if (!starname.empty()) {
 						Vec4f Color(HipStarMgr::color_table[s->getBVIndex()][0]*0.75,
 								HipStarMgr::color_table[s->getBVIndex()][1]*0.75,
 								HipStarMgr::color_table[s->getBVIndex()][2]*0.75,
 								names_brightness);
-						// prj->printGravity180(starFont,xy[0],xy[1], starname, Color, true, 4, 4);//, false);
-						starNameToDraw.push_back(std::make_tuple(xy[0],xy[1], starname, Color));
-					}
-				}
-			} else {
-				const std::string starname = s->getNameI18n();
-				if (selected_stars.find(starname) != selected_stars.end()) {
-					if (!starname.empty()) {
-						Vec4f Color(HipStarMgr::color_table[s->getBVIndex()][0]*0.75,
-								HipStarMgr::color_table[s->getBVIndex()][1]*0.75,
-								HipStarMgr::color_table[s->getBVIndex()][2]*0.75,
-								names_brightness);
-						// prj->printGravity180(starFont,xy[0],xy[1], starname, Color, true, 4, 4);//, false);
-						starNameToDraw.push_back(std::make_tuple(xy[0],xy[1], starname, Color));
+						target.pushName(xy[0],xy[1], starname, Color, false);
 					}
 				}
 			}
+			// In isolate mode, only named stars of ZoneArray1 can be selected
 		}
 	}
 }
@@ -489,7 +647,7 @@ void SpecialZoneArray<Star>::searchAround(int index,const Vec3d &v, double cos_l
 }
 
 template<class Star>
-SpecialZoneArray<Star>::SpecialZoneArray(FILE *f,bool byte_swap,bool use_mmap, const HipStarMgr &hip_star_mgr, int level, int mag_min,int mag_range, int mag_steps)
+SpecialZoneArray<Star>::SpecialZoneArray(FILE *f,bool byte_swap,bool use_mmap, const HipStarMgr &hip_star_mgr, int level, int mag_min,int mag_range, int mag_steps, const std::string &file_name, bool deferred)
 	:ZoneArray(hip_star_mgr,level, mag_min,mag_range,mag_steps), stars(0),
 	 #ifdef __linux__
 	 mmap_start(MAP_FAILED)
@@ -497,6 +655,8 @@ SpecialZoneArray<Star>::SpecialZoneArray(FILE *f,bool byte_swap,bool use_mmap, c
 	 mmap_start(NULL), mapping_handle(NULL)
 	 #endif /* LINUX */
 {
+	this->file_name = file_name;
+	this->use_mmap = use_mmap;
 	if (nr_of_zones > 0) {
 		zones = new SpecialZoneData<Star>[nr_of_zones];
 		if (zones == 0) {
@@ -530,94 +690,106 @@ SpecialZoneArray<Star>::SpecialZoneArray(FILE *f,bool byte_swap,bool use_mmap, c
 			if (zones) delete[] getZones();
 			zones = 0;
 			nr_of_zones = 0;
+		} else if (deferred) {
+			stars_offset = ftell(f);
+			state = ZONE_ARRAY_DEFERRED;
+		} else if (loadStars(f)) {
+			state = ZONE_ARRAY_LOADED;
 		} else {
-			if (use_mmap) {
-				const int64_t start_in_file = ftell(f);
-				#ifdef __linux__
-				const int64_t page_size = sysconf(_SC_PAGE_SIZE);
-				#else
-				SYSTEM_INFO system_info;
-				GetSystemInfo(&system_info);
-				const int64_t page_size = system_info.dwAllocationGranularity;
-				#endif /* LINUX */
-				const int64_t mmap_offset = start_in_file % page_size;
-				#ifdef __linux__
-				mmap_start = mmap(0,mmap_offset+sizeof(Star)*nr_of_stars,PROT_READ, MAP_PRIVATE | MAP_NORESERVE, fileno(f),start_in_file-mmap_offset);
-				if (mmap_start == MAP_FAILED) {
-					std::cerr << "ERROR: SpecialZoneArray(" << level << ")::SpecialZoneArray:  mmap(" << fileno(f) << ',' << start_in_file << ','
-							  << (sizeof(Star)*nr_of_stars) << ") failed: " << strerror(errno) << std::endl;
-					stars = 0;
-					nr_of_stars = 0;
-					delete[] getZones();
-					zones = 0;
-					nr_of_zones = 0;
-				} else {
-					stars = (Star*)(((char*)mmap_start)+mmap_offset);
-					Star *s = stars;
-					for (unsigned int z=0; z<nr_of_zones; z++) {
-						getZones()[z].stars = s;
-						s += getZones()[z].size;
-					}
-				}
-				#else
-				HANDLE file_handle = (void*)_get_osfhandle(_fileno(f));
-				if (file_handle == INVALID_HANDLE_VALUE) {
-					std::cerr << "ERROR: SpecialZoneArray(" << level << ")::SpecialZoneArray: _get_osfhandle(_fileno(f)) failed" << std::endl;
-				} else {
-					mapping_handle = CreateFileMapping(file_handle,NULL,PAGE_READONLY, 0,0,NULL);
-					if (mapping_handle == NULL) {
-						// yes, NULL indicates failure, not INVALID_HANDLE_VALUE
-						std::cerr << "ERROR: SpecialZoneArray(" << level << ")::SpecialZoneArray: CreateFileMapping failed: " << GetLastError() << std::endl;
-					} else {
-						mmap_start = MapViewOfFile(mapping_handle,
-						                           FILE_MAP_READ,
-						                           0,
-						                           start_in_file-mmap_offset,
-						                           mmap_offset+sizeof(Star)*nr_of_stars);
-						if (mmap_start == NULL) {
-							std::cerr << "ERROR: SpecialZoneArray(" << level
-							     << ")::SpecialZoneArray: "
-							     "MapViewOfFile failed: " << GetLastError()
-							     << ", page_size: " << page_size << std::endl;
-							stars = 0;
-							nr_of_stars = 0;
-							delete[] getZones();
-							zones = 0;
-							nr_of_zones = 0;
-						} else {
-							stars = (Star*)(((char*)mmap_start)+mmap_offset);
-							Star *s = stars;
-							for (unsigned int z=0; z<nr_of_zones; z++) {
-								getZones()[z].stars = s;
-								s += getZones()[z].size;
-							}
-						}
-					}
-				}
-				#endif /* LINUX */
+			nr_of_stars = 0;
+			delete[] getZones();
+			zones = 0;
+			nr_of_zones = 0;
+		}
+	}
+}
+
+template<class Star>
+bool SpecialZoneArray<Star>::loadStars(FILE *f)
+{
+	bool mapped = false;
+	if (use_mmap) {
+		const int64_t start_in_file = ftell(f);
+		#ifdef __linux__
+		const int64_t page_size = sysconf(_SC_PAGE_SIZE);
+		#else
+		SYSTEM_INFO system_info;
+		GetSystemInfo(&system_info);
+		const int64_t page_size = system_info.dwAllocationGranularity;
+		#endif /* LINUX */
+		const int64_t mmap_offset = start_in_file % page_size;
+		#ifdef __linux__
+		mmap_start = mmap(0,mmap_offset+sizeof(Star)*nr_of_stars,PROT_READ, MAP_PRIVATE | MAP_NORESERVE, fileno(f),start_in_file-mmap_offset);
+		if (mmap_start == MAP_FAILED) {
+			std::cerr << "ERROR: SpecialZoneArray(" << level << ")::SpecialZoneArray:  mmap(" << fileno(f) << ',' << start_in_file << ','
+					  << (sizeof(Star)*nr_of_stars) << ") failed: " << strerror(errno) << std::endl;
+		} else {
+			stars = (Star*)(((char*)mmap_start)+mmap_offset);
+			// the zones are read in the order of the view, no read ahead: only the pages of the drawn zones are resident
+			madvise(mmap_start, mmap_offset+sizeof(Star)*nr_of_stars, MADV_RANDOM);
+			advised.assign(nr_of_zones, 0);
+			mapped = true;
+		}
+		#else
+		HANDLE file_handle = (void*)_get_osfhandle(_fileno(f));
+		if (file_handle == INVALID_HANDLE_VALUE) {
+			std::cerr << "ERROR: SpecialZoneArray(" << level << ")::SpecialZoneArray: _get_osfhandle(_fileno(f)) failed" << std::endl;
+		} else if ((mapping_handle = CreateFileMapping(file_handle,NULL,PAGE_READONLY, 0,0,NULL)) == NULL) {
+			// yes, NULL indicates failure, not INVALID_HANDLE_VALUE
+			std::cerr << "ERROR: SpecialZoneArray(" << level << ")::SpecialZoneArray: CreateFileMapping failed: " << GetLastError() << std::endl;
+		} else {
+			mmap_start = MapViewOfFile(mapping_handle,
+			                           FILE_MAP_READ,
+			                           0,
+			                           start_in_file-mmap_offset,
+			                           mmap_offset+sizeof(Star)*nr_of_stars);
+			if (mmap_start == NULL) {
+				std::cerr << "ERROR: SpecialZoneArray(" << level
+				     << ")::SpecialZoneArray: "
+				     "MapViewOfFile failed: " << GetLastError()
+				     << ", page_size: " << page_size << std::endl;
+				CloseHandle(mapping_handle);
+				mapping_handle = NULL;
 			} else {
-				stars = new Star[nr_of_stars];
-				if (stars == 0) {
-					std::cerr << "ERROR: SpecialZoneArray(" << level << ")::SpecialZoneArray: no memory (3)" << std::endl;
-					exit(1);
-				}
-				if (!readStarFile(f,stars,sizeof(Star)*nr_of_stars)) {
-					delete[] stars;
-					stars = 0;
-					nr_of_stars = 0;
-					delete[] getZones();
-					zones = 0;
-					nr_of_zones = 0;
-				} else {
-					Star *s = stars;
-					for (unsigned int z=0; z<nr_of_zones; z++) {
-						getZones()[z].stars = s;
-						s += getZones()[z].size;
-					}
-				}
+				stars = (Star*)(((char*)mmap_start)+mmap_offset);
+				mapped = true;
 			}
 		}
+		#endif /* LINUX */
+	}
+	if (!mapped) {
+		// the stars are read in memory when they can't be mapped
+		stars = new Star[nr_of_stars];
+		if (stars == 0) {
+			std::cerr << "ERROR: SpecialZoneArray(" << level << ")::SpecialZoneArray: no memory (3)" << std::endl;
+			exit(1);
+		}
+		if (!readStarFile(f,stars,sizeof(Star)*nr_of_stars)) {
+			delete[] stars;
+			stars = 0;
+			return false;
+		}
 	}
+	Star *s = stars;
+	for (unsigned int z=0; z<nr_of_zones; z++) {
+		getZones()[z].stars = s;
+		s += getZones()[z].size;
+	}
+	return true;
+}
+
+template<class Star>
+void SpecialZoneArray<Star>::adviseZone(int index) const
+{
+	#ifdef __linux__
+	static const uintptr_t page_size = sysconf(_SC_PAGE_SIZE);
+	const SpecialZoneData<Star> *const z = getZones() + index;
+	if (z->size == 0)
+		return;
+	const uintptr_t begin = (uintptr_t) z->getStars() & ~(page_size - 1);
+	const uintptr_t end = (uintptr_t) (z->getStars() + z->size);
+	madvise((void *) begin, end - begin, MADV_WILLNEED);
+	#endif /* LINUX */
 }
 
 } // namespace BigStarCatalog
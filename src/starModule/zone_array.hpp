@@ -25,6 +25,9 @@
 #define _ZONE_ARRAY_HPP_
 
 #include <SDL2/SDL_endian.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
 
 
 //#include "spacecrafter.hpp"
@@ -61,14 +64,30 @@ class s_texture;
 #endif
 
 
+// The stars of a converted catalogue start on this boundary, a multiple of the page size
+// and of the allocation granularity of windows
+#define STAR_FILE_ALIGNMENT 65536
+
 namespace BigStarCatalog {
 
 // A ZoneArray manages all ZoneData structures of a given GeodesicGrid level.
+// The stars of a deferred ZoneArray are only read by load(), meanwhile its zones can be initialized but not drawn.
+
+enum ZoneArrayState {
+	ZONE_ARRAY_DEFERRED,
+	ZONE_ARRAY_LOADING,
+	ZONE_ARRAY_LOADED,
+	ZONE_ARRAY_FAILED
+};
 
 class ZoneArray {
 
 public:
-	static ZoneArray *create(const HipStarMgr &hip_star_mgr, const std::string &extended_file_name);
+	//! read the header and the zone sizes of the file, and its stars if its level is below deferred_level
+	//! a file with Hipparcos stars is never deferred, they are needed by the hip index
+	static ZoneArray *create(const HipStarMgr &hip_star_mgr, const std::string &extended_file_name, int deferred_level);
+	//! write a copy of the catalogue src in native byte order, with its stars aligned on STAR_FILE_ALIGNMENT
+	static bool convert(const std::string &src, const std::string &dst);
 	virtual ~ZoneArray(void) {
 		nr_of_zones = 0;
 	}
@@ -85,11 +104,40 @@ public:
 	virtual void removeAllVariableStar(void) {};
 	virtual float checkMag(int hip) {return -1;};
 
-	virtual void draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, Navigator *nav, int max_mag_star_name, float names_brightness, std::vector<starDBtoDraw> &starNameToDraw, std::map<std::string, bool> selected_stars, bool atmosphere, bool isolateSelected) const = 0;
+	virtual void draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, Navigator *nav, int max_mag_star_name, float names_brightness, StarDrawTarget &target, const std::vector<bool> &selected_hip, bool atmosphere, bool isolateSelected) const = 0;
 
 	bool isInitialized(void) const {
 		return (nr_of_zones>0);
 	}
+	//! tell if the stars can be drawn
+	bool isLoaded(void) const {
+		return state.load(std::memory_order_acquire) == ZONE_ARRAY_LOADED;
+	}
+	//! return true only for the first call on a deferred ZoneArray, the caller must then call load()
+	bool startLoading(void) {
+		int expected = ZONE_ARRAY_DEFERRED;
+		return state.compare_exchange_strong(expected, ZONE_ARRAY_LOADING);
+	}
+	//! read the stars of a deferred ZoneArray, can be called from any thread
+	void load(void);
+	//! brightness of the stars of a deferred ZoneArray read less than duration seconds ago, from 0 to 1
+	//! the stars read by create() are at 1
+	float getFadeIn(float duration) const {
+		const float age = std::chrono::duration<float>(std::chrono::steady_clock::now() - loaded_time).count();
+		return (age < duration) ? age / duration : 1.f;
+	}
+	int getZoneSize(int index) const {
+		return zones[index].size;
+	}
+	//! tell the system that the mapped stars of the zone are going to be read
+	//! the hint is only given when the zone was not drawn in the previous frame, frame starts at 2
+	void willDraw(int index, unsigned int frame) {
+		if (advised.empty())
+			return;
+		if (advised[index] + 1 < frame)
+			adviseZone(index);
+		advised[index] = frame;
+	}
 	void initTriangle(int index, const Vec3d &c0, const Vec3d &c1, const Vec3d &c2);
 	virtual void scaleAxis(void) = 0;
 	const int level;
@@ -102,15 +150,24 @@ public:
 protected:
 	static bool readStarFile(FILE *f, void *data,size_t size);
 	ZoneArray(const HipStarMgr &hip_star_mgr,int level, int mag_min,int mag_range,int mag_steps);
+	//! read the stars from the current position of f, the zones are left untouched on failure
+	virtual bool loadStars(FILE *f) = 0;
+	virtual void adviseZone(int index) const = 0;
 	unsigned int nr_of_zones;
 	unsigned int nr_of_stars;
 	ZoneData *zones;
+	std::string file_name;
+	bool use_mmap;
+	long stars_offset; // position of the stars in the file
+	std::atomic<int> state;
+	std::chrono::steady_clock::time_point loaded_time; // end of load(), published by state
+	std::vector<unsigned int> advised; // last frame where each zone was drawn, empty if the stars are not mapped
 };
 
 
 template<class Star> class SpecialZoneArray : public ZoneArray {
 public:
-	SpecialZoneArray(FILE *f,bool byte_swap,bool use_mmap, const HipStarMgr &hip_star_mgr,int level, int mag_min,int mag_range,int mag_steps);
+	SpecialZoneArray(FILE *f,bool byte_swap,bool use_mmap, const HipStarMgr &hip_star_mgr,int level, int mag_min,int mag_range,int mag_steps, const std::string &file_name = "", bool deferred = false);
 	~SpecialZoneArray(void);
 
 protected:
@@ -125,8 +182,10 @@ private:
 	HANDLE mapping_handle;
 	#endif
 	void scaleAxis(void) override;
+	bool loadStars(FILE *f) override;
+	void adviseZone(int index) const override;
 	void searchAround(int index,const Vec3d &v,double cos_lim_fov, std::vector<ObjectBaseP > &result) override;
-	void draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, Navigator *nav, int max_mag_star_name, float names_brightness, std::vector<starDBtoDraw> &starNameToDraw, std::map<std::string, bool> selected_stars, bool atmosphere, bool isolateSelected) const override;
+	void draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, Navigator *nav, int max_mag_star_name, float names_brightness, StarDrawTarget &target, const std::vector<bool> &selected_hip, bool atmosphere, bool isolateSelected) const override;
 };
 
 template<class Star> void SpecialZoneArray<Star>::scaleAxis(void)
@@ -148,8 +207,8 @@ struct HipIndexStruct {
 
 class ZoneArray1 : public SpecialZoneArray<Star1> {
 public:
-	ZoneArray1(FILE *f,bool byte_swap,bool use_mmap, const HipStarMgr &hip_star_mgr, int level,int mag_min,int mag_range,int mag_steps)
-		: SpecialZoneArray<Star1>(f,byte_swap,use_mmap,hip_star_mgr,level, mag_min,mag_range,mag_steps) {}
+	ZoneArray1(FILE *f,bool byte_swap,bool use_mmap, const HipStarMgr &hip_star_mgr, int level,int mag_min,int mag_range,int mag_steps, const std::string &file_name)
+		: SpecialZoneArray<Star1>(f,byte_swap,use_mmap,hip_star_mgr,level, mag_min,mag_range,mag_steps, file_name) {}
 
 	void hideStar(int hip) override;
 	void showStar(int hip) override;
@@ -158,7 +217,7 @@ public:
 	void removeVariableStar(int hip) override;
 	void removeAllVariableStar(void) override;
 	virtual float checkMag(int hip) override;
-	virtual void draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, Navigator *nav, int max_mag_star_name, float names_brightness, std::vector<starDBtoDraw> &starNameToDraw, std::map<std::string, bool> selected_stars, bool atmosphere, bool isolateSelected) const override;
+	virtual void draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, Navigator *nav, int max_mag_star_name, float names_brightness, StarDrawTarget &target, const std::vector<bool> &selected_hip, bool atmosphere, bool isolateSelected) const override;
 private:
 	void updateHipIndex(HipIndexStruct hip_index[]) const override;
 	std::set<int> hide_stars;
@@ -0,0 +1,99 @@
+/*
+ * SpscQueue
+ *
+ * Copyright 2020 Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef _SPSC_QUEUE_HPP_
+#define _SPSC_QUEUE_HPP_
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <utility>
+
+/*! \class SpscQueue
+ * \brief bounded lock-free queue between exactly one producer thread and one consumer thread
+ *
+ * \details The capacity is rounded up to a power of two. Each side keeps a copy of the
+ * other side's index and only reloads it when the queue looks full or empty, so a burst
+ * costs one atomic store per element. The slots are reused, a std::string keeps its capacity.
+ */
+template<class T>
+class SpscQueue {
+public:
+	explicit SpscQueue(size_t capacity) {
+		size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+		slots = std::make_unique<T[]>(size);
+		mask = size - 1;
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	//! producer side, value is only moved from when true is returned
+	bool push(T &&value) {
+		const size_t t = tail.load(std::memory_order_relaxed);
+		if (t - cachedHead > mask) {
+			cachedHead = head.load(std::memory_order_acquire);
+			if (t - cachedHead > mask)
+				return false;
+		}
+		slots[t & mask] = std::move(value);
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! consumer side, return false if the queue is empty
+	bool pop(T &value) {
+		const size_t h = head.load(std::memory_order_relaxed);
+		if (h == cachedTail) {
+			cachedTail = tail.load(std::memory_order_acquire);
+			if (h == cachedTail)
+				return false;
+		}
+		value = std::move(slots[h & mask]);
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! approximate when called from a third thread
+	bool empty() const {
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+	}
+
+	size_t capacity() const {
+		return mask + 1;
+	}
+
+private:
+	std::unique_ptr<T[]> slots;
+	size_t mask;
+	// written by the consumer
+	alignas(64) std::atomic<size_t> head{0};
+	size_t cachedTail = 0;
+	// written by the producer
+	alignas(64) std::atomic<size_t> tail{0};
+	size_t cachedHead = 0;
+};
+
+#endif // _SPSC_QUEUE_HPP_
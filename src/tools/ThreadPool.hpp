@@ -2,7 +2,7 @@
 #define THREAD_POOL_HPP
 
 #include <vector>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -10,48 +10,327 @@
 #include <future>
 #include <functional>
 #include <stdexcept>
+#include <atomic>
+#include <type_traits>
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <chrono>
 
+// Move-only callable, small callables are stored inline to avoid the
+// allocations of std::function
+class ThreadTask {
+public:
+    static constexpr size_t INLINE_SIZE = 96;
+
+    ThreadTask() = default;
+
+    template<class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, ThreadTask>>>
+    ThreadTask(F&& f) {
+        using T = std::decay_t<F>;
+        if constexpr (sizeof(T) <= INLINE_SIZE && alignof(T) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<T>) {
+            new (storage) T(std::forward<F>(f));
+            ops = &inlineOps<T>;
+        } else {
+            *reinterpret_cast<T**>(storage) = new T(std::forward<F>(f));
+            ops = &heapOps<T>;
+        }
+    }
+
+    ThreadTask(ThreadTask&& other) noexcept : ops(other.ops) {
+        if (ops) {
+            ops->move(storage, other.storage);
+            other.ops = nullptr;
+        }
+    }
+
+    ThreadTask& operator=(ThreadTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            ops = other.ops;
+            if (ops) {
+                ops->move(storage, other.storage);
+                other.ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    ThreadTask(const ThreadTask&) = delete;
+    ThreadTask& operator=(const ThreadTask&) = delete;
+
+    ~ThreadTask() {
+        reset();
+    }
+
+    void operator()() {
+        ops->call(storage);
+    }
+
+    explicit operator bool() const {
+        return ops != nullptr;
+    }
+
+private:
+    struct Ops {
+        void (*call)(void*);
+        void (*move)(void* dst, void* src); // move src into dst and destroy src
+        void (*destroy)(void*);
+    };
+
+    template<class T>
+    static inline const Ops inlineOps = {
+        [](void* p) { (*static_cast<T*>(p))(); },
+        [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); static_cast<T*>(src)->~T(); },
+        [](void* p) { static_cast<T*>(p)->~T(); }
+    };
+
+    template<class T>
+    static inline const Ops heapOps = {
+        [](void* p) { (**static_cast<T**>(p))(); },
+        [](void* dst, void* src) { *static_cast<T**>(dst) = *static_cast<T**>(src); },
+        [](void* p) { delete *static_cast<T**>(p); }
+    };
+
+    void reset() {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+    const Ops* ops = nullptr;
+};
+
+// Work-stealing pool: every worker owns a deque, it pops the tasks it pushed
+// from the back and steals from the front of the other deques when it runs out.
+// Threads outside the pool push their tasks round-robin on the workers.
 class ThreadPool {
 public:
     ThreadPool(size_t);
+    ~ThreadPool();
+
+    // pool shared by the whole process, with one worker less than the hardware threads
+    // since the threads waiting on it run its tasks meanwhile
+    static ThreadPool& shared();
+
+    // run f(args...) on the pool and get its result through a future
     template<class F, class... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type>;
-    ~ThreadPool();
+
+    // run f on the pool without result, doesn't allocate if f fits in ThreadTask
+    template<class F>
+    void submit(F&& f) {
+        push(ThreadTask(std::forward<F>(f)));
+    }
+
+    // call f(first, last) on ranges of at most grain indices covering [begin, end)
+    // the calling thread takes part in the work and returns once every range is done
+    template<class F>
+    void parallelFor(size_t begin, size_t end, size_t grain, F&& f);
+
+    // run one pending task in the calling thread
+    // return false if there was no task to run
+    bool runPendingTask();
+
+    size_t size() const {
+        return workers.size();
+    }
+
 private:
+    struct alignas(64) WorkerQueue {
+        std::mutex lock;
+        std::deque<ThreadTask> tasks;
+    };
+
+    void push(ThreadTask&& task);
+    bool pop(size_t index, ThreadTask& task);
+    void workerLoop(size_t index);
+
     // need to keep track of threads so we can join them
     std::vector< std::thread > workers;
-    // the task queue
-    std::queue< std::function<void()> > tasks;
+    std::unique_ptr<WorkerQueue[]> queues;
+    size_t nbQueues;
+
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> nextQueue{0};
+    std::atomic<int> sleeping{0};
+    std::atomic<bool> stop{false};
 
-    // synchronization
-    std::mutex queue_mutex;
+    // synchronization of the sleeping workers only
+    std::mutex sleep_mutex;
     std::condition_variable condition;
-    bool stop;
+
+    // pool and queue of the worker running on this thread
+    static inline thread_local ThreadPool* currentPool = nullptr;
+    static inline thread_local size_t currentIndex = 0;
+};
+
+// Set of tasks which can be waited together, without future nor allocation
+class TaskGroup {
+public:
+    TaskGroup(ThreadPool& pool) : pool(pool) {}
+    ~TaskGroup() {
+        join();
+    }
+
+    template<class F>
+    void run(F&& f) {
+        // counted before submit, a task can end before submit returns
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++pending;
+        }
+        try {
+            pool.submit([this, f = std::forward<F>(f)]() mutable {
+                std::exception_ptr caught;
+                try {
+                    f();
+                } catch (...) {
+                    caught = std::current_exception();
+                }
+                // notified under the lock, so the group can't be destroyed before the end of the notification
+                std::lock_guard<std::mutex> lock(mutex);
+                if (caught && !error)
+                    error = caught;
+                if (--pending == 0)
+                    done.notify_all();
+            });
+        } catch (...) {
+            // the task was not queued, join must not wait for it
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0)
+                done.notify_all();
+            throw;
+        }
+    }
+
+    // wait for all the tasks of the group, the calling thread runs pending tasks meanwhile
+    // and sleeps when there is none left to run
+    // rethrow the first exception thrown by a task
+    void wait() {
+        join();
+        if (error)
+            std::rethrow_exception(std::exchange(error, nullptr));
+    }
+
+private:
+    void join() {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (pending == 0)
+                    return;
+            }
+            if (pool.runPendingTask())
+                continue;
+            // the timeout catches up with the tasks pushed after runPendingTask gave up,
+            // which no sleeping worker may take if every worker is itself waiting
+            std::unique_lock<std::mutex> lock(mutex);
+            if (done.wait_for(lock, std::chrono::milliseconds(1), [this]{ return pending == 0; }))
+                return;
+        }
+    }
+
+    ThreadPool& pool;
+    size_t pending = 0;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
 };
 
+inline ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool(std::max(2u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
 // the constructor just launches some amount of workers
 inline ThreadPool::ThreadPool(size_t threads)
-    :   stop(false)
+    :   nbQueues(threads > 0 ? threads : 1)
 {
+    queues = std::make_unique<WorkerQueue[]>(nbQueues);
     for(size_t i = 0;i<threads;++i)
-        workers.emplace_back(
-            [this]
-            {
-                for(;;)
-                {
-                    std::function<void()> task;
-                    {
-                        std::unique_lock<std::mutex> lock(this->queue_mutex);
-                        this->condition.wait(lock,[this]{ return this->stop || !this->tasks.empty(); });
-                        if(this->stop && this->tasks.empty())
-                            return;
-                        task = std::move(this->tasks.front());
-                        this->tasks.pop();
-                    }
-                    task();
-                }
-            }
-        );
+        workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+inline void ThreadPool::workerLoop(size_t index)
+{
+    currentPool = this;
+    currentIndex = index;
+    for(;;)
+    {
+        ThreadTask task;
+        if (pop(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleeping.fetch_add(1);
+        condition.wait(lock, [this]{ return stop.load() || queued.load() > 0; });
+        sleeping.fetch_sub(1);
+        if(stop.load() && queued.load() == 0)
+            return;
+    }
+}
+
+inline void ThreadPool::push(ThreadTask&& task)
+{
+    // don't allow enqueueing after stopping the pool
+    if(stop.load(std::memory_order_relaxed))
+        throw std::runtime_error("enqueue on stopped ThreadPool");
+
+    // a worker keeps its own tasks, the others are spread over the workers
+    const size_t index = (currentPool == this) ? currentIndex : nextQueue.fetch_add(1, std::memory_order_relaxed) % nbQueues;
+    {
+        std::lock_guard<std::mutex> lock(queues[index].lock);
+        queues[index].tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1);
+    // a sleeping worker either sees queued > 0 or is waiting when notified
+    if (sleeping.load() > 0) {
+        { std::lock_guard<std::mutex> lock(sleep_mutex); }
+        condition.notify_one();
+    }
+}
+
+inline bool ThreadPool::pop(size_t index, ThreadTask& task)
+{
+    if (queued.load(std::memory_order_relaxed) == 0)
+        return false;
+    {
+        WorkerQueue &own = queues[index];
+        std::lock_guard<std::mutex> lock(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    for (size_t i = 1; i < nbQueues; ++i) {
+        WorkerQueue &victim = queues[(index + i) % nbQueues];
+        std::unique_lock<std::mutex> lock(victim.lock, std::try_to_lock);
+        if (lock.owns_lock() && !victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool ThreadPool::runPendingTask()
+{
+    ThreadTask task;
+    const size_t index = (currentPool == this) ? currentIndex : nextQueue.load(std::memory_order_relaxed) % nbQueues;
+    if (!pop(index, task))
+        return false;
+    task();
+    return true;
 }
 
 // add new work item to the pool
@@ -60,19 +339,38 @@ auto ThreadPool::enqueue(F&& f, Args&&... args) -> std::future<typename std::inv
 {
     using return_type = typename std::invoke_result<F, Args...>::type;
 
-    auto task = std::make_shared< std::packaged_task<return_type()> >(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-
-    std::future<return_type> res = task->get_future();
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        // don't allow enqueueing after stopping the pool
-        if(stop)
-            throw std::runtime_error("enqueue on stopped ThreadPool");
+    std::promise<return_type> promise;
+    std::future<return_type> res = promise.get_future();
+    submit([promise = std::move(promise), f = std::forward<F>(f), ...args = std::forward<Args>(args)]() mutable {
+        try {
+            if constexpr (std::is_void_v<return_type>) {
+                std::invoke(std::move(f), std::move(args)...);
+                promise.set_value();
+            } else
+                promise.set_value(std::invoke(std::move(f), std::move(args)...));
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    });
+    return res;
+}
 
-        tasks.emplace([task](){ (*task)(); });
+template<class F>
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, F&& f)
+{
+    if (begin >= end)
+        return;
+    if (grain == 0)
+        grain = 1;
+    TaskGroup group(*this);
+    // the calling thread does the first range itself
+    size_t first = begin + grain;
+    for (; first < end; first += grain) {
+        const size_t last = std::min(first + grain, end);
+        group.run([&f, first, last] { f(first, last); });
     }
-    condition.notify_one();
-    return res;
+    f(begin, std::min(begin + grain, end));
+    group.wait();
 }
 
 
@@ -80,7 +378,7 @@ auto ThreadPool::enqueue(F&& f, Args&&... args) -> std::future<typename std::inv
 inline ThreadPool::~ThreadPool()
 {
     {
-        std::unique_lock<std::mutex> lock(queue_mutex);
+        std::unique_lock<std::mutex> lock(sleep_mutex);
         stop = true;
     }
     condition.notify_all();
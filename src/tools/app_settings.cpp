@@ -207,6 +207,11 @@ const std::string AppSettings::getLogDir() const
 	return getUserDir() + REP_LOG + "/";
 }
 
+const std::string AppSettings::getCacheDir() const
+{
+	return getUserDir() + REP_CACHE + "/";
+}
+
 const std::string AppSettings::getWebDir() const
 {
 	return getUserDir() + REP_WEB + "/";
@@ -248,6 +253,7 @@ void AppSettings::display_all() const
 	std::cout << "getScriptDir " << getScriptDir() << std::endl;
 	std::cout << "getUserDir " << getUserDir() << std::endl;
 	std::cout << "getLogDir " << getLogDir() << std::endl;
+	std::cout << "getCacheDir " << getCacheDir() << std::endl;
 	std::cout << "getWebDir " << getWebDir() << std::endl;
 	std::cout << "getLandscapeDir " << getLandscapeDir() << std::endl;
 	std::cout << "getSkyCultureDir " << getSkyCultureDir() << std::endl;
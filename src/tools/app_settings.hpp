@@ -84,6 +84,9 @@ public:
 	//! Get the fullname of the directory containing the log
 	const std::string getLogDir() const;
 
+	//! Get the fullname of the directory containing the files rebuilt from the data
+	const std::string getCacheDir() const;
+
 	//! Get the fullname of the directory containing the web server
 	const std::string getWebDir() const;
 
@@ -117,6 +117,7 @@ void CallSystem::checkUserSubDirectory(const std::string &CDIR, std::string& dir
 	listSubDirectory[REP_FTP]=true;
 	listSubDirectory[REP_LANDSCAPE]=true;
 	listSubDirectory[REP_LOG]=false;
+	listSubDirectory[REP_CACHE]=false;
 	listSubDirectory[REP_SCREENSHOT]=false;
 	listSubDirectory[REP_SCRIPT]=true;
 	listSubDirectory[REP_PICTURE]=false;
@@ -1,8 +1,10 @@
+#include <cstring>
 #include "tools/draw_helper.hpp"
 #include "tools/context.hpp"
 #include "EntityCore/EntityCore.hpp"
 #include "tools/s_texture.hpp"
 #include "tools/s_font.hpp"
+#include "tools/glyph_atlas.hpp"
 #include "coreModule/ubo_cam.hpp"
 #include "EntityCore/Resource/TileMap.hpp"
 #include "EntityCore/Core/RenderMgr.hpp"
@@ -13,6 +15,7 @@
 
 #define MAX_CMDS 128
 #define WRITE_PRINT(x, y, tx, ty) *(ptr++) = x; *(ptr++) = y; *(ptr++) = data.texture->tx; *ptr = data.texture->ty; ptr += 3
+#define WRITE_GLYPH(x, y, tx, ty) *(ptr++) = x; *(ptr++) = y; *(ptr++) = tx; *ptr = ty; ptr += 3
 #define WRITE_PRINTH(x, y, t1x, t1y, t2x, t2y) *(ptr++) = x; *(ptr++) = y; *(ptr++) = t1x; *(ptr++) = t1y; *(ptr++) = t2x; *(ptr++) = t2y
 
 DrawHelper::DrawHelper() : nebulaMat(*Context::instance->uniformMgr)
@@ -67,6 +70,10 @@ void DrawHelper::mainloop()
                 drawPrintH(data->printh);
                 lastFlag = DRAW_PRINTH;
                 break;
+            case DRAW_PRINT_RUN:
+                drawPrintRun(data->printrun);
+                lastFlag = DRAW_PRINT; // same pipeline
+                break;
             case DRAW_HINT:
                 drawHint(data->hint);
                 lastFlag = DRAW_HINT;
@@ -312,6 +319,54 @@ void DrawHelper::drawPrint(s_print &data)
     }
 }
 
+void DrawHelper::drawPrintRun(s_printrun &data)
+{
+    auto cmd = getCmd();
+    bindPrint(cmd);
+
+    // A single strip, glyphs are joined by two degenerated triangles
+    const int vertexCount = data.count * 6 - 2;
+    if (drawIdx + vertexCount > MAX_IDX)
+        drawIdx = 0;
+    layoutPrint->pushConstant(cmd, 0, &data.Color);
+    layoutPrint->pushConstant(cmd, 1, &data.MVP);
+    vkCmdDraw(cmd, vertexCount, 1, drawIdx, 0);
+    float *ptr = ((float *) Context::instance->multiVertexMgr->getPtr()) + drawIdx * 6;
+    drawIdx += vertexCount;
+    for (int i = 0; i < data.count; ++i) {
+        const GlyphQuad &q = data.quads[i];
+        const float x1 = data.x + q.x1;
+        const float x2 = data.x + q.x2;
+        if (data.h < 0) {
+            // upsidedown is true, the line is mirrored
+            const float y1 = data.y - data.h - q.y1;
+            const float y2 = data.y - data.h - q.y2;
+            if (i) {
+                memcpy(ptr, ptr - 6, 6 * sizeof(float));
+                ptr += 6;
+                WRITE_GLYPH(x2, y1, q.u2, q.v1);
+            }
+            WRITE_GLYPH(x2, y1, q.u2, q.v1);
+            WRITE_GLYPH(x1, y1, q.u1, q.v1);
+            WRITE_GLYPH(x2, y2, q.u2, q.v2);
+            WRITE_GLYPH(x1, y2, q.u1, q.v2);
+        } else {
+            // upsidedown is false
+            const float y1 = data.y + q.y1;
+            const float y2 = data.y + q.y2;
+            if (i) {
+                memcpy(ptr, ptr - 6, 6 * sizeof(float));
+                ptr += 6;
+                WRITE_GLYPH(x1, y1, q.u1, q.v1);
+            }
+            WRITE_GLYPH(x1, y1, q.u1, q.v1);
+            WRITE_GLYPH(x1, y2, q.u1, q.v2);
+            WRITE_GLYPH(x2, y1, q.u2, q.v1);
+            WRITE_GLYPH(x2, y2, q.u2, q.v2);
+        }
+    }
+}
+
 void DrawHelper::drawPrintH(s_printh &data)
 {
     auto cmd = getCmd();
@@ -12,6 +12,10 @@
 #include "tools/vecmath.hpp"
 
 #define MAX_IDX 64*1024
+// Vertices a frame can take in the ring without reaching those of the 2 other frames in flight
+#define MAX_FRAME_IDX ((MAX_IDX) / 3)
+// Vertices of a frame left to the glyph runs, 8K are kept for the other draws as before the glyph atlas
+#define MAX_GLYPH_IDX (MAX_FRAME_IDX - 8*1024)
 // This work while there is no more than 96 vertices, otherwise...
 #define MAX_HINT_IDX_ 32
 
@@ -19,10 +23,12 @@ class Hints;
 class s_texture;
 class VideoPlayer;
 class Body;
+struct GlyphQuad;
 
 enum DrawFlag {
     DRAW_PRINT = 1,
     DRAW_PRINTH,
+    DRAW_PRINT_RUN,
     DRAW_HINT,
     DRAW_NEBULA,
     SIGNAL_PASS,
@@ -52,6 +58,17 @@ struct s_printh {
     SubTexture *texture; // string, then border
 };
 
+struct s_printrun {
+    unsigned char flag;
+    unsigned short count; // number of glyphs
+    float x;
+    float y;
+    float h; // height of the line, negative for upsidedown
+    Vec4f Color;
+    const GlyphQuad *quads; // glyphs from (x, y)
+    Mat4f MVP;
+};
+
 struct s_sigpass {
     unsigned char flag;
     unsigned char subpass;
@@ -67,6 +84,7 @@ typedef union {
     unsigned char flag;
     s_print print;
     s_printh printh;
+    s_printrun printrun;
     struct s_hint {
         unsigned char flag;
         Vec4f color;
@@ -137,6 +155,7 @@ private:
     void endDrawCommand(unsigned char subpass); // Stop draw command recording
     void drawPrint(s_print &data);
     void drawPrintH(s_printh &data);
+    void drawPrintRun(s_printrun &data);
     void drawHint(DrawData::s_hint &data);
     void drawNebula(DrawData::s_nebula &data);
     void bindPrint(VkCommandBuffer cmd);
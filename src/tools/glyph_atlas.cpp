@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2020 of the LSS Team & Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include <cstring>
+#include "tools/glyph_atlas.hpp"
+
+GlyphShelfPacker::GlyphShelfPacker(int _width, int _height, int _padding) :
+	width(_width), height(_height), padding(_padding)
+{}
+
+bool GlyphShelfPacker::insert(int w, int h, int &x, int &y)
+{
+	w += padding;
+	h += padding;
+	if (w > width || h > height)
+		return false;
+	// the lowest shelf which can hold it, to keep the tall shelves for the tall glyphs
+	Shelf *best = nullptr;
+	for (auto &shelf : shelves) {
+		if (shelf.height >= h && shelf.x + w <= width && (!best || shelf.height < best->height))
+			best = &shelf;
+	}
+	if (!best) {
+		const int top = getUsedHeight();
+		if (top + h > height)
+			return false;
+		shelves.push_back({top, h, 0});
+		best = &shelves.back();
+	}
+	x = best->x;
+	y = best->y;
+	best->x += w;
+	return true;
+}
+
+void GlyphShelfPacker::clear()
+{
+	shelves.clear();
+}
+
+int GlyphShelfPacker::getUsedHeight() const
+{
+	return shelves.empty() ? 0 : shelves.back().y + shelves.back().height;
+}
+
+GlyphAtlas::GlyphAtlas(int _pageWidth, int _pageHeight, int _maxPages) :
+	pageWidth(_pageWidth), pageHeight(_pageHeight), maxPages(_maxPages)
+{}
+
+const GlyphInfo *GlyphAtlas::insert(uint32_t c, int w, int h, const uint32_t *pixels, int pitch, short offsetX, short offsetY, short advance)
+{
+	GlyphInfo info {0, 0, (unsigned short) w, (unsigned short) h, 0, offsetX, offsetY, advance};
+	if (w && h) {
+		int x, y;
+		int page = pages.size() - 1;
+		// a glyph which doesn't fit in the last page is tried in a new one
+		if (page < 0 || !pages[page].packer.insert(w, h, x, y)) {
+			if (++page >= maxPages)
+				return nullptr;
+			pages.emplace_back(pageWidth, pageHeight);
+			if (!pages[page].packer.insert(w, h, x, y)) {
+				pages.pop_back();
+				return nullptr;
+			}
+		}
+		Page &p = pages[page];
+		for (int i = 0; i < h; ++i)
+			memcpy(p.pixels.data() + (y + i) * pageWidth + x, pixels + i * pitch, w * sizeof(uint32_t));
+		p.dirty = true;
+		info.x = x;
+		info.y = y;
+		info.page = page;
+	}
+	return &(glyphs[c] = info);
+}
+
+void GlyphAtlas::clear()
+{
+	glyphs.clear();
+	pages.clear();
+}
+
+void GlyphAtlas::limitPages(int nbPages)
+{
+	maxPages = nbPages;
+	if ((int) pages.size() <= nbPages)
+		return;
+	pages.erase(pages.begin() + nbPages, pages.end());
+	for (auto it = glyphs.begin(); it != glyphs.end();) {
+		if (it->second.w && it->second.page >= nbPages)
+			it = glyphs.erase(it);
+		else
+			++it;
+	}
+}
+
+void GlyphAtlas::setPageRect(int page, float u1, float v1, float u2, float v2)
+{
+	Page &p = pages[page];
+	p.u1 = u1;
+	p.v1 = v1;
+	p.du = (u2 - u1) / pageWidth;
+	p.dv = (v2 - v1) / pageHeight;
+	p.dirty = false;
+}
+
+bool GlyphAtlas::decodeUTF8(const std::string &s, std::vector<uint32_t> &codepoints)
+{
+	codepoints.clear();
+	const unsigned char *ptr = (const unsigned char *) s.data();
+	const unsigned char *end = ptr + s.size();
+	while (ptr < end) {
+		uint32_t c = *(ptr++);
+		int following;
+		if (c < 0x80) {
+			codepoints.push_back(c);
+			continue;
+		} else if ((c & 0xe0) == 0xc0) {
+			c &= 0x1f;
+			following = 1;
+		} else if ((c & 0xf0) == 0xe0) {
+			c &= 0x0f;
+			following = 2;
+		} else if ((c & 0xf8) == 0xf0) {
+			c &= 0x07;
+			following = 3;
+		} else
+			return false;
+		if (end - ptr < following)
+			return false;
+		while (following--) {
+			if ((*ptr & 0xc0) != 0x80)
+				return false;
+			c = (c << 6) | (*(ptr++) & 0x3f);
+		}
+		codepoints.push_back(c);
+	}
+	return true;
+}
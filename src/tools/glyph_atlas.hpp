@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2020 of the LSS Team & Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// glyph atlas and glyph run layout, without any dependency to SDL or Vulkan
+
+#ifndef _GLYPH_ATLAS_H
+#define _GLYPH_ATLAS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#define GLYPH_PAGE_WIDTH 1024
+#define GLYPH_PADDING 1
+
+//! one glyph of a run, in pixels from the origin of the run and in texture coordinates
+struct GlyphQuad {
+	float x1, y1, x2, y2;
+	float u1, v1, u2, v2;
+};
+
+//! glyph stored in the atlas
+struct GlyphInfo {
+	unsigned short x, y;	//!< place of the bitmap in its page
+	unsigned short w, h;	//!< size of the bitmap, 0 for an invisible glyph
+	unsigned char page;
+	short offsetX;			//!< left of the bitmap from the pen position
+	short offsetY;			//!< top of the bitmap from the top of the line
+	short advance;			//!< pen move after this glyph
+};
+
+/**
+ * \class GlyphShelfPacker
+ * \brief place rectangles in a page, row by row
+ *
+ * The glyphs of a font have close heights, a rectangle goes in the lowest shelf
+ * which can hold it, a new shelf is opened when none fits.
+ */
+class GlyphShelfPacker {
+public:
+	GlyphShelfPacker(int width, int height, int padding = GLYPH_PADDING);
+	//! find room for a w*h rectangle, return false if the page is full
+	bool insert(int w, int h, int &x, int &y);
+	//! forget every rectangles
+	void clear();
+	//! height used by the shelves
+	int getUsedHeight() const;
+private:
+	struct Shelf {
+		int y;
+		int height;
+		int x; // first free column
+	};
+	std::vector<Shelf> shelves;
+	int width;
+	int height;
+	int padding;
+};
+
+/**
+ * \class GlyphAtlas
+ * \brief glyph bitmaps of one font packed into pages, and layout of strings into quads
+ *
+ * The bitmaps are RGBA, one uint32_t per pixel in the byte order of the texture.
+ * The owner uploads the dirty pages and tells where each page is in the texture with setPageRect.
+ */
+class GlyphAtlas {
+public:
+	GlyphAtlas(int pageWidth, int pageHeight, int maxPages);
+
+	//! return the glyph of the codepoint c, nullptr if it is not in the atlas
+	const GlyphInfo *find(uint32_t c) const {
+		auto it = glyphs.find(c);
+		return (it == glyphs.end()) ? nullptr : &it->second;
+	}
+	//! copy the w*h bitmap in the atlas, pitch is in pixels
+	//! return nullptr if every pages are full
+	const GlyphInfo *insert(uint32_t c, int w, int h, const uint32_t *pixels, int pitch, short offsetX, short offsetY, short advance);
+	//! remove every glyphs and pages
+	void clear();
+	//! keep only the first nbPages pages and their glyphs, no page is added after
+	void limitPages(int nbPages);
+
+	int getNbPages() const {
+		return pages.size();
+	}
+	int getPageWidth() const {
+		return pageWidth;
+	}
+	int getPageHeight() const {
+		return pageHeight;
+	}
+	const uint32_t *getPixels(int page) const {
+		return pages[page].pixels.data();
+	}
+	//! tell if the page changed since the last call to setPageRect
+	bool isDirty(int page) const {
+		return pages[page].dirty;
+	}
+	//! set where the page is in the texture, in texture coordinates
+	void setPageRect(int page, float u1, float v1, float u2, float v2);
+
+	//! decode an UTF-8 string, return false if it is malformed
+	static bool decodeUTF8(const std::string &s, std::vector<uint32_t> &codepoints);
+
+	//! append one quad per visible glyph of text, the pen starts at (x, y) on the top of the line
+	//! every glyph must be in the atlas, kerning(previous, current) give the pen adjustment between two glyphs
+	//! return the width of the run
+	template<class Kerning>
+	float layout(const std::vector<uint32_t> &text, float x, float y, std::vector<GlyphQuad> &quads, Kerning &&kerning) const {
+		float pen = x;
+		uint32_t previous = 0;
+		for (uint32_t c : text) {
+			auto it = glyphs.find(c);
+			if (it == glyphs.end())
+				continue;
+			const GlyphInfo &g = it->second;
+			if (previous)
+				pen += kerning(previous, c);
+			previous = c;
+			if (g.w) {
+				const Page &p = pages[g.page];
+				const float x1 = pen + g.offsetX;
+				const float y1 = y + g.offsetY;
+				quads.push_back({x1, y1, x1 + g.w, y1 + g.h,
+					p.u1 + g.x * p.du, p.v1 + g.y * p.dv, p.u1 + (g.x + g.w) * p.du, p.v1 + (g.y + g.h) * p.dv});
+			}
+			pen += g.advance;
+		}
+		return pen - x;
+	}
+
+private:
+	struct Page {
+		Page(int width, int height) : packer(width, height), pixels(width * height, 0) {}
+		GlyphShelfPacker packer;
+		std::vector<uint32_t> pixels;
+		float u1 = 0, v1 = 0;
+		float du = 0, dv = 0; // texture coordinates per pixel
+		bool dirty = true;
+	};
+	std::unordered_map<uint32_t, GlyphInfo> glyphs;
+	std::vector<Page> pages;
+	int pageWidth;
+	int pageHeight;
+	int maxPages;
+};
+
+#endif // _GLYPH_ATLAS_H
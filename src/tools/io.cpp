@@ -38,6 +38,18 @@
 #include <direct.h>
 #endif
 
+#ifdef LINUX
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+#include <system_error>
+#endif
+
 /*
 Application control server
 Utility: this program allows to talk with the application through the network
@@ -67,7 +79,6 @@ std::string toString(const T& t) //ServerSocket
 #define SMALL_BUFFER_SIZE 	512 //Buffer size considered dangerously small (must be larger than the messages that can be sent by the server)
 #define BIG_BUFFER_SIZE 	1048576 //Buffer size considered unnecessarily large
 
-
 ServerSocket::ServerSocket(unsigned int port)
 {
 	initErrorCode = init(port, MAX_CLIENTS, BUFFER_SIZE);
@@ -113,7 +124,10 @@ int ServerSocket::init(unsigned int port, unsigned int maxClients, unsigned int
 	initErrorCode = -1;
 	serverOpen = false;
 	stopThread = false;
+	threadReturnValue = IO_NO_ERROR;
+#ifndef LINUX
 	activeSocketsCount = 0;
+#endif
 	clientCount = 0;
 	broadcastId = 0;
 
@@ -129,6 +143,33 @@ int ServerSocket::init(unsigned int port, unsigned int maxClients, unsigned int
 	dataSend = 0;
 	requestSendFailed = 0;
 
+#ifdef LINUX
+	/* Creation of the epoll instance to monitor the sockets */
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (epollFd < 0) {
+		debugOut("EPOLL_CREATE_ERROR "+ (std::string)strerror(errno), LOG_TYPE::L_ERROR); //Debug
+		return EPOLL_CREATE_ERROR_CODE;
+	}
+
+	/* Creation of the eventfd which wakes the thread up when there is data to send */
+	wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (wakeFd < 0) {
+		debugOut("EVENTFD_CREATE_ERROR "+ (std::string)strerror(errno), LOG_TYPE::L_ERROR); //Debug
+		return EVENTFD_CREATE_ERROR_CODE;
+	}
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.u64 = maxClients + 1; //After the clients and the server
+	if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) < 0) {
+		debugOut("EPOLL_ADD_EVENTFD_ERROR "+ (std::string)strerror(errno), LOG_TYPE::L_ERROR); //Debug
+		return EVENTFD_CREATE_ERROR_CODE;
+	}
+
+	/* Initialization of the client table */
+	clientTab.resize(maxClients);
+	for (unsigned int i = maxClients; i > 0; i--)
+		freeClientTab.push_back(i - 1); //The lowest slots are taken first
+#else
 	/* Initialization of SDL_net */
 	if (SDLNet_Init() < 0) {
 		debugOut("SDL_NET_INIT_ERROR "+ (std::string)SDLNet_GetError(), LOG_TYPE::L_ERROR); //Debug
@@ -155,54 +196,601 @@ int ServerSocket::init(unsigned int port, unsigned int maxClients, unsigned int
 		return SDL_CREATEMUTEX_ERROR_CODE;
 	}
 
-	/* Initialization of the client sockets array */
-	clientSocketTab = new TCPsocket[maxClients]; //Allocation of the client sockets array
-	if(clientSocketTab == NULL) {
-		debugOut("NEW_TCPSOCKET_TAB_ERROR", LOG_TYPE::L_ERROR); //Debug
-		return NEW_TCPSOCKET_TAB_ERROR_CODE;
+	/* Initialization of the client sockets array */
+	clientSocketTab = new TCPsocket[maxClients]; //Allocation of the client sockets array
+	if(clientSocketTab == NULL) {
+		debugOut("NEW_TCPSOCKET_TAB_ERROR", LOG_TYPE::L_ERROR); //Debug
+		return NEW_TCPSOCKET_TAB_ERROR_CODE;
+	}
+	for (unsigned int i = 0; i < maxClients; i++)
+		clientSocketTab[i] = NULL; //Initialization of all client sockets to NULL
+#endif
+
+	clientBroadcastTab = new bool[maxClients];
+	if(clientBroadcastTab == NULL) {
+		debugOut("NEW_BOOL_TAB_ERROR", LOG_TYPE::L_ERROR); //Debug
+		return NEW_BOOL_TAB_ERROR_CODE;
+	}
+	for (unsigned int i = 0; i < maxClients; i++)
+		clientBroadcastTab[i] = false;
+
+	/* Initialization of the buffer */
+	buffer = new char[bufferSize];
+	if(buffer == NULL) {
+		debugOut("NEW_BUFFER_ERROR", LOG_TYPE::L_ERROR); //Debug
+		return NEW_BUFFER_ERROR_CODE;
+	}
+
+#ifndef LINUX
+	/* Creation of the mutex to protect the client input queue */
+	outputting = SDL_CreateMutex();
+	if (outputting == NULL) {
+		debugOut("SDL_CREATEMUTEX_ERROR "+ (std::string)SDLNet_GetError(), LOG_TYPE::L_ERROR); //Debug
+		return SDL_CREATEMUTEX_ERROR_CODE;
+	}
+
+	/* Creation of a mutex to protect the client exit queue */
+	inputting = SDL_CreateMutex();
+	if (inputting == NULL) {
+		debugOut("SDL_CREATEMUTEX_ERROR "+ (std::string)SDLNet_GetError(), LOG_TYPE::L_ERROR); //Debug
+		return SDL_CREATEMUTEX_ERROR_CODE;
+	}
+#endif
+
+	return IO_NO_ERROR; //No error
+}
+
+
+std::string ServerSocket::replace(std::string base, const std::string from, const std::string to)
+{
+	std::string SecureCopy = base;
+	for (size_t start_pos = SecureCopy.find(from); start_pos != std::string::npos; start_pos = SecureCopy.find(from,start_pos)) SecureCopy.replace(start_pos, from.length(), to);
+	return SecureCopy;
+}
+
+
+void ServerSocket::stats()
+{
+	debugOut("-- STATS --", LOG_TYPE::L_DEBUG); //Debug
+
+	if(connection) {
+		debugOut("CONNECTION "+ toString(connection) + " (" + toString(maxSimultaneousClient) + " max)", LOG_TYPE::L_DEBUG);
+		debugOut("REQUEST_RECIEVED "+ toString(requestRecieved) + " requests (" + toString(dataRecieved) + " bytes)", LOG_TYPE::L_DEBUG);
+		debugOut("REQUEST_SEND "+ toString(requestSend) + " requests (" + toString(dataSend) + " bytes)", LOG_TYPE::L_DEBUG);
+
+		debugOut("CONNECTION "+ humanReadable(connection) + " (" + humanReadable(maxSimultaneousClient) + " max)", LOG_TYPE::L_INFO);
+		debugOut("REQUEST_RECIEVED "+ humanReadable(requestRecieved) + " (" + humanReadable(dataRecieved) + "B)", LOG_TYPE::L_INFO);
+		debugOut("REQUEST_SEND "+ humanReadable(requestSend) + " (" + humanReadable(dataSend) + "B)", LOG_TYPE::L_INFO);
+
+	}
+
+	debugOut("DEBUG_FULL_COUNT "+ toString(refusedConnectionServerFull), LOG_TYPE::L_DEBUG);
+	if(refusedConnectionServerFull)
+		debugOut("DEBUG_FULL_COUNT "+ humanReadable(refusedConnectionServerFull), LOG_TYPE::L_WARNING);
+
+	debugOut("DEBUG_CANNOTACCEPT_COUNT "+ toString(cannotAcceptClient), LOG_TYPE::L_DEBUG);
+	debugOut("DEBUG_CANNOTACCEPT_COUNT "+ humanReadable(cannotAcceptClient), LOG_TYPE::L_WARNING);
+	debugOut("DEBUG_OVERFLOW_COUNT "+ toString(possibleBufferOverflow), LOG_TYPE::L_DEBUG);
+	debugOut("DEBUG_OVERFLOW_COUNT "+ humanReadable(possibleBufferOverflow), LOG_TYPE::L_WARNING);
+	debugOut("DEBUG_SENDFAILED_COUNT "+ toString(requestSendFailed), LOG_TYPE::L_DEBUG);
+	debugOut("DEBUG_SENDFAILED_COUNT "+ humanReadable(requestSendFailed), LOG_TYPE::L_WARNING);
+}
+
+std::string ServerSocket::humanReadable(unsigned int data)
+{
+	if(data < 1000) return toString(data);
+	else if(data < 1000000) return toString(data / 1000) + "K";
+	else if(data < 1000000000) return toString(data / 1000000) + "M";
+	else return toString(data / 1000000000) + "G";
+}
+
+void ServerSocket::debugOut(std::string msg, LOG_TYPE log)
+{
+	cLog::get()->write("TCP : " + msg, log, LOG_FILE::TCP);
+}
+
+bool ServerSocket::computeString(unsigned int client, std::string string)
+{
+	debugOut("-- COMPUTE STRING --", LOG_TYPE::L_DEBUG); //Debug
+
+	if(computeHttp(client, string)) {
+		return false; //HTTP client
+	} else {
+		computeNormalString(client, string);
+		return true;
+	}
+}
+
+bool ServerSocket::computeHttp(unsigned int client, std::string string)
+{
+	//TODO proprer
+	#ifdef LINUX
+	if(string.substr(0,3) == "GET") { //HTTP client
+
+		/* Processing of the url */
+		std::string path = AppSettings::Instance()->getWebDir();
+
+		printf("%s\n", string.c_str()); //Debug
+
+		std::string url = string.substr(4, string.substr(4, std::string::npos).find(' ')); //Retrieve the url only
+		printf("URL : \"%s\"\n", url.c_str()); //Debug
+
+		std::string urlFile = url.substr(0, url.find('?')); //Retrieve the url without parameters
+		printf("FILE : \"%s\"\n", urlFile.c_str()); //Debug
+
+		if(urlFile[urlFile.size()-1] == '/') urlFile.append("index.html"); //Modify the url to index.html
+
+		std::string filename = path + urlFile; //Path to the file locally
+		printf("\"FILE PATH : %s\"\n", filename.c_str()); //debug
+
+		if(url.find('?') != std::string::npos) { //Parameters in the url
+			std::string urlParam = url.substr(url.find('?')+1, std::string::npos); //Retrieve parameters only
+			printf("PARAM : \"%s\"\n", urlParam.c_str()); //Debug
+
+			if(urlParam.find("command=", 0) != std::string::npos) { //Parameter command present
+				std::string command = urlParam.substr(urlParam.find("command=", 0), std::string::npos); //Retrieve from parameter
+				command = command.substr(8, command.find('&')-8); //Retrieves command only
+				command = replace(command, "%20", " "); //Decodes spaces
+				command = replace(command, "+", " "); //Decodes spaces
+				command = replace(command, "%3A", ":"); //Decodes ":"
+				printf("COMMAND : \"%s\"\n", command.c_str());
+				pushInput(std::string(command)); //Adds the string to the input queue
+				broadcast(clientIp(client) + CLIENT_SEPARATOR2 + "HTTP" + CLIENT_SEPARATOR1 + command + '\n'); //Sends the string to all clients
+			}
+		}
+
+		/* Send the file */
+		struct stat filestat;
+		if(!stat(filename.c_str(), &filestat)) { //Retrieves statistics from the file
+			FILE* file = fopen(filename.c_str(), "r"); //Open the file in read mode
+			if(file != NULL) { //File opened
+				std::string extension = urlFile.substr(urlFile.find_last_of(".", std::string::npos)+1, std::string::npos);
+				std::string type;
+				if(extension == "html" || extension == "HTML") type = "text/html;charset=UTF-8";
+				else if(extension == "css" || extension == "CSS") type = "text/css;charset=UTF-8";
+				else if(extension == "js" || extension == "JS") type = "application/x-javascript;charset=UTF-8";
+				else if(extension == "jpeg" || extension == "JPEG" || extension == "jpg" || extension == "JPEG") type = "image/jpeg";
+				else if(extension == "png" || extension == "PNG") type = "image/png";
+				else if(extension == "gif" || extension == "GIF") type == "image/gif";
+				else type = "text/plain";
+
+				strcpy(buffer, ("HTTP/1.0 200 OK\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: " + toString(filestat.st_size) + "\nContent-Type: " + type + "\r\n\r\n").c_str());
+				sendRaw(client, buffer, strlen(buffer)); //Send headers
+				unsigned int size;
+				do {
+					size = fread(buffer, 1, bufferSize, file); //Read the file in the buffer
+					sendRaw(client, buffer, size); //Send the buffer
+				} while(size == bufferSize); //Not at the end of the file
+				fclose(file); //Closing the file
+			}
+		} else { //Problem when opening the file (non-existent...)
+			strcpy(buffer, "HTTP/1.0 500 Internal Error\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: 0\r\n\r\n");
+			send(client); //Sending of the headers
+		}
+
+		close(client); //Closing the connection
+		return true;
+	} else
+	if (string.substr(0,4) == "POST") { //HTTP POST request (not supported)
+		strcpy(buffer, "HTTP/1.0 500 Internal Error\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: 0\r\n\r\n");
+		send(client);
+		close(client);
+		return true;
+	} else
+		return false;
+	#else
+	return true;
+	#endif
+}
+
+void ServerSocket::computeNormalString(unsigned int client, std::string string)
+{
+	//TODO proprer
+	if(string.substr(0, 7) == "$NOTICE") { //command NOTICE
+		strcpy(buffer, "$NOTICE $LOGON $LOGOFF");
+		send(client);
+	} else
+	if(string.substr(0, 4) == "$LOG") { //LOG command
+		if(string.substr(4, 2) == "ON" && !clientBroadcastTab[client]) { //LOGON
+			clientBroadcastTab[client] = true; //Change of customer preferences
+			strcpy(buffer, "Vous receverez maintenant les logs\n");
+		} else
+		if(string.substr(4, 3) == "OFF" && clientBroadcastTab[client]) { //LOGOFF
+			clientBroadcastTab[client] = false; //Change of customer's preferences
+			strcpy(buffer, "Vous receverez maintenant PLUS les logs\n");
+		} else
+			strcpy(buffer, "REQUEST ERROR");
+		send(client); //Send buffer to client
+	} else {
+		pushInput(std::move(string)); //Add string to input queue
+		//broadcast(clientIp(client) + CLIENT_SEPARATOR1 + string + '\n'); //Send string to all clients
+	}
+}
+
+int ServerSocket::broadcast(std::string data)
+{
+	debugOut("-- BROADCAST --", LOG_TYPE::L_DEBUG); //Debug
+	debugOut("BROADCAST_DATA "+ data, LOG_TYPE::L_DEBUG); //Debug
+
+	strcpy(buffer, data.c_str()); //Prepares the message
+	unsigned int sent = 0; //Number of clients to which the data is sent
+	for (unsigned int client = 0; client < maxClients; client++) { //Path of all connected clients
+		if(clientBroadcastTab[client]) { //If the client requests feedback
+			send(client); //Sends to client
+			sent++; //Increates the total number of requests sent
+		}
+	}
+	return sent;
+}
+
+#ifdef LINUX
+
+/* Event driven server: the thread sleeps in epoll_wait until a socket or the application needs it */
+
+int ServerSocket::open()
+{
+	debugOut("-- OPEN --", LOG_TYPE::L_DEBUG); //Debug
+	debugOut("SERVER_START "+ toString(port), LOG_TYPE::L_INFO); //Debug
+
+	/* Opening of the server socket */
+	serverFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (serverFd < 0) {
+		debugOut("OPEN_SERVER_SOCKET_ERROR "+ (std::string)strerror(errno), LOG_TYPE::L_ERROR); //Debug
+		return SERVER_SOCKET_OPEN_ERROR_CODE;
+	}
+	int enable = 1;
+	setsockopt(serverFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)); //As SDL_net, the port can be reopened at once
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(port);
+	if (bind(serverFd, (sockaddr *) &address, sizeof(address)) < 0 || listen(serverFd, SOMAXCONN) < 0) {
+		debugOut("OPEN_SERVER_SOCKET_ERROR "+ (std::string)strerror(errno) + " (port "  + toString(this->port) + ")", LOG_TYPE::L_ERROR); //Debug
+		::close(serverFd);
+		return SERVER_SOCKET_OPEN_ERROR_CODE;
+	}
+
+	/* Add the server socket to epoll to monitor it */
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.u64 = maxClients; //After the clients
+	if (epoll_ctl(epollFd, EPOLL_CTL_ADD, serverFd, &event) < 0) {
+		debugOut("EPOLL_ADD_SERVER_ERROR "+ (std::string)strerror(errno), LOG_TYPE::L_ERROR); //Debug
+		::close(serverFd); //Close the server socket
+		return SDL_ADDSOCKET_SERVER_ERROR_CODE;
+	}
+
+	/* Launch the processing thread */
+	stopThread = false;
+	try {
+		thread = std::thread([this] {
+			threadReturnValue = run();
+		});
+	} catch (const std::system_error &e) {
+		debugOut("CREATETHREAD_ERROR "+ (std::string)e.what(), LOG_TYPE::L_ERROR); //Debug
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, serverFd, nullptr);
+		::close(serverFd);
+		return SDL_CREATETHREAD_ERROR_CODE;
+	}
+
+	/* Change the server status flag */
+	serverOpen = true;
+
+	return IO_NO_ERROR; //No error
+}
+
+int ServerSocket::close()
+{
+	debugOut("-- CLOSE --", LOG_TYPE::L_DEBUG); //Debug
+	if(!serverOpen) {
+		debugOut("SERVER_NOT_OPEN", LOG_TYPE::L_WARNING); //Debug
+		return SERVER_NOT_OPEN_CODE;
+	}
+
+	debugOut("SERVER_STOP", LOG_TYPE::L_INFO); //Debug
+	killThread();
+
+	//Close all open clients
+	strcpy(buffer, "GOODBYE"); //Preparation of the message
+	for (unsigned int client = 0; client < maxClients; client++) { //Scans all clients
+		if(clientCount <= 0) break; //All client sockets are already closed
+		if (clientTab[client].fd >= 0) { //If the socket is used
+			send(client); //Send the message to the client
+			close(client); //Closing operations of the client socket
+		}
+	}
+
+	epoll_ctl(epollFd, EPOLL_CTL_DEL, serverFd, nullptr);
+	::close(serverFd); //Closing the server socket
+	serverOpen = false; //Change the server status flag
+
+	return IO_NO_ERROR;
+}
+
+ServerSocket::~ServerSocket()
+{
+	debugOut("-- DELETE --", LOG_TYPE::L_DEBUG); //Debug
+
+	if(serverOpen) close(); //Closing the server
+
+	::close(wakeFd);
+	::close(epollFd);
+	delete[] clientBroadcastTab; //Release feedback array
+	delete[] buffer; //Release buffer
+
+	stats(); //Display statistics
+}
+
+std::string ServerSocket::clientIp(unsigned int client)
+{
+	return clientTab[client].ip;
+}
+
+std::string ServerSocket::getInput()
+{
+	std::string data;
+	inputQueue.pop(data); //Stays empty if there is nothing
+	return data;
+}
+
+void ServerSocket::setOutput(std::string data)
+{
+	debugOut("Data info OUT : " + data, LOG_TYPE::L_INFO);
+	if (data.size() > MAX_BUFFER) {
+		cLog::get()->write("ServerSocket data setOutput too big", LOG_TYPE::L_WARNING);
+		data.resize(MAX_BUFFER);
+	}
+	{
+		std::lock_guard<std::mutex> lock(outputting);
+		outputQueue.push(std::move(data));
+	}
+	wakeUp();
+}
+
+void ServerSocket::wakeUp()
+{
+	const uint64_t one = 1;
+	if (write(wakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN) //EAGAIN: the counter is already set
+		debugOut("EVENTFD_WRITE_ERROR "+ (std::string)strerror(errno), LOG_TYPE::L_ERROR); //Debug
+}
+
+int ServerSocket::run()
+{
+	debugOut("-- RUN --", LOG_TYPE::L_DEBUG); //Debug
+
+	epoll_event events[TCP_EPOLL_EVENTS];
+	while (!stopThread) {
+		//Sleep until there is activity, or a little while if commands wait for room in inputQueue
+		const int eventCount = epoll_wait(epollFd, events, TCP_EPOLL_EVENTS, inputAside.empty() ? -1 : TCP_INPUT_RETRY);
+		if (eventCount < 0) {
+			if (errno == EINTR)
+				continue;
+			debugOut("EPOLL_WAIT_ERROR "+ (std::string)strerror(errno), LOG_TYPE::L_ERROR); //Debug
+			return EPOLL_WAIT_ERROR_CODE;
+		}
+
+		for (int i = 0; i < eventCount; i++) {
+			const uint64_t id = events[i].data.u64;
+			if (id == maxClients + 1) { //Data to send or stop request
+				uint64_t count;
+				while (read(wakeFd, &count, sizeof(count)) > 0); //Reset the counter
+			} else if (id == maxClients) {
+				checkNewClient(); //Process the new clients
+			} else if (clientTab[id].fd >= 0) {
+				checkNewData(id); //Process the new data of the client
+			}
+		}
+
+		if (!inputAside.empty())
+			pushInputAside();
+		checkDataToSend(); //Checks if there is data to send to clients
+	}
+	return IO_NO_ERROR;
+}
+
+void ServerSocket::checkNewClient()
+{
+	debugOut("-- CHECK NEW CLIENT --", LOG_TYPE::L_DEBUG); //Debug
+
+	while (true) { //Accept all the waiting clients
+		sockaddr_in address;
+		socklen_t addressSize = sizeof(address);
+		const int fd = accept4(serverFd, (sockaddr *) &address, &addressSize, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) { //Error when accepting the client
+				cannotAcceptClient++; //Increment the total number of errors when accepting the client
+				debugOut("ACCEPT_CLIENT_ERROR "+ (std::string)strerror(errno), LOG_TYPE::L_WARNING); //Debug
+			}
+			return;
+		}
+
+		if (freeClientTab.empty()) { //If there is no space for the client
+			refusedConnectionServerFull++; //Increment the number of refused connections due to a full server
+			debugOut("server full", LOG_TYPE::L_WARNING); //Debug
+			static const char full[] = "SERVER_FULL";
+			::send(fd, full, sizeof(full), MSG_NOSIGNAL); //Sends message to client
+			::close(fd); //Closes the socket
+			continue;
+		}
+
+		const unsigned int client = freeClientTab.back();
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.u64 = client;
+		if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) { //Adds the client socket to epoll
+			debugOut("EPOLL_ADD_CLIENT_ERROR "+ (std::string)strerror(errno), LOG_TYPE::L_ERROR); //Debug
+			::close(fd); //Closes the temporary socket
+			continue;
+		}
+		int enable = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable)); //The answers are short, send them at once
+		freeClientTab.pop_back();
+
+		char ip[INET_ADDRSTRLEN];
+		inet_ntop(AF_INET, &address.sin_addr, ip, sizeof(ip));
+		clientTab[client].fd = fd;
+		clientTab[client].ip = ip;
+		debugOut("New client " + clientIp(client), LOG_TYPE::L_INFO); //Debug
+
+		connection++; //Increases the total number of connections
+		clientCount++; //Increases the number of connected clients
+		if(clientCount > maxSimultaneousClient)
+			maxSimultaneousClient = clientCount; //Update the maximum number of simulataneously connected clients
+
+		debugOut("CLIENT_COUNT " + toString(clientCount) + "/" + toString(maxClients), LOG_TYPE::L_INFO); //Debug
+	}
+}
+
+void ServerSocket::checkNewData(unsigned int client)
+{
+	debugOut("-- CHECK NEW DATA --", LOG_TYPE::L_DEBUG); //Debug
+
+	//One read per event, epoll reports the client again if there is more to read
+	const ssize_t receivedByteCount = recv(clientTab[client].fd, buffer, bufferSize, 0);
+	if (receivedByteCount < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+		return;
+	if (receivedByteCount <= 0) { //Disconnecting the client
+		debugOut("RESETED_BY_PEER "+ clientIp(client), LOG_TYPE::L_INFO); //Debug
+		computeNewData(client, true); //The last command may have no line break
+		if (clientTab[client].fd >= 0)
+			close(client); //Close client socket operations
+		return;
+	}
+
+	requestRecieved++; //Increment the total number of received requests
+	dataRecieved += receivedByteCount; //Increment the total number of received data
+
+	debugOut("CLIENT_DATA_QUANTITY " + clientIp(client) + " " + toString(receivedByteCount), LOG_TYPE::L_INFO); //Debug
+
+	for(ssize_t i = 0; i < receivedByteCount; i++) if(buffer[i] == '\r' || buffer[i] == '\0') buffer[i] = '\n';// Replace \r and \0 by \n
+	clientTab[client].pending.append(buffer, receivedByteCount);
+	computeNewData(client, false); //Processes the complete lines
+
+	if (clientTab[client].fd >= 0 && clientTab[client].pending.size() >= bufferSize) { //A line which does not fit in the buffer
+		possibleBufferOverflow++; //Increments the total number of buffer overflows
+		strcpy(buffer, "SERVER_OVERFLOW"); //Prepares the message
+		send(client); //Sends the message
+
+		debugOut("BUFFER_OVERFLOW too many data "+ clientIp(client), LOG_TYPE::L_WARNING); //Debug
+
+		close(client); //Closing the client socket
 	}
-	clientBroadcastTab = new bool[maxClients];
-	if(clientBroadcastTab == NULL) {
-		debugOut("NEW_BOOL_TAB_ERROR", LOG_TYPE::L_ERROR); //Debug
-		return NEW_BOOL_TAB_ERROR_CODE;
+}
+
+void ServerSocket::computeNewData(unsigned int client, bool lastData)
+{
+	debugOut("-- COMPUTE NEW DATA --", LOG_TYPE::L_DEBUG); //Debug
+	std::string &data = clientTab[client].pending;
+	size_t begin = 0; //Start of the line
+	size_t end; //End of the line
+	while ((end = data.find('\n', begin)) != std::string::npos) {
+		if (end > begin && !computeString(client, data.substr(begin, end - begin)))
+			return; //HTTP client, the connection is closed
+		begin = end + 1; //After \n
 	}
-	for (unsigned int i = 0; i < maxClients; i++)	{
-		clientSocketTab[i] = NULL; //Initialization of all client sockets to NULL
-		clientBroadcastTab[i] = false;
+	if (lastData && begin < data.size()) {
+		if (!computeString(client, data.substr(begin)))
+			return;
+		begin = data.size();
 	}
+	data.erase(0, begin); //Keeps the incomplete line for the next data
+}
 
-	/* Initialization of the buffer */
-	buffer = new char[bufferSize];
-	if(buffer == NULL) {
-		debugOut("NEW_BUFFER_ERROR", LOG_TYPE::L_ERROR); //Debug
-		return NEW_BUFFER_ERROR_CODE;
-	}
+void ServerSocket::pushInput(std::string &&string)
+{
+	//If the main loop is late the command waits with the previous ones, the order is kept
+	if (!inputAside.empty() || !inputQueue.push(std::move(string)))
+		inputAside.push_back(std::move(string));
+}
 
-	/* Creation of the mutex to protect the client input queue */
-	outputting = SDL_CreateMutex();
-	if (outputting == NULL) {
-		debugOut("SDL_CREATEMUTEX_ERROR "+ (std::string)SDLNet_GetError(), LOG_TYPE::L_ERROR); //Debug
-		return SDL_CREATEMUTEX_ERROR_CODE;
-	}
+void ServerSocket::pushInputAside()
+{
+	while (!inputAside.empty() && inputQueue.push(std::move(inputAside.front())))
+		inputAside.pop_front();
+}
 
-	/* Creation of a mutex to protect the client exit queue */
-	inputting = SDL_CreateMutex();
-	if (inputting == NULL) {
-		debugOut("SDL_CREATEMUTEX_ERROR "+ (std::string)SDLNet_GetError(), LOG_TYPE::L_ERROR); //Debug
-		return SDL_CREATEMUTEX_ERROR_CODE;
+void ServerSocket::checkDataToSend()
+{
+	std::queue<std::string> data;
+	{
+		std::lock_guard<std::mutex> lock(outputting);
+		std::swap(data, outputQueue); //Take the queue, the application is not blocked by the sending
+	}
+	while(!data.empty()) { //Non-empty queue
+		broadcast(data.front() + '\n'); //Send to all clients from the head of the queue
+		data.pop(); //Scrolls
 	}
+}
 
-	return IO_NO_ERROR; //No error
+int ServerSocket::send(unsigned int client)
+{
+	debugOut("-- SEND --", LOG_TYPE::L_DEBUG); //Debug
+
+	unsigned int size = strlen(buffer) + 1; //Size of the string
+	unsigned int sendCount = sendRaw(client, buffer, size); //Sends the content of the buffer to the client
+	if(sendCount < size) { //Problem while sending
+		requestSendFailed++; //Increments the total number of request sending errors
+		debugOut("SEND_ERROR", LOG_TYPE::L_WARNING); //Debug
+		return SDL_SEND_ERROR_CODE;
+	} else	requestSend++; //Increment the total number of requests sent
+
+	dataSend += sendCount; //Increments the total amount of data sent
+
+	return IO_NO_ERROR;
+}
+
+int ServerSocket::sendRaw(unsigned int client, const char *data, unsigned int size)
+{
+	unsigned int sent = 0;
+	while (sent < size) {
+		const ssize_t count = ::send(clientTab[client].fd, data + sent, size - sent, MSG_NOSIGNAL);
+		if (count > 0) {
+			sent += count;
+			continue;
+		}
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) { //The client is slow, wait for room in its socket
+			pollfd writable = {clientTab[client].fd, POLLOUT, 0};
+			if (poll(&writable, 1, TCP_SEND_TIMEOUT) > 0)
+				continue;
+		}
+		break;
+	}
+	return sent;
 }
 
+int ServerSocket::close(unsigned int client)
+{
+	debugOut("-- CLIENT CLOSE --", LOG_TYPE::L_DEBUG); //Debug
+	debugOut("CLIENT_DISCONECTED "+ clientIp(client), LOG_TYPE::L_INFO); //Debug
+	if (epoll_ctl(epollFd, EPOLL_CTL_DEL, clientTab[client].fd, nullptr) < 0) //Removal of the client socket from epoll
+		debugOut("EPOLL_DEL_CLIENT_ERROR "+ (std::string)strerror(errno), LOG_TYPE::L_ERROR); //Debug, closing the socket removes it anyway
+	::close(clientTab[client].fd); //Closing the client socket
+	clientTab[client].fd = -1; //Free the slot
+	clientTab[client].pending.clear();
+	freeClientTab.push_back(client);
+	clientBroadcastTab[client] = false; //Falsify the status of the feedback request
+	clientCount--; //Decrease the number of connected clients
+
+	debugOut("CLIENT_COUNT " + toString(clientCount) + "/" + toString(maxClients), LOG_TYPE::L_INFO); //Debug
 
-std::string ServerSocket::replace(std::string base, const std::string from, const std::string to)
+	return IO_NO_ERROR;
+}
+
+int ServerSocket::killThread()
 {
-	std::string SecureCopy = base;
-	for (size_t start_pos = SecureCopy.find(from); start_pos != std::string::npos; start_pos = SecureCopy.find(from,start_pos)) SecureCopy.replace(start_pos, from.length(), to);
-	return SecureCopy;
+	debugOut("-- KILL THREAD --", LOG_TYPE::L_DEBUG); //Debug
+
+	stopThread = true; //Stop thread request
+	wakeUp();
+	if (thread.joinable())
+		thread.join(); //Wait for the thread
+
+	return threadReturnValue;
 }
 
+#else
 
 int ServerSocket::open()
 {
@@ -281,41 +869,6 @@ ServerSocket::~ServerSocket()
 	while(!outputQueue.empty()) outputQueue.pop(); //Empty output queue
 }
 
-void ServerSocket::stats()
-{
-	debugOut("-- STATS --", LOG_TYPE::L_DEBUG); //Debug
-
-	if(connection) {
-		debugOut("CONNECTION "+ toString(connection) + " (" + toString(maxSimultaneousClient) + " max)", LOG_TYPE::L_DEBUG);
-		debugOut("REQUEST_RECIEVED "+ toString(requestRecieved) + " requests (" + toString(dataRecieved) + " bytes)", LOG_TYPE::L_DEBUG);
-		debugOut("REQUEST_SEND "+ toString(requestSend) + " requests (" + toString(dataSend) + " bytes)", LOG_TYPE::L_DEBUG);
-
-		debugOut("CONNECTION "+ humanReadable(connection) + " (" + humanReadable(maxSimultaneousClient) + " max)", LOG_TYPE::L_INFO);
-		debugOut("REQUEST_RECIEVED "+ humanReadable(requestRecieved) + " (" + humanReadable(dataRecieved) + "B)", LOG_TYPE::L_INFO);
-		debugOut("REQUEST_SEND "+ humanReadable(requestSend) + " (" + humanReadable(dataSend) + "B)", LOG_TYPE::L_INFO);
-
-	}
-
-	debugOut("DEBUG_FULL_COUNT "+ toString(refusedConnectionServerFull), LOG_TYPE::L_DEBUG);
-	if(refusedConnectionServerFull)
-		debugOut("DEBUG_FULL_COUNT "+ humanReadable(refusedConnectionServerFull), LOG_TYPE::L_WARNING);
-
-	debugOut("DEBUG_CANNOTACCEPT_COUNT "+ toString(cannotAcceptClient), LOG_TYPE::L_DEBUG);
-	debugOut("DEBUG_CANNOTACCEPT_COUNT "+ humanReadable(cannotAcceptClient), LOG_TYPE::L_WARNING);
-	debugOut("DEBUG_OVERFLOW_COUNT "+ toString(possibleBufferOverflow), LOG_TYPE::L_DEBUG);
-	debugOut("DEBUG_OVERFLOW_COUNT "+ humanReadable(possibleBufferOverflow), LOG_TYPE::L_WARNING);
-	debugOut("DEBUG_SENDFAILED_COUNT "+ toString(requestSendFailed), LOG_TYPE::L_DEBUG);
-	debugOut("DEBUG_SENDFAILED_COUNT "+ humanReadable(requestSendFailed), LOG_TYPE::L_WARNING);
-}
-
-std::string ServerSocket::humanReadable(unsigned int data)
-{
-	if(data < 1000) return toString(data);
-	else if(data < 1000000) return toString(data / 1000) + "K";
-	else if(data < 1000000000) return toString(data / 1000000) + "M";
-	else return toString(data / 1000000000) + "G";
-}
-
 std::string ServerSocket::clientIp(unsigned int client)
 {
 	Uint32 ip = SDLNet_TCP_GetPeerAddress(clientSocketTab[client])->host;
@@ -351,11 +904,6 @@ void ServerSocket::setOutput(std::string data)
 	}
 }
 
-void ServerSocket::debugOut(std::string msg, LOG_TYPE log)
-{
-	cLog::get()->write("TCP : " + msg, log, LOG_FILE::TCP);
-}
-
 /* thread */
 
 int ServerSocket::threadWrapper(void *Data)
@@ -507,124 +1055,6 @@ void ServerSocket::computeNewData(unsigned int client)
 	} while(end != (unsigned int)std::string::npos && continues); //As long as there are n's in the chain
 }
 
-bool ServerSocket::computeString(unsigned int client, std::string string)
-{
-	debugOut("-- COMPUTE STRING --", LOG_TYPE::L_DEBUG); //Debug
-
-	if(computeHttp(client, string)) {
-		return false; //HTTP client
-	} else {
-		computeNormalString(client, string);
-		return true;
-	}
-}
-
-bool ServerSocket::computeHttp(unsigned int client, std::string string)
-{
-	//TODO proprer
-	#ifdef LINUX
-	if(string.substr(0,3) == "GET") { //HTTP client
-
-		/* Processing of the url */
-		std::string path = AppSettings::Instance()->getWebDir();
-
-		printf("%s\n", string.c_str()); //Debug
-
-		std::string url = string.substr(4, string.substr(4, std::string::npos).find(' ')); //Retrieve the url only
-		printf("URL : \"%s\"\n", url.c_str()); //Debug
-
-		std::string urlFile = url.substr(0, url.find('?')); //Retrieve the url without parameters
-		printf("FILE : \"%s\"\n", urlFile.c_str()); //Debug
-
-		if(urlFile[urlFile.size()-1] == '/') urlFile.append("index.html"); //Modify the url to index.html
-
-		std::string filename = path + urlFile; //Path to the file locally
-		printf("\"FILE PATH : %s\"\n", filename.c_str()); //debug
-
-		if(url.find('?') != std::string::npos) { //Parameters in the url
-			std::string urlParam = url.substr(url.find('?')+1, std::string::npos); //Retrieve parameters only
-			printf("PARAM : \"%s\"\n", urlParam.c_str()); //Debug
-
-			if(urlParam.find("command=", 0) != std::string::npos) { //Parameter command present
-				std::string command = urlParam.substr(urlParam.find("command=", 0), std::string::npos); //Retrieve from parameter
-				command = command.substr(8, command.find('&')-8); //Retrieves command only
-				command = replace(command, "%20", " "); //Decodes spaces
-				command = replace(command, "+", " "); //Decodes spaces
-				command = replace(command, "%3A", ":"); //Decodes ":"
-				printf("COMMAND : \"%s\"\n", command.c_str());
-				inputQueue.push(command); //Adds the string to the output queue
-				broadcast(clientIp(client) + CLIENT_SEPARATOR2 + "HTTP" + CLIENT_SEPARATOR1 + command + '\n'); //Sends the string to all clients
-			}
-		}
-
-		/* Send the file */
-		struct stat filestat;
-		if(!stat(filename.c_str(), &filestat)) { //Retrieves statistics from the file
-			FILE* file = fopen(filename.c_str(), "r"); //Open the file in read mode
-			if(file != NULL) { //File opened
-				std::string extension = urlFile.substr(urlFile.find_last_of(".", std::string::npos)+1, std::string::npos);
-				std::string type;
-				if(extension == "html" || extension == "HTML") type = "text/html;charset=UTF-8";
-				else if(extension == "css" || extension == "CSS") type = "text/css;charset=UTF-8";
-				else if(extension == "js" || extension == "JS") type = "application/x-javascript;charset=UTF-8";
-				else if(extension == "jpeg" || extension == "JPEG" || extension == "jpg" || extension == "JPEG") type = "image/jpeg";
-				else if(extension == "png" || extension == "PNG") type = "image/png";
-				else if(extension == "gif" || extension == "GIF") type == "image/gif";
-				else type = "text/plain";
-
-				strcpy(buffer, ("HTTP/1.0 200 OK\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: " + toString(filestat.st_size) + "\nContent-Type: " + type + "\r\n\r\n").c_str());
-				SDLNet_TCP_Send(clientSocketTab[client], (void *)buffer, strlen(buffer)); //Send headers
-				unsigned int size;
-				do {
-					size = fread(buffer, 1, bufferSize, file); //Read the file in the buffer
-					SDLNet_TCP_Send(clientSocketTab[client], (void *)buffer, size); //Send the buffer
-				} while(size == bufferSize); //Not at the end of the file
-				fclose(file); //Closing the file
-			}
-		} else { //Problem when opening the file (non-existent...)
-			strcpy(buffer, "HTTP/1.0 500 Internal Error\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: 0\r\n\r\n");
-			send(clientSocketTab[client]); //Sending of the headers
-		}
-
-		close(client); //Closing the connection
-		return true;
-	} else
-	if (string.substr(0,4) == "POST") { //HTTP POST request (not supported)
-		strcpy(buffer, "HTTP/1.0 500 Internal Error\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: 0\r\n\r\n");
-		send(clientSocketTab[client]);
-		close(client);
-		return true;
-	} else
-		return false;
-	#else
-	return true;
-	#endif
-}
-
-void ServerSocket::computeNormalString(unsigned int client, std::string string)
-{
-	//TODO proprer
-	if(string.substr(0, 7) == "$NOTICE") { //command NOTICE
-		strcpy(buffer, "$NOTICE $LOGON $LOGOFF");
-		send(clientSocketTab[client]);
-	} else
-	if(string.substr(0, 4) == "$LOG") { //LOG command
-		if(string.substr(4, 2) == "ON" && !clientBroadcastTab[client]) { //LOGON
-			clientBroadcastTab[client] = true; //Change of customer preferences
-			strcpy(buffer, "Vous receverez maintenant les logs\n");
-		} else
-		if(string.substr(4, 3) == "OFF" && clientBroadcastTab[client]) { //LOGOFF
-			clientBroadcastTab[client] = false; //Change of customer's preferences
-			strcpy(buffer, "Vous receverez maintenant PLUS les logs\n");
-		} else
-			strcpy(buffer, "REQUEST ERROR");
-		send(clientSocketTab[client]); //Send buffer to client
-	} else {
-		inputQueue.push(string); //Add string to output queue
-		//broadcast(clientIp(client) + CLIENT_SEPARATOR1 + string + '\n'); //Send string to all clients
-	}
-}
-
 void ServerSocket::checkDataToSend()
 {
 	if(lock(outputting) == IO_NO_ERROR) {
@@ -636,20 +1066,17 @@ void ServerSocket::checkDataToSend()
 	}
 }
 
-int ServerSocket::broadcast(std::string data)
+void ServerSocket::pushInput(std::string &&string)
 {
-	debugOut("-- BROADCAST --", LOG_TYPE::L_DEBUG); //Debug
-	debugOut("BROADCAST_DATA "+ data, LOG_TYPE::L_DEBUG); //Debug
-
-	strcpy(buffer, data.c_str()); //Prepares the message
-	unsigned int sent = 0; //Number of clients to which the data is sent
-	for (unsigned int client = 0; client < maxClients; client++) { //Path of all connected clients
-		if(clientBroadcastTab[client]) { //If the client requests feedback
-			send(clientSocketTab[client]); //Sends to client
-			sent++; //Increates the total number of requests sent
-		}
+	if(lock(inputting) == IO_NO_ERROR) {
+		inputQueue.push(std::move(string)); //Add string to input queue
+		unlock(inputting);
 	}
-	return sent;
+}
+
+int ServerSocket::send(unsigned int client)
+{
+	return send(clientSocketTab[client]);
 }
 
 int ServerSocket::send(TCPsocket client)
@@ -715,3 +1142,5 @@ int ServerSocket::unlock(SDL_mutex *mutex)
 	}
 	return IO_NO_ERROR;
 }
+
+#endif
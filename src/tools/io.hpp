@@ -25,10 +25,8 @@
 #ifndef IO_H
 #define IO_H
 
-#include <SDL2/SDL_thread.h>
 #include <queue> //ServerSocket
 #include <cstring>
-#include <SDL2/SDL_net.h> //ServerSocket
 #include <iostream> //ServerSocket
 
 //#include "spacecrafter.hpp"
@@ -41,6 +39,16 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <errno.h>
+// event driven server
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "tools/SpscQueue.hpp"
+#else
+#include <SDL2/SDL_thread.h>
+#include <SDL2/SDL_net.h> //ServerSocket
 #endif
 
 
@@ -63,6 +71,8 @@ Updated on 17/05/2016
 #define NEW_TCPSOCKET_TAB_ERROR_CODE 	5 //Error when allocating the client sockets array
 #define NEW_BOOL_TAB_ERROR_CODE 		6 //Error while allocating the client sockets array
 #define NEW_BUFFER_ERROR_CODE 			7 //Error while allocating the buffer
+#define EPOLL_CREATE_ERROR_CODE 		8 //Error when creating the epoll instance
+#define EVENTFD_CREATE_ERROR_CODE 		9 //Error when creating the wake up eventfd
 /* Error codes in opening */
 #define SERVER_SOCKET_OPEN_ERROR_CODE 	101 //Error when opening the server socket
 #define SDL_ADDSOCKET_SERVER_ERROR_CODE	102 //Error when adding the server socket to the SocketSet
@@ -73,6 +83,7 @@ Updated on 17/05/2016
 #define SDL_CHECKSOCKETS_ERROR_CODE 	203 //Error when checking the SocketSet
 #define SDL_SEND_ERROR_CODE 			204
 #define SDL_DELSOCKET_CLIENT_ERROR_CODE 205
+#define EPOLL_WAIT_ERROR_CODE 			206 //Error when waiting for the socket events
 /* Error codes in closing */
 #define SERVER_NOT_OPEN_CODE 			301
 
@@ -80,6 +91,13 @@ Updated on 17/05/2016
 #define CLIENT_SEPARATOR2 				"/"
 #define DEBUG_SEPARATOR3 				" | " //Third error in the debug
 
+#ifdef LINUX
+#define TCP_INPUT_QUEUE_SIZE 			4096 //Commands waiting for the main loop before they are kept aside by the server thread
+#define TCP_INPUT_RETRY 				1 //Time between two tries to hand over the kept aside commands (in milliseconds)
+#define TCP_EPOLL_EVENTS 				64 //Events handled by one epoll_wait
+#define TCP_SEND_TIMEOUT 				100 //Maximum wait for a client to accept more data (in milliseconds)
+#endif
+
 
 class ServerSocket {
 public:
@@ -127,12 +145,37 @@ private:
 	unsigned int dataSend; //Total data sent
 	unsigned int requestSendFailed; //Total number of errors while sending the request
 
+	bool* clientBroadcastTab; //Feedback request table
+	char* buffer; //Receive buffer
+#ifdef LINUX
+	/* Server variables */
+	struct Client {
+		int fd = -1; //Client socket, -1 if the slot is free
+		std::string ip; //Client IP as a string
+		std::string pending; //Received data after the last line break
+	};
+	int serverFd = -1; //Server listening socket
+	int epollFd = -1; //Monitoring of the server, client and wake up descriptors
+	int wakeFd = -1; //eventfd which wakes the thread up for the output and the stop
+	std::vector<Client> clientTab; //Client table, the index is the epoll data of the client
+	std::vector<unsigned int> freeClientTab; //Free slots of clientTab
+
+	/* Thread variables */
+	std::thread thread; //Thread of the server that waits for the events
+	int threadReturnValue; //Return value of the thread
+	std::atomic<bool> stopThread;
+
+	/* Data storage variables */
+	SpscQueue<std::string> inputQueue{TCP_INPUT_QUEUE_SIZE}; //Input queue, from the server thread to the main loop
+	std::deque<std::string> inputAside; //Commands which did not fit in inputQueue, server thread only
+	std::queue<std::string> outputQueue; //Output queue
+	std::mutex outputting; //Mutex of the output queue
+#else
 	/* Server variables */
 	IPaddress serverIP; //Server IP (0.0.0.0 to listen on all server IPs)
 	TCPsocket serverSocket; //Server listening socket
 	SDLNet_SocketSet socketSet; //Socket monitoring table
 	TCPsocket* clientSocketTab; //Client sockets table
-	bool* clientBroadcastTab; //Feedback request table
 
 	/* Thread variables */
 	SDL_Thread *thread; //Thread of the server that waits for the packets
@@ -142,24 +185,32 @@ private:
 	int unlock(SDL_mutex *mutex);
 	SDL_mutex *running; //Mutex of active server
 	int activeSocketsCount; //Number of active sockets
-	char* buffer; //Receive buffer
 
 	/* Data storage variables */
 	std::queue<std::string> inputQueue; //Input queue
 	std::queue<std::string> outputQueue; //Output queue
 	SDL_mutex *inputting; //Input queue mutex
 	SDL_mutex *outputting; //Mutex of the output queue
+#endif
 
 	/* Initialization function and code */
 	int init(unsigned int port, unsigned int maxClients, unsigned int bufferSize); //Initialization function called by the constructors
 	int initErrorCode; //Initialization error code
 
 	/* Processing functions */
-	static int threadWrapper(void *Data); //Function that delegates run
 	int run(); //Incoming data processing loop
 	void checkNewClient(); //Function to check new clients
+#ifdef LINUX
+	void checkNewData(unsigned int client); //Reads the data of a client which has activity
+	void computeNewData(unsigned int client, bool lastData); //Processes the complete lines of the client
+	void pushInputAside(); //Hands over the commands kept aside
+	void wakeUp(); //Wakes the thread up from epoll_wait
+#else
+	static int threadWrapper(void *Data); //Function that delegates run
 	void checkNewData(); //New data verification function
 	void computeNewData(unsigned int client); //Data processing function
+#endif
+	void pushInput(std::string &&string); //Hands a command over to the main loop
 	bool computeString(unsigned int client, std::string string); //Chain processing function
 	bool computeHttp(unsigned int client, std::string string);//HTTP request processing function (BETA)
 	void computeNormalString(unsigned int client, std::string string);//Normal request processing function
@@ -168,7 +219,12 @@ private:
 	int close(unsigned int client); //Function to close the client socket
 
 	/* FFactoring or assistance functions */
+	int send(unsigned int client); //Function that sends the string contained in the buffer
+#ifdef LINUX
+	int sendRaw(unsigned int client, const char *data, unsigned int size); //Function that sends size bytes to the client
+#else
 	int send(TCPsocket client); //Function that sends the string contained in the buffer
+#endif
 	int resetThread(); //Fonction qui redémarre le thread de traiement quand il est inactif
 	int killThread(); //Function that kills the processing thread when it is inactive
 
@@ -26,9 +26,17 @@
 #include <exception>
 #include <string>
 #include <time.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <SDL2/SDL.h>
 #include "EntityCore/Core/VulkanMgr.hpp"
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #define LOG_EE "(EE): "
 #define LOG_WW "(WW): "
 #define LOG_II "(II): "
@@ -80,30 +88,53 @@ cLog* cLog::singleton = nullptr;
 
 cLog::cLog()
 {
+	queue = std::make_unique<Record[]>(LOG_QUEUE_SIZE);
+	for (uint64_t i = 0; i < LOG_QUEUE_SIZE; ++i)
+		queue[i].sequence.store(i, std::memory_order_relaxed);
+	writer = std::thread(&cLog::mainloop, this);
+	// the errors logged just before an exit() explain it
+	std::atexit(cLog::atExit);
 }
 
 void cLog::openLog(const LOG_FILE& fichier, const std::string& LogfilePath, const bool keepHistory)
 {
 	std::ofstream file;
+	const std::string path = keepHistory ? logDirectory + LogfilePath + "-" + getDate() + LOG_EXTENSION : logDirectory + LogfilePath + LOG_EXTENSION;
 
 	if (keepHistory)
-		file.open(logDirectory + LogfilePath + "-" + getDate() + LOG_EXTENSION, std::ofstream::out | std::ofstream::app);
+		file.open(path, std::ofstream::out | std::ofstream::app);
 	else
-		file.open(logDirectory + LogfilePath + LOG_EXTENSION, std::ofstream::out | std::ofstream::trunc);
+		file.open(path, std::ofstream::out | std::ofstream::trunc);
 
 	if (!file.is_open()) {
 		std::cerr << "(EE): Couldn't open file log!\n Please check file/directory permissions" << std::endl;
 		throw;
 	}
+	std::lock_guard<std::mutex> lock(fileMutex);
 	logFile.insert(std::pair<const LOG_FILE, std::ofstream>(fichier, std::move(file)));
+#ifndef WIN32
+	// a signal handler can't open a file, so emergencyFlush gets its descriptor now
+	int &fd = emergencyFd[(int) fichier];
+	if (fd < 0)
+		fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+#endif
 }
 
 void cLog::close() {
 	if (singleton != nullptr) {
+		// the writer leaves once the queue is empty
+		atExit();
 		for (auto &file: singleton->logFile) {
 			file.second << LOG_II << "EOF" << std::endl;
 			file.second.close();
 		}
+#ifndef WIN32
+		for (int &fd : singleton->emergencyFd) {
+			if (fd >= 0)
+				::close(fd);
+			fd = -1;
+		}
+#endif
 		delete singleton;
 	}
 	singleton = nullptr;
@@ -111,51 +142,247 @@ void cLog::close() {
 
 cLog::~cLog()
 {
+	if (writer.joinable()) {
+		stop.store(true);
+		wakeWriter();
+		writer.join();
+	}
 }
 
 
 void cLog::write(const std::string& texte, const LOG_TYPE& type, const LOG_FILE& fichier)
 {
-	writeMutex.lock();
-	std::string ligne;
+	const bool toConsole = isDebug;
+	const bool toFile = isWritingLog;
+	if (!toConsole && !toFile)
+		return;
 
-	if (isDebug) {
-		writeConsole(texte, type);
-		char value[15];
-		sprintf(value, "%012d: ", SDL_GetTicks());
-		ligne.append(std::string(value));
+	// take a slot, the caller never waits for the writer
+	uint64_t pos = head.load(std::memory_order_relaxed);
+	Record *record;
+	int retry = 0;
+	for (;;) {
+		record = &queue[pos % LOG_QUEUE_SIZE];
+		const int64_t diff = (int64_t) (record->sequence.load(std::memory_order_acquire) - pos);
+		if (diff == 0) {
+			if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if (diff < 0) {
+			// the writer is late by a whole queue, give it a few chances before dropping the message
+			if (++retry > LOG_FULL_RETRIES) {
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			if (retry == 1)
+				wakeWriter();
+			std::this_thread::yield();
+			pos = head.load(std::memory_order_relaxed);
+		} else {
+			pos = head.load(std::memory_order_relaxed);
+		}
 	}
-	if (!isWritingLog) {
-		writeMutex.unlock();
+
+	record->type = type;
+	record->file = fichier;
+	record->toConsole = toConsole;
+	record->toFile = toFile;
+	record->ticks = toConsole ? SDL_GetTicks() : 0;
+	record->text.assign(texte);
+	record->sequence.store(pos + 1, std::memory_order_release);
+
+	// an error is often the last message before an exit(), it is in its file on return
+	// once the writer has stopped, every message is written by its caller
+	if (type == LOG_TYPE::L_ERROR || stop.load(std::memory_order_relaxed))
+		writeThrough(pos + 1);
+	// otherwise the writer takes the message at its next period
+	else if (pos - written.load(std::memory_order_relaxed) == LOG_QUEUE_SIZE / 2)
+		wakeWriter();
+}
+
+void cLog::writeThrough(uint64_t target)
+{
+	uint64_t done = written.load();
+	while (done < target) {
+		if (tryLockDrain()) {
+			drain();
+			drainLock.store(false, std::memory_order_release);
+		}
+		done = written.load();
+		// a message before ours is still being filled by its thread
+		if (done < target)
+			std::this_thread::yield();
+	}
+}
+
+void cLog::atExit()
+{
+	cLog *log = singleton;
+	if (log == nullptr || !log->writer.joinable())
 		return;
-	};
+	// the writer leaves once the queue is empty, the later messages are written by their caller
+	log->stop.store(true);
+	log->wakeWriter();
+	log->writer.join();
+}
 
-	switch(type) {
-		case LOG_TYPE::L_WARNING :
-			ligne.append(LOG_WW);
-			break;
-		case LOG_TYPE::L_ERROR :
-			ligne.append(LOG_EE);
-			break;
-		case LOG_TYPE::L_DEBUG :
-			ligne.append(LOG_DD);
-			break;
-		case LOG_TYPE::L_INFO :
-			ligne.append(LOG_II);
+void cLog::wakeWriter()
+{
+	// the lock avoids losing the notification while the writer is about to wait
+	{ std::lock_guard<std::mutex> lock(wakeMutex); }
+	wakeUp.notify_one();
+}
+
+bool cLog::tryLockDrain()
+{
+	bool expected = false;
+	return drainLock.compare_exchange_strong(expected, true, std::memory_order_acquire);
+}
+
+bool cLog::drain()
+{
+	std::unique_lock<std::mutex> lock(fileMutex, std::try_to_lock);
+	if (!lock.owns_lock())
+		return false;
+
+	auto internal = logFile.find(LOG_FILE::INTERNAL);
+	uint64_t count = 0;
+	std::string ligne;
+	for (;; ++tail, ++count) {
+		Record &record = queue[tail % LOG_QUEUE_SIZE];
+		if (record.sequence.load(std::memory_order_acquire) != tail + 1)
 			break;
-		default :
-			;
+
+		if (record.toConsole) {
+			writeConsole(record.text, record.type);
+			char value[15];
+			sprintf(value, "%012u: ", record.ticks);
+			ligne.assign(value);
+		} else
+			ligne.clear();
+
+		switch(record.type) {
+			case LOG_TYPE::L_WARNING :
+				ligne.append(LOG_WW);
+				break;
+			case LOG_TYPE::L_ERROR :
+				ligne.append(LOG_EE);
+				break;
+			case LOG_TYPE::L_DEBUG :
+				ligne.append(LOG_DD);
+				break;
+			case LOG_TYPE::L_INFO :
+				ligne.append(LOG_II);
+				break;
+			default :
+				;
+		}
+
+		if (record.toFile) {
+			auto file = logFile.find(record.file);
+			if (file == logFile.end())
+				file = internal;
+			if (file != logFile.end())
+				file->second << ligne << record.text << '\n';
+		}
+
+		record.text.clear();
+		if (record.text.capacity() > LOG_RECORD_KEEP)
+			record.text.shrink_to_fit();
+		record.sequence.store(tail + LOG_QUEUE_SIZE, std::memory_order_release);
 	}
 
-	if (logFile.count(fichier)) {
-		logFile.at(fichier) << ligne << texte << std::endl;
-		logFile.at(fichier).flush();
-	} else {
-		logFile.at(LOG_FILE::INTERNAL) << ligne << texte << std::endl;
-		logFile.at(LOG_FILE::INTERNAL).flush();
+	const uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+	if (lost && internal != logFile.end())
+		internal->second << LOG_WW << lost << " log messages dropped, the log queue was full\n";
+
+	if (count || lost) {
+		for (auto &file: logFile)
+			file.second.flush();
+		written.fetch_add(count);
+		written.notify_all();
+	}
+	return count > 0;
+}
+
+void cLog::mainloop()
+{
+	std::unique_lock<std::mutex> lock(wakeMutex);
+	for (;;) {
+		lock.unlock();
+		bool busy = false;
+		if (tryLockDrain()) {
+			busy = drain();
+			drainLock.store(false, std::memory_order_release);
+		}
+		lock.lock();
+		if (busy)
+			continue;
+		if (stop.load())
+			return;
+		wakeUp.wait_for(lock, std::chrono::milliseconds(LOG_WRITE_PERIOD));
 	}
+}
+
+#ifndef WIN32
+//! async-signal-safe copy of a string to a descriptor
+static void writeFd(int fd, const char *text, size_t size)
+{
+	while (size > 0) {
+		const ssize_t n = ::write(fd, text, size);
+		if (n <= 0)
+			return;
+		text += n;
+		size -= n;
+	}
+}
+
+static void writeFd(int fd, const char *text)
+{
+	writeFd(fd, text, strlen(text));
+}
+#endif
 
-	writeMutex.unlock();
+void cLog::emergencyFlush()
+{
+#ifndef WIN32
+	cLog *log = singleton;
+	if (log == nullptr)
+		return;
+	// let the writer finish its batch, which also flushes the std::ofstream buffers
+	const struct timespec delay = {0, 1000000};
+	bool locked = false;
+	for (int i = 0; i < 100 && !(locked = log->tryLockDrain()); ++i)
+		nanosleep(&delay, nullptr);
+	if (!locked)
+		return;
+	// only write(2) from here: no allocation, no lock, no stream
+	for (;; ++log->tail) {
+		Record &record = log->queue[log->tail % LOG_QUEUE_SIZE];
+		if (record.sequence.load(std::memory_order_acquire) != log->tail + 1)
+			break;
+		const char *prefix;
+		switch(record.type) {
+			case LOG_TYPE::L_WARNING : prefix = LOG_WW; break;
+			case LOG_TYPE::L_ERROR : prefix = LOG_EE; break;
+			case LOG_TYPE::L_DEBUG : prefix = LOG_DD; break;
+			case LOG_TYPE::L_INFO : prefix = LOG_II; break;
+			default : prefix = "";
+		}
+		if (record.toConsole) {
+			writeFd(STDERR_FILENO, prefix);
+			writeFd(STDERR_FILENO, record.text.data(), record.text.size());
+			writeFd(STDERR_FILENO, "\n");
+		}
+		int fd = log->emergencyFd[(int) record.file];
+		if (fd < 0)
+			fd = log->emergencyFd[(int) LOG_FILE::INTERNAL];
+		if (record.toFile && fd >= 0) {
+			writeFd(fd, prefix);
+			writeFd(fd, record.text.data(), record.text.size());
+			writeFd(fd, "\n");
+		}
+	}
+#endif
 }
 
 void cLog::mark(const LOG_FILE& fichier)
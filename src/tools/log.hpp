@@ -31,6 +31,22 @@
 #include <mutex>
 #include <sstream>
 #include <map>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <cstdint>
+#include <condition_variable>
+
+//! number of messages the log queue can hold, the messages written while it is full are dropped
+#define LOG_QUEUE_SIZE 4096
+//! times a caller yields to the writer thread when the queue is full before dropping its message
+#define LOG_FULL_RETRIES 64
+//! the writer thread writes the queued messages at least every LOG_WRITE_PERIOD ms
+#define LOG_WRITE_PERIOD 50
+//! above this capacity, the text of a queued message is released once written
+#define LOG_RECORD_KEEP 1024
+//! number of LOG_FILE values
+#define LOG_FILE_COUNT 5
 
 
 /**
@@ -116,6 +132,11 @@ public:
 		return isDebug;
 	}
 
+	//! write the queued messages from a signal handler, the process is about to end
+	//! only uses write(2) on the descriptors opened by openLog
+	//! gives up if the writer thread doesn't release the queue, which is the case if it crashed
+	static void emergencyFlush();
+
 	void close();
 
 	void openLog(const LOG_FILE& fichier, const std::string& LogfilePath, const bool keepHistory = false);
@@ -129,8 +150,44 @@ private:
     static cLog *singleton;
 	cLog();
 
-	std::mutex writeMutex;
+	// message waiting in the queue, the writer thread formats it
+	struct Record {
+		std::atomic<uint64_t> sequence;
+		LOG_TYPE type;
+		LOG_FILE file;
+		bool toConsole;
+		bool toFile;
+		uint32_t ticks;
+		std::string text;
+	};
+
+	//! writer thread, writes the queued messages by batch
+	void mainloop();
+	void wakeWriter();
+	//! write every published message, the caller owns drainLock
+	//! \return true if a message was written
+	bool drain();
+	bool tryLockDrain();
+	//! return once the messages before target are written, draining them if the writer doesn't
+	void writeThrough(uint64_t target);
+	//! registered with atexit, writes what remains when exit() is called without close()
+	static void atExit();
+
+	// bounded queue with many producers and one consumer
+	std::unique_ptr<Record[]> queue;
+	alignas(64) std::atomic<uint64_t> head{0};	//!< next slot to fill
+	alignas(64) uint64_t tail = 0;				//!< next slot to write, owned by the drainLock holder
+	std::atomic<uint64_t> written{0};			//!< number of messages taken from the queue, writeThrough waits on it
+	std::atomic<uint64_t> dropped{0};			//!< messages dropped since the last report
+	std::atomic<bool> drainLock{false};
+	std::atomic<bool> stop{false};
+	std::thread writer;
+	std::mutex wakeMutex;
+	std::condition_variable wakeUp;
+
+	std::mutex fileMutex; //!< protects logFile
 	std::map<const LOG_FILE, std::ofstream> logFile;
+	int emergencyFd[LOG_FILE_COUNT] = {-1, -1, -1, -1, -1}; //!< same files, opened in append mode for emergencyFlush
 	std::string logDirectory = "";
 
 	void writeConsole(const std::string&, const LOG_TYPE&);
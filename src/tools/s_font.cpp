@@ -21,6 +21,7 @@
 // Class to manage fonts
 
 #include <vector>
+#include <algorithm>
 #include "tools/log.hpp"
 #include "tools/s_font.hpp"
 #include "tools/utility.hpp"
@@ -31,6 +32,12 @@
 #include "coreModule/projector.hpp"
 #include "EntityCore/Resource/TileMap.hpp"
 
+#define TEXT_MARGIN_X 2 // left of the string in its texture
+#define TEXT_MARGIN_Y 1 // top of the string in its texture
+#define GLYPH_ATLAS_ROWS 8 // lines of glyphs in an atlas page
+#define GLYPH_ATLAS_MAX_PAGES 4
+#define GLYPH_RUN_MAX 1024 // longer strings are not drawn from the atlas
+
 std::vector<renderedString_struct> s_font::tempCache, s_font::tempCache2;
 std::string s_font::lastUncached;
 int s_font::nbFontInstances = 0;
@@ -38,11 +45,33 @@ bool s_font::needFlush = false;
 std::list<s_font *> s_font::fontList;
 
 std::vector<std::pair<std::vector<struct s_print>, std::vector<struct s_printh>>> s_font::printData;
+std::vector<std::pair<std::vector<struct s_printrun>, std::vector<GlyphQuad>>> s_font::printRunData;
 
 std::string s_font::baseFontName;
 
 TileMap *s_font::tileMap = nullptr;
 
+//! create a surface in the byte order of the textures
+static SDL_Surface *createRGBASurface(int w, int h)
+{
+	Uint32 rmask, gmask, bmask, amask;
+
+	/* SDL interprets each pixel as a 32-bit number, so our masks must depend on the endianness (byte order) of the machine */
+	#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	 rmask = 0xff000000;
+	 gmask = 0x00ff0000;
+	 bmask = 0x0000ff00;
+	 amask = 0x000000ff;
+	#else
+	 rmask = 0x000000ff;
+	 gmask = 0x0000ff00;
+	 bmask = 0x00ff0000;
+	 amask = 0xff000000;
+	#endif
+
+	return SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 32, rmask, gmask, bmask, amask);
+}
+
 void s_font::initBaseFont(const std::string& ttfFileName)
 {
 	baseFontName = ttfFileName;
@@ -77,6 +106,7 @@ s_font::s_font(float size_i, const std::string& ttfFileName)
         context.transferSync->build();
 	}
 	//std::cout << "Created new font with size: " << fontSize << " and TTF name : " << fontName << std::endl;
+	initAtlas();
 	fontList.push_front(this);
 	self = fontList.begin();
 }
@@ -96,10 +126,12 @@ void s_font::rebuild(float size_i, const std::string& ttfFileName)
 		return;
 	} else {
 		clearCache();
+		releaseAtlas();
 		TTF_CloseFont(myFont);
 		fontName = ttfFileName;
 		fontSize = size_i;
 		myFont = tmpFont;
+		initAtlas();
 		cLog::get()->write("s_font: rebuild font succes", LOG_TYPE::L_INFO);
 	}
 }
@@ -107,6 +139,7 @@ void s_font::rebuild(float size_i, const std::string& ttfFileName)
 s_font::~s_font()
 {
 	clearCache();
+	releaseAtlas();
 	TTF_CloseFont(myFont);
 	myFont = nullptr;
 	if (--nbFontInstances == 0) { // if it's the last s_font instance, clear per-frame caches
@@ -129,12 +162,114 @@ void s_font::createSC_context()
 		value.first.reserve(2048); // max 2048 print per frame
 		value.second.reserve(256); // max 256 printHorizontal per frame
 	}
+	printRunData.resize(3);
+	for (auto &value : printRunData) {
+		value.first.reserve(2048); // max 2048 print from the glyph atlas per frame
+		value.second.reserve(MAX_GLYPH_IDX / 6); // a glyph takes 6 vertices of the draw helper ring
+	}
+}
+
+void s_font::initAtlas()
+{
+	lineHeight = TTF_FontHeight(myFont);
+	int pageHeight = 64;
+	while (pageHeight < lineHeight * GLYPH_ATLAS_ROWS && pageHeight < 512)
+		pageHeight <<= 1;
+	atlas = std::make_unique<GlyphAtlas>(GLYPH_PAGE_WIDTH, pageHeight, GLYPH_ATLAS_MAX_PAGES);
+	// warm-up with the printable ASCII characters, in a single upload
+	codepoints.clear();
+	for (uint32_t c = ' '; c <= '~'; ++c)
+		codepoints.push_back(c);
+	if (!loadGlyphs())
+		cLog::get()->write("s_font: can't fill the glyph atlas of " + fontName, LOG_TYPE::L_WARNING);
+}
+
+void s_font::releaseAtlas()
+{
+	// There must be no command using those textures
+	for (auto &tex : atlasTextures)
+		tileMap->releaseSurface(tex);
+	atlasTextures.clear();
+	atlas.reset();
+}
+
+const GlyphInfo *s_font::renderGlyph(uint32_t c)
+{
+	int minx, maxx, miny, maxy, advance;
+	if (c > 0xffff || TTF_GlyphMetrics(myFont, c, &minx, &maxx, &miny, &maxy, &advance))
+		return nullptr;
+	SDL_Color color={255,255,255,0};
+	SDL_Surface *glyph = TTF_RenderGlyph_Blended(myFont, c, color); //write in white
+	if (!glyph) // nothing to draw, like a space
+		return atlas->insert(c, 0, 0, nullptr, 0, 0, 0, advance);
+	// same conversion as renderString
+	SDL_Surface *surface = createRGBASurface(glyph->w, glyph->h);
+	if (!surface) {
+		cLog::get()->write("s_font "+ fontName +": error SDL_CreateRGBSurface" + std::string(SDL_GetError()) , LOG_TYPE::L_ERROR);
+		SDL_FreeSurface(glyph);
+		return nullptr;
+	}
+	SDL_BlitSurface(glyph, NULL, surface, NULL);
+
+	// the glyph is rendered on the whole line height, keep only its visible part
+	const uint32_t *pixels = (const uint32_t *) surface->pixels;
+	const int pitch = surface->pitch / 4;
+	const uint32_t amask = surface->format->Amask;
+	int left = surface->w, right = -1, top = surface->h, bottom = -1;
+	for (int y = 0; y < surface->h; ++y) {
+		for (int x = 0; x < surface->w; ++x) {
+			if (pixels[y * pitch + x] & amask) {
+				left = std::min(left, x);
+				right = std::max(right, x);
+				top = std::min(top, y);
+				bottom = y;
+			}
+		}
+	}
+	// a glyph surface starts at the pen position, or at the left of the glyph if it goes before the pen
+	const GlyphInfo *info = (right < 0) ?
+		atlas->insert(c, 0, 0, nullptr, 0, 0, 0, advance) :
+		atlas->insert(c, right - left + 1, bottom - top + 1, pixels + top * pitch + left, pitch, std::min(0, minx) + left, top, advance);
+	SDL_FreeSurface(surface);
+	SDL_FreeSurface(glyph);
+	return info;
+}
+
+bool s_font::loadGlyphs()
+{
+	bool complete = true;
+	for (uint32_t c : codepoints) {
+		if (!atlas->find(c) && !renderGlyph(c)) {
+			complete = false;
+			break;
+		}
+	}
+	// upload the modified pages, the glyphs already drawn are rewritten with the same pixels
+	for (int i = 0; i < atlas->getNbPages(); ++i) {
+		if (!atlas->isDirty(i))
+			continue;
+		if (i == (int) atlasTextures.size()) {
+			atlasTextures.push_back(tileMap->acquireSurface(atlas->getPageWidth(), atlas->getPageHeight()));
+			if (!atlasTextures.back().width) {
+				// no room left, the glyphs of this page are lost
+				atlasTextures.pop_back();
+				atlas->limitPages(i);
+				return false;
+			}
+		}
+		SubTexture &tex = atlasTextures[i];
+		tileMap->writeSurface(tex, atlas->getPixels(i));
+		atlas->setPageRect(i, tex.x1, tex.y1, tex.x2, tex.y2);
+	}
+	return complete;
 }
 
 void s_font::beginPrint()
 {
 	printData[Context::instance->frameIdx].first.clear();
 	printData[Context::instance->frameIdx].second.clear();
+	printRunData[Context::instance->frameIdx].first.clear();
+	printRunData[Context::instance->frameIdx].second.clear();
 	if (needFlush) {
 		// Clear every subtextures, both cached and uncached.
 		// Needing to flush will cause graphical glitch for one frame (due to missing texture)
@@ -161,7 +296,7 @@ void s_font::beginPrint()
 //! print out a string
 void s_font::print(float x, float y, const std::string& s, Vec4f Color, Mat4f MVP, int upsidedown, bool cache)
 {
-	if (s.empty())
+	if (s.empty() || printRun(x, y, s, Color, MVP, upsidedown))
 		return;
 
 	renderedString_struct currentRender;
@@ -196,6 +331,36 @@ void s_font::print(float x, float y, const std::string& s, Vec4f Color, Mat4f MV
 		cLog::get()->write("Limit of " + std::to_string(tmp.capacity()) + " print per frame reach, next attempt will be skipped\n", LOG_TYPE::L_WARNING);
 }
 
+bool s_font::printRun(float x, float y, const std::string& s, const Vec4f &Color, const Mat4f &MVP, int upsidedown)
+{
+	if (!atlas || !GlyphAtlas::decodeUTF8(s, codepoints) || codepoints.size() > GLYPH_RUN_MAX || !loadGlyphs())
+		return false;
+
+	Context &context = *Context::instance;
+	auto &runs = printRunData[context.frameIdx].first;
+	auto &quads = printRunData[context.frameIdx].second;
+	if (runs.capacity() == runs.size())
+		return true;
+	// quads must not be reallocated, they are read by the draw helper
+	if (quads.capacity() - quads.size() < codepoints.size()) {
+		cLog::get()->write("Limit of " + std::to_string(quads.capacity()) + " glyphs per frame reach, print skipped\n", LOG_TYPE::L_WARNING);
+		return true;
+	}
+	const size_t first = quads.size();
+	atlas->layout(codepoints, TEXT_MARGIN_X, TEXT_MARGIN_Y, quads, [this](uint32_t previous, uint32_t c) {
+		return TTF_GetFontKerningSizeGlyphs(myFont, previous, c);
+	});
+	if (quads.size() == first)
+		return true; // nothing visible
+
+	const float h = lineHeight + 2 * TEXT_MARGIN_Y;
+	runs.push_back({DRAW_PRINT_RUN, (unsigned short) (quads.size() - first), x, y - lineHeight, upsidedown ? -h : h, Color, quads.data() + first, MVP});
+	context.helper->draw(&runs.back());
+	if (runs.capacity() == runs.size())
+		cLog::get()->write("Limit of " + std::to_string(runs.capacity()) + " print per frame reach, next attempt will be skipped\n", LOG_TYPE::L_WARNING);
+	return true;
+}
+
 float s_font::getStrLen(const std::string& s)
 {
 	if (s.empty())
@@ -251,27 +416,12 @@ renderedString_struct s_font::renderString(const std::string &s, bool withBorder
 	rendering.stringH = text->h;
 	rendering.haveBorder =  false;
 
-	const unsigned short decalageX = 2;
-	const unsigned short decalageY = 1;
+	const unsigned short decalageX = TEXT_MARGIN_X;
+	const unsigned short decalageY = TEXT_MARGIN_Y;
 	rendering.textureW = text->w+2*decalageX;
 	rendering.textureH = text->h+2*decalageY;
 
-	Uint32 rmask, gmask, bmask, amask;
-
-	/* SDL interprets each pixel as a 32-bit number, so our masks must depend on the endianness (byte order) of the machine */
-	#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-	 rmask = 0xff000000;
-	 gmask = 0x00ff0000;
-	 bmask = 0x0000ff00;
-	 amask = 0x000000ff;
-	#else
-	 rmask = 0x000000ff;
-	 gmask = 0x0000ff00;
-	 bmask = 0x00ff0000;
-	 amask = 0xff000000;
-	#endif
-
-	SDL_Surface *surface = SDL_CreateRGBSurface(SDL_SWSURFACE, (int)rendering.textureW, (int)rendering.textureH, 32, rmask, gmask, bmask, amask);
+	SDL_Surface *surface = createRGBASurface((int)rendering.textureW, (int)rendering.textureH);
 	renderedString_struct nothing;
 	nothing.textureW = nothing.textureH = nothing.stringW = nothing.stringH = 0;
 	nothing.haveBorder =false;
@@ -311,7 +461,7 @@ renderedString_struct s_font::renderString(const std::string &s, bool withBorder
 		// creation of the border
 		//
 		// ***********************************
-		SDL_Surface *border = SDL_CreateRGBSurface(SDL_SWSURFACE, (int)rendering.textureW, (int)rendering.textureH, 32, rmask, gmask, bmask, amask);
+		SDL_Surface *border = createRGBASurface((int)rendering.textureW, (int)rendering.textureH);
 		if(!border)  {
 			cLog::get()->write("s_font "+ fontName +": error SDL_CreateRGBSurface" + std::string(SDL_GetError()) , LOG_TYPE::L_ERROR);
 			SDL_FreeSurface(text);
@@ -36,6 +36,7 @@
 #include "tools/s_font_common.hpp"
 #include "tools/s_texture.hpp"
 #include "tools/draw_helper.hpp"
+#include "tools/glyph_atlas.hpp"
 #include "EntityCore/SubTexture.hpp"
 
 class VertexArray;
@@ -69,6 +70,9 @@ typedef renderedStringHash_t::const_iterator renderedStringHashIter_t;
  * for OpenGL to display it in two ways:
  * - display parallel to the horizon
  * - right display, in the sky.
+ *
+ * print draws the strings glyph by glyph from an atlas of the font, only the new glyphs are rasterized.
+ * printHorizontal and the strings which can't be drawn from the atlas still get one texture per string.
  */
 class s_font {
 
@@ -80,6 +84,7 @@ public:
 	void rebuild(float size_i, const std::string& ttfFileName);
 
 	//! display a text s right at the point M(x,y) of color Color at the position MVP with upsidedown indicating if it is upright or upside down
+	//! cached indicates whether to keep the texture of s when it can't be drawn from the glyph atlas
 	void print(float x, float y, const std::string& s, Vec4f Color, Mat4f MVP ,int upsidedown, bool cached = true);
 	//! display a text parallel to the horizon in altitude azimuth
 	//! cache indicates whether to keep the text in memory
@@ -103,10 +108,25 @@ public:
 	}
 protected:
 	renderedString_struct renderString(const std::string &s, bool withBorder) const;
+	//! draw s from the glyph atlas, return false if s can't be drawn this way
+	bool printRun(float x, float y, const std::string& s, const Vec4f &Color, const Mat4f &MVP, int upsidedown);
+	//! rasterize the glyphs of codepoints missing in the atlas and upload the modified pages
+	bool loadGlyphs();
+	//! rasterize a glyph into the atlas
+	const GlyphInfo *renderGlyph(uint32_t c);
+	//! create the atlas of the current font with the printable ASCII characters
+	void initAtlas();
+	//! release the atlas pages
+	void releaseAtlas();
 	renderedStringHash_t renderCache;
+	std::unique_ptr<GlyphAtlas> atlas;
+	std::vector<SubTexture> atlasTextures; // one per atlas page
+	std::vector<uint32_t> codepoints; // string being printed
+	int lineHeight; // height of a line in pixels
 	static std::vector<renderedString_struct> tempCache, tempCache2; // to hold texture while it is used
 	static std::string lastUncached;
 	static std::vector<std::pair<std::vector<struct s_print>, std::vector<struct s_printh>>> printData;
+	static std::vector<std::pair<std::vector<struct s_printrun>, std::vector<GlyphQuad>>> printRunData;
 	static std::list<s_font *> fontList;
 	std::list<s_font *>::iterator self;
 
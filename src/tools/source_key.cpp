@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 of the LSS Team & Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "tools/source_key.hpp"
+
+#define SOURCE_KEY_BLOCK (1<<16)
+
+uint64_t SourceKey::hashData(const char *data, size_t size, uint64_t hash)
+{
+	// FNV-1a
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= (unsigned char) data[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+uint64_t SourceKey::hashFile(const std::string &fileName)
+{
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file)
+		return 0;
+	std::vector<char> block(SOURCE_KEY_BLOCK);
+	uint64_t hash = 0xcbf29ce484222325ull;
+	while (file) {
+		file.read(block.data(), block.size());
+		hash = hashData(block.data(), file.gcount(), hash);
+	}
+	return file.eof() ? hash : 0;
+}
+
+bool SourceKey::read(const std::string &fileName)
+{
+	std::error_code ec;
+	size = std::filesystem::file_size(fileName, ec);
+	if (ec)
+		return false;
+	mtime = std::filesystem::last_write_time(fileName, ec).time_since_epoch().count();
+	if (ec)
+		return false;
+	hash = hashFile(fileName);
+	return hash != 0;
+}
+
+bool SourceKey::matches(const std::string &fileName)
+{
+	std::error_code ec;
+	if (std::filesystem::file_size(fileName, ec) != size || ec)
+		return false;
+	const int64_t date = std::filesystem::last_write_time(fileName, ec).time_since_epoch().count();
+	if (ec)
+		return hashFile(fileName) == hash;
+	if (date == mtime)
+		return true;
+	if (hashFile(fileName) != hash)
+		return false;
+	mtime = date;
+	return true;
+}
+
+bool SourceKey::writeTo(const std::string &fileName, uint64_t offset) const
+{
+	std::fstream file(fileName, std::ios::binary | std::ios::in | std::ios::out);
+	file.seekp(offset);
+	file.write((const char *) this, sizeof(*this));
+	return file.good();
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2020 of the LSS Team & Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// identity of the text sources compiled into a binary cache at the first start
+
+#ifndef _SOURCE_KEY_H
+#define _SOURCE_KEY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/**
+ * \struct SourceKey
+ * \brief size, date and hash of a source file, stored in the header of the cache built from it
+ *
+ * The cache is valid while the size and the date of the source are the same. A source with
+ * the same size but another date, copied again at the installation for example, is hashed
+ * and its cache is kept when the hash is the same. The new date is then written back in the
+ * cache, so that the source isn't hashed again at the next start.
+ */
+struct SourceKey {
+	uint64_t size = 0;
+	int64_t mtime = 0;
+	uint64_t hash = 0;
+
+	//! read the key of fileName, return false if it can't be read
+	bool read(const std::string &fileName);
+	//! tell if a cache built from a source with this key is valid for fileName
+	//! when only the date differs, mtime takes the date of fileName so that writeTo can store it
+	bool matches(const std::string &fileName);
+	//! write this key at offset in the cache fileName, return false if it can't be written
+	bool writeTo(const std::string &fileName, uint64_t offset) const;
+
+	static uint64_t hashData(const char *data, size_t size, uint64_t hash = 0xcbf29ce484222325ull);
+	//! hash of the content of fileName, 0 if it can't be read
+	static uint64_t hashFile(const std::string &fileName);
+};
+
+#endif // _SOURCE_KEY_H
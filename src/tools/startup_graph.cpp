@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2020 of the LSS Team & Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include "tools/startup_graph.hpp"
+#include "tools/ThreadPool.hpp"
+#include "tools/log.hpp"
+
+void StartupGraph::add(const std::string &name, const std::vector<std::string> &after, std::function<void()> task, bool mainThread)
+{
+	Task t;
+	t.name = name;
+	t.run = std::move(task);
+	t.mainThread = mainThread;
+	for (const auto &dependency : after) {
+		auto it = std::find_if(tasks.begin(), tasks.end(), [&](const Task &other) {
+			return other.name == dependency;
+		});
+		if (it == tasks.end()) {
+			// only the tasks already added can be waited, there is no cycle
+			cLog::get()->write("StartupGraph: " + name + " is after the unknown task " + dependency, LOG_TYPE::L_ERROR);
+			continue;
+		}
+		t.after.push_back(it - tasks.begin());
+		it->before.push_back(tasks.size());
+	}
+	t.remaining = t.after.size();
+	tasks.push_back(std::move(t));
+}
+
+void StartupGraph::run(ThreadPool &pool)
+{
+	const auto origin = std::chrono::steady_clock::now();
+	auto now = [origin]() {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - origin).count();
+	};
+	nbWorkers = pool.size();
+
+	// the state of the graph is shared under lock, the tasks run outside
+	std::mutex lock;
+	std::condition_variable changed;
+	std::deque<int> mainReady;		// tasks waiting for the calling thread
+	std::deque<int> workerReady;	// tasks waiting for a worker, in the order they were added
+	int running = 0;				// tasks given to the workers
+	size_t nbDone = 0;
+	std::exception_ptr error;
+
+	auto execute = [&](int index) {
+		Task &t = tasks[index];
+		t.start = now();
+		try {
+			t.run();
+		} catch (...) {
+			t.failed = true;
+			std::lock_guard<std::mutex> guard(lock);
+			if (!error)
+				error = std::current_exception();
+		}
+		t.end = now();
+	};
+	std::function<void(int)> complete;
+	auto dispatch = [&](int index) {
+		Task &t = tasks[index];
+		t.ready = now();
+		if (t.failed) {
+			// skipped, a task it is after has failed
+			t.start = t.end = t.ready;
+			complete(index);
+		} else if (t.mainThread) {
+			mainReady.push_back(index);
+		} else {
+			workerReady.push_back(index);
+		}
+	};
+	std::function<void()> launch;
+	complete = [&](int index) {
+		++nbDone;
+		for (int next : tasks[index].before) {
+			tasks[next].failed |= tasks[index].failed;
+			if (--tasks[next].remaining == 0)
+				dispatch(next);
+		}
+	};
+	// the pool runs the last task pushed first, the tasks are given one per worker to keep their order
+	launch = [&]() {
+		while (running < nbWorkers && !workerReady.empty()) {
+			const int index = workerReady.front();
+			workerReady.pop_front();
+			++running;
+			pool.submit([&, index]() {
+				execute(index);
+				std::lock_guard<std::mutex> guard(lock);
+				--running;
+				complete(index);
+				launch();
+				changed.notify_one();
+			});
+		}
+	};
+
+	std::unique_lock<std::mutex> guard(lock);
+	for (size_t i = 0; i < tasks.size(); ++i) {
+		if (tasks[i].remaining == 0)
+			dispatch(i);
+	}
+	launch();
+	while (nbDone < tasks.size()) {
+		changed.wait(guard, [&]() { return !mainReady.empty() || nbDone == tasks.size(); });
+		if (mainReady.empty())
+			break;
+		const int index = mainReady.front();
+		mainReady.pop_front();
+		guard.unlock();
+		execute(index);
+		guard.lock();
+		complete(index);
+		launch();
+	}
+	guard.unlock();
+	wallTime = now();
+
+	std::istringstream report(getReport());
+	for (std::string line; std::getline(report, line);)
+		cLog::get()->write("Startup: " + line, LOG_TYPE::L_INFO);
+	if (error)
+		std::rethrow_exception(error);
+}
+
+std::vector<int> StartupGraph::getCriticalPath() const
+{
+	// from the task which ended last, back through the task which held each one: the last of its
+	// dependencies, or the task which kept its thread busy once it was ready
+	int index = -1;
+	for (size_t i = 0; i < tasks.size(); ++i) {
+		if (index < 0 || tasks[i].end > tasks[index].end)
+			index = i;
+	}
+	std::vector<int> path;
+	while (index >= 0) {
+		const Task &t = tasks[index];
+		path.push_back(index);
+		int previous = -1;
+		for (int dependency : t.after) {
+			if (previous < 0 || tasks[dependency].end > tasks[previous].end)
+				previous = dependency;
+		}
+		for (size_t i = 0; i < tasks.size(); ++i) {
+			const Task &other = tasks[i];
+			if (other.mainThread == t.mainThread && other.start < t.start && other.end >= t.ready && other.end <= t.start
+				&& (previous < 0 || other.end > tasks[previous].end))
+				previous = i;
+		}
+		index = previous;
+	}
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+
+double StartupGraph::getCriticalTime() const
+{
+	double total = 0;
+	for (int index : getCriticalPath())
+		total += tasks[index].end - tasks[index].start;
+	return total;
+}
+
+std::string StartupGraph::getReport() const
+{
+	std::ostringstream oss;
+	char line[256];
+	double busy = 0;
+	size_t width = 0;
+	for (const auto &t : tasks) {
+		busy += t.end - t.start;
+		width = std::max(width, t.name.size());
+	}
+	snprintf(line, sizeof(line), "%zu tasks in %.0f ms on the main thread and %d workers, %.0f ms of work\n", tasks.size(), wallTime, nbWorkers, busy);
+	oss << line;
+	for (const auto &t : tasks) {
+		snprintf(line, sizeof(line), "  %-*s %-6s ready %6.0f ms  start %6.0f ms  end %6.0f ms  (%.0f ms)%s\n", (int) width, t.name.c_str(),
+			t.mainThread ? "main" : "worker", t.ready, t.start, t.end, t.end - t.start, t.failed ? " failed" : "");
+		oss << line;
+	}
+
+	const std::vector<int> path = getCriticalPath();
+	snprintf(line, sizeof(line), "critical path %.0f ms:", getCriticalTime());
+	oss << line;
+	for (size_t i = 0; i < path.size(); ++i) {
+		const Task &t = tasks[path[i]];
+		snprintf(line, sizeof(line), "%s %s (%.0f ms)", i ? " >" : "", t.name.c_str(), t.end - t.start);
+		oss << line;
+	}
+	oss << "\n";
+	return oss.str();
+}
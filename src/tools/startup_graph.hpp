@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2020 of the LSS Team & Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// startup tasks run on worker threads in the order of their dependencies
+
+#ifndef _STARTUP_GRAPH_H
+#define _STARTUP_GRAPH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "tools/no_copy.hpp"
+
+class ThreadPool;
+
+#define STARTUP_MAIN_THREAD true
+#define STARTUP_WORKER false
+
+/**
+ * \class StartupGraph
+ * \brief set of loading tasks with their dependencies, and timeline of their execution
+ *
+ * A task runs once all the tasks it is declared after are done. The tasks which use the
+ * vulkan context or a non thread-safe resource are flagged STARTUP_MAIN_THREAD and run
+ * on the thread calling run(), the others run on the pool meanwhile.
+ * The dependents of a task which throws are skipped and run() rethrows its exception.
+ */
+class StartupGraph : public NoCopy {
+public:
+	//! add a task, after holds the names of tasks added before this one
+	void add(const std::string &name, const std::vector<std::string> &after, std::function<void()> task, bool mainThread = STARTUP_WORKER);
+	//! run every task and write the timeline in the log
+	void run(ThreadPool &pool);
+	//! timeline of the last run: start, duration and thread of each task, then the critical path
+	std::string getReport() const;
+	//! duration of the last run, in ms
+	double getWallTime() const {
+		return wallTime;
+	}
+	//! sum of the durations of the tasks on the critical path of the last run, in ms
+	double getCriticalTime() const;
+
+private:
+	std::vector<int> getCriticalPath() const;
+	struct Task {
+		std::string name;
+		std::vector<int> after;
+		std::vector<int> before; // tasks waiting for this one
+		std::function<void()> run;
+		bool mainThread;
+		int remaining = 0;		// unfinished tasks of after
+		bool failed = false;	// thrown or skipped
+		double ready = 0;		// times in ms from the beginning of run()
+		double start = 0;
+		double end = 0;
+	};
+	std::vector<Task> tasks;
+	double wallTime = 0;
+	int nbWorkers = 0;
+};
+
+#endif // _STARTUP_GRAPH_H
@@ -0,0 +1,157 @@
+// Cost of the sky color grid of Atmosphere::computeColor: point by point
+// kernels against the row kernels, on one thread and on the ThreadPool
+//
+// g++ -Ofast -std=c++20 -pthread -I../../src main.cpp ../../src/atmosphereModule/skylight.cpp ../../src/atmosphereModule/skybright.cpp ../../src/atmosphereModule/tone_reproductor.cpp -o atmosphere_kernel
+
+#include "atmosphereModule/skylight.hpp"
+#include "atmosphereModule/skybright.hpp"
+#include "atmosphereModule/tone_reproductor.hpp"
+#include "tools/ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#define MAX_RESOLUTION 254
+
+struct Grid {
+    unsigned int n; // points per row
+    std::vector<float> x, y, z;
+};
+
+// directions of a fisheye of 180 degrees, the points outside the disk are folded back
+static Grid makeGrid(unsigned int resolution)
+{
+    Grid grid;
+    grid.n = resolution + 1;
+    for (unsigned int j = 0; j < grid.n; ++j) {
+        for (unsigned int i = 0; i < grid.n; ++i) {
+            const double u = 2.0 * i / resolution - 1, v = 2.0 * j / resolution - 1;
+            const double r = std::sqrt(u * u + v * v);
+            const double angle = r * M_PI_2;
+            const double s = r > 0 ? std::sin(angle) / r : 0;
+            grid.x.push_back(u * s);
+            grid.y.push_back(v * s);
+            grid.z.push_back(std::abs(std::cos(angle)));
+        }
+    }
+    return grid;
+}
+
+struct Sky {
+    Skylight sky;
+    Skybright skyb;
+    ToneReproductor eye;
+    float sun[3];
+    float moon[3];
+
+    Sky(float sunAltitude) {
+        const float a = sunAltitude * M_PI / 180;
+        sun[0] = cosf(a); sun[1] = 0; sun[2] = sinf(a);
+        moon[0] = -0.6f; moon[1] = 0.3f; moon[2] = 0.742f;
+        sky.setParamsv(sun, 5.f);
+        skyb.setDefaultMoonBrightness(1);
+        skyb.setLoc(45 * M_PI / 180, 200, 15, 40);
+        skyb.setSunMoon(moon[2], sun[2]);
+        skyb.setDate(2020, 6, 1.f);
+        eye.setWorldAdaptationLuminance(3.75f + 40000.f * std::max(0.f, sun[2]));
+    }
+};
+
+// previous loop of Atmosphere::computeColor
+static double pointByPoint(const Sky &s, const Grid &g, size_t first, size_t last, float *rgb)
+{
+    Skybright skyb = s.skyb; // getLuminance isn't const
+    double sum = 0;
+    skylight_struct2 b2;
+    for (size_t row = first; row < last; ++row) {
+        for (unsigned int i = 0; i < g.n; ++i) {
+            const size_t k = row * g.n + i;
+            b2.pos[0] = g.x[k]; b2.pos[1] = g.y[k]; b2.pos[2] = g.z[k];
+            s.sky.get_xyY_Valuev(b2);
+            b2.color[2] = skyb.getLuminance(s.moon[0]*b2.pos[0]+s.moon[1]*b2.pos[1]+s.moon[2]*b2.pos[2],
+                                            s.sun[0]*b2.pos[0]+s.sun[1]*b2.pos[1]+s.sun[2]*b2.pos[2], b2.pos[2]);
+            sum += b2.color[2];
+            s.eye.xyY_to_RGB(b2.color);
+            std::copy(b2.color, b2.color + 3, rgb + 3 * k);
+        }
+    }
+    return sum;
+}
+
+// loop of Atmosphere::computeRows
+static double byRow(const Sky &s, const Grid &g, size_t first, size_t last, float *rgb)
+{
+    float color[3][MAX_RESOLUTION+1];
+    float cosMoon[MAX_RESOLUTION+1];
+    float cosSun[MAX_RESOLUTION+1];
+    double sum = 0;
+    for (size_t row = first; row < last; ++row) {
+        const float *x = &g.x[row * g.n], *y = &g.y[row * g.n], *z = &g.z[row * g.n];
+        s.sky.get_xyY_Valuev(x, y, z, color[0], color[1], color[2], g.n);
+        for (unsigned int i = 0; i < g.n; ++i) {
+            cosMoon[i] = s.moon[0]*x[i] + s.moon[1]*y[i] + s.moon[2]*z[i];
+            cosSun[i] = s.sun[0]*x[i] + s.sun[1]*y[i] + s.sun[2]*z[i];
+        }
+        s.skyb.getLuminance(cosMoon, cosSun, z, color[2], g.n);
+        for (unsigned int i = 0; i < g.n; ++i)
+            sum += color[2][i];
+        s.eye.xyY_to_RGB(color[0], color[1], color[2], g.n);
+        for (unsigned int i = 0; i < g.n; ++i)
+            for (int c = 0; c < 3; ++c)
+                rgb[3 * (row * g.n + i) + c] = color[c][i];
+    }
+    return sum;
+}
+
+template<class F>
+static double timeMs(int repeat, F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; ++r)
+        f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeat;
+}
+
+int main()
+{
+    ThreadPool &pool = ThreadPool::shared();
+    printf("%zu workers + calling thread\n\n", pool.size());
+
+    const float altitudes[] = {45.f, 2.f, -8.f, -30.f};
+    printf("error of the row kernels at resolution 128\n");
+    const Grid grid = makeGrid(128);
+    for (float altitude : altitudes) {
+        Sky sky(altitude);
+        std::vector<float> ref(3 * grid.n * grid.n), row(ref.size());
+        const double sumRef = pointByPoint(sky, grid, 0, grid.n, ref.data());
+        const double sumRow = byRow(sky, grid, 0, grid.n, row.data());
+        float maxRgb = 0, maxDiff = 0;
+        for (size_t i = 0; i < ref.size(); ++i) {
+            maxRgb = std::max(maxRgb, std::abs(ref[i]));
+            maxDiff = std::max(maxDiff, std::abs(ref[i] - row[i]));
+        }
+        printf("  sun at %5.1f deg: max |rgb diff| %.2e (max rgb %.3f), luminance sum rel. diff %.2e\n",
+               altitude, maxDiff, maxRgb, std::abs(sumRow - sumRef) / sumRef);
+    }
+
+    printf("\ntime of one grid (ms)\n%10s %14s %10s %14s\n", "resolution", "point by point", "by row", "by row + pool");
+    for (unsigned int resolution : {48u, 128u, 192u, 254u}) {
+        const Grid g = makeGrid(resolution);
+        Sky sky(2.f);
+        std::vector<float> rgb(3 * g.n * g.n);
+        std::vector<double> rowSum(g.n);
+        const int repeat = 40;
+        const double tPoint = timeMs(repeat, [&] { pointByPoint(sky, g, 0, g.n, rgb.data()); });
+        const double tRow = timeMs(repeat, [&] { byRow(sky, g, 0, g.n, rgb.data()); });
+        const double tPool = timeMs(repeat, [&] {
+            pool.parallelFor(0, g.n, 4, [&](size_t first, size_t last) {
+                for (size_t r = first; r < last; ++r)
+                    rowSum[r] = byRow(sky, g, r, r + 1, rgb.data());
+            });
+        });
+        printf("%10u %14.3f %10.3f %14.3f\n", resolution, tPoint, tRow, tPool);
+    }
+    return 0;
+}
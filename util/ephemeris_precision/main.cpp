@@ -0,0 +1,104 @@
+// Error and speedup of the truncated VSOP87 and ELP82B series
+// against the full series, for several tolerances
+//
+// gcc -O2 -c ../../planetsephems/*.c
+// g++ -O2 -std=c++17 -I../../planetsephems main.cpp *.o -o ephemeris_precision
+
+#include "stellplanet.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+typedef void (PositionFunction)(double jd, double xyz[3]);
+typedef void (ToleranceFunction)(double tolerance);
+
+struct Ephemeris {
+    const char *name;
+    PositionFunction *position;
+    ToleranceFunction *tolerance;
+};
+
+static const Ephemeris ephemeris[] = {
+    {"mercury", get_mercury_helio_coordsv, set_mercury_helio_tolerance},
+    {"venus", get_venus_helio_coordsv, set_venus_helio_tolerance},
+    {"emb", get_emb_helio_coordsv, set_emb_helio_tolerance},
+    {"mars", get_mars_helio_coordsv, set_mars_helio_tolerance},
+    {"jupiter", get_jupiter_helio_coordsv, set_jupiter_helio_tolerance},
+    {"saturn", get_saturn_helio_coordsv, set_saturn_helio_tolerance},
+    {"uranus", get_uranus_helio_coordsv, set_uranus_helio_tolerance},
+    {"neptune", get_neptune_helio_coordsv, set_neptune_helio_tolerance},
+    {"moon", get_lunar_parent_coordsv, set_lunar_parent_tolerance},
+};
+static const int nbEphemeris = sizeof(ephemeris) / sizeof(ephemeris[0]);
+
+static const double AU_KM = 149597870.691;
+
+// the dates are far enough from each other to defeat the interpolation of planetsephems
+static std::vector<double> randomDates(int count)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> dist(2086302.5, 2816787.5); // 1000-3000
+    std::vector<double> dates(count);
+    for (double &jd : dates)
+        jd = dist(rng);
+    return dates;
+}
+
+static void setTolerance(double tolerance)
+{
+    for (int i = 0; i < nbEphemeris; ++i)
+        ephemeris[i].tolerance(tolerance);
+}
+
+// average time of one call in microseconds
+static double timeEphemeris(const Ephemeris &e, const std::vector<double> &dates)
+{
+    double xyz[3], sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (double jd : dates) {
+        e.position(jd, xyz);
+        sum += xyz[0];
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    if (sum == 0.123456789)
+        printf(" ");
+    return elapsed.count() / dates.size();
+}
+
+int main()
+{
+    const std::vector<double> dates = randomDates(2000);
+    const double tolerances[] = {1e-8, 1e-7, 1e-6, 1e-5, 1e-4, 1e-3};
+
+    // reference positions and timings with the full series
+    std::vector<double> reference(nbEphemeris * dates.size() * 3);
+    double fullTime[nbEphemeris];
+    setTolerance(0);
+    for (int i = 0; i < nbEphemeris; ++i) {
+        for (size_t d = 0; d < dates.size(); ++d)
+            ephemeris[i].position(dates[d], &reference[(i * dates.size() + d) * 3]);
+        fullTime[i] = timeEphemeris(ephemeris[i], dates);
+    }
+
+    printf("%-8s %12s %14s %14s %10s\n", "body", "tolerance", "max error", "time", "speedup");
+    for (int i = 0; i < nbEphemeris; ++i) {
+        printf("%-8s %12s %14s %11.1f us %10s\n", ephemeris[i].name, "full", "0", fullTime[i], "1.0");
+        for (double tolerance : tolerances) {
+            setTolerance(tolerance);
+            double maxError = 0;
+            for (size_t d = 0; d < dates.size(); ++d) {
+                double xyz[3];
+                const double *ref = &reference[(i * dates.size() + d) * 3];
+                ephemeris[i].position(dates[d], xyz);
+                maxError = std::max(maxError, std::sqrt((xyz[0] - ref[0]) * (xyz[0] - ref[0]) + (xyz[1] - ref[1]) * (xyz[1] - ref[1]) + (xyz[2] - ref[2]) * (xyz[2] - ref[2])));
+            }
+            const double time = timeEphemeris(ephemeris[i], dates);
+            printf("%-8s %9g AU %11.1f km %11.1f us %10.1f\n", ephemeris[i].name, tolerance, maxError * AU_KM, time, fullTime[i] / time);
+        }
+    }
+    setTolerance(0);
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Cost of a GeodesicGrid::search which misses the cache, and the hits of a panning view,
+// with the default margin and with a margin of 1 zone
+//
+// g++ -O2 -std=c++20 -I../../src main.cpp ../../src/starModule/geodesic_grid.cpp ../../src/starModule/sphere_geometry.cpp -o geodesic_search
+
+#include "starModule/geodesic_grid.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+using namespace StelGeom;
+
+static double now()
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// view of 60 degrees in the direction (ra, de)
+static ConvexS view(double ra, double de)
+{
+	auto dir = [](double a, double d) { return Vec3d(cos(d)*cos(a), cos(d)*sin(a), sin(d)); };
+	const double h = 30*M_PI/180;
+	return ConvexS(dir(ra-h, de-h), dir(ra+h, de-h), dir(ra+h, de+h), dir(ra-h, de+h));
+}
+
+static void count(const GeodesicSearchResult &r, int level, int &inside, int &border)
+{
+	inside = border = 0;
+	GeodesicSearchInsideIterator it(r, level);
+	while (it.next() >= 0)
+		inside++;
+	GeodesicSearchBorderIterator bt(r, level);
+	while (bt.next() >= 0)
+		border++;
+}
+
+// every search is of a new region, 1 degree apart
+static void miss(int level, double margin)
+{
+	GeodesicGrid grid(level);
+	grid.setSearchMargin(margin);
+	const int searches = 1000;
+	int inside = 0, border = 0;
+	const double t = now();
+	for (int i = 0; i < searches; ++i) {
+		auto r = grid.search(view(i*M_PI/180, 0.3), level);
+		if (i == 0)
+			count(*r, level, inside, border);
+	}
+	printf("level %d margin %.0f: %.3f ms per miss, %d inside zones, %d border zones\n",
+	       level, margin, (now() - t) / searches, inside, border);
+}
+
+// pan of 0.05 degree per frame, plus a picking search around a fixed point every frame
+static void pan(int level, double margin)
+{
+	GeodesicGrid grid(level);
+	grid.setSearchMargin(margin);
+	const int frames = 2000;
+	const double t = now();
+	for (int f = 0; f < frames; ++f) {
+		grid.search(view(f*0.05*M_PI/180, 0.3), level);
+		grid.search(view(1.0, -0.5), level);
+	}
+	printf("level %d margin %.0f pan: %lu hits, %lu misses, %.1f ms\n",
+	       level, margin, grid.getSearchHits(), grid.getSearchMisses(), now() - t);
+}
+
+int main()
+{
+	for (int level : {5, 7}) {
+		miss(level, GEODESIC_SEARCH_MARGIN);
+		miss(level, 1);
+		pan(level, GEODESIC_SEARCH_MARGIN);
+		pan(level, 1);
+	}
+	return 0;
+}
@@ -0,0 +1,173 @@
+// Headless checks of the glyph atlas: shelf packing, UTF-8 decoding, glyph run layout,
+// and cost of the layout of labels changing every frame once the atlas is warm.
+//
+// g++ -O2 -std=c++20 -I../../src main.cpp ../../src/tools/glyph_atlas.cpp -o glyph_atlas
+
+#include "tools/glyph_atlas.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAILED line %d: %s\n", __LINE__, #cond); failures++; } } while (0)
+
+struct Rect {
+	int x, y, w, h;
+};
+
+static void checkPacker()
+{
+	const int width = 256, height = 128;
+	GlyphShelfPacker packer(width, height);
+	std::mt19937 rng(42);
+	std::vector<Rect> rects;
+	int area = 0;
+	for (;;) {
+		Rect r {0, 0, 3 + (int) (rng() % 14), 10 + (int) (rng() % 8)};
+		if (!packer.insert(r.w, r.h, r.x, r.y))
+			break;
+		rects.push_back(r);
+		area += r.w * r.h;
+	}
+	for (size_t i = 0; i < rects.size(); ++i) {
+		const Rect &a = rects[i];
+		CHECK(a.x >= 0 && a.y >= 0 && a.x + a.w <= width && a.y + a.h <= height);
+		for (size_t j = i + 1; j < rects.size(); ++j) {
+			const Rect &b = rects[j];
+			CHECK(a.x + a.w <= b.x || b.x + b.w <= a.x || a.y + a.h <= b.y || b.y + b.h <= a.y);
+		}
+	}
+	CHECK(packer.getUsedHeight() <= height);
+	int x, y;
+	CHECK(!packer.insert(width + 1, 1, x, y));
+	packer.clear();
+	CHECK(packer.insert(10, 10, x, y) && x == 0 && y == 0);
+	printf("packer: %zu glyphs in %dx%d, %.0f %% of the page filled\n", rects.size(), width, height, 100. * area / (width * height));
+}
+
+static void checkDecode()
+{
+	std::vector<uint32_t> text;
+	CHECK(GlyphAtlas::decodeUTF8("A\xc3\xa9\xe2\x82\xac\xf0\x9f\x8c\x8d", text));
+	CHECK(text.size() == 4 && text[0] == 'A' && text[1] == 0xe9 && text[2] == 0x20ac && text[3] == 0x1f30d);
+	CHECK(GlyphAtlas::decodeUTF8("", text) && text.empty());
+	CHECK(!GlyphAtlas::decodeUTF8("\xc3", text));		// truncated
+	CHECK(!GlyphAtlas::decodeUTF8("\xe9t\xe9", text));	// latin-1
+	CHECK(!GlyphAtlas::decodeUTF8("\x80", text));		// lone continuation
+}
+
+// fake font: glyph c is (c % 7 + 3) pixels wide, 10 high, advance 8, the pixels hold the codepoint
+static void fillAtlas(GlyphAtlas &atlas, uint32_t first, uint32_t last)
+{
+	std::vector<uint32_t> bitmap;
+	for (uint32_t c = first; c <= last; ++c) {
+		if (c == ' ') {
+			atlas.insert(c, 0, 0, nullptr, 0, 0, 0, 4);
+			continue;
+		}
+		const int w = c % 7 + 3;
+		bitmap.assign(w * 10, c);
+		atlas.insert(c, w, 10, bitmap.data(), w, -1, 2, 8);
+	}
+}
+
+static void checkLayout()
+{
+	GlyphAtlas atlas(64, 32, 8);
+	fillAtlas(atlas, ' ', '~');
+	CHECK(atlas.getNbPages() > 1);
+	for (int i = 0; i < atlas.getNbPages(); ++i) {
+		CHECK(atlas.isDirty(i));
+		atlas.setPageRect(i, 0.5f, 0.25f, 0.75f, 0.5f);
+		CHECK(!atlas.isDirty(i));
+	}
+
+	std::vector<uint32_t> text;
+	std::vector<GlyphQuad> quads;
+	GlyphAtlas::decodeUTF8("AV A", text);
+	const float width = atlas.layout(text, 2, 1, quads, [](uint32_t previous, uint32_t c) {
+		return (previous == 'A' && c == 'V') ? -2 : 0;
+	});
+	CHECK(quads.size() == 3);				// the space has no quad
+	CHECK(width == 8 - 2 + 8 + 4 + 8);
+	CHECK(quads[0].x1 == 1 && quads[0].y1 == 3 && quads[0].x2 == 1 + 'A' % 7 + 3 && quads[0].y2 == 13);
+	CHECK(quads[1].x1 == 2 + 8 - 2 - 1);	// kerning
+	CHECK(quads[2].x1 == 2 + 8 - 2 + 8 + 4 - 1);
+
+	// the texture coordinates point to the bitmap of the glyph
+	for (size_t i = 0; i < quads.size(); ++i) {
+		const GlyphInfo *g = atlas.find(text[i < 2 ? i : 3]);
+		const GlyphQuad &q = quads[i];
+		CHECK(q.u1 >= 0.5f && q.u2 <= 0.75f && q.v1 >= 0.25f && q.v2 <= 0.5f);
+		const int px = (q.u1 - 0.5f) / 0.25f * 64 + 0.5f;
+		const int py = (q.v1 - 0.25f) / 0.25f * 32 + 0.5f;
+		CHECK(px == g->x && py == g->y);
+		CHECK(atlas.getPixels(g->page)[py * 64 + px] == text[i < 2 ? i : 3]);
+		CHECK(atlas.getPixels(g->page)[(py + 9) * 64 + px + g->w - 1] == text[i < 2 ? i : 3]);
+	}
+
+	// a full atlas refuses the glyph, a limited atlas drops the glyphs of the removed pages
+	std::vector<uint32_t> bitmap(60 * 30, 1);
+	GlyphAtlas small(64, 32, 1);
+	CHECK(small.insert('a', 60, 30, bitmap.data(), 60, 0, 0, 60));
+	CHECK(!small.insert('b', 60, 30, bitmap.data(), 60, 0, 0, 60));
+	const int pages = atlas.getNbPages();
+	atlas.limitPages(1);
+	CHECK(atlas.getNbPages() == 1 && atlas.find(' ') && atlas.find('!') && !atlas.find('~'));
+	printf("layout: %d pages of 64x32 for the printable ASCII characters\n", pages);
+}
+
+// labels of skyDisplay, a new string at each frame
+static void benchmark()
+{
+	GlyphAtlas atlas(GLYPH_PAGE_WIDTH, 128, 4);
+	fillAtlas(atlas, ' ', '~');
+	for (int i = 0; i < atlas.getNbPages(); ++i)
+		atlas.setPageRect(i, 0, 0, 1, 1);
+	const int pages = atlas.getNbPages();
+
+	const int count = 1000000;
+	std::vector<std::string> labels(count);
+	char label[64];
+	for (int i = 0; i < count; ++i) {
+		snprintf(label, sizeof(label), "RA %02dh%02dm%05.2fs DE %+03d %02d' %04.1f\"", i % 24, i % 60, (i % 6000) / 100., i % 90 - 45, i % 60, (i % 600) / 10.);
+		labels[i] = label;
+	}
+	std::vector<uint32_t> text;
+	std::vector<GlyphQuad> quads;
+	quads.reserve(16384);
+	double sum = 0;
+	size_t nbQuads = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; ++i) {
+		GlyphAtlas::decodeUTF8(labels[i], text);
+		if (quads.size() + text.size() > quads.capacity()) {
+			nbQuads += quads.size();
+			quads.clear(); // a frame
+		}
+		sum += atlas.layout(text, 2, 1, quads, [](uint32_t, uint32_t) { return 0; });
+	}
+	nbQuads += quads.size();
+	const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+	CHECK(atlas.getNbPages() == pages && !atlas.isDirty(0));
+	printf("benchmark: %d distinct labels, %.0f ns per label (decode and layout, %.1f glyphs each), no glyph added (%.0f)\n",
+		count, ns, (double) nbQuads / count, sum / count);
+}
+
+int main()
+{
+	checkPacker();
+	checkDecode();
+	checkLayout();
+	benchmark();
+	if (failures) {
+		printf("%d failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("all checks passed\n");
+	return EXIT_SUCCESS;
+}
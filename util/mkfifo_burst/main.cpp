@@ -0,0 +1,174 @@
+// Time to apply a burst of commands written into the Mkfifo pipe, with a main loop at 60 fps.
+// The previous reader (blocking read, sleep(1) once the writer has left, one command
+// taken per frame) is emulated for comparison.
+//
+// g++ -O2 -std=c++20 -pthread -I../../src main.cpp ../../src/appModule/mkfifo.cpp ../../src/tools/log.cpp -lSDL2 -o mkfifo_burst
+
+#include "appModule/mkfifo.hpp"
+#include "tools/log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FIFO_NEW "/tmp/mkfifo_burst_new.fifo"
+#define FIFO_OLD "/tmp/mkfifo_burst_old.fifo"
+#define BUFFER_SIZE 256
+#define BURST_SIZE 200
+#define FRAME std::chrono::microseconds(16667)
+#define BUDGET std::chrono::milliseconds(4)
+#define COMMAND_COST std::chrono::microseconds(20)
+#define NB_SINGLE 20
+#define SINGLE_PERIOD std::chrono::milliseconds(50)
+
+using Clock = std::chrono::steady_clock;
+
+// previous Mkfifo::thread and Mkfifo::update
+class OldMkfifo {
+public:
+	explicit OldMkfifo(const char *name) : filename(name) {
+		thread = std::thread([this] { run(); });
+	}
+	~OldMkfifo() {
+		is_active = false;
+		int fd = open(filename, O_WRONLY | O_NONBLOCK); // unblock read()
+		if (fd >= 0 && write(fd, "\n", 1) == 1)
+			close(fd);
+		thread.join();
+	}
+	bool update(std::string &output) {
+		if (from_outside.empty())
+			return false;
+		std::lock_guard<std::mutex> guard(lock);
+		output = from_outside.front();
+		from_outside.pop();
+		return true;
+	}
+
+private:
+	void run() {
+		std::vector<char> in(BUFFER_SIZE);
+		unlink(filename);
+		mkfifo(filename, S_IRWXU);
+		int fdtr = open(filename, O_RDONLY);
+		while (is_active) {
+			memset(in.data(), '\0', BUFFER_SIZE);
+			if (read(fdtr, in.data(), BUFFER_SIZE) == -1)
+				perror("read");
+			if (in[0] != '\0') {
+				in[BUFFER_SIZE - 1] = '\0';
+				std::lock_guard<std::mutex> guard(lock);
+				from_outside.push(in.data());
+			} else
+				sleep(1);
+		}
+		close(fdtr);
+		unlink(filename);
+	}
+
+	const char *filename;
+	std::thread thread;
+	std::atomic<bool> is_active{true};
+	std::mutex lock;
+	std::queue<std::string> from_outside;
+};
+
+static void waitFifo(const char *name)
+{
+	struct stat st;
+	while (stat(name, &st) != 0 || !S_ISFIFO(st.st_mode))
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+static Clock::time_point written[BURST_SIZE];
+
+// session 0: one open, BURST_SIZE lines in one write, close
+// session 1: NB_SINGLE times open, one command without line break, close, as util/server_standalone/writer_fifo.c
+static void writeBurst(const char *name, int session)
+{
+	if (session == 0) {
+		std::string burst;
+		for (int i = 0; i < BURST_SIZE; i++)
+			burst += "flag stars on " + std::to_string(i) + "\n";
+		int fd = open(name, O_WRONLY);
+		for (int i = 0; i < BURST_SIZE; i++)
+			written[i] = Clock::now();
+		if (write(fd, burst.data(), burst.size()) != (ssize_t) burst.size())
+			perror("write");
+		close(fd);
+	} else {
+		for (int i = 0; i < NB_SINGLE; i++) {
+			const std::string command = "flag stars on " + std::to_string(i);
+			int fd = open(name, O_WRONLY);
+			written[i] = Clock::now();
+			if (write(fd, command.data(), command.size()) != (ssize_t) command.size())
+				perror("write");
+			close(fd);
+			std::this_thread::sleep_for(SINGLE_PERIOD);
+		}
+	}
+}
+
+// main loop at 60 fps until the commands are applied or 10 s
+template<class Fifo>
+static void measure(const char *name, Fifo &fifo, const char *fifoName, bool budget)
+{
+	for (int session = 0; session < 2; session++) {
+		const int count = session ? NB_SINGLE : BURST_SIZE;
+		const Clock::time_point start = Clock::now();
+		std::thread writer(writeBurst, fifoName, session);
+		int applied = 0, garbled = 0, frames = 0;
+		double delay = 0, maxDelay = 0;
+		Clock::time_point last = start;
+		std::string out;
+		while (applied + garbled < count && Clock::now() - start < std::chrono::seconds(10)) {
+			const Clock::time_point frame = Clock::now();
+			const Clock::time_point deadline = frame + BUDGET;
+			while (fifo.update(out)) {
+				int index;
+				last = Clock::now();
+				if (sscanf(out.c_str(), "flag stars on %d", &index) == 1 && index >= 0 && index < count && out == "flag stars on " + std::to_string(index)) {
+					applied++;
+					const double d = std::chrono::duration<double, std::milli>(last - written[index]).count();
+					delay += d;
+					maxDelay = std::max(maxDelay, d);
+				} else
+					garbled++;
+				while (Clock::now() - last < COMMAND_COST); // executeCommand
+				if (!budget || Clock::now() >= deadline)
+					break;
+			}
+			frames++;
+			std::this_thread::sleep_until(frame + FRAME);
+		}
+		writer.join();
+		printf("%s, %s: %d/%d commands applied, %d garbled, last one after %.0f ms (%d frames), delay from the write mean %.0f ms max %.0f ms\n", name,
+			session ? "one writer per command" : "one writer for the burst", applied, count, garbled,
+			std::chrono::duration<double, std::milli>(last - start).count(), frames, applied ? delay / applied : 0., maxDelay);
+	}
+}
+
+int main()
+{
+	cLog::get()->setWriteLog(false);
+	{
+		OldMkfifo fifo(FIFO_OLD);
+		waitFifo(FIFO_OLD);
+		measure("read + one per frame", fifo, FIFO_OLD, false);
+	}
+	for (bool budget : {false, true}) {
+		Mkfifo fifo;
+		fifo.init(FIFO_NEW, BUFFER_SIZE);
+		waitFifo(FIFO_NEW);
+		measure(budget ? "poll + budget       " : "poll + one per frame", fifo, FIFO_NEW, budget);
+	}
+	return 0;
+}
@@ -0,0 +1,113 @@
+// Checks Projector::projectBatch against projectCustom in every PROJECTION_FRAME and times both,
+// then times a SkyLine polyline projected point by point as before (each inner point projected
+// twice by the segment tests) and in one projectBatch call.
+//
+// g++ -O2 -std=c++20 -DLINUX=1 -I../../src main.cpp ../../src/starModule/sphere_geometry.cpp -o projector_batch
+
+// Projector::printGravity180 is the only user of s_font and isn't called here
+#define _S_FONT_H
+#include "tools/vecmath.hpp"
+#include <string>
+class s_font {
+public:
+	float getStrLen(const std::string &) {
+		return 0;
+	}
+	void print(float, float, const std::string &, Vec4f, Mat4f, int, bool = true) {}
+};
+#include "coreModule/projector.cpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#define NB_POINTS 200000
+// largest accepted difference with projectCustom, in pixels
+#define MAX_ERROR 1e-9
+// points of a SkyLine circle and number of lines drawn
+#define LINE_POINTS 49
+#define NB_LINES 20000
+
+static double now()
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main()
+{
+	Projector prj(1920, 1080, 120.);
+	const Mat4d m = Mat4d::zrotation(0.3) * Mat4d::xrotation(1.1);
+	prj.setModelViewMatrices(m, m, m, m, Mat4d::yrotation(0.7), m, m);
+
+	std::mt19937 rng(1);
+	std::normal_distribution<double> gauss;
+	std::vector<Vec3d> in(NB_POINTS), out(NB_POINTS), ref(NB_POINTS);
+	std::vector<uint8_t> visible(NB_POINTS), refVisible(NB_POINTS);
+	for (Vec3d &v : in)
+		v = Vec3d(gauss(rng), gauss(rng), gauss(rng));
+	// behind, in front and on the axis of view
+	in[0] = Vec3d(0, 0, -1);
+	in[1] = Vec3d(0, 0, 2);
+	in[2] = Vec3d(m.r[2], m.r[6], m.r[10]);
+
+	int failures = 0;
+	printf("frame   max error px   visibility differences   projectCustom ms   projectBatch ms\n");
+	for (int f = 0; f < PF_COUNT; ++f) {
+		const PROJECTION_FRAME frame = (PROJECTION_FRAME) f;
+		const double t0 = now();
+		for (size_t i = 0; i < NB_POINTS; ++i)
+			refVisible[i] = prj.projectCustom(in[i], ref[i], prj.getMatFrameToEye(frame));
+		const double t1 = now();
+		prj.projectBatch(frame, in.data(), out.data(), visible.data(), NB_POINTS);
+		const double t2 = now();
+
+		double error = 0;
+		size_t differences = 0;
+		for (size_t i = 0; i < NB_POINTS; ++i) {
+			if (refVisible[i])
+				error = std::max(error, (out[i] - ref[i]).length());
+			differences += (visible[i] != refVisible[i]);
+		}
+		if (error > MAX_ERROR || differences)
+			++failures;
+		printf("%5d   %12.2e   %22zu   %16.2f   %15.2f\n", f, error, differences, t1 - t0, t2 - t1);
+	}
+
+	// a SkyLine circle, segments kept when both ends are visible
+	Vec3f circle[LINE_POINTS];
+	for (int i = 0; i < LINE_POINTS; ++i) {
+		const float a = 2.f * M_PI * i / (LINE_POINTS - 1);
+		circle[i] = Vec3f(cos(a), sin(a), 0.3f);
+	}
+	Vec3d win[LINE_POINTS], pt1, pt2;
+	uint8_t lineVisible[LINE_POINTS];
+	size_t segments[2] = {0, 0};
+	const Mat4d &mat = prj.getMatFrameToEye(PF_EARTH_EQU);
+
+	const double t0 = now();
+	for (int l = 0; l < NB_LINES; ++l) {
+		for (int i = 0; i + 1 < LINE_POINTS; ++i) {
+			if (prj.projectCustom(circle[i], pt1, mat) && prj.projectCustom(circle[i+1], pt2, mat))
+				++segments[0];
+		}
+	}
+	const double t1 = now();
+	for (int l = 0; l < NB_LINES; ++l) {
+		prj.projectBatch(PF_EARTH_EQU, circle, win, lineVisible, LINE_POINTS);
+		for (int i = 0; i + 1 < LINE_POINTS; ++i) {
+			if (lineVisible[i] && lineVisible[i+1])
+				++segments[1];
+		}
+	}
+	const double t2 = now();
+	if (segments[0] != segments[1])
+		++failures;
+
+	printf("\n%d lines of %d points, %zu and %zu segments\n", NB_LINES, LINE_POINTS, segments[0], segments[1]);
+	printf("  point by point : %7.2f ms, %6.1f ns per point\n", t1 - t0, (t1 - t0) * 1e6 / (double(NB_LINES) * LINE_POINTS));
+	printf("  projectBatch   : %7.2f ms, %6.1f ns per point\n", t2 - t1, (t2 - t1) * 1e6 / (double(NB_LINES) * LINE_POINTS));
+	printf("%s\n", failures ? "FAILED" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+// Cost of the script commands: parsed at every execution as before, or compiled
+// once into ScriptCommand and executed from it, on a generated script
+//
+// g++ -O2 -std=c++20 -I../../src main.cpp ../../src/scriptModule/script_command.cpp -o script_throughput
+
+#include "scriptModule/script_command.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+static const char *lines[] = {
+    "flag atmosphere on",
+    "set atmosphere_fade_duration 2",
+    "moveto lat 45.2 lon 2.3 alt 200 duration 0",
+    "text name t1 string \"hello  world of scripts\" x 10 y 20 display on",
+    "wait duration 0.01",
+    "add a 1",
+    "struct if a equal 10",
+    "color property constellation_lines r 0.2 g 0.4 b 0.6",
+    "  zoom auto initial",
+    "select planet home_planet duration 5",
+};
+
+// what AppCommandInterface::executeCommand takes before running a command, the
+// arguments are shared with the compiled command instead of being copied
+struct State {
+    std::string commandline;
+    std::string command;
+    ScriptArgs args;
+    SC_COMMAND code;
+};
+
+static const std::map<const std::string, SC_COMMAND> commands = {
+    {"flag", SC_COMMAND::SC_FLAG}, {"set", SC_COMMAND::SC_SET}, {"moveto", SC_COMMAND::SC_MOVETO},
+    {"text", SC_COMMAND::SC_TEXT}, {"wait", SC_COMMAND::SC_WAIT}, {"add", SC_COMMAND::SC_ADD},
+    {"struct", SC_COMMAND::SC_STRUCT}, {"color", SC_COMMAND::SC_COLOR}, {"zoom", SC_COMMAND::SC_ZOOMR},
+    {"select", SC_COMMAND::SC_SELECT},
+};
+
+static void compile(const std::string &line, ScriptCommand &compiled)
+{
+    compiled.parse(line);
+    auto it = commands.find(compiled.command);
+    if (it != commands.end())
+        compiled.code = it->second;
+}
+
+static size_t count(const ScriptArgs &args)
+{
+    return std::distance(args.begin(), args.end());
+}
+
+template<class F>
+static double timeMs(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    const unsigned int nbLines = 20000;
+    const int nbTurns = 20;
+    std::vector<std::string> script;
+    for (unsigned int i = 0; i < nbLines; ++i)
+        script.push_back(lines[i % (sizeof(lines) / sizeof(*lines))]);
+
+    State state;
+    size_t checksum[2] = {0, 0};
+
+    // previous loop: the raw strings are parsed again at every turn
+    const double parsed = timeMs([&] {
+        for (int turn = 0; turn < nbTurns; ++turn) {
+            for (const std::string &line : script) {
+                ScriptCommand tmp;
+                tmp.parse(line);
+                state.commandline = line;
+                state.command = tmp.command;
+                state.args = std::move(tmp.args);
+                auto it = commands.find(state.command);
+                state.code = (it != commands.end()) ? it->second : SC_COMMAND::SC_UNKNOWN;
+                checksum[0] += count(state.args) + (int) state.code;
+            }
+        }
+    });
+
+    std::vector<ScriptCommand> compiled(script.size());
+    const double load = timeMs([&] {
+        for (size_t i = 0; i < script.size(); ++i)
+            compile(script[i], compiled[i]);
+    });
+    const double replay = timeMs([&] {
+        for (int turn = 0; turn < nbTurns; ++turn) {
+            for (const ScriptCommand &c : compiled) {
+                state.code = c.code;
+                state.commandline = c.commandline;
+                state.command = c.command;
+                state.args = c.args;
+                checksum[1] += count(state.args) + (int) state.code;
+            }
+        }
+    });
+
+    const double n = double(nbLines) * nbTurns;
+    printf("%u lines, %d loop turns\n", nbLines, nbTurns);
+    printf("  parsed at every execution : %7.1f ms, %6.0f ns per command\n", parsed, parsed * 1e6 / n);
+    printf("  compiled once             : %7.1f ms to compile\n", load);
+    printf("  executed from compiled    : %7.1f ms, %6.0f ns per command\n", replay, replay * 1e6 / n);
+    printf("  same commands: %s\n", checksum[0] == checksum[1] ? "yes" : "no");
+    return 0;
+}
@@ -0,0 +1,273 @@
+// Load of a body file with thousands of asteroids: previous reader (getline, std::map per body,
+// parameters read with Utility::strToDouble and copied along the orbit creators) against BodyFile
+// and BodyDescriptor, with the parameter reads of ProtoSystem::addBody and the orbit creators.
+// Also checks that both read the same values from data/default_ssystem.ini, and times the
+// first sort of the rendered bodies.
+//
+// g++ -O2 -std=c++20 -I../../src main.cpp ../../src/bodyModule/body_descriptor.cpp ../../src/tools/log.cpp -lSDL2 -o ssystem_load
+// ./ssystem_load ../../data/default_ssystem.ini
+
+#include "bodyModule/body_descriptor.hpp"
+#include "tools/log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define NB_ASTEROIDS 20000
+#define GENERATED_FILE "/tmp/ssystem_load.ini"
+
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAILED line %d: %s\n", __LINE__, #cond); failures++; } } while (0)
+
+using Clock = std::chrono::steady_clock;
+
+// Utility::strToDouble and Utility::strToBool
+static double oldDouble(const std::string &str, double defaultValue = 0)
+{
+	try {
+		return std::stod(str);
+	} catch (...) {
+		return defaultValue;
+	}
+}
+
+static bool oldBool(const std::string &str, bool defaultValue = false)
+{
+	if (str.empty())
+		return defaultValue;
+	std::string tmp = str;
+	transform(tmp.begin(), tmp.end(), tmp.begin(), ::tolower);
+	return tmp == "true" || tmp == "1";
+}
+
+// previous ProtoSystem::load
+template<class F>
+static void oldLoad(const std::string &fileName, F &&addBody)
+{
+	stringHash_t bodyParams;
+	std::ifstream fileBody(fileName.c_str(), std::ifstream::in);
+	std::string ligne;
+	while (getline(fileBody, ligne)) {
+		if (ligne.size() < 2)
+			continue;
+		if (ligne[0] != '[') {
+			if (ligne[ligne.length() - 1] == '\r')
+				ligne.pop_back();
+			if (ligne[0] != '#' && ligne.size() != 0) {
+				int pos = ligne.find('=', 0);
+				std::string p1 = ligne.substr(0, pos - 1);
+				std::string p2 = ligne.substr(pos + 2, ligne.size());
+				bodyParams[p1] = p2;
+			}
+		} else if (bodyParams.size() != 0)
+			addBody(std::move(bodyParams));
+	}
+	if (!bodyParams.empty())
+		addBody(std::move(bodyParams));
+}
+
+// numbers read by ProtoSystem::addBody for a small body, with their defaults
+static const std::vector<std::pair<const char *, double>> bodyNumbers = {
+	{"orbit_bounding_radius", -1}, {"sol_local_day", 1}, {"radius", 0}, {"oblateness", 0}, {"albedo", 0},
+	{"big_halo_size", 50}, {"ring_inner_size", 0}, {"ring_outer_size", 0},
+	{"rot_obliquity", 0}, {"rot_equator_ascending_node", 0}, {"rot_pole_ra", 0}, {"rot_pole_de", 0},
+	{"rot_periode", 24}, {"orbit_period", 24}, {"rot_rotation_offset", 0}, {"rot_epoch", 2451545},
+	{"rot_precession_rate", 0}, {"orbit_visualization_period", 0}, {"axial_tilt", 0},
+};
+// numbers read by OrbitCreatorComet::handle
+static const std::vector<std::pair<const char *, double>> orbitNumbers = {
+	{"orbit_eccentricity", 0}, {"orbit_pericenterdistance", -1e100}, {"orbit_semimajoraxis", -1e100},
+	{"orbit_meanmotion", -1e100}, {"orbit_period", -1e100}, {"orbit_timeatpericenter", -1e100},
+	{"orbit_epoch", -1e100}, {"orbit_meananomaly", -1e100}, {"orbit_inclination", 0},
+	{"orbit_ascendingnode", 0}, {"orbit_argofpericenter", 0},
+};
+static const std::vector<const char *> bodyStrings = {
+	"color", "label_color", "orbit_color", "trail_color", "tex_map", "tex_normal", "tex_night",
+	"tex_specular", "tex_heightmap", "tex_skin", "model_name", "tex_big_halo",
+};
+static const std::vector<const char *> bodyFlags = {"close_orbit", "halo", "rings", "hidden"};
+
+// the orbit creators took the hash by value: bary, elliptic then comet
+static double oldOrbit(stringHash_t params, int link)
+{
+	if (link < 2)
+		return oldOrbit(params, link + 1);
+	double sum = 0;
+	for (const auto &n : orbitNumbers)
+		sum += oldDouble(params[n.first], n.second);
+	return sum;
+}
+
+static double oldAddBody(stringHash_t param)
+{
+	double sum = param["name"].size() + param["parent"].size() + param["type"].size() + param["coord_func"].size();
+	sum += oldOrbit(param, 0);
+	for (const auto &n : bodyNumbers)
+		sum += oldDouble(param[n.first], n.second);
+	for (const char *s : bodyStrings)
+		sum += param[s].size();
+	for (const char *f : bodyFlags)
+		sum += oldBool(param[f]);
+	return sum;
+}
+
+static double newAddBody(const BodyDescriptor &param)
+{
+	double sum = param.name.size() + param.parent.size() + param.type.size() + param.coordFunc.size();
+	for (const auto &n : orbitNumbers)
+		sum += param.getDouble(n.first, n.second);
+	for (const auto &n : bodyNumbers)
+		sum += param.getDouble(n.first, n.second);
+	for (const char *s : bodyStrings)
+		sum += param.getStr(s).size();
+	for (const char *f : bodyFlags)
+		sum += param.getBool(f);
+	return sum;
+}
+
+static void checkSameValues(const std::string &fileName)
+{
+	std::vector<stringHash_t> oldBodies;
+	oldLoad(fileName, [&](stringHash_t &&param) { oldBodies.push_back(std::move(param)); });
+	BodyFile file;
+	CHECK(file.load(fileName));
+	const auto &bodies = file.getBodies();
+	CHECK(bodies.size() == oldBodies.size());
+	size_t values = 0;
+	for (size_t i = 0; i < std::min(bodies.size(), oldBodies.size()); ++i) {
+		// the new reader trims the spaces around the values
+		stringHash_t trimmed = oldBodies[i];
+		for (auto &p : trimmed) {
+			p.second.erase(0, p.second.find_first_not_of(' '));
+			p.second.erase(p.second.find_last_not_of(' ') + 1);
+		}
+		CHECK(bodies[i].toHash() == trimmed);
+		CHECK(bodies[i].name == oldBodies[i]["name"] && bodies[i].coordFunc == oldBodies[i]["coord_func"]);
+		for (auto &p : oldBodies[i]) {
+			CHECK(bodies[i].getDouble(p.first, -7) == oldDouble(p.second, -7));
+			CHECK(bodies[i].getBool(p.first, true) == oldBool(p.second, true));
+			++values;
+		}
+		CHECK(newAddBody(bodies[i]) == oldAddBody(oldBodies[i]));
+	}
+	// malformed lines and a value given twice
+	BodyFile text;
+	text.parse("# comment\n[a]\nname = A\r\nradius=  12.5e3  \nnot a parameter\nradius = -3\n\n[b]\nname = B\nhidden = TRUE\n");
+	CHECK(text.getBodies().size() == 2);
+	CHECK(text.getBodies()[0].name == "A" && text.getBodies()[0].getDouble("radius") == -3);
+	CHECK(text.getBodies()[1].getBool("hidden") && text.getBodies()[1].get("radius").empty());
+	printf("%s: %zu bodies, %zu values read the same way\n", fileName.c_str(), bodies.size(), values);
+}
+
+static void generate(const std::string &base)
+{
+	std::ifstream in(base, std::ios::binary);
+	std::ofstream out(GENERATED_FILE, std::ios::binary);
+	out << in.rdbuf();
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<double> u(0, 1);
+	char section[1024];
+	for (int i = 0; i < NB_ASTEROIDS; i++) {
+		snprintf(section, sizeof(section),
+			"\n[asteroid %d]\nname = A%d\nparent = Sun\ntype = Asteroid\nradius = %.1f\noblateness = 0.0\nalbedo = %.3f\n"
+			"lighting = true\nhalo = true\ncolor = 1.0,1.0,1.0\nlabel_color = 0.3,0.3,0.2\norbit_color = 0.3,0.3,0.2\n"
+			"tex_halo = star16x16.png\ntex_map = bodies/generic.png\ncoord_func = comet_orbit\norbit_epoch = 54600.\n"
+			"orbit_meananomaly = %.12f\norbit_semimajoraxis = %.12f\norbit_eccentricity = %.12f\n"
+			"orbit_argofpericenter = %.12f\norbit_ascendingnode = %.12f\norbit_inclination = %.12f\n"
+			"orbit_visualization_period = %.2f\nhidden = true\n",
+			i, i, 1 + 100 * u(rng), u(rng), 360 * u(rng), 2 + 2 * u(rng), 0.3 * u(rng), 360 * u(rng), 360 * u(rng), 30 * u(rng), 1000 + 1000 * u(rng));
+		out << section;
+	}
+}
+
+static void benchmark()
+{
+	for (int run = 0; run < 2; run++) {
+		double oldSum = 0, newSum = 0;
+		size_t nbOld = 0;
+		auto start = Clock::now();
+		oldLoad(GENERATED_FILE, [&](stringHash_t &&param) { oldSum += oldAddBody(std::move(param)); ++nbOld; });
+		const double oldMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		start = Clock::now();
+		BodyFile file;
+		file.load(GENERATED_FILE);
+		const double parseMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		for (const auto &body : file.getBodies())
+			newSum += newAddBody(body);
+		const double newMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		CHECK(nbOld == file.getBodies().size() && oldSum == newSum);
+		printf("%zu bodies: previous reader %.0f ms, BodyFile %.0f ms (split %.0f ms, parameters %.0f ms)\n",
+			nbOld, oldMs, newMs, parseMs, newMs - parseMs);
+	}
+}
+
+// sort pass of ProtoSystem::computeDraw, each body is moved up by one place at most
+static void sortPass(std::vector<double *> &bodies)
+{
+	double ** const begin = bodies.data() - 1;
+	double ** const end = begin + bodies.size();
+	double **swapPos, **pos = bodies.data(), *tmp;
+	do {
+		if (*pos[0] < *pos[1]) {
+			swapPos = pos;
+			tmp = pos[1];
+			do {
+				pos[1] = pos[0];
+			} while (--pos != begin && *pos[0] < *pos[1]);
+			pos[1] = tmp;
+			pos = swapPos;
+		}
+	} while (++pos < end);
+}
+
+// bodies shown in file order: frames drawn out of order by the per frame pass, or one stable_sort
+static void benchmarkSort()
+{
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<double> u(0, 50);
+	std::vector<double> distances(NB_ASTEROIDS);
+	for (auto &d : distances)
+		d = u(rng);
+	std::vector<double *> bubble(distances.size());
+	for (size_t i = 0; i < distances.size(); ++i)
+		bubble[i] = &distances[i];
+	std::vector<double *> sorted = bubble;
+
+	auto start = Clock::now();
+	std::stable_sort(sorted.begin(), sorted.end(), [](double *a, double *b) { return *a > *b; });
+	const double sortMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	int frames = 0;
+	start = Clock::now();
+	while (bubble != sorted && frames < 100000) {
+		sortPass(bubble);
+		++frames;
+	}
+	const double passMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / std::max(frames, 1);
+	CHECK(bubble == sorted);
+	printf("%d bodies shown in file order: %d frames (%.2f ms each) before the per frame pass reaches the order, stable_sort %.1f ms\n",
+		NB_ASTEROIDS, frames, passMs, sortMs);
+}
+
+int main(int argc, char **argv)
+{
+	cLog::get()->setWriteLog(false);
+	const std::string base = argc > 1 ? argv[1] : "../../data/default_ssystem.ini";
+	checkSameValues(base);
+	generate(base);
+	benchmark();
+	benchmarkSort();
+	if (failures) {
+		printf("%d failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("all checks passed\n");
+	return EXIT_SUCCESS;
+}
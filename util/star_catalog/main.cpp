@@ -0,0 +1,163 @@
+// Round trip of the mapped star catalogue of StarNavigator: stars of a StarManager saved by
+// StarCatalog::save, mapped back and compared column by column with the catalogue built from
+// the manager, then exported back into a StarManager. Also checks that a truncated file or an
+// out of date source isn't mapped, that a new date of an unchanged source is written back in
+// the header, and times the text catalogue load against the mapping.
+//
+// g++ -O2 -std=c++20 -I../../src main.cpp ../../src/inGalaxyModule/starCatalog.cpp ../../src/inGalaxyModule/starManager.cpp ../../src/tools/source_key.cpp ../../src/tools/utility.cpp ../../src/tools/log.cpp -lSDL2 -o star_catalog
+
+#include "inGalaxyModule/starCatalog.hpp"
+#include "inGalaxyModule/starManager.hpp"
+#include "tools/log.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#define NB_STARS 200000
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+	printf("  %-52s %s\n", what, ok ? "ok" : "FAILED");
+	if (!ok)
+		++failures;
+}
+
+static double now()
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// same stars, cubes and visibility in both catalogues
+static bool sameCatalog(const StarCatalog &a, const StarCatalog &b)
+{
+	if (a.size() != b.size() || a.getNbCubes() != b.getNbCubes())
+		return false;
+	if (memcmp(a.getCubes(), b.getCubes(), a.getNbCubes() * sizeof(StarCatalogCube)))
+		return false;
+	const size_t n = a.size();
+	return !memcmp(a.posX, b.posX, n * sizeof(float)) && !memcmp(a.posY, b.posY, n * sizeof(float))
+		&& !memcmp(a.posZ, b.posZ, n * sizeof(float)) && !memcmp(a.mag, b.mag, n * sizeof(float))
+		&& !memcmp(a.pmRA, b.pmRA, n * sizeof(float)) && !memcmp(a.pmDE, b.pmDE, n * sizeof(float))
+		&& !memcmp(a.pc, b.pc, n * sizeof(float)) && !memcmp(a.hip, b.hip, n * sizeof(uint32_t))
+		&& !memcmp(a.bv, b.bv, n * sizeof(uint8_t));
+}
+
+int main()
+{
+	cLog::get()->setWriteLog(false);
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "star_catalog_test";
+	std::filesystem::create_directories(dir);
+	const std::string textName = (dir / "stars.dat").string();
+	const std::string mappedName = (dir / "stars.dat.bin").string();
+	const std::string brokenName = (dir / "broken.bin").string();
+
+	std::mt19937 rng(1);
+	std::normal_distribution<float> position(0.f, 300.f);
+	std::uniform_real_distribution<float> uniform(0.f, 1.f);
+	{
+		StarManager mgr;
+		for (unsigned int i = 0; i < NB_STARS; ++i) {
+			starInfo *si = new starInfo;
+			si->HIP = i + 1;
+			si->posXYZ = Vec3f(position(rng), position(rng), position(rng));
+			si->pmRA = uniform(rng) * 100.f - 50.f;
+			si->pmDE = uniform(rng) * 100.f - 50.f;
+			si->mag = uniform(rng) * 16.f - 4.f;
+			si->B_V = (int) (uniform(rng) * 128.f);
+			si->pc = si->posXYZ.length();
+			si->show = true;
+			mgr.addHcStar(si);
+		}
+		check(mgr.saveStarCatalog(textName), "text catalogue written");
+	}
+
+	printf("%d stars\n", NB_STARS);
+	StarManager mgr;
+	double t0 = now();
+	check(mgr.loadStarCatalog(textName), "text catalogue loaded");
+	StarCatalog built;
+	built.build(mgr);
+	const double textTime = now() - t0;
+
+	SourceKey source;
+	check(source.read(textName), "source key of the text catalogue");
+	check(built.save(mappedName, source), "catalogue saved");
+
+	StarCatalog mapped;
+	t0 = now();
+	const bool isMapped = mapped.map(mappedName, textName);
+	const double mapTime = now() - t0;
+	check(isMapped && mapped.isMapped(), "catalogue mapped");
+	check(sameCatalog(built, mapped), "mapped stars equal to the saved ones");
+
+	bool sameInfo = true;
+	for (unsigned int i = 0; i < mapped.size() && sameInfo; i += 97) {
+		const starInfo a = built.getStarInfo(i);
+		const starInfo b = mapped.getStarInfo(i);
+		sameInfo = a.HIP == b.HIP && a.posXYZ == b.posXYZ && a.mag == b.mag && a.B_V == b.B_V && a.show == b.show
+			&& mapped.findStar(a.HIP) == built.findStar(a.HIP);
+	}
+	check(sameInfo, "same starInfo and findStar");
+
+	// the exported stars are put in cubes again from their positions, only the stars are compared
+	StarManager exported;
+	mapped.exportTo(exported);
+	StarCatalog rebuilt;
+	rebuilt.build(exported);
+	bool sameStars = rebuilt.size() == built.size();
+	for (unsigned int i = 0; i < rebuilt.size() && sameStars; ++i) {
+		const int j = built.findStar(rebuilt.hip[i]);
+		sameStars = j >= 0 && rebuilt.posX[i] == built.posX[j] && rebuilt.posY[i] == built.posY[j] && rebuilt.posZ[i] == built.posZ[j]
+			&& rebuilt.mag[i] == built.mag[j] && rebuilt.pmRA[i] == built.pmRA[j] && rebuilt.pmDE[i] == built.pmDE[j]
+			&& rebuilt.pc[i] == built.pc[j] && rebuilt.bv[i] == built.bv[j];
+	}
+	check(sameStars, "stars exported from the mapping");
+
+	// a truncated file is refused, the catalogue mapped before stays usable in its own object
+	{
+		std::ifstream in(mappedName, std::ios::binary);
+		std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		std::ofstream out(brokenName, std::ios::binary);
+		out.write(data.data(), data.size() / 2);
+	}
+	StarCatalog broken;
+	check(!broken.map(brokenName) && broken.size() == 0, "truncated catalogue refused");
+	check(!broken.map((dir / "missing.bin").string()), "missing catalogue refused");
+	check(sameCatalog(built, mapped), "mapping kept after the refused ones");
+
+	// the text catalogue is copied again with the same content, the mapping hashes it once
+	// and writes its new date in the header
+	std::filesystem::last_write_time(textName, std::filesystem::last_write_time(textName) + std::chrono::hours(1));
+	StarCatalog touched;
+	check(touched.map(mappedName, textName), "catalogue mapped after a new date of its source");
+	touched.clear();
+	SourceKey stored;
+	{
+		std::ifstream in(mappedName, std::ios::binary);
+		in.seekg(offsetof(StarCatalogHeader, source));
+		in.read((char *) &stored, sizeof(stored));
+	}
+	SourceKey touchedSource;
+	touchedSource.read(textName);
+	check(stored.mtime == touchedSource.mtime && stored.hash == source.hash, "new date of the source written back");
+
+	// the text catalogue changes, the compiled one is out of date
+	{
+		std::ofstream out(textName, std::ios::app);
+		out << "\n";
+	}
+	StarCatalog outdated;
+	check(!outdated.map(mappedName, textName), "out of date catalogue refused");
+
+	printf("load of the text catalogue : %8.1f ms\n", textTime);
+	printf("mapping of the catalogue   : %8.1f ms\n", mapTime);
+	std::filesystem::remove_all(dir);
+	printf("%s\n", failures ? "FAILED" : "ok");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+// Checks the batch kernels of src/starModule/star_projection.cpp against Projector::projectLocalCheck,
+// the projection of Star1 and of the stars before the kernels, from the maximal fov down to the
+// minimal fov of the Projector, and times both.
+//
+// g++ -O2 -std=c++20 -DLINUX=1 -I../../src main.cpp ../../src/starModule/star_projection.cpp ../../src/starModule/sphere_geometry.cpp -o star_projection
+
+// Projector::printGravity180 is the only user of s_font and isn't called here
+#define _S_FONT_H
+#include "tools/vecmath.hpp"
+#include <string>
+class s_font {
+public:
+	float getStrLen(const std::string &) {
+		return 0;
+	}
+	void print(float, float, const std::string &, Vec4f, Mat4f, int, bool = true) {}
+};
+#include "coreModule/projector.cpp"
+
+#include "starModule/star_projection.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace BigStarCatalog;
+
+#define NB_STARS (1 << 16)
+// largest accepted difference with projectLocalCheck, in pixels
+#define MAX_ERROR 1e-3
+
+static int failures = 0;
+
+// zone centered on the view direction, the stars cover 1.5 times the fov
+struct TestZone {
+	StarProjectionZone zone;
+	Vec3d center, axis0, axis1;
+};
+
+static TestZone makeZone(const Mat4d &toLocal, const Mat4d &toEye, double fov)
+{
+	TestZone t;
+	const Vec3d view = (toEye * toLocal).fastInverse().multiplyWithoutTranslation(Vec3d(0, 0, -1));
+	t.center = view;
+	t.center.normalize();
+	Vec3d side = t.center ^ Vec3d(0, 0, 1);
+	side.normalize();
+	Vec3d up = side ^ t.center;
+	// c0 and c1 in [-1000, 1000] as the Star2 positions
+	const double step = 1.5 * fov * (M_PI/180) / 2000;
+	t.axis0 = side * step;
+	t.axis1 = up * step;
+	for (int i = 0; i < 3; ++i) {
+		t.zone.center[i] = t.center[i];
+		t.zone.axis0[i] = t.axis0[i];
+		t.zone.axis1[i] = t.axis1[i];
+	}
+	return t;
+}
+
+int main()
+{
+	Projector prj(1920, 1080, 60);
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+	std::uniform_real_distribution<double> coord(-1000, 1000);
+	const double fovs[] = {350, 180, 60, 10, 1, 0.1, 0.01, 0.001, 0.0001};
+
+	printf("kernels: %s\n", starBatchImplementation());
+	printf("     fov   max error px   mask differences   batch ns/star   projectLocal ns/star\n");
+	for (double fov : fovs) {
+		prj.setFov(fov);
+		const Mat4d toLocal = Mat4d::zrotation(angle(rng)) * Mat4d::xrotation(angle(rng));
+		const Mat4d toEye = Mat4d::xrotation(angle(rng)) * Mat4d::zrotation(angle(rng));
+		prj.setModelViewMatrices(toEye, toEye, toEye, toEye, toEye, toEye, toEye);
+		StarProjectionFrame frame;
+		frame.update(&prj, toLocal, toEye);
+		const TestZone t = makeZone(toLocal, toEye, fov);
+
+		std::vector<double> c0(NB_STARS), c1(NB_STARS);
+		for (int i = 0; i < NB_STARS; ++i) {
+			c0[i] = coord(rng);
+			c1[i] = coord(rng);
+		}
+
+		// reference, as ZoneArray1::draw
+		std::vector<Vec3d> ref(NB_STARS);
+		std::vector<bool> refVisible(NB_STARS);
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < NB_STARS; ++i) {
+			Vec3d pos = t.center + c0[i]*t.axis0 + c1[i]*t.axis1;
+			pos.normalize();
+			refVisible[i] = prj.projectLocalCheck(toLocal * pos, ref[i]);
+		}
+		const double refTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / NB_STARS;
+
+		// kernels, as SpecialZoneArray::draw
+		std::vector<double> winX(NB_STARS), winY(NB_STARS);
+		std::vector<bool> visible(NB_STARS);
+		StarBatch batch;
+		start = std::chrono::steady_clock::now();
+		for (int first = 0; first < NB_STARS; first += STAR_BATCH_SIZE) {
+			for (int i = 0; i < STAR_BATCH_SIZE; ++i) {
+				batch.c0[i] = c0[first + i];
+				batch.c1[i] = c1[first + i];
+			}
+			starBatchToLocal(frame, t.zone, batch);
+			const unsigned int mask = starBatchProject(frame, true, batch);
+			for (int i = 0; i < STAR_BATCH_SIZE; ++i) {
+				winX[first + i] = batch.winX[i];
+				winY[first + i] = batch.winY[i];
+				visible[first + i] = (mask >> i) & 1;
+			}
+		}
+		const double batchTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / NB_STARS;
+
+		double maxError = 0;
+		int maskDiff = 0;
+		for (int i = 0; i < NB_STARS; ++i) {
+			if (visible[i] != refVisible[i]) {
+				maskDiff++;
+				continue;
+			}
+			if (visible[i])
+				maxError = std::max(maxError, std::hypot(winX[i] - ref[i][0], winY[i] - ref[i][1]));
+		}
+		printf("%8g   %12.2e   %16d   %13.1f   %20.1f\n", fov, maxError, maskDiff, batchTime, refTime);
+		if (maxError > MAX_ERROR || maskDiff > 0)
+			failures++;
+	}
+	printf(failures ? "%d fov FAILED\n" : "all checks passed\n", failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+// Checks of StartupGraph: order of the dependencies, main thread tasks, failure of a task,
+// critical path; and time of the first part of Core::init run in sequence or as a graph,
+// each loading being emulated by a sleep of its duration.
+//
+// g++ -O2 -std=c++20 -pthread -I../../src main.cpp ../../src/tools/startup_graph.cpp ../../src/tools/log.cpp -lSDL2 -o startup_graph
+
+#include "tools/startup_graph.hpp"
+#include "tools/ThreadPool.hpp"
+#include "tools/log.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAILED line %d: %s\n", __LINE__, #cond); failures++; } } while (0)
+
+static void sleepMs(int ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static void checkOrder()
+{
+	ThreadPool pool(3);
+	StartupGraph graph;
+	std::mutex lock;
+	std::vector<std::string> order;
+	const std::thread::id caller = std::this_thread::get_id();
+	std::atomic<int> wrongThread{0};
+	auto task = [&](const std::string &name, int ms, bool mainThread) {
+		return [&, name, ms, mainThread]() {
+			if ((std::this_thread::get_id() == caller) != mainThread)
+				++wrongThread;
+			sleepMs(ms);
+			std::lock_guard<std::mutex> guard(lock);
+			order.push_back(name);
+		};
+	};
+	graph.add("a", {}, task("a", 20, false));
+	graph.add("b", {}, task("b", 5, true), STARTUP_MAIN_THREAD);
+	graph.add("c", {"a", "b"}, task("c", 5, true), STARTUP_MAIN_THREAD);
+	graph.add("d", {"a"}, task("d", 5, false));
+	graph.add("e", {"c", "d"}, task("e", 5, false));
+	graph.add("f", {"unknown"}, task("f", 1, false));
+	graph.run(pool);
+	auto rank = [&](const std::string &name) {
+		for (size_t i = 0; i < order.size(); ++i)
+			if (order[i] == name)
+				return (int) i;
+		return -1;
+	};
+	CHECK(order.size() == 6 && wrongThread == 0);
+	CHECK(rank("a") < rank("c") && rank("b") < rank("c") && rank("a") < rank("d"));
+	CHECK(rank("c") < rank("e") && rank("d") < rank("e"));
+	// a (20) > c (5) > e (5), b and d are not critical
+	CHECK(graph.getCriticalTime() >= 30 && graph.getCriticalTime() < graph.getWallTime() + 1);
+	const std::string report = graph.getReport();
+	CHECK(report.find("critical path") != std::string::npos && report.find(" a (") != std::string::npos);
+	CHECK(report.find("> e (") != std::string::npos);
+}
+
+static void checkFailure()
+{
+	ThreadPool pool(2);
+	StartupGraph graph;
+	std::atomic<int> ran{0};
+	graph.add("ok", {}, [&]() { ++ran; });
+	graph.add("throw", {}, []() { throw std::runtime_error("broken file"); });
+	graph.add("after throw", {"throw"}, [&]() { ++ran; }, STARTUP_MAIN_THREAD);
+	graph.add("after after", {"after throw", "ok"}, [&]() { ++ran; });
+	graph.add("independent", {"ok"}, [&]() { ++ran; }, STARTUP_MAIN_THREAD);
+	bool thrown = false;
+	try {
+		graph.run(pool);
+	} catch (const std::runtime_error &e) {
+		thrown = std::string(e.what()) == "broken file";
+	}
+	CHECK(thrown);
+	CHECK(ran == 2);
+	CHECK(graph.getReport().find("after after") != std::string::npos);
+}
+
+struct Loading {
+	const char *name;
+	std::vector<std::string> after;
+	int ms;
+	bool mainThread;
+};
+
+// first part of Core::init, durations of a start with the compiled catalogues
+static const std::vector<Loading> coreInit = {
+	{"ssystem setup", {}, 60, STARTUP_MAIN_THREAD},
+	{"ephemeris cache", {}, 40, STARTUP_WORKER},
+	{"solar system", {"ssystem setup", "ephemeris cache"}, 250, STARTUP_MAIN_THREAD},
+	{"anchors", {"solar system"}, 15, STARTUP_MAIN_THREAD},
+	{"galactic system", {"anchors"}, 25, STARTUP_MAIN_THREAD},
+	{"hip stars", {}, 180, STARTUP_WORKER},
+	{"hip stars texture", {"hip stars"}, 10, STARTUP_MAIN_THREAD},
+	{"nebulas", {}, 120, STARTUP_MAIN_THREAD},
+	{"landscape", {"anchors"}, 90, STARTUP_MAIN_THREAD},
+	{"star navigator", {}, 30, STARTUP_WORKER},
+	{"star navigator buffers", {"star navigator"}, 20, STARTUP_MAIN_THREAD},
+	{"star lines", {}, 15, STARTUP_WORKER},
+};
+
+static void benchmark()
+{
+	auto start = std::chrono::steady_clock::now();
+	for (const auto &l : coreInit)
+		sleepMs(l.ms);
+	const double sequential = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	// the pool of Core::init
+	ThreadPool &pool = ThreadPool::shared();
+	StartupGraph graph;
+	int mainWork = 0;
+	for (const auto &l : coreInit) {
+		graph.add(l.name, l.after, [ms = l.ms]() { sleepMs(ms); }, l.mainThread);
+		if (l.mainThread)
+			mainWork += l.ms;
+	}
+	graph.run(pool);
+	printf("%s", graph.getReport().c_str());
+	printf("benchmark: sequential %.0f ms, graph %.0f ms (main thread work %d ms), critical path %.0f ms\n",
+		sequential, graph.getWallTime(), mainWork, graph.getCriticalTime());
+	CHECK(graph.getWallTime() < sequential);
+}
+
+int main()
+{
+	cLog::get()->setWriteLog(false);
+	checkOrder();
+	checkFailure();
+	benchmark();
+	if (failures) {
+		printf("%d failures\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("all checks passed\n");
+	return EXIT_SUCCESS;
+}
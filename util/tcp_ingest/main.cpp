@@ -0,0 +1,252 @@
+// Loopback test of ServerSocket: command throughput, latency from the client write
+// to getInput, lines lost or cut, and cpu used by an idle server.
+// The previous SDL_net loop is emulated with select() and a 1 ms timeout for comparison.
+//
+// g++ -O2 -std=c++20 -pthread -DLINUX=1 -I../../src main.cpp ../../src/tools/io.cpp ../../src/tools/log.cpp -lSDL2 -o tcp_ingest
+
+#include "tools/io.hpp"
+#include "tools/app_settings.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// computeHttp is not reached, no need for app_settings.cpp and config.h
+AppSettings* AppSettings::Instance() { return nullptr; }
+const std::string AppSettings::getWebDir() const { return ""; }
+
+#define NB_CLIENT 4
+#define NB_BURST 50
+#define BURST_SIZE 200
+#define PORT_NEW 17805
+#define PORT_OLD 17806
+
+static uint64_t nowNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double cpuMs()
+{
+	timespec t;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+	return t.tv_sec * 1e3 + t.tv_nsec / 1e6;
+}
+
+// previous ServerSocket::run: select on every socket with a 1 ms timeout, a mutex
+// each turn, a scan of the clients and the lines cut at the end of each recv
+class OldServer {
+public:
+	explicit OldServer(unsigned int port) {
+		serverFd = socket(AF_INET, SOCK_STREAM, 0);
+		int enable = 1;
+		setsockopt(serverFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(port);
+		bind(serverFd, (sockaddr *) &address, sizeof(address));
+		listen(serverFd, 16);
+		clients.assign(16, -1);
+		buffer.resize(65536);
+		thread = std::thread([this] { run(); });
+	}
+	~OldServer() {
+		stop = true;
+		thread.join();
+		for (int fd : clients)
+			if (fd >= 0)
+				::close(fd);
+		::close(serverFd);
+	}
+	std::string getInput() {
+		std::lock_guard<std::mutex> lock(inputting);
+		if (inputQueue.empty())
+			return "";
+		std::string data = inputQueue.front();
+		inputQueue.pop();
+		return data;
+	}
+
+private:
+	void run() {
+		while (!stop) {
+			fd_set set;
+			FD_ZERO(&set);
+			FD_SET(serverFd, &set);
+			int maxFd = serverFd;
+			for (int fd : clients) {
+				if (fd >= 0) {
+					FD_SET(fd, &set);
+					maxFd = std::max(maxFd, fd);
+				}
+			}
+			timeval timeout = {0, 1000};
+			int active = select(maxFd + 1, &set, nullptr, nullptr, &timeout);
+			std::lock_guard<std::mutex> lock(running);
+			if (active <= 0)
+				continue;
+			if (FD_ISSET(serverFd, &set)) {
+				*std::find(clients.begin(), clients.end(), -1) = accept(serverFd, nullptr, nullptr);
+				--active;
+			}
+			for (int &fd : clients) {
+				if (fd < 0 || !FD_ISSET(fd, &set))
+					continue;
+				int count = recv(fd, buffer.data(), buffer.size() - 1, 0);
+				if (count <= 0) {
+					::close(fd);
+					fd = -1;
+				} else {
+					for (int i = 0; i < count; i++) if (buffer[i] == '\r' || buffer[i] == '\0') buffer[i] = '\n';
+					buffer[count] = '\0';
+					std::string data = buffer.data();
+					std::lock_guard<std::mutex> lock(inputting);
+					size_t begin = 0, end;
+					do {
+						end = data.find('\n', begin);
+						if (begin < data.size() && end != begin)
+							inputQueue.push(data.substr(begin, end - begin));
+						begin = end + 1;
+					} while (end != std::string::npos);
+				}
+				if (--active <= 0)
+					break;
+			}
+		}
+	}
+
+	int serverFd;
+	std::vector<int> clients;
+	std::vector<char> buffer;
+	std::thread thread;
+	std::atomic<bool> stop{false};
+	std::mutex running, inputting;
+	std::queue<std::string> inputQueue;
+};
+
+static int connectTo(unsigned int port)
+{
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+	if (connect(fd, (sockaddr *) &address, sizeof(address)) < 0) {
+		perror("connect");
+		exit(1);
+	}
+	return fd;
+}
+
+// idle: one client connected, nothing sent
+static void measureIdle(const char *name, unsigned int port)
+{
+	int idle = connectTo(port);
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	double cpu = cpuMs();
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+	printf("%s: idle cpu %.1f ms/s\n", name, cpuMs() - cpu);
+	::close(idle);
+}
+
+// bursts of commands from several clients, pauseMs between two bursts, the consumer polls like a busy main loop
+template<class Server>
+static void measure(const char *name, Server &server, unsigned int port, int pauseMs)
+{
+	const unsigned int total = NB_CLIENT * NB_BURST * BURST_SIZE;
+	std::vector<std::thread> clients;
+	std::atomic<int> ready{0};
+	for (int c = 0; c < NB_CLIENT; c++) {
+		clients.emplace_back([&, c] {
+			int fd = connectTo(port);
+			ready++;
+			while (ready < NB_CLIENT)
+				std::this_thread::yield();
+			std::string burst;
+			unsigned int seq = 0;
+			for (int b = 0; b < NB_BURST; b++) {
+				burst.clear();
+				const uint64_t t = nowNs();
+				for (int i = 0; i < BURST_SIZE; i++)
+					burst += "flag stars on bench " + std::to_string(c) + " " + std::to_string(seq++) + " " + std::to_string(t) + "\n";
+				for (size_t sent = 0; sent < burst.size();) {
+					ssize_t n = write(fd, burst.data() + sent, burst.size() - sent);
+					if (n <= 0)
+						break;
+					sent += n;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(pauseMs));
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(500));
+			::close(fd);
+		});
+	}
+
+	std::vector<uint64_t> latencies;
+	latencies.reserve(total);
+	std::vector<unsigned int> expected(NB_CLIENT, 0);
+	unsigned int received = 0, cut = 0, outOfOrder = 0;
+	const uint64_t start = nowNs();
+	uint64_t last = start;
+	while (received < total && nowNs() - start < 20000000000ull) {
+		std::string command = server.getInput();
+		if (command.empty()) {
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+			continue;
+		}
+		last = nowNs();
+		int c;
+		unsigned int seq;
+		unsigned long long t;
+		if (sscanf(command.c_str(), "flag stars on bench %d %u %llu", &c, &seq, &t) != 3 || c < 0 || c >= NB_CLIENT || t > last || last - t > 10000000000ull) { // a cut timestamp is far in the past
+			cut++;
+			continue;
+		}
+		if (seq != expected[c])
+			outOfOrder++;
+		expected[c] = seq + 1;
+		received++;
+		latencies.push_back(last - t);
+	}
+	for (auto &t : clients)
+		t.join();
+
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&](double p) {
+		return latencies.empty() ? 0. : latencies[std::min(latencies.size() - 1, (size_t) (p * latencies.size()))] / 1e3;
+	};
+	printf("%s, pause %d ms: %u/%u commands in %.0f ms (%.0f commands/s), latency p50 %.0f us p99 %.0f us max %.0f us, %u cut lines, %u out of order\n",
+		name, pauseMs, received, total, (last - start) / 1e6, received / ((last - start) / 1e9),
+		percentile(0.5), percentile(0.99), percentile(1.), cut, outOfOrder);
+}
+
+int main()
+{
+	cLog::get()->setWriteLog(false); // the previous loop is emulated without its log
+	{
+		OldServer server(PORT_OLD);
+		measureIdle("select 1 ms", PORT_OLD);
+		for (int pauseMs : {5, 0})
+			measure("select 1 ms", server, PORT_OLD, pauseMs);
+	}
+	{
+		ServerSocket server(PORT_NEW, 16, 65536);
+		server.open();
+		measureIdle("epoll      ", PORT_NEW);
+		for (int pauseMs : {5, 0})
+			measure("epoll      ", server, PORT_NEW, pauseMs);
+		server.close();
+	}
+	return 0;
+}
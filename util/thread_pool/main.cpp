@@ -0,0 +1,164 @@
+// Microbenchmark of src/tools/ThreadPool.hpp against the previous pool
+// (one mutex-protected std::queue of std::function)
+//
+// g++ -O2 -std=c++20 -pthread -I../../src main.cpp -o thread_pool_bench
+
+#include "tools/ThreadPool.hpp"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <queue>
+
+class LegacyThreadPool {
+public:
+    LegacyThreadPool(size_t threads) : stop(false) {
+        for(size_t i = 0;i<threads;++i)
+            workers.emplace_back([this] {
+                for(;;) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(this->queue_mutex);
+                        this->condition.wait(lock,[this]{ return this->stop || !this->tasks.empty(); });
+                        if(this->stop && this->tasks.empty())
+                            return;
+                        task = std::move(this->tasks.front());
+                        this->tasks.pop();
+                    }
+                    task();
+                }
+            });
+    }
+    template<class F, class... Args>
+    auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type> {
+        using return_type = typename std::invoke_result<F, Args...>::type;
+        auto task = std::make_shared< std::packaged_task<return_type()> >(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+        std::future<return_type> res = task->get_future();
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            tasks.emplace([task](){ (*task)(); });
+        }
+        condition.notify_one();
+        return res;
+    }
+    ~LegacyThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for(std::thread &worker: workers)
+            worker.join();
+    }
+private:
+    std::vector< std::thread > workers;
+    std::queue< std::function<void()> > tasks;
+    std::mutex queue_mutex;
+    std::condition_variable condition;
+    bool stop;
+};
+
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::atomic<size_t> counter{0};
+
+static void work(size_t n)
+{
+    counter.fetch_add(n, std::memory_order_relaxed);
+}
+
+// per task cost of enqueue + get() on N futures
+template<class Pool>
+static double futures(Pool &pool, size_t n)
+{
+    std::vector<std::future<void>> results;
+    results.reserve(n);
+    double t = now();
+    for (size_t i = 0; i < n; ++i)
+        results.emplace_back(pool.enqueue(work, i));
+    for (auto &r : results)
+        r.get();
+    return (now() - t) / n * 1e9;
+}
+
+// per task cost of TaskGroup::run + wait
+static double group(ThreadPool &pool, size_t n)
+{
+    double t = now();
+    TaskGroup g(pool);
+    for (size_t i = 0; i < n; ++i)
+        g.run([i] { work(i); });
+    g.wait();
+    return (now() - t) / n * 1e9;
+}
+
+// latency of a single enqueue until the result is back
+template<class Pool>
+static double roundTrip(Pool &pool, size_t n)
+{
+    double t = now();
+    for (size_t i = 0; i < n; ++i)
+        pool.enqueue(work, i).get();
+    return (now() - t) / n * 1e9;
+}
+
+static double loop(ThreadPool &pool, size_t n, size_t grain)
+{
+    double t = now();
+    pool.parallelFor(0, n, grain, [](size_t first, size_t last) { work(last - first); });
+    return (now() - t) * 1e6;
+}
+
+// groups waited from inside the tasks of other groups, as the startup graph does
+static bool nested(ThreadPool &pool, size_t outer, size_t inner)
+{
+    counter = 0;
+    TaskGroup g(pool);
+    for (size_t i = 0; i < outer; ++i)
+        g.run([&pool, inner] {
+            TaskGroup sub(pool);
+            for (size_t j = 0; j < inner; ++j)
+                sub.run([] { work(1); });
+            sub.wait();
+        });
+    g.wait();
+    return counter == outer * inner;
+}
+
+// CPU time spent by a thread waiting for a task which sleeps
+static double idleWait(ThreadPool &pool)
+{
+    TaskGroup g(pool);
+    g.run([] { std::this_thread::sleep_for(std::chrono::milliseconds(200)); });
+    const std::clock_t c = std::clock();
+    g.wait();
+    return double(std::clock() - c) / CLOCKS_PER_SEC * 1e3;
+}
+
+int main()
+{
+    const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t n = 200000;
+    printf("%zu threads, %zu tasks\n", threads, n);
+    {
+        LegacyThreadPool pool(threads);
+        printf("legacy   enqueue+get   %8.1f ns/task\n", futures(pool, n));
+        printf("legacy   round trip    %8.1f ns\n", roundTrip(pool, n / 10));
+    }
+    {
+        ThreadPool pool(threads);
+        printf("stealing enqueue+get   %8.1f ns/task\n", futures(pool, n));
+        printf("stealing round trip    %8.1f ns\n", roundTrip(pool, n / 10));
+        printf("stealing TaskGroup     %8.1f ns/task\n", group(pool, n));
+        printf("stealing parallelFor   %8.1f us for 10M indices\n", loop(pool, 10000000, 65536));
+    }
+    {
+        ThreadPool &pool = ThreadPool::shared();
+        printf("shared pool            %8zu workers\n", pool.size());
+        printf("shared nested groups   %8s\n", nested(pool, 64, 1000) ? "ok" : "FAILED");
+        printf("shared idle wait       %8.1f ms CPU for a 200 ms task\n", idleWait(pool));
+    }
+    return 0;
+}
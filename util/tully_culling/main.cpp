@@ -0,0 +1,155 @@
+// Cost of Tully::computeSquareGalaxies: loop over every galaxy with a std::list
+// against the TullyGrid candidates with a reused vector, on a synthetic catalogue
+//
+// g++ -Ofast -std=c++20 -I../../src main.cpp ../../src/coreModule/tullyGrid.cpp -o tully_culling
+
+#include "coreModule/tullyGrid.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Square {
+    float position[3];
+    float texture;
+    float radius;
+    float distance;
+    uint32_t index;
+    uint8_t planeSide;
+};
+
+// clusters of galaxies in a sphere of 300 units, same scales as Tully::loadCatalog
+static std::vector<float> makeCatalogue(unsigned int nbGalaxy, std::mt19937 &rng)
+{
+    std::normal_distribution<float> gauss(0.f, 1.f);
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+    std::vector<float> data;
+    float center[3] = {0, 0, 0};
+    float spread = 1;
+    for (unsigned int i = 0; i < nbGalaxy; ++i) {
+        if (i % 50 == 0) {
+            for (float &c : center)
+                c = 300.f * (2 * uniform(rng) - 1);
+            spread = 0.5f + 8.f * uniform(rng);
+        }
+        const float t = uniform(rng);
+        float texture = 1, scale = 0.25;
+        if (t < 0.15) { texture = 0; scale = 8; }
+        else if (t < 0.25) { texture = 7; scale = 0.125; }
+        else if (t < 0.26) { texture = 9; scale = 64; }
+        else if (t < 0.27) { texture = 12; scale = 128; }
+        for (float c : center)
+            data.push_back(c + spread * gauss(rng));
+        data.insert(data.end(), {uniform(rng), uniform(rng), uniform(rng), texture, scale});
+    }
+    return data;
+}
+
+// previous Tully::computeSquareGalaxies, with the comparator fixed to get the same order
+static bool compList(const Square &a, const Square &b)
+{
+    if (a.planeSide != b.planeSide)
+        return a.planeSide < b.planeSide;
+    if (a.distance != b.distance)
+        return a.distance > b.distance;
+    return a.index < b.index;
+}
+
+struct Old {
+    std::list<std::pair<Square, std::string>> list;
+
+    int run(const std::vector<float> &data, unsigned int nbGalaxy, const float cam[3], float *out) {
+        float x,y,z,a = cam[0],b = cam[1],c = cam[2],distance,radius;
+        for (unsigned int i = 0; i < nbGalaxy; i++) {
+            x = data[8*i]; y = data[8*i+1]; z = data[8*i+2];
+            distance=sqrt((x-a)*(x-a)+(y-b)*(y-b)+(z-c)*(z-c));
+            radius = 3.0/(distance*data[8*i+7]);
+            if (radius<2)
+                continue;
+            Square tmp{{x, y, z}, data[8*i+6], radius, distance, i, 0};
+            list.push_back({tmp, std::string()});
+        }
+        const int count = list.size();
+        list.sort([](auto &l, auto &r) { return compList(l.first, r.first); });
+        for (int side = 0; side < 2; ++side) {
+            for (auto &it : list) {
+                if (it.first.planeSide == side) {
+                    memcpy(out, &it.first, 5 * sizeof(float));
+                    out += 5;
+                }
+            }
+        }
+        list.clear();
+        return count;
+    }
+};
+
+struct New {
+    TullyGrid grid;
+    std::vector<Square> squares;
+
+    int run(const Vec3f &cam, float *out) {
+        squares.clear();
+        grid.forEachCandidate(cam, [&](const TullyGrid::Entry &g) {
+            const float distance=sqrt((g.x-cam[0])*(g.x-cam[0])+(g.y-cam[1])*(g.y-cam[1])+(g.z-cam[2])*(g.z-cam[2]));
+            const float radius = 3.0/(distance*g.scale);
+            if (radius<2)
+                return;
+            squares.push_back({{g.x, g.y, g.z}, g.texture, radius, distance, g.index, 0});
+        });
+        std::sort(squares.begin(), squares.end(), compList);
+        for (const Square &s : squares) {
+            memcpy(out, &s, 5 * sizeof(float));
+            out += 5;
+        }
+        return squares.size();
+    }
+};
+
+int main()
+{
+    std::mt19937 rng(42);
+    for (unsigned int nbGalaxy : {10000u, 17000u, 100000u}) {
+        const std::vector<float> data = makeCatalogue(nbGalaxy, rng);
+        New n;
+        auto start = std::chrono::steady_clock::now();
+        n.grid.build(data.data(), nbGalaxy);
+        const double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // cameras near random galaxies and anywhere in the catalogue
+        std::vector<Vec3f> cameras;
+        std::uniform_int_distribution<unsigned int> pick(0, nbGalaxy - 1);
+        std::uniform_real_distribution<float> uniform(-300.f, 300.f);
+        for (int i = 0; i < 500; ++i) {
+            const unsigned int g = pick(rng);
+            cameras.push_back(Vec3f(data[8*g] + 0.2f, data[8*g+1] - 0.1f, data[8*g+2] + 0.3f));
+            cameras.push_back(Vec3f(uniform(rng), uniform(rng), uniform(rng)));
+        }
+
+        Old o;
+        std::vector<float> outOld(5 * nbGalaxy), outNew(5 * nbGalaxy);
+        size_t mismatches = 0, drawn = 0;
+        double oldMs = 0, newMs = 0;
+        for (const Vec3f &cam : cameras) {
+            const float c[3] = {cam[0], cam[1], cam[2]};
+            start = std::chrono::steady_clock::now();
+            const int countOld = o.run(data, nbGalaxy, c, outOld.data());
+            oldMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            start = std::chrono::steady_clock::now();
+            const int countNew = n.run(cam, outNew.data());
+            newMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            drawn += countNew;
+            if (countOld != countNew || memcmp(outOld.data(), outNew.data(), 5 * sizeof(float) * countNew))
+                ++mismatches;
+        }
+        printf("%6u galaxies, %6u cells, build %.2f ms: per frame %.4f ms -> %.4f ms (x%.0f), %.1f squares, %zu mismatches\n",
+               nbGalaxy, n.grid.getNbCells(), buildMs, oldMs / cameras.size(), newMs / cameras.size(),
+               oldMs / newMs, double(drawn) / cameras.size(), mismatches);
+    }
+    return 0;
+}